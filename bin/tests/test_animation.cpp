@@ -0,0 +1,286 @@
+/*************************************************************************/
+/*  test_animation.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_animation.h"
+
+#include "os/os.h"
+#include "os/memory.h"
+#include "print_string.h"
+#include "scene/resources/animation.h"
+
+/* Memory and sampling throughput of transform tracks, plain and compressed */
+
+namespace TestAnimation {
+
+enum {
+	BONES=200,
+	FPS=30,
+	SECONDS=10,
+	FRAMES=3000, // played at 60 fps, wrapping around
+	ERROR_SAMPLES=997
+};
+
+static const float MAX_ERROR=0.001;
+
+static Ref<Animation> _make_animation() {
+
+	// something like a character: a few bones move, most only rotate, some don't move at all
+
+	Ref<Animation> anim = memnew( Animation );
+	anim->set_length(SECONDS);
+	anim->set_loop(true);
+
+	for(int i=0;i<BONES;i++) {
+
+		int t = anim->add_track(Animation::TYPE_TRANSFORM);
+		anim->track_set_path(t,"Skeleton:bone"+itos(i));
+
+		bool moves = (i%8)==0;
+		bool still = (i%5)==4;
+		Vector3 axis = Vector3(Math::sin(i*0.7),Math::cos(i*1.3),0.5).normalized();
+		Vector3 rest = Vector3(0,0.1*i,0);
+
+		for(int j=0;j<=FPS*SECONDS;j++) {
+
+			float time = float(j)/FPS;
+			float phase = time*Math_PI*2.0/SECONDS;
+
+			Vector3 loc = rest;
+			if (moves)
+				loc+=Vector3(Math::sin(phase*3+i),Math::abs(Math::sin(phase*6))*0.2,Math::cos(phase*2+i)*0.5);
+
+			Quat rot;
+			if (!still)
+				rot=Quat(axis,0.8*Math::sin(phase*(1+i%4)+i)+0.1*Math::sin(phase*9));
+
+			anim->transform_track_insert_key(t,time,loc,rot,Vector3(1,1,1));
+		}
+	}
+
+	return anim;
+}
+
+static void _measure_error(const Ref<Animation>& p_plain, const Ref<Animation>& p_compressed, float &r_loc_err, float &r_rot_err) {
+
+	r_loc_err=0;
+	r_rot_err=0;
+
+	for(int i=0;i<BONES;i++) {
+
+		for(int j=0;j<ERROR_SAMPLES;j++) {
+
+			float time = SECONDS*float(j)/ERROR_SAMPLES;
+			Vector3 loc_a,loc_b,scale_a,scale_b;
+			Quat rot_a,rot_b;
+			p_plain->transform_track_interpolate(i,time,&loc_a,&rot_a,&scale_a);
+			p_compressed->transform_track_interpolate(i,time,&loc_b,&rot_b,&scale_b);
+
+			r_loc_err=MAX(r_loc_err,loc_a.distance_to(loc_b));
+			r_loc_err=MAX(r_loc_err,scale_a.distance_to(scale_b));
+			rot_a.normalize();
+			rot_b.normalize();
+			Quat d = rot_a.dot(rot_b)<0 ? rot_a+rot_b : rot_a-rot_b;
+			r_rot_err=MAX(r_rot_err,4.0*Math::asin(MIN(Math::sqrt(d.dot(d))*0.5,1.0)));
+		}
+	}
+}
+
+static float _batch_difference(const Ref<Animation>& p_anim) {
+
+	// the batched slerp approximates the trigonometry, it has to stay close to Quat::slerp
+
+	Vector3 loc[BONES];
+	Quat rot[BONES];
+	Vector3 scale[BONES];
+	bool ok[BONES];
+	int tracks[BONES];
+
+	for(int i=0;i<BONES;i++)
+		tracks[i]=i;
+
+	float diff=0;
+
+	for(int j=0;j<ERROR_SAMPLES;j++) {
+
+		float time = SECONDS*float(j)/ERROR_SAMPLES;
+		p_anim->transform_tracks_interpolate(tracks,BONES,time,loc,rot,scale,ok);
+
+		for(int i=0;i<BONES;i++) {
+
+			Vector3 l,s;
+			Quat r;
+			p_anim->transform_track_interpolate(i,time,&l,&r,&s);
+			if (!ok[i])
+				return 1e10;
+
+			diff=MAX(diff,l.distance_to(loc[i]));
+			diff=MAX(diff,s.distance_to(scale[i]));
+			diff=MAX(diff,Math::abs(r.x-rot[i].x)+Math::abs(r.y-rot[i].y)+Math::abs(r.z-rot[i].z)+Math::abs(r.w-rot[i].w));
+		}
+	}
+
+	return diff;
+}
+
+static bool _check_roundtrip(const Ref<Animation>& p_compressed) {
+
+	// compressed keys are saved as they are, loading them back must give the same track
+
+	Ref<Animation> loaded = memnew( Animation );
+	loaded->set_length(p_compressed->get_length());
+	loaded->set_loop(p_compressed->has_loop());
+
+	for(int i=0;i<BONES;i++) {
+
+		loaded->add_track(Animation::TYPE_TRANSFORM);
+		loaded->set("tracks/"+itos(i)+"/keys",p_compressed->get("tracks/"+itos(i)+"/keys"));
+		if (loaded->transform_track_is_compressed(i)!=p_compressed->transform_track_is_compressed(i))
+			return false;
+	}
+
+	for(int j=0;j<ERROR_SAMPLES;j++) {
+
+		float time = SECONDS*float(j)/ERROR_SAMPLES;
+		for(int i=0;i<BONES;i++) {
+
+			Vector3 loc_a,loc_b,scale_a,scale_b;
+			Quat rot_a,rot_b;
+			p_compressed->transform_track_interpolate(i,time,&loc_a,&rot_a,&scale_a);
+			loaded->transform_track_interpolate(i,time,&loc_b,&rot_b,&scale_b);
+			if (loc_a!=loc_b || rot_a!=rot_b || scale_a!=scale_b)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+enum SampleMode {
+	SAMPLE_SEARCH,
+	SAMPLE_HINTED,
+	SAMPLE_BATCH
+};
+
+static float _bench_sampling(const Ref<Animation>& p_anim, SampleMode p_mode, float *r_checksum) {
+
+	Vector3 loc[BONES];
+	Quat rot[BONES];
+	Vector3 scale[BONES];
+	bool ok[BONES];
+	int tracks[BONES];
+	int hints[BONES];
+
+	for(int i=0;i<BONES;i++) {
+		tracks[i]=i;
+		hints[i]=-1;
+	}
+
+	float checksum=0;
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+	for(int f=0;f<FRAMES;f++) {
+
+		float time = Math::fmod(f/60.0,(double)SECONDS);
+
+		switch(p_mode) {
+
+			case SAMPLE_SEARCH: {
+
+				for(int i=0;i<BONES;i++)
+					p_anim->transform_track_interpolate(i,time,&loc[i],&rot[i],&scale[i]);
+			} break;
+			case SAMPLE_HINTED: {
+
+				for(int i=0;i<BONES;i++)
+					p_anim->transform_track_interpolate(i,time,&loc[i],&rot[i],&scale[i],&hints[i]);
+			} break;
+			case SAMPLE_BATCH: {
+
+				p_anim->transform_tracks_interpolate(tracks,BONES,time,loc,rot,scale,ok,hints);
+			} break;
+		}
+
+		checksum+=loc[f%BONES].y+rot[f%BONES].w;
+	}
+
+	uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	*r_checksum=checksum;
+	return usec*1000.0/(FRAMES*BONES);
+}
+
+MainLoop* test() {
+
+	// only tracked when built with DEBUG_MEMORY_ENABLED
+	size_t base = Memory::get_static_mem_usage();
+	Ref<Animation> plain = _make_animation();
+	size_t plain_mem = Memory::get_static_mem_usage()-base;
+
+	base = Memory::get_static_mem_usage();
+	Ref<Animation> compressed = _make_animation();
+	compressed->compress(MAX_ERROR);
+	size_t compressed_mem = Memory::get_static_mem_usage()-base;
+
+	int compressed_tracks=0;
+	int keys=0;
+	for(int i=0;i<BONES;i++) {
+		if (compressed->transform_track_is_compressed(i))
+			compressed_tracks++;
+		keys+=compressed->track_get_key_count(i);
+	}
+
+	String mem = plain_mem ? ("plain "+itos(plain_mem/1024)+" kb, compressed "+itos(compressed_mem/1024)+" kb") : String("usage not tracked in this build");
+	print_line("memory: "+itos(BONES)+" tracks, "+itos(BONES*(FPS*SECONDS+1))+" keys, "+mem+" ("+itos(compressed_tracks)+" tracks compressed, "+itos(keys)+" keys kept)");
+
+	float loc_err,rot_err;
+	_measure_error(plain,compressed,loc_err,rot_err);
+	bool ok = loc_err<=MAX_ERROR && rot_err<=MAX_ERROR;
+	print_line("error: loc/scale "+rtos(loc_err)+", rot "+rtos(rot_err)+" rad, bound "+rtos(MAX_ERROR));
+
+	float check_search,check_hinted,check_batch,check_compressed;
+	print_line("plain, search: "+rtos(_bench_sampling(plain,SAMPLE_SEARCH,&check_search))+" nsec per track");
+	print_line("plain, hinted: "+rtos(_bench_sampling(plain,SAMPLE_HINTED,&check_hinted))+" nsec per track");
+	print_line("plain, batch: "+rtos(_bench_sampling(plain,SAMPLE_BATCH,&check_batch))+" nsec per track");
+	print_line("compressed, batch: "+rtos(_bench_sampling(compressed,SAMPLE_BATCH,&check_compressed))+" nsec per track");
+
+	float batch_diff = MAX(_batch_difference(plain),_batch_difference(compressed));
+	print_line("batch vs single track: "+rtos(batch_diff)+" max difference");
+	if (batch_diff>1e-5 || check_search!=check_hinted)
+		ok=false;
+
+	bool roundtrip = _check_roundtrip(compressed);
+	print_line(String("save and load compressed: ")+(roundtrip?"same":"different"));
+	if (!roundtrip)
+		ok=false;
+
+	print_line(String("animation ")+(ok?"OK":"FAILED"));
+
+	return NULL;
+}
+
+}
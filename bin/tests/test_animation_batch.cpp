@@ -0,0 +1,190 @@
+/*************************************************************************/
+/*  test_animation_batch.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_animation_batch.h"
+
+#include "os/os.h"
+#include "globals.h"
+#include "print_string.h"
+#include "scene/main/scene_main_loop.h"
+#include "scene/main/viewport.h"
+#include "scene/3d/skeleton.h"
+#include "scene/animation/animation_player.h"
+#include "scene/animation/animation_batch.h"
+
+/* A crowd of skinned characters animated by their own AnimationPlayer, sampled on the main thread and on all cores */
+
+namespace TestAnimationBatch {
+
+enum {
+	CHARACTERS=200,
+	BONES=60,
+	FPS=30,
+	SECONDS=4,
+	FRAMES=300
+};
+
+class TestMainLoop : public SceneMainLoop {
+
+	Vector<AnimationPlayer*> players;
+	Vector<Skeleton*> skeletons;
+	Vector<Transform> serial_poses;
+	int pass;
+	int frame;
+	uint64_t sample_usec;
+	uint64_t apply_usec;
+	uint64_t process_usec;
+
+	Ref<Animation> _make_animation() {
+
+		Ref<Animation> anim = memnew( Animation );
+		anim->set_length(SECONDS);
+		anim->set_loop(true);
+
+		for(int i=0;i<BONES;i++) {
+
+			int t = anim->add_track(Animation::TYPE_TRANSFORM);
+			anim->track_set_path(t,"Skeleton:bone"+itos(i));
+			Vector3 axis = Vector3(Math::sin(i*0.7),Math::cos(i*1.3),0.5).normalized();
+
+			for(int j=0;j<=FPS*SECONDS;j++) {
+
+				float time = float(j)/FPS;
+				float phase = time*Math_PI*2.0/SECONDS;
+				Vector3 loc = Vector3(0,0.1,0);
+				if (i==0)
+					loc+=Vector3(0,Math::abs(Math::sin(phase*2))*0.2,0);
+				anim->transform_track_insert_key(t,time,loc,Quat(axis,0.8*Math::sin(phase*(1+i%4)+i)),Vector3(1,1,1));
+			}
+		}
+
+		return anim;
+	}
+
+	void _start_pass(int p_threads) {
+
+		//thread count is read when the workers start
+		AnimationBatch::finish();
+		Globals::get_singleton()->set("animation/process_threads",p_threads);
+
+		for(int i=0;i<players.size();i++) {
+			players[i]->play("walk");
+			players[i]->seek(float(i%16)/16.0*SECONDS);
+		}
+
+		frame=0;
+		sample_usec=0;
+		apply_usec=0;
+		process_usec=0;
+	}
+
+	void _end_pass(const String& p_name) {
+
+		print_line(p_name+": sample "+rtos(sample_usec/float(FRAMES))+" usec, apply "+rtos(apply_usec/float(FRAMES))+" usec, process "+rtos(process_usec/float(FRAMES))+" usec per frame");
+	}
+
+public:
+
+	virtual void init() {
+
+		SceneMainLoop::init();
+
+		Ref<Animation> anim = _make_animation();
+
+		for(int i=0;i<CHARACTERS;i++) {
+
+			Spatial *character = memnew( Spatial );
+			character->set_name("character"+itos(i));
+
+			Skeleton *skeleton = memnew( Skeleton );
+			skeleton->set_name("Skeleton");
+			for(int j=0;j<BONES;j++) {
+				skeleton->add_bone("bone"+itos(j));
+				skeleton->set_bone_parent(j,j-1);
+			}
+			character->add_child(skeleton);
+
+			AnimationPlayer *player = memnew( AnimationPlayer );
+			player->add_animation("walk",anim);
+			character->add_child(player);
+
+			get_root()->add_child(character);
+			players.push_back(player);
+			skeletons.push_back(skeleton);
+		}
+
+		pass=0;
+		_start_pass(1);
+	}
+
+	virtual bool idle(float p_time) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		bool quit = SceneMainLoop::idle(1.0/60.0);
+		process_usec+=OS::get_singleton()->get_ticks_usec()-from;
+		sample_usec+=AnimationBatch::get_sample_usec(AnimationBatch::MODE_IDLE);
+		apply_usec+=AnimationBatch::get_apply_usec(AnimationBatch::MODE_IDLE);
+
+		if (++frame<FRAMES)
+			return quit;
+
+		if (pass==0) {
+
+			_end_pass(itos(CHARACTERS)+" characters, main thread");
+
+			for(int i=0;i<skeletons.size();i++) {
+				for(int j=0;j<BONES;j++)
+					serial_poses.push_back(skeletons[i]->get_bone_pose(j));
+			}
+
+			pass=1;
+			_start_pass(0);
+			return quit;
+		}
+
+		_end_pass(itos(CHARACTERS)+" characters, "+itos(OS::get_singleton()->get_processor_count())+" threads");
+
+		//threads must not change what gets applied
+		bool ok=true;
+		for(int i=0;i<skeletons.size();i++) {
+			for(int j=0;j<BONES;j++)
+				ok = ok && skeletons[i]->get_bone_pose(j)==serial_poses[i*BONES+j];
+		}
+
+		print_line(String("animation batch ")+(ok?"OK":"FAILED"));
+		return true;
+	}
+
+};
+
+MainLoop* test() {
+
+	return memnew( TestMainLoop );
+}
+
+}
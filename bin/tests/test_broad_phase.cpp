@@ -0,0 +1,681 @@
+/*************************************************************************/
+/*  test_broad_phase.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_broad_phase.h"
+
+#include "servers/physics_2d/broad_phase_2d_hash_grid.h"
+#include "servers/physics/broad_phase_basic.h"
+#include "servers/physics/broad_phase_octree.h"
+#include "servers/physics/broad_phase_sap.h"
+#include "servers/physics/collision_object_sw.h"
+#include "os/os.h"
+#include "math_funcs.h"
+#include "print_string.h"
+#include "vector.h"
+
+/* Broadphase move/pair benchmarks. 2D owners are fake pointers, 2D broadphases never dereference them.
+   The 3D octree asks the owner for its type, so 3D owners are real (empty) objects. */
+
+namespace TestBroadPhase {
+
+struct PairCounter {
+
+	int pairs;
+	int pair_events;
+	int unpair_events;
+};
+
+static void* _pair_2d(CollisionObject2DSW *A,int p_subindex_A,CollisionObject2DSW *B,int p_subindex_B,void *p_userdata) {
+
+	PairCounter *pc=(PairCounter*)p_userdata;
+	pc->pairs++;
+	pc->pair_events++;
+	return NULL;
+}
+
+static void _unpair_2d(CollisionObject2DSW *A,int p_subindex_A,CollisionObject2DSW *B,int p_subindex_B,void *p_data,void *p_userdata) {
+
+	PairCounter *pc=(PairCounter*)p_userdata;
+	pc->pairs--;
+	pc->unpair_events++;
+}
+
+static void _benchmark_2d(const String& p_name,BroadPhase2DSW *p_bp,int p_count,int p_frames) {
+
+	PairCounter pc;
+	pc.pairs=0;
+	pc.pair_events=0;
+	pc.unpair_events=0;
+
+	p_bp->set_pair_callback(_pair_2d,&pc);
+	p_bp->set_unpair_callback(_unpair_2d,&pc);
+
+	// keep density constant, roughly 8 neighbours per object
+	float world_size = Math::sqrt(p_count)*64.0;
+	Math::seed(1234);
+
+	Vector<BroadPhase2DSW::ID> ids;
+	Vector<Vector2> pos;
+	Vector<Vector2> vel;
+	ids.resize(p_count);
+	pos.resize(p_count);
+	vel.resize(p_count);
+
+	uint64_t t=OS::get_singleton()->get_ticks_usec();
+
+	for(int i=0;i<p_count;i++) {
+
+		ids[i]=p_bp->create((CollisionObject2DSW*)(size_t)(i+1));
+		pos[i]=Vector2(Math::random(0,world_size),Math::random(0,world_size));
+		vel[i]=Vector2(Math::random(-4,4),Math::random(-4,4));
+		p_bp->move(ids[i],Rect2(pos[i],Size2(24,24)));
+	}
+
+	uint64_t create_usec=OS::get_singleton()->get_ticks_usec()-t;
+	t=OS::get_singleton()->get_ticks_usec();
+
+	for(int f=0;f<p_frames;f++) {
+
+		for(int i=0;i<p_count;i++) {
+
+			Vector2 &p=pos[i];
+			p+=vel[i];
+			if (p.x<0 || p.x>world_size)
+				vel[i].x=-vel[i].x;
+			if (p.y<0 || p.y>world_size)
+				vel[i].y=-vel[i].y;
+			p_bp->move(ids[i],Rect2(p,Size2(24,24)));
+		}
+		p_bp->update();
+	}
+
+	uint64_t move_usec=OS::get_singleton()->get_ticks_usec()-t;
+	t=OS::get_singleton()->get_ticks_usec();
+
+	for(int i=0;i<p_count;i++)
+		p_bp->remove(ids[i]);
+
+	uint64_t remove_usec=OS::get_singleton()->get_ticks_usec()-t;
+
+	print_line(p_name+" objects: "+itos(p_count)+" create: "+rtos(create_usec/1000.0)+"ms, move: "+rtos(move_usec/1000.0/p_frames)+"ms/frame ("+rtos(double(move_usec)*1000.0/(double(p_count)*p_frames))+"ns/move), remove: "+rtos(remove_usec/1000.0)+"ms, pair events: "+itos(pc.pair_events)+", leaked pairs: "+itos(pc.pairs));
+}
+
+class BenchObject3D : public CollisionObjectSW {
+public:
+
+	int index;
+
+	virtual void _shapes_changed() {}
+	virtual void set_space(SpaceSW *p_space) {}
+	BenchObject3D() : CollisionObjectSW(TYPE_BODY) { index=0; }
+};
+
+static void* _pair_3d(CollisionObjectSW *A,int p_subindex_A,CollisionObjectSW *B,int p_subindex_B,void *p_userdata) {
+
+	PairCounter *pc=(PairCounter*)p_userdata;
+	pc->pairs++;
+	pc->pair_events++;
+	return NULL;
+}
+
+static void _unpair_3d(CollisionObjectSW *A,int p_subindex_A,CollisionObjectSW *B,int p_subindex_B,void *p_data,void *p_userdata) {
+
+	PairCounter *pc=(PairCounter*)p_userdata;
+	pc->pairs--;
+	pc->unpair_events++;
+}
+
+static void _benchmark_3d(const String& p_name,BroadPhaseSW *p_bp,int p_count,int p_frames) {
+
+	PairCounter pc;
+	pc.pairs=0;
+	pc.pair_events=0;
+	pc.unpair_events=0;
+
+	p_bp->set_pair_callback(_pair_3d,&pc);
+	p_bp->set_unpair_callback(_unpair_3d,&pc);
+
+	// vehicles/crowds: spread on a plane, moving mostly horizontally
+	float world_size = Math::sqrt(p_count)*8.0;
+	Math::seed(1234);
+
+	Vector<BenchObject3D*> objects;
+	Vector<BroadPhaseSW::ID> ids;
+	Vector<Vector3> pos;
+	Vector<Vector3> vel;
+	objects.resize(p_count);
+	ids.resize(p_count);
+	pos.resize(p_count);
+	vel.resize(p_count);
+
+	uint64_t t=OS::get_singleton()->get_ticks_usec();
+
+	for(int i=0;i<p_count;i++) {
+
+		objects[i]=memnew( BenchObject3D );
+		ids[i]=p_bp->create(objects[i]);
+		p_bp->set_static(ids[i],false);
+		pos[i]=Vector3(Math::random(0,world_size),Math::random(0,4),Math::random(0,world_size));
+		vel[i]=Vector3(Math::random(-0.5,0.5),0,Math::random(-0.5,0.5));
+		p_bp->move(ids[i],AABB(pos[i],Vector3(3,2,3)));
+	}
+
+	uint64_t create_usec=OS::get_singleton()->get_ticks_usec()-t;
+	t=OS::get_singleton()->get_ticks_usec();
+
+	for(int f=0;f<p_frames;f++) {
+
+		for(int i=0;i<p_count;i++) {
+
+			Vector3 &p=pos[i];
+			p+=vel[i];
+			if (p.x<0 || p.x>world_size)
+				vel[i].x=-vel[i].x;
+			if (p.z<0 || p.z>world_size)
+				vel[i].z=-vel[i].z;
+			p_bp->move(ids[i],AABB(p,Vector3(3,2,3)));
+		}
+		p_bp->update();
+	}
+
+	uint64_t move_usec=OS::get_singleton()->get_ticks_usec()-t;
+	t=OS::get_singleton()->get_ticks_usec();
+
+	int culled=0;
+	CollisionObjectSW *results[256];
+	int subindices[256];
+	for(int i=0;i<1000;i++) {
+
+		Vector3 from(Math::random(0,world_size),2,Math::random(0,world_size));
+		culled+=p_bp->cull_aabb(AABB(from,Vector3(16,4,16)),results,256,subindices);
+		culled+=p_bp->cull_segment(from,from+Vector3(Math::random(-32,32),0,Math::random(-32,32)),results,256,subindices);
+	}
+
+	uint64_t cull_usec=OS::get_singleton()->get_ticks_usec()-t;
+	t=OS::get_singleton()->get_ticks_usec();
+
+	for(int i=0;i<p_count;i++)
+		p_bp->remove(ids[i]);
+
+	uint64_t remove_usec=OS::get_singleton()->get_ticks_usec()-t;
+
+	for(int i=0;i<p_count;i++)
+		memdelete(objects[i]);
+
+	print_line(p_name+" objects: "+itos(p_count)+" create: "+rtos(create_usec/1000.0)+"ms, move: "+rtos(move_usec/1000.0/p_frames)+"ms/frame ("+rtos(double(move_usec)*1000.0/(double(p_count)*p_frames))+"ns/move), cull: "+rtos(cull_usec/2000.0)+"us/query ("+itos(culled)+" hits), remove: "+rtos(remove_usec/1000.0)+"ms, pair events: "+itos(pc.pair_events)+", leaked pairs: "+itos(pc.pairs));
+}
+
+/* Pair validation: elements live in slots, two slots (subindex 0 and 1) share each owner.
+   Every pair/unpair event is tracked, and after each update() the live pairs must match a brute force overlap test. */
+
+enum {
+	VALIDATE_SLOTS=256,
+	VALIDATE_FRAMES=300
+};
+
+struct PairChecker {
+
+	Vector<uint8_t> paired; // VALIDATE_SLOTS*VALIDATE_SLOTS, indexed by the lower slot first
+	int errors;
+
+	_FORCE_INLINE_ int _index(int p_a,int p_b) const { return p_a<p_b ? p_a*VALIDATE_SLOTS+p_b : p_b*VALIDATE_SLOTS+p_a; }
+
+	bool is_paired(int p_a,int p_b) const { return paired[_index(p_a,p_b)]; }
+
+	void pair(int p_a,int p_b) {
+
+		if (p_a==p_b || paired[_index(p_a,p_b)])
+			errors++; // paired twice
+		paired[_index(p_a,p_b)]=1;
+	}
+
+	void unpair(int p_a,int p_b) {
+
+		if (!paired[_index(p_a,p_b)])
+			errors++; // unpaired without a pair
+		paired[_index(p_a,p_b)]=0;
+	}
+
+	bool has_pairs(int p_slot) const {
+
+		for(int i=0;i<VALIDATE_SLOTS;i++) {
+			if (i!=p_slot && paired[_index(p_slot,i)])
+				return true;
+		}
+		return false;
+	}
+
+	PairChecker() {
+		paired.resize(VALIDATE_SLOTS*VALIDATE_SLOTS);
+		for(int i=0;i<paired.size();i++)
+			paired[i]=0;
+		errors=0;
+	}
+};
+
+struct ValidateSlot3D {
+
+	BroadPhaseSW::ID id; // 0 if not created
+	bool placed;
+	bool _static;
+	AABB aabb;
+};
+
+static int _slot_3d(CollisionObjectSW *p_owner,int p_subindex) {
+
+	return static_cast<BenchObject3D*>(p_owner)->index*2+p_subindex;
+}
+
+static void* _check_pair_3d(CollisionObjectSW *A,int p_subindex_A,CollisionObjectSW *B,int p_subindex_B,void *p_userdata) {
+
+	((PairChecker*)p_userdata)->pair(_slot_3d(A,p_subindex_A),_slot_3d(B,p_subindex_B));
+	return NULL;
+}
+
+static void _check_unpair_3d(CollisionObjectSW *A,int p_subindex_A,CollisionObjectSW *B,int p_subindex_B,void *p_data,void *p_userdata) {
+
+	((PairChecker*)p_userdata)->unpair(_slot_3d(A,p_subindex_A),_slot_3d(B,p_subindex_B));
+}
+
+static AABB _random_aabb_3d() {
+
+	// mostly small boxes, a few long ones so the largest extent keeps changing
+	Vector3 size(Math::random(1,6),Math::random(1,4),Math::random(1,6));
+	if (Math::randf()<0.05)
+		size.x=Math::random(10,30);
+	return AABB(Vector3(Math::random(0,60),Math::random(0,6),Math::random(0,60)),size);
+}
+
+static int _check_pairs_3d(const PairChecker& p_checker,const Vector<ValidateSlot3D>& p_slots) {
+
+	int errors=0;
+
+	for(int i=0;i<VALIDATE_SLOTS;i++) {
+
+		const ValidateSlot3D &a=p_slots[i];
+
+		for(int j=i+1;j<VALIDATE_SLOTS;j++) {
+
+			const ValidateSlot3D &b=p_slots[j];
+			bool expected = a.id && b.id && a.placed && b.placed && (i>>1)!=(j>>1) && !(a._static && b._static) && a.aabb.intersects(b.aabb);
+			if (expected!=p_checker.is_paired(i,j))
+				errors++;
+		}
+	}
+
+	return errors;
+}
+
+static int _check_cull_3d(BroadPhaseSW *p_bp,const Vector<ValidateSlot3D>& p_slots) {
+
+	AABB query=_random_aabb_3d();
+	query.size*=2;
+
+	CollisionObjectSW *results[VALIDATE_SLOTS];
+	int subindices[VALIDATE_SLOTS];
+	int count=p_bp->cull_aabb(query,results,VALIDATE_SLOTS,subindices);
+
+	bool found[VALIDATE_SLOTS];
+	for(int i=0;i<VALIDATE_SLOTS;i++)
+		found[i]=false;
+
+	int errors=0;
+	for(int i=0;i<count;i++) {
+
+		int slot=_slot_3d(results[i],subindices[i]);
+		if (found[slot])
+			errors++; // reported twice
+		found[slot]=true;
+	}
+
+	for(int i=0;i<VALIDATE_SLOTS;i++) {
+
+		const ValidateSlot3D &s=p_slots[i];
+		if (found[i]!=(s.id && s.placed && s.aabb.intersects(query)))
+			errors++;
+	}
+
+	return errors;
+}
+
+struct ValidateSlot2D {
+
+	BroadPhase2DSW::ID id; // 0 if not created
+	bool placed;
+	bool _static;
+	Rect2 aabb;
+};
+
+static int _slot_2d(CollisionObject2DSW *p_owner,int p_subindex) {
+
+	return int((size_t)p_owner-1)*2+p_subindex;
+}
+
+static void* _check_pair_2d(CollisionObject2DSW *A,int p_subindex_A,CollisionObject2DSW *B,int p_subindex_B,void *p_userdata) {
+
+	((PairChecker*)p_userdata)->pair(_slot_2d(A,p_subindex_A),_slot_2d(B,p_subindex_B));
+	return NULL;
+}
+
+static void _check_unpair_2d(CollisionObject2DSW *A,int p_subindex_A,CollisionObject2DSW *B,int p_subindex_B,void *p_data,void *p_userdata) {
+
+	((PairChecker*)p_userdata)->unpair(_slot_2d(A,p_subindex_A),_slot_2d(B,p_subindex_B));
+}
+
+static Rect2 _random_rect_2d() {
+
+	// spans from one to many cells, so moves enter and exit cells incrementally
+	Size2 size(Math::random(4,60),Math::random(4,60));
+	if (Math::randf()<0.05)
+		size.x=Math::random(200,400);
+	return Rect2(Math::random(0,600),Math::random(0,600),size.x,size.y);
+}
+
+static int _check_pairs_2d(const PairChecker& p_checker,const Vector<ValidateSlot2D>& p_slots) {
+
+	int errors=0;
+
+	for(int i=0;i<VALIDATE_SLOTS;i++) {
+
+		const ValidateSlot2D &a=p_slots[i];
+
+		for(int j=i+1;j<VALIDATE_SLOTS;j++) {
+
+			const ValidateSlot2D &b=p_slots[j];
+			bool expected = a.id && b.id && a.placed && b.placed && (i>>1)!=(j>>1) && !(a._static && b._static) && a.aabb.intersects(b.aabb);
+			if (expected!=p_checker.is_paired(i,j))
+				errors++;
+		}
+	}
+
+	return errors;
+}
+
+static int _check_cull_2d(BroadPhase2DSW *p_bp,const Vector<ValidateSlot2D>& p_slots) {
+
+	Rect2 query=_random_rect_2d();
+
+	CollisionObject2DSW *results[VALIDATE_SLOTS];
+	int subindices[VALIDATE_SLOTS];
+	int count=p_bp->cull_aabb(query,results,VALIDATE_SLOTS,subindices);
+
+	bool found[VALIDATE_SLOTS];
+	for(int i=0;i<VALIDATE_SLOTS;i++)
+		found[i]=false;
+
+	int errors=0;
+	for(int i=0;i<count;i++) {
+
+		int slot=_slot_2d(results[i],subindices[i]);
+		if (found[slot])
+			errors++; // reported twice
+		found[slot]=true;
+	}
+
+	for(int i=0;i<VALIDATE_SLOTS;i++) {
+
+		const ValidateSlot2D &s=p_slots[i];
+		if (found[i]!=(s.id && s.placed && s.aabb.intersects(query)))
+			errors++;
+	}
+
+	return errors;
+}
+
+static void _validate_2d(const String& p_name,BroadPhase2DSW *p_bp) {
+
+	PairChecker checker;
+	p_bp->set_pair_callback(_check_pair_2d,&checker);
+	p_bp->set_unpair_callback(_check_unpair_2d,&checker);
+
+	Vector<ValidateSlot2D> slots;
+	slots.resize(VALIDATE_SLOTS);
+	for(int i=0;i<VALIDATE_SLOTS;i++) {
+		slots[i].id=0;
+		slots[i].placed=false;
+		slots[i]._static=false;
+	}
+
+	Math::seed(4321);
+	int pair_errors=0;
+	int cull_errors=0;
+	int remove_errors=0;
+
+	for(int f=0;f<VALIDATE_FRAMES;f++) {
+
+		for(int i=0;i<VALIDATE_SLOTS;i++) {
+
+			ValidateSlot2D &s=slots[i];
+			double r=Math::randf();
+
+			if (!s.id) {
+
+				if (r>0.3)
+					continue;
+
+				// recycles pooled elements, and the cells and pairs freed by earlier removes
+				s.id=p_bp->create((CollisionObject2DSW*)(size_t)((i>>1)+1),i&1);
+				s._static=Math::randf()<0.2;
+				p_bp->set_static(s.id,s._static);
+				s.placed=Math::randf()<0.9;
+				if (s.placed) {
+					s.aabb=_random_rect_2d();
+					p_bp->move(s.id,s.aabb);
+				}
+				continue;
+			}
+
+			if (r<0.02) {
+
+				p_bp->remove(s.id);
+				s.id=0;
+				if (checker.has_pairs(i))
+					remove_errors++;
+				continue;
+			}
+
+			if (r<0.06) {
+				s._static=!s._static;
+				p_bp->set_static(s.id,s._static);
+			}
+
+			if (r<0.6) {
+
+				if (!s.placed || Math::randf()<0.05) {
+					s.aabb=_random_rect_2d();
+				} else {
+					s.aabb.pos+=Vector2(Math::random(-8,8),Math::random(-8,8));
+				}
+				s.placed=true;
+				p_bp->move(s.id,s.aabb);
+			}
+		}
+
+		p_bp->update();
+
+		pair_errors+=_check_pairs_2d(checker,slots);
+		for(int i=0;i<4;i++)
+			cull_errors+=_check_cull_2d(p_bp,slots);
+	}
+
+	for(int i=0;i<VALIDATE_SLOTS;i++) {
+
+		if (!slots[i].id)
+			continue;
+		p_bp->remove(slots[i].id);
+		slots[i].id=0;
+	}
+
+	pair_errors+=_check_pairs_2d(checker,slots);
+
+	int errors=checker.errors+pair_errors+cull_errors+remove_errors;
+	print_line(p_name+" validation: "+itos(VALIDATE_FRAMES)+" frames, event errors: "+itos(checker.errors)+", pair mismatches: "+itos(pair_errors)+", cull mismatches: "+itos(cull_errors)+", pairs left after remove: "+itos(remove_errors)+" - "+(errors?"FAILED":"OK"));
+}
+
+static void _validate_3d(const String& p_name,BroadPhaseSW *p_bp) {
+
+	PairChecker checker;
+	p_bp->set_pair_callback(_check_pair_3d,&checker);
+	p_bp->set_unpair_callback(_check_unpair_3d,&checker);
+
+	BenchObject3D *owners = memnew_arr( BenchObject3D, VALIDATE_SLOTS/2 );
+	for(int i=0;i<VALIDATE_SLOTS/2;i++)
+		owners[i].index=i;
+
+	Vector<ValidateSlot3D> slots;
+	slots.resize(VALIDATE_SLOTS);
+	for(int i=0;i<VALIDATE_SLOTS;i++) {
+		slots[i].id=0;
+		slots[i].placed=false;
+		slots[i]._static=false;
+	}
+
+	Math::seed(4321);
+	int pair_errors=0;
+	int cull_errors=0;
+	int remove_errors=0;
+
+	for(int f=0;f<VALIDATE_FRAMES;f++) {
+
+		for(int i=0;i<VALIDATE_SLOTS;i++) {
+
+			ValidateSlot3D &s=slots[i];
+			double r=Math::randf();
+
+			if (!s.id) {
+
+				if (r>0.3)
+					continue;
+
+				// ids freed since the last update() are reused here, dead ones only after it
+				s.id=p_bp->create(&owners[i>>1],i&1);
+				s._static=Math::randf()<0.2;
+				p_bp->set_static(s.id,s._static);
+				s.placed=Math::randf()<0.9;
+				if (s.placed) {
+					s.aabb=_random_aabb_3d();
+					p_bp->move(s.id,s.aabb);
+				}
+
+				if (Math::randf()<0.2) {
+					// removed before update() ever sorted it in
+					p_bp->remove(s.id);
+					s.id=0;
+				}
+				continue;
+			}
+
+			if (r<0.02) {
+
+				p_bp->remove(s.id);
+				s.id=0;
+				if (checker.has_pairs(i))
+					remove_errors++; // pairs must go away immediately, owners may be freed
+				continue;
+			}
+
+			if (r<0.06) {
+				s._static=!s._static;
+				p_bp->set_static(s.id,s._static);
+			}
+
+			if (r<0.6) {
+
+				if (!s.placed || Math::randf()<0.05) {
+					s.aabb=_random_aabb_3d();
+				} else {
+					s.aabb.pos+=Vector3(Math::random(-0.5,0.5),Math::random(-0.2,0.2),Math::random(-0.5,0.5));
+				}
+				s.placed=true;
+				p_bp->move(s.id,s.aabb);
+			}
+		}
+
+		p_bp->update();
+
+		pair_errors+=_check_pairs_3d(checker,slots);
+		for(int i=0;i<4;i++)
+			cull_errors+=_check_cull_3d(p_bp,slots);
+	}
+
+	for(int i=0;i<VALIDATE_SLOTS;i++) {
+
+		if (!slots[i].id)
+			continue;
+		p_bp->remove(slots[i].id);
+		slots[i].id=0;
+	}
+
+	pair_errors+=_check_pairs_3d(checker,slots);
+	memdelete_arr(owners);
+
+	int errors=checker.errors+pair_errors+cull_errors+remove_errors;
+	print_line(p_name+" validation: "+itos(VALIDATE_FRAMES)+" frames, event errors: "+itos(checker.errors)+", pair mismatches: "+itos(pair_errors)+", cull mismatches: "+itos(cull_errors)+", pairs left after remove: "+itos(remove_errors)+" - "+(errors?"FAILED":"OK"));
+}
+
+MainLoop* test() {
+
+	static const int counts[]={1000,5000,10000,20000};
+
+	BroadPhase2DSW *grid = BroadPhase2DHashGrid::_create();
+	_validate_2d("2D hash grid",grid);
+	memdelete(grid);
+
+	BroadPhaseSW *sap = BroadPhaseSAP::_create();
+	_validate_3d("3D sweep and prune",sap);
+	memdelete(sap);
+
+	for(int i=0;i<4;i++) {
+
+		BroadPhase2DSW *bp = BroadPhase2DHashGrid::_create();
+		_benchmark_2d("2D hash grid",bp,counts[i],60);
+		memdelete(bp);
+	}
+
+	for(int i=0;i<4;i++) {
+
+		// basic is O(n^2) per update, keep it to the smallest scene
+		if (i==0) {
+			BroadPhaseSW *bp = BroadPhaseBasic::_create();
+			_benchmark_3d("3D basic",bp,counts[i],60);
+			memdelete(bp);
+		}
+
+		BroadPhaseSW *bp = BroadPhaseOctree::_create();
+		_benchmark_3d("3D octree",bp,counts[i],60);
+		memdelete(bp);
+
+		bp = BroadPhaseSAP::_create();
+		_benchmark_3d("3D sweep and prune",bp,counts[i],60);
+		memdelete(bp);
+	}
+
+	return NULL;
+}
+
+}
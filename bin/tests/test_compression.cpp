@@ -0,0 +1,164 @@
+/*************************************************************************/
+/*  test_compression.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_compression.h"
+
+#include "io/file_access_compressed.h"
+#include "math_funcs.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "print_string.h"
+
+#include <string.h>
+
+/* Write and sequential read throughput of FileAccessCompressed for every mode, against the old 4kb FastLZ setup */
+
+namespace TestCompression {
+
+enum {
+	DATA_SIZE=256*1024*1024,
+	CHUNK_SIZE=1024*1024
+};
+
+struct Setup {
+
+	const char *name;
+	Compression::Mode mode;
+	int block_size;
+	bool threads;
+};
+
+static void _make_data(Vector<uint8_t>& r_data) {
+
+	//a mix of mesh-like floats, text and noise, roughly what an exported project holds
+	r_data.resize(DATA_SIZE);
+	uint8_t *w = r_data.ptr();
+	uint32_t seed=1234;
+	int pos=0;
+	int section=0;
+
+	while(pos<DATA_SIZE) {
+
+		int len = MIN(65536,DATA_SIZE-pos);
+		switch(section%4) {
+			case 0:
+			case 1: {
+				for(int i=0;i+4<=len;i+=4) {
+					float v = Math::sin((pos+i)*0.0001)*100.0;
+					copymem(&w[pos+i],&v,4);
+				}
+			} break;
+			case 2: {
+				CharString cs = String("[node name=\"Node\" type=\"Spatial\" parent=\".\"]\ntransform/pos = Vector3( "+itos(section)+", 0, 1 )\n").utf8();
+				for(int i=0;i<len;i++)
+					w[pos+i]=cs[i%cs.length()];
+			} break;
+			case 3: {
+				for(int i=0;i<len;i++)
+					w[pos+i]=Math::rand_from_seed(&seed)&0xFF;
+			} break;
+		}
+		pos+=len;
+		section++;
+	}
+}
+
+static void _bench(const Setup& p_setup,const Vector<uint8_t>& p_data,const String& p_path) {
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+	FileAccessCompressed *fac = memnew( FileAccessCompressed );
+	fac->configure("GCPT",p_setup.mode,p_setup.block_size);
+	fac->set_use_threads(p_setup.threads);
+	fac->_open(p_path,FileAccess::WRITE);
+	for(int i=0;i<DATA_SIZE;i+=CHUNK_SIZE)
+		fac->store_buffer(&p_data[i],CHUNK_SIZE);
+	fac->close();
+	memdelete(fac);
+
+	uint64_t write_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	FileAccess *f = FileAccess::open(p_path,FileAccess::READ);
+	size_t compressed_size = f->get_len();
+	memdelete(f);
+
+	Vector<uint8_t> chunk;
+	chunk.resize(CHUNK_SIZE);
+	int errors=0;
+
+	from = OS::get_singleton()->get_ticks_usec();
+
+	fac = memnew( FileAccessCompressed );
+	fac->configure("GCPT");
+	fac->set_use_threads(p_setup.threads);
+	fac->_open(p_path,FileAccess::READ);
+	for(int i=0;i<DATA_SIZE;i+=CHUNK_SIZE) {
+
+		fac->get_buffer(chunk.ptr(),CHUNK_SIZE);
+		if (memcmp(chunk.ptr(),&p_data[i],CHUNK_SIZE)!=0)
+			errors++;
+	}
+	fac->close();
+	memdelete(fac);
+
+	uint64_t read_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	int mb = DATA_SIZE/(1024*1024);
+	print_line(String(p_setup.name)+": ratio "+rtos(double(compressed_size)/DATA_SIZE)+", write "+itos(mb*1000000ULL/MAX(write_usec,1))+" mb/s, read "+itos(mb*1000000ULL/MAX(read_usec,1))+" mb/s, "+itos(errors)+" errors");
+}
+
+MainLoop* test() {
+
+	static const Setup setups[]={
+		{"fastlz 4kb (old)",Compression::MODE_FASTLZ,4096,false},
+		{"fastlz 64kb",Compression::MODE_FASTLZ,65536,true},
+		{"lz4 64kb",Compression::MODE_LZ4,65536,true},
+		{"lz4 256kb",Compression::MODE_LZ4,262144,true},
+		{"zstd 64kb",Compression::MODE_ZSTD,65536,true},
+		{"zstd 256kb",Compression::MODE_ZSTD,262144,true},
+		{NULL,Compression::MODE_FASTLZ,0,false}
+	};
+
+	Vector<uint8_t> data;
+	_make_data(data);
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->change_dir("user://");
+	String path = da->get_current_dir()+"/test_compression.bin";
+
+	print_line("compressing "+itos(DATA_SIZE/(1024*1024))+"mb on "+itos(OS::get_singleton()->get_processor_count())+" cores");
+	for(int i=0;setups[i].name;i++)
+		_bench(setups[i],data,path);
+
+	da->remove(path);
+	memdelete(da);
+
+	return NULL;
+}
+
+}
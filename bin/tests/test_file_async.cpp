@@ -0,0 +1,251 @@
+/*************************************************************************/
+/*  test_file_async.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_file_async.h"
+
+#include "io/file_io_queue.h"
+#include "io/file_access_compressed.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "print_string.h"
+
+/* Random block reads from a local file through FileIOQueue at growing queue depths */
+
+namespace TestFileAsync {
+
+enum {
+	FILE_SIZE=64*1024*1024,
+	BLOCK_SIZE=64*1024,
+	READS=4096,
+	MAX_DEPTH=32
+};
+
+static uint32_t _rand(uint32_t &r_seed) {
+
+	r_seed=r_seed*1103515245+12345;
+	return r_seed>>8;
+}
+
+//every 32 bits word holds its own offset
+static bool _check_block(const uint8_t *p_block,size_t p_offset,int p_len) {
+
+	for(int i=0;i<p_len;i+=4093*4) {
+
+		const uint8_t *w=&p_block[i];
+		uint32_t v = w[0]|(w[1]<<8)|(w[2]<<16)|(w[3]<<24);
+		if (v!=uint32_t(p_offset+i))
+			return false;
+	}
+	return true;
+}
+
+static String _mbs(uint64_t p_bytes,uint64_t p_usec) {
+
+	return String::num(double(p_bytes)/(1024.0*1024.0)/(MAX(p_usec,1)/1000000.0),1)+" MB/s";
+}
+
+static void _bench_blocking(FileAccess *p_file) {
+
+	Vector<uint8_t> buf;
+	buf.resize(BLOCK_SIZE);
+	uint32_t seed=1;
+	bool ok=true;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<READS;i++) {
+
+		size_t ofs = size_t(_rand(seed)%(FILE_SIZE/BLOCK_SIZE))*BLOCK_SIZE;
+		p_file->seek(ofs);
+		int read = p_file->get_buffer(buf.ptr(),BLOCK_SIZE);
+		ok = ok && read==BLOCK_SIZE && _check_block(buf.ptr(),ofs,BLOCK_SIZE);
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	print_line("blocking: "+_mbs(uint64_t(READS)*BLOCK_SIZE,usec)+", "+(ok?"OK":"FAILED"));
+}
+
+static void _bench_depth(FileAccess *p_file,int p_depth) {
+
+	FileIOQueue *ioq = FileIOQueue::get_singleton();
+	ioq->set_thread_count(MIN(p_depth,16));
+
+	Vector<uint8_t> buf;
+	buf.resize(BLOCK_SIZE*p_depth);
+	int requests[MAX_DEPTH];
+	size_t offsets[MAX_DEPTH];
+	uint32_t seed=1;
+	bool ok=true;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<READS+p_depth;i++) {
+
+		int slot = i%p_depth;
+		if (i>=p_depth) {
+			//oldest request first, then reuse its buffer
+			int read = ioq->wait(requests[slot]);
+			ok = ok && read==BLOCK_SIZE && _check_block(&buf[slot*BLOCK_SIZE],offsets[slot],BLOCK_SIZE);
+		}
+		if (i<READS) {
+			offsets[slot] = size_t(_rand(seed)%(FILE_SIZE/BLOCK_SIZE))*BLOCK_SIZE;
+			requests[slot] = p_file->read_async(offsets[slot],BLOCK_SIZE,&buf[slot*BLOCK_SIZE]);
+		}
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	print_line("queue depth "+itos(p_depth)+": "+_mbs(uint64_t(READS)*BLOCK_SIZE,usec)+", "+(ok?"OK":"FAILED"));
+}
+
+static void _test_completion_queue(FileAccess *p_file) {
+
+	FileIOQueue *ioq = FileIOQueue::get_singleton();
+	FileIOQueue::CompletionQueue cq;
+
+	Vector<uint8_t> buf;
+	buf.resize(BLOCK_SIZE*MAX_DEPTH);
+	for(int i=0;i<MAX_DEPTH;i++)
+		ioq->read(p_file,size_t(i)*BLOCK_SIZE*3,BLOCK_SIZE,&buf[i*BLOCK_SIZE],NULL,(void*)(intptr_t)i,&cq);
+
+	int done=0;
+	bool ok=true;
+	while(done<MAX_DEPTH) {
+
+		FileIOQueue::Completion c;
+		if (!cq.poll(&c)) {
+			OS::get_singleton()->delay_usec(100);
+			continue;
+		}
+		int i = (intptr_t)c.userdata;
+		ok = ok && c.read==BLOCK_SIZE && _check_block(&buf[i*BLOCK_SIZE],size_t(i)*BLOCK_SIZE*3,BLOCK_SIZE);
+		done++;
+	}
+
+	print_line("completion queue: "+itos(done)+" reads, "+(ok?"OK":"FAILED"));
+}
+
+static void _test_serialized(const String& p_path) {
+
+	//read-write files are read through the file position, which must be back where it was afterwards
+	FileAccess *f = FileAccess::open(p_path,FileAccess::READ_WRITE);
+	ERR_FAIL_COND(!f);
+
+	Vector<uint8_t> buf;
+	buf.resize(BLOCK_SIZE*MAX_DEPTH);
+	for(int i=0;i<buf.size();i+=4) {
+		buf[i+0]=i&0xFF;
+		buf[i+1]=(i>>8)&0xFF;
+		buf[i+2]=(i>>16)&0xFF;
+		buf[i+3]=(i>>24)&0xFF;
+	}
+	f->store_buffer(buf.ptr(),buf.size());
+	zeromem(buf.ptr(),buf.size());
+
+	FileIOQueue *ioq = FileIOQueue::get_singleton();
+	int requests[MAX_DEPTH];
+
+	f->seek(12345);
+	bool ok=!f->is_read_at_concurrent();
+	for(int i=0;i<MAX_DEPTH;i++)
+		requests[i]=f->read_async(size_t(i)*BLOCK_SIZE,BLOCK_SIZE,&buf[i*BLOCK_SIZE]);
+	for(int i=0;i<MAX_DEPTH;i++)
+		ok = ok && ioq->wait(requests[i])==BLOCK_SIZE && _check_block(&buf[i*BLOCK_SIZE],size_t(i)*BLOCK_SIZE,BLOCK_SIZE);
+	ok = ok && !f->is_async_pending() && f->get_pos()==12345;
+	memdelete(f);
+
+	print_line("serialized reads: "+itos(MAX_DEPTH)+" reads, "+(ok?"OK":"FAILED"));
+}
+
+static void _test_compressed(const String& p_path) {
+
+	//big enough for the read-ahead to kick in
+	int size = FileAccessCompressed::READ_AHEAD_MIN_SIZE*4;
+
+	FileAccessCompressed *fac = memnew( FileAccessCompressed );
+	fac->configure("GCPF");
+	fac->_open(p_path,FileAccess::WRITE);
+	for(int i=0;i<size;i+=4)
+		fac->store_32(i/7);
+	fac->close();
+
+	fac->_open(p_path,FileAccess::READ);
+	bool ok=fac->get_len()==size_t(size);
+	for(int i=0;ok && i<size;i+=4)
+		ok = fac->get_32()==uint32_t(i/7);
+	fac->close();
+	memdelete(fac);
+
+	print_line("compressed read-ahead: "+itos(size/1024)+" kb, "+(ok?"OK":"FAILED"));
+}
+
+MainLoop* test() {
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->change_dir("user://");
+	String dir = da->get_current_dir();
+	String path = dir+"/test_file_async.bin";
+
+	FileAccess *f = FileAccess::open(path,FileAccess::WRITE);
+	ERR_FAIL_COND_V(!f,NULL);
+	Vector<uint8_t> chunk;
+	chunk.resize(BLOCK_SIZE);
+	for(int ofs=0;ofs<FILE_SIZE;ofs+=BLOCK_SIZE) {
+		for(int i=0;i<BLOCK_SIZE;i+=4) {
+			uint32_t v=ofs+i;
+			chunk[i+0]=v&0xFF;
+			chunk[i+1]=(v>>8)&0xFF;
+			chunk[i+2]=(v>>16)&0xFF;
+			chunk[i+3]=(v>>24)&0xFF;
+		}
+		f->store_buffer(chunk.ptr(),BLOCK_SIZE);
+	}
+	memdelete(f);
+
+	f = FileAccess::open(path,FileAccess::READ);
+	ERR_FAIL_COND_V(!f,NULL);
+
+	int threads = FileIOQueue::get_singleton()->get_thread_count();
+	print_line(itos(READS)+" random reads of "+itos(BLOCK_SIZE/1024)+" kb from a "+itos(FILE_SIZE/(1024*1024))+" mb file");
+	_bench_blocking(f);
+	for(int depth=1;depth<=MAX_DEPTH;depth*=2)
+		_bench_depth(f,depth);
+	FileIOQueue::get_singleton()->set_thread_count(threads);
+
+	_test_completion_queue(f);
+	memdelete(f);
+	da->remove(path);
+
+	_test_serialized(dir+"/test_file_async_rw.bin");
+	da->remove(dir+"/test_file_async_rw.bin");
+
+	_test_compressed(dir+"/test_file_async.gcpf");
+	da->remove(dir+"/test_file_async.gcpf");
+	memdelete(da);
+
+	return NULL;
+}
+
+}
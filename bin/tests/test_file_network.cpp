@@ -0,0 +1,366 @@
+/*************************************************************************/
+/*  test_file_network.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_file_network.h"
+
+#ifdef TOOLS_ENABLED
+
+#include "tools/editor/fileserver/editor_file_server.h"
+#include "io/file_access_network.h"
+#include "io/tcp_server.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "globals.h"
+#include "print_string.h"
+
+/* Remote filesystem through EditorFileServer, over loopback with a proxy adding latency */
+
+namespace TestFileNetwork {
+
+enum {
+	SERVER_PORT=16010,
+	PROXY_PORT=16011,
+	LATENCY_USEC=5000, //each way
+	BIG_FILE_SIZE=4*1024*1024,
+	SMALL_FILES=32,
+	SMALL_FILE_SIZE=16*1024,
+	RANDOM_READS=32,
+	READ_CHUNK=4096,
+	OPEN_THREADS=4
+};
+
+struct Proxy {
+
+	struct Chunk {
+
+		uint64_t due;
+		Vector<uint8_t> data;
+	};
+
+	Ref<TCP_Server> server;
+	Ref<StreamPeerTCP> client_side;
+	Ref<StreamPeerTCP> server_side;
+	List<Chunk> to_server;
+	List<Chunk> to_client;
+	Thread *thread;
+	bool quit;
+	bool hold; //stop passing answers to the client
+};
+
+static bool _forward(Ref<StreamPeerTCP>& p_from,Ref<StreamPeerTCP>& p_to,List<Proxy::Chunk>& p_queue,uint8_t *p_buf) {
+
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+
+	int received=0;
+	if (p_from->get_partial_data(p_buf,65536,received)!=OK)
+		return false;
+	if (received>0) {
+		Proxy::Chunk c;
+		c.due=now+LATENCY_USEC;
+		c.data.resize(received);
+		copymem(c.data.ptr(),p_buf,received);
+		p_queue.push_back(c);
+	}
+
+	while(p_queue.size() && p_queue.front()->get().due<=now) {
+		const Vector<uint8_t> &d=p_queue.front()->get().data;
+		if (p_to->put_data(d.ptr(),d.size())!=OK)
+			return false;
+		p_queue.pop_front();
+	}
+	return true;
+}
+
+static void _proxy_func(void *p_userdata) {
+
+	Proxy *proxy = (Proxy*)p_userdata;
+
+	while(!proxy->quit && !proxy->server->is_connection_available())
+		OS::get_singleton()->delay_usec(1000);
+	if (proxy->quit)
+		return;
+
+	proxy->client_side=proxy->server->take_connection();
+	proxy->server_side=StreamPeerTCP::create_ref();
+	proxy->server_side->connect(IP_Address("127.0.0.1"),SERVER_PORT);
+	while(proxy->server_side->get_status()==StreamPeerTCP::STATUS_CONNECTING)
+		OS::get_singleton()->delay_usec(1000);
+	proxy->client_side->set_nodelay(true);
+	proxy->server_side->set_nodelay(true);
+
+	Vector<uint8_t> buf;
+	buf.resize(65536);
+	while(!proxy->quit) {
+
+		if (!_forward(proxy->client_side,proxy->server_side,proxy->to_server,buf.ptr()))
+			break;
+		if (!proxy->hold && !_forward(proxy->server_side,proxy->client_side,proxy->to_client,buf.ptr()))
+			break;
+		OS::get_singleton()->delay_usec(100);
+	}
+
+	proxy->client_side->disconnect();
+	proxy->server_side->disconnect();
+}
+
+static String _name(int p_idx) {
+
+	return "res://test_file_network_"+itos(p_idx)+".bin";
+}
+
+static uint8_t _byte(int p_file,int p_ofs) {
+
+	return (p_ofs*7+p_file*13+(p_ofs>>9))&0xFF;
+}
+
+static void _write_file(int p_idx,int p_size) {
+
+	FileAccess *f = FileAccess::open(_name(p_idx),FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+	Vector<uint8_t> data;
+	data.resize(p_size);
+	for(int i=0;i<p_size;i++)
+		data[i]=_byte(p_idx,i);
+	f->store_buffer(data.ptr(),p_size);
+	memdelete(f);
+}
+
+static bool _check(int p_idx,const uint8_t *p_data,int p_ofs,int p_len) {
+
+	for(int i=0;i<p_len;i++) {
+		if (p_data[i]!=_byte(p_idx,p_ofs+i))
+			return false;
+	}
+	return true;
+}
+
+static String _ms(uint64_t p_usec) {
+
+	return String::num(p_usec/1000.0,1)+" msec";
+}
+
+static void _bench_sequential(const String& p_label,int p_read_ahead,int p_max_read_ahead) {
+
+	Globals::get_singleton()->set("remote_fs/page_read_ahead",p_read_ahead);
+	Globals::get_singleton()->set("remote_fs/max_page_read_ahead",p_max_read_ahead);
+
+	FileAccessNetwork *fa = memnew( FileAccessNetwork );
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	bool ok = fa->_open(_name(0),FileAccess::READ)==OK && fa->get_len()==BIG_FILE_SIZE;
+
+	uint8_t buf[READ_CHUNK];
+	for(int ofs=0;ok && ofs<BIG_FILE_SIZE;ofs+=READ_CHUNK)
+		ok = fa->get_buffer(buf,READ_CHUNK)==READ_CHUNK && _check(0,buf,ofs,READ_CHUNK);
+	uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+	memdelete(fa);
+
+	//jumping around resets the window, reopen so nothing is cached
+	fa = memnew( FileAccessNetwork );
+	ok = ok && fa->_open(_name(0),FileAccess::READ)==OK;
+	uint32_t seed=7;
+	uint64_t rfrom = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;ok && i<RANDOM_READS;i++) {
+		seed=seed*1103515245+12345;
+		int ofs = (seed>>8)%(BIG_FILE_SIZE-READ_CHUNK);
+		fa->seek(ofs);
+		ok = fa->get_buffer(buf,READ_CHUNK)==READ_CHUNK && _check(0,buf,ofs,READ_CHUNK);
+	}
+	uint64_t rusec = OS::get_singleton()->get_ticks_usec()-rfrom;
+	memdelete(fa);
+
+	print_line(p_label+": sequential "+String::num(BIG_FILE_SIZE/1048576.0/(usec/1000000.0),1)+" MB/s, random read "+_ms(rusec/RANDOM_READS)+", "+(ok?"OK":"FAILED"));
+}
+
+struct OpenJob {
+
+	int first;
+	int step;
+	bool ok;
+};
+
+static void _open_func(void *p_userdata) {
+
+	OpenJob *job = (OpenJob*)p_userdata;
+	uint8_t buf[SMALL_FILE_SIZE];
+	for(int i=job->first;i<=SMALL_FILES;i+=job->step) {
+
+		FileAccessNetwork *fa = memnew( FileAccessNetwork );
+		bool ok = fa->_open(_name(i),FileAccess::READ)==OK && fa->get_buffer(buf,SMALL_FILE_SIZE)==SMALL_FILE_SIZE && _check(i,buf,0,SMALL_FILE_SIZE);
+		memdelete(fa);
+		job->ok = job->ok && ok;
+	}
+}
+
+static void _bench_open(int p_threads) {
+
+	OpenJob jobs[OPEN_THREADS];
+	Thread *threads[OPEN_THREADS];
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<p_threads;i++) {
+		jobs[i].first=i+1;
+		jobs[i].step=p_threads;
+		jobs[i].ok=true;
+		threads[i] = i>0 ? Thread::create(_open_func,&jobs[i]) : NULL;
+	}
+	_open_func(&jobs[0]);
+	bool ok=jobs[0].ok;
+	for(int i=1;i<p_threads;i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+		ok = ok && jobs[i].ok;
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	print_line("open and read "+itos(SMALL_FILES)+" files from "+itos(p_threads)+" thread(s): "+_ms(usec)+", "+(ok?"OK":"FAILED"));
+}
+
+static void _bench_modtimes() {
+
+	Vector<String> paths;
+	for(int i=0;i<=SMALL_FILES;i++)
+		paths.push_back(_name(i));
+	paths.push_back("res://test_file_network_missing.bin");
+
+	FileAccessNetwork *fa = memnew( FileAccessNetwork );
+	Vector<uint64_t> single;
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<paths.size();i++)
+		single.push_back(fa->_get_modified_time(paths[i]));
+	uint64_t single_usec = OS::get_singleton()->get_ticks_usec()-from;
+	memdelete(fa);
+
+	from = OS::get_singleton()->get_ticks_usec();
+	Vector<uint64_t> batch = FileAccessNetworkClient::get_singleton()->get_modified_times(paths);
+	uint64_t batch_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	bool ok = batch.size()==single.size() && batch[paths.size()-1]==0;
+	for(int i=0;ok && i<batch.size();i++)
+		ok = batch[i]==single[i];
+
+	print_line("modified times of "+itos(paths.size())+" files: one by one "+_ms(single_usec)+", batched "+_ms(batch_usec)+", "+(ok?"OK":"FAILED"));
+}
+
+static void _drop_func(void *p_userdata) {
+
+	Proxy *proxy = (Proxy*)p_userdata;
+	OS::get_singleton()->delay_usec(LATENCY_USEC*20);
+	proxy->quit=true;
+}
+
+static void _check_lost_connection(Proxy *p_proxy) {
+
+	//the proxy swallows the answer and then drops the connection, waiters must be released
+	p_proxy->hold=true;
+	Thread *drop = Thread::create(_drop_func,p_proxy);
+
+	FileAccessNetwork *fa = memnew( FileAccessNetwork );
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	Error err = fa->_open(_name(1),FileAccess::READ);
+	uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+	bool ok = err!=OK && !fa->file_exists(_name(1)) && fa->_get_modified_time(_name(1))==0;
+	memdelete(fa);
+
+	Vector<String> paths;
+	paths.push_back(_name(1));
+	ok = ok && FileAccessNetworkClient::get_singleton()->get_modified_times(paths).empty();
+
+	Thread::wait_to_finish(drop);
+	memdelete(drop);
+
+	print_line("connection lost while opening: released after "+_ms(usec)+", "+(ok?"OK":"FAILED"));
+}
+
+MainLoop* test() {
+
+	_write_file(0,BIG_FILE_SIZE);
+	for(int i=1;i<=SMALL_FILES;i++)
+		_write_file(i,SMALL_FILE_SIZE);
+
+	EditorFileServer *efs = memnew( EditorFileServer );
+	efs->start(SERVER_PORT);
+	while(!efs->is_active())
+		OS::get_singleton()->delay_usec(1000);
+
+	Proxy proxy;
+	proxy.quit=false;
+	proxy.hold=false;
+	proxy.server=TCP_Server::create_ref();
+	proxy.server->listen(PROXY_PORT);
+	proxy.thread=Thread::create(_proxy_func,&proxy);
+
+	FileAccessNetworkClient *nc = memnew( FileAccessNetworkClient );
+	if (nc->connect("127.0.0.1",PROXY_PORT)==OK) {
+
+		print_line("round trip "+itos(LATENCY_USEC*2/1000)+" msec, "+itos(BIG_FILE_SIZE/1048576)+" mb file read in "+itos(READ_CHUNK)+" byte chunks");
+		_bench_sequential("one page at a time",1,1);
+		_bench_sequential("adaptive window",4,32);
+		_bench_open(1);
+		_bench_open(OPEN_THREADS);
+		_bench_modtimes();
+		_check_lost_connection(&proxy);
+	} else {
+		print_line("could not connect to the file server");
+	}
+
+	memdelete(nc);
+	proxy.quit=true;
+	Thread::wait_to_finish(proxy.thread);
+	memdelete(proxy.thread);
+	proxy.server->stop();
+
+	//let the server notice the connection is gone
+	OS::get_singleton()->delay_usec(300000);
+	efs->stop();
+	memdelete(efs);
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_RESOURCES);
+	for(int i=0;i<=SMALL_FILES;i++)
+		da->remove(_name(i));
+	memdelete(da);
+
+	return NULL;
+}
+
+}
+
+#else
+
+#include "print_string.h"
+
+namespace TestFileNetwork {
+
+MainLoop* test() {
+
+	print_line("file_network needs the editor file server, build with tools");
+	return NULL;
+}
+
+}
+
+#endif
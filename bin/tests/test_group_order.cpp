@@ -0,0 +1,158 @@
+/*************************************************************************/
+/*  test_group_order.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_group_order.h"
+
+#include "os/os.h"
+#include "print_string.h"
+#include "scene/main/scene_main_loop.h"
+#include "scene/main/viewport.h"
+
+/* Cost of keeping groups in tree order while spawning and freeing nodes every frame in a big tree */
+
+namespace TestGroupOrder {
+
+enum {
+	ROOM_COUNT=200,
+	NODES_PER_ROOM=100, // 20k nodes in the tree
+	SPAWN_PER_FRAME=1000,
+	MOVE_EVERY=10,
+	FRAME_COUNT=100,
+	NOTIFICATION_PING=9000 // not handled by anyone, only walks the group
+};
+
+class TestMainLoop : public SceneMainLoop {
+
+	Vector<Node*> rooms;
+	Vector<Node*> spawned;
+	uint32_t seed;
+	int frame;
+	uint64_t usec;
+	uint64_t max_usec;
+
+	uint32_t _rand() {
+
+		seed=seed*1103515245+12345;
+		return (seed>>16)&0x7FFF;
+	}
+
+	bool _check_order() {
+
+		List<Node*> nodes;
+		get_nodes_in_group("actors",&nodes);
+
+		List<Node*>::Element *E=nodes.front();
+		int count=0;
+		for(int i=0;i<rooms.size();i++) {
+
+			Node *room=rooms[i];
+			for(int j=0;j<room->get_child_count();j++) {
+
+				if (!E || E->get()!=room->get_child(j))
+					return false;
+				E=E->next();
+				count++;
+			}
+		}
+
+		return !E && count==nodes.size();
+	}
+
+public:
+
+	virtual void init() {
+
+		SceneMainLoop::init();
+
+		seed=1;
+		frame=0;
+		usec=0;
+		max_usec=0;
+
+		for(int i=0;i<ROOM_COUNT;i++) {
+
+			Node *room = memnew( Node );
+			room->set_name("room_"+itos(i));
+			get_root()->add_child(room);
+			rooms.push_back(room);
+
+			for(int j=0;j<NODES_PER_ROOM;j++) {
+
+				Node *n = memnew( Node );
+				n->add_to_group("actors");
+				room->add_child(n);
+			}
+		}
+	}
+
+	virtual bool idle(float p_time) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+		for(int i=0;i<spawned.size();i++)
+			memdelete(spawned[i]);
+		spawned.clear();
+
+		for(int i=0;i<SPAWN_PER_FRAME;i++) {
+
+			Node *n = memnew( Node );
+			n->add_to_group("actors");
+			rooms[_rand()%ROOM_COUNT]->add_child(n);
+			spawned.push_back(n);
+		}
+
+		if (frame%MOVE_EVERY==0) {
+
+			Node *room = rooms[_rand()%ROOM_COUNT];
+			room->move_child(room->get_child(room->get_child_count()-1),0);
+		}
+
+		notify_group(GROUP_CALL_REALTIME,"actors",NOTIFICATION_PING);
+
+		uint64_t frame_usec = OS::get_singleton()->get_ticks_usec()-from;
+		usec+=frame_usec;
+		max_usec=MAX(max_usec,frame_usec);
+
+		SceneMainLoop::idle(p_time);
+
+		frame++;
+		if (frame<FRAME_COUNT)
+			return false;
+
+		print_line(itos(get_node_count())+" nodes, "+itos(SPAWN_PER_FRAME)+" spawned per frame: "+rtos(usec/double(FRAME_COUNT*1000))+" msec per frame avg, "+rtos(max_usec/1000.0)+" max, order "+(_check_order()?"OK":"FAILED"));
+		return true;
+	}
+
+};
+
+MainLoop* test() {
+
+	return memnew( TestMainLoop );
+}
+
+}
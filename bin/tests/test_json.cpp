@@ -0,0 +1,205 @@
+/*************************************************************************/
+/*  test_json.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_json.h"
+
+#include "io/json.h"
+#include "os/os.h"
+#include "print_string.h"
+
+/* Parse and print throughput on generated documents shaped like the usual JSON benchmark corpora */
+
+namespace TestJSON {
+
+enum {
+	PASSES=5
+};
+
+//lots of coordinates, like canada.json
+static String _make_numbers() {
+
+	String s="{\"type\":\"FeatureCollection\",\"features\":[";
+	for(int f=0;f<40;f++) {
+		if (f>0)
+			s+=",";
+		s+="{\"type\":\"Feature\",\"properties\":{\"name\":\"Region "+itos(f)+"\"},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[";
+		for(int i=0;i<1000;i++) {
+			if (i>0)
+				s+=",";
+			s+="["+String::num(-65.613616999999977+i*0.0013+f,15)+","+String::num(43.420273000000009-i*0.0007,15)+"]";
+		}
+		s+="]]}}";
+	}
+	s+="]}";
+	return s;
+}
+
+//short objects full of strings, like twitter.json
+static String _make_strings() {
+
+	String s="{\"statuses\":[";
+	for(int i=0;i<4000;i++) {
+		if (i>0)
+			s+=",";
+		s+="{\"id\":"+itos(505874924095815681LL%1000000000+i)+",\"text\":\"@aym0566x \\n\\u540d\\u524d:\\u524d\\u7530\\u3042\\u3086\\u307f "+String::utf8("caf\xc3\xa9")+" number "+itos(i)+" \\\"quoted\\\"\",";
+		s+="\"user\":{\"id\":"+itos(1186275104+i)+",\"name\":\"user_"+itos(i)+"\",\"screen_name\":\"ayuu0123\",\"location\":\"\",\"verified\":false,\"followers_count\":"+itos(i*7)+"},";
+		s+="\"entities\":{\"hashtags\":[\"tag"+itos(i%13)+"\",\"other\"],\"urls\":[],\"user_mentions\":[{\"screen_name\":\"aym0566x\",\"indices\":[0,9]}]},";
+		s+="\"favorited\":false,\"retweeted\":true,\"lang\":\"ja\",\"reply\":null}";
+	}
+	s+="]}";
+	return s;
+}
+
+//one big object keyed by id, like citm_catalog.json
+static String _make_objects() {
+
+	String s="{\"events\":{";
+	for(int i=0;i<5000;i++) {
+		if (i>0)
+			s+=",";
+		s+="\""+itos(138586341+i)+"\":{\"id\":"+itos(138586341+i)+",\"name\":null,\"logo\":\"/images/UE0AAAAACEKo6QAAAAZDSVRN\",\"subTopicIds\":[337184269,337184283],\"topicIds\":[324846099,107888604]}";
+	}
+	s+="},\"areaNames\":{\"205705993\":\""+String::utf8("Arri\xc3\xa8re-sc\xc3\xa8ne")+" central\",\"205705994\":\"1er balcon central\"}}";
+	return s;
+}
+
+class CountingHandler : public JSON::Handler {
+public:
+
+	int values;
+	double sum;
+
+	virtual Error object_key(const CharType *p_key,int p_len) { values++; return OK; }
+	virtual Error value_string(const CharType *p_str,int p_len) { values++; return OK; }
+	virtual Error value_int(int64_t p_int) { values++; sum+=p_int; return OK; }
+	virtual Error value_real(double p_real) { values++; sum+=p_real; return OK; }
+	virtual Error value_bool(bool p_bool) { values++; return OK; }
+	virtual Error value_null() { values++; return OK; }
+
+	CountingHandler() { values=0; sum=0; }
+};
+
+static bool _same(const Variant& p_a,const Variant& p_b) {
+
+	if (p_a.get_type()!=p_b.get_type())
+		return false;
+
+	if (p_a.get_type()==Variant::DICTIONARY) {
+
+		Dictionary a=p_a;
+		Dictionary b=p_b;
+		if (a.size()!=b.size())
+			return false;
+		List<Variant> keys;
+		a.get_key_list(&keys);
+		for (List<Variant>::Element *E=keys.front();E;E=E->next()) {
+			if (!b.has(E->get()) || !_same(a[E->get()],b[E->get()]))
+				return false;
+		}
+		return true;
+	}
+
+	if (p_a.get_type()==Variant::ARRAY) {
+
+		Array a=p_a;
+		Array b=p_b;
+		if (a.size()!=b.size())
+			return false;
+		for(int i=0;i<a.size();i++) {
+			if (!_same(a[i],b[i]))
+				return false;
+		}
+		return true;
+	}
+
+	//reals are printed with limited decimals
+	if (p_a.get_type()==Variant::REAL)
+		return Math::abs(double(p_a)-double(p_b))<=0.000001*MAX(1.0,Math::abs(double(p_a)));
+
+	return p_a==p_b;
+}
+
+static String _mbs(int p_bytes,uint64_t p_usec) {
+
+	return rtos(int(double(p_bytes)*PASSES/MAX(p_usec,1)*100)/100.0)+" MB/s";
+}
+
+static void _bench(const String& p_name,const String& p_json) {
+
+	CharString utf8=p_json.utf8();
+	int size=utf8.length();
+	String err_str;
+	int err_line=0;
+
+	Dictionary d;
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<PASSES;i++) {
+		d=Dictionary();
+		JSON::parse(p_json,d,err_str,err_line);
+	}
+	uint64_t parse_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	Dictionary d8;
+	from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<PASSES;i++) {
+		d8=Dictionary();
+		JSON::parse_utf8((const uint8_t*)utf8.get_data(),size,d8,err_str,err_line);
+	}
+	uint64_t parse_utf8_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	CountingHandler counter;
+	from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<PASSES;i++) {
+		counter.values=0;
+		JSON::parse_events_utf8((const uint8_t*)utf8.get_data(),size,&counter,err_str,err_line);
+	}
+	uint64_t events_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	String printed;
+	from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<PASSES;i++)
+		printed=JSON::print(d);
+	uint64_t print_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	//what was printed must parse back to the same document
+	Dictionary again;
+	bool ok = JSON::parse(printed,again,err_str,err_line)==OK && _same(d,again) && _same(d,d8) && counter.values>0;
+
+	print_line(p_name+" ("+itos(size/1024)+" kb, "+itos(counter.values)+" values): parse "+_mbs(size,parse_usec)+", parse utf8 "+_mbs(size,parse_utf8_usec)+", events "+_mbs(size,events_usec)+", print "+_mbs(size,print_usec)+", "+(ok?"OK":"FAILED"));
+}
+
+MainLoop* test() {
+
+	_bench("numbers",_make_numbers());
+	_bench("strings",_make_strings());
+	_bench("objects",_make_objects());
+
+	return NULL;
+}
+
+}
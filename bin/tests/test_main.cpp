@@ -40,6 +40,29 @@
 #include "test_misc.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
+#include "test_physics_ccd.h"
+#include "test_broad_phase.h"
+#include "test_physics_sat.h"
+#include "test_physics_snapshot.h"
+#include "test_resource_load.h"
+#include "test_resource_mmap.h"
+#include "test_pack_index.h"
+#include "test_compression.h"
+#include "test_scene_load.h"
+#include "test_scene_instance.h"
+#include "test_xml_load.h"
+#include "test_json.h"
+#include "test_file_async.h"
+#include "test_file_network.h"
+#include "test_group_order.h"
+#include "test_process.h"
+#include "test_signal.h"
+#include "test_message_queue.h"
+#include "test_transform.h"
+#include "test_node_path.h"
+#include "test_animation.h"
+#include "test_animation_batch.h"
+#include "test_skeleton.h"
 #include "test_python.h"
 #include "test_io.h"
 #include "test_particles.h"
@@ -95,6 +118,121 @@ MainLoop* test_main(String p_test,const List<String>& p_args) {
 		return TestPhysics2D::test();
 	}
 
+	if (p_test=="physics_ccd") {
+
+		return TestPhysicsCCD::test();
+	}
+
+	if (p_test=="broadphase") {
+
+		return TestBroadPhase::test();
+	}
+
+	if (p_test=="physics_sat") {
+
+		return TestPhysicsSAT::test();
+	}
+
+	if (p_test=="physics_snapshot") {
+
+		return TestPhysicsSnapshot::test();
+	}
+
+	if (p_test=="resource_load") {
+
+		return TestResourceLoad::test();
+	}
+
+	if (p_test=="resource_mmap") {
+
+		return TestResourceMMap::test();
+	}
+
+	if (p_test=="pack_index") {
+
+		return TestPackIndex::test();
+	}
+
+	if (p_test=="compression") {
+
+		return TestCompression::test();
+	}
+
+	if (p_test=="scene_load") {
+
+		return TestSceneLoad::test();
+	}
+
+	if (p_test=="scene_instance") {
+
+		return TestSceneInstance::test();
+	}
+
+	if (p_test=="xml_load") {
+
+		return TestXMLLoad::test();
+	}
+
+	if (p_test=="json") {
+
+		return TestJSON::test();
+	}
+
+	if (p_test=="file_async") {
+
+		return TestFileAsync::test();
+	}
+
+	if (p_test=="file_network") {
+
+		return TestFileNetwork::test();
+	}
+
+	if (p_test=="group_order") {
+
+		return TestGroupOrder::test();
+	}
+
+	if (p_test=="process") {
+
+		return TestProcess::test();
+	}
+
+	if (p_test=="signal") {
+
+		return TestSignal::test();
+	}
+
+	if (p_test=="message_queue") {
+
+		return TestMessageQueue::test();
+	}
+
+	if (p_test=="transform") {
+
+		return TestTransform::test();
+	}
+
+	if (p_test=="node_path") {
+
+		return TestNodePath::test();
+	}
+
+	if (p_test=="animation") {
+
+		return TestAnimation::test();
+	}
+
+	if (p_test=="animation_batch") {
+
+		return TestAnimationBatch::test();
+	}
+
+	if (p_test=="skeleton") {
+
+		return TestSkeleton::test();
+	}
+
   	if (p_test=="misc") {
 	
 		return TestMisc::test();
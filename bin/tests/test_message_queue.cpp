@@ -0,0 +1,204 @@
+/*************************************************************************/
+/*  test_message_queue.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_message_queue.h"
+
+#include "os/os.h"
+#include "os/thread.h"
+#include "print_string.h"
+#include "object_type_db.h"
+#include "message_queue.h"
+
+/* Deferred call throughput, from the main thread and from several producer threads at once */
+
+namespace TestMessageQueue {
+
+enum {
+	BATCH=10000,
+	ROUNDS=100,
+	THREADS=4,
+	THREAD_PUSHES=100000
+};
+
+class QueueReceiver : public Object {
+
+	OBJ_TYPE( QueueReceiver, Object );
+protected:
+
+	static void _bind_methods() {
+
+		ObjectTypeDB::bind_method(_MD("_ping"),&QueueReceiver::_ping);
+		ObjectTypeDB::bind_method(_MD("_add","a","b"),&QueueReceiver::_add);
+	}
+
+	void _notification(int p_what) {
+
+		if (p_what==NOTIFICATION_PING)
+			calls++;
+	}
+
+public:
+
+	enum {
+		NOTIFICATION_PING=1000
+	};
+
+	int calls;
+	int64_t sum;
+
+	void _ping() {
+
+		calls++;
+	}
+
+	void _add(int p_a,int p_b) {
+
+		calls++;
+		sum+=p_a+p_b;
+	}
+
+	QueueReceiver() { calls=0; sum=0; }
+};
+
+enum PushType {
+	PUSH_CALL,
+	PUSH_NOTIFICATION,
+	PUSH_CALL_ARGS
+};
+
+static StringName _ping_name;
+static StringName _add_name;
+
+static void _push(QueueReceiver *p_receiver,PushType p_type,int p_value) {
+
+	switch(p_type) {
+		case PUSH_CALL: MessageQueue::get_singleton()->push_call(p_receiver,_ping_name); break;
+		case PUSH_NOTIFICATION: MessageQueue::get_singleton()->push_notification(p_receiver,QueueReceiver::NOTIFICATION_PING); break;
+		case PUSH_CALL_ARGS: MessageQueue::get_singleton()->push_call(p_receiver,_add_name,p_value,1); break;
+	}
+}
+
+static void _queue_bench(const String& p_name,PushType p_type) {
+
+	QueueReceiver *receiver = memnew( QueueReceiver );
+	uint64_t push_usec=0;
+	uint64_t flush_usec=0;
+
+	for(int i=0;i<ROUNDS;i++) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		for(int j=0;j<BATCH;j++) {
+			_push(receiver,p_type,j&0xFF);
+		}
+		uint64_t mid = OS::get_singleton()->get_ticks_usec();
+		MessageQueue::get_singleton()->flush();
+		uint64_t to = OS::get_singleton()->get_ticks_usec();
+
+		push_usec+=mid-from;
+		flush_usec+=to-mid;
+	}
+
+	bool ok = receiver->calls==BATCH*ROUNDS;
+	memdelete(receiver);
+
+	double count = double(BATCH)*ROUNDS;
+	print_line(p_name+": "+itos(BATCH*ROUNDS)+" messages, "+rtos(push_usec*1000.0/count)+" nsec per push, "+rtos(flush_usec*1000.0/count)+" nsec per dispatch, "+(ok?"OK":"FAILED"));
+}
+
+struct ProducerData {
+
+	QueueReceiver *receiver;
+	volatile int done;
+};
+
+static void _producer(void *p_data) {
+
+	ProducerData *pd = (ProducerData*)p_data;
+	for(int i=0;i<THREAD_PUSHES;i++) {
+		_push(pd->receiver,(i&1)?PUSH_NOTIFICATION:PUSH_CALL,0);
+	}
+	pd->done=1;
+}
+
+static void _threaded_bench() {
+
+	//producers push concurrently while the main thread keeps flushing, nothing may be dropped
+
+	QueueReceiver *receiver = memnew( QueueReceiver );
+	ProducerData data[THREADS];
+	Thread *threads[THREADS];
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<THREADS;i++) {
+		data[i].receiver=receiver;
+		data[i].done=0;
+		threads[i]=Thread::create(_producer,&data[i]);
+	}
+
+	bool running=true;
+	while(running) {
+
+		running=false;
+		for(int i=0;i<THREADS;i++) {
+			if (!data[i].done)
+				running=true;
+		}
+		MessageQueue::get_singleton()->flush();
+	}
+
+	for(int i=0;i<THREADS;i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	MessageQueue::get_singleton()->flush();
+	uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	bool ok = receiver->calls==THREADS*THREAD_PUSHES;
+	memdelete(receiver);
+
+	print_line("threaded: "+itos(THREADS)+" producers, "+itos(THREADS*THREAD_PUSHES)+" messages, "+itos(usec/1000)+" msec, "+rtos(usec*1000.0/(THREADS*THREAD_PUSHES))+" nsec per message, "+(ok?"OK":"FAILED"));
+}
+
+MainLoop* test() {
+
+	ObjectTypeDB::register_type<QueueReceiver>();
+	_ping_name="_ping";
+	_add_name="_add";
+
+	_queue_bench("call",PUSH_CALL);
+	_queue_bench("notification",PUSH_NOTIFICATION);
+	_queue_bench("call args",PUSH_CALL_ARGS);
+	_threaded_bench();
+
+	_ping_name=StringName();
+	_add_name=StringName();
+
+	return NULL;
+}
+
+}
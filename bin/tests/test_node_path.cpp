@@ -0,0 +1,180 @@
+/*************************************************************************/
+/*  test_node_path.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_node_path.h"
+
+#include "os/os.h"
+#include "print_string.h"
+#include "scene/main/scene_main_loop.h"
+#include "scene/main/viewport.h"
+#include "scene/main/node.h"
+#include "scene/main/node_ref.h"
+
+/* NodePath resolution under parents with many children, and cached resolution through NodeRef */
+
+namespace TestNodePath {
+
+enum {
+	WIDE_CHILDREN=10000,
+	NARROW_CHILDREN=8,
+	LOOKUP_COUNT=100000
+};
+
+class TestMainLoop : public SceneMainLoop {
+
+	Node *wide;
+	Node *narrow;
+	Vector<NodePath> wide_paths;
+	bool ok;
+
+	Node *_add_children(Node *p_parent,int p_count,const String& p_prefix,uint64_t *r_usec) {
+
+		Node *last=NULL;
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		for(int i=0;i<p_count;i++) {
+
+			Node *n = memnew( Node );
+			n->set_name(p_prefix+itos(i));
+			p_parent->add_child(n);
+			last=n;
+		}
+		*r_usec=OS::get_singleton()->get_ticks_usec()-from;
+		return last;
+	}
+
+	void _bench_lookup(const String& p_name,Node *p_from,const Vector<NodePath>& p_paths,Node *p_expected) {
+
+		//when p_expected is NULL, each path must resolve to a node with its last name
+		int path_count=p_paths.size();
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		int found=0;
+		for(int i=0;i<LOOKUP_COUNT;i++) {
+
+			const NodePath &path=p_paths[i%path_count];
+			Node *n = p_from->get_node(path);
+			if (n && (p_expected ? n==p_expected : n->get_name()==path.get_name(path.get_name_count()-1)))
+				found++;
+		}
+		uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+
+		ok = ok && found==LOOKUP_COUNT;
+		print_line(p_name+": "+rtos(usec*1000.0/LOOKUP_COUNT)+" nsec per lookup");
+	}
+
+	void _bench_node_ref(Node *p_from,const NodePath& p_path,Node *p_expected) {
+
+		Ref<NodeRef> ref = p_from->get_node_ref(p_path);
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		int found=0;
+		for(int i=0;i<LOOKUP_COUNT;i++) {
+
+			if (ref->get_node()==p_expected)
+				found++;
+		}
+		uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+		print_line("node ref "+String(p_path)+": "+rtos(usec*1000.0/LOOKUP_COUNT)+" nsec per lookup");
+		ok = ok && found==LOOKUP_COUNT;
+
+		//must follow the tree when it changes
+		Node *parent = p_expected->get_parent();
+		parent->remove_child(p_expected);
+		ok = ok && ref->get_node()==NULL;
+		parent->add_child(p_expected);
+		ok = ok && ref->get_node()==p_expected;
+
+		String name = p_expected->get_name();
+		p_expected->set_name("renamed");
+		ok = ok && ref->get_node()==NULL;
+		p_expected->set_name(name);
+		ok = ok && ref->get_node()==p_expected;
+	}
+
+public:
+
+	virtual void init() {
+
+		SceneMainLoop::init();
+		ok=true;
+
+		uint64_t usec;
+		wide = memnew( Node );
+		wide->set_name("wide");
+		get_root()->add_child(wide);
+		Node *wide_last=_add_children(wide,WIDE_CHILDREN,"child",&usec);
+		print_line("add "+itos(WIDE_CHILDREN)+" children: "+rtos(usec*1000.0/WIDE_CHILDREN)+" nsec per child");
+
+		narrow = memnew( Node );
+		narrow->set_name("narrow");
+		get_root()->add_child(narrow);
+		Node *narrow_last=_add_children(narrow,NARROW_CHILDREN,"child",&usec);
+
+		//three levels, the middle one wide
+		Node *leaf = _add_children(_add_children(wide_last,1,"inner",&usec),1,"leaf",&usec);
+
+		for(int i=0;i<WIDE_CHILDREN;i+=97)
+			wide_paths.push_back(NodePath("child"+itos((i*7919)%WIDE_CHILDREN)));
+
+		Vector<NodePath> paths;
+		paths.push_back(NodePath("child"+itos(NARROW_CHILDREN-1)));
+		_bench_lookup("narrow",narrow,paths,narrow_last);
+		_bench_lookup("wide spread",wide,wide_paths,NULL);
+
+		paths.clear();
+		paths.push_back(NodePath("wide/child"+itos(WIDE_CHILDREN-1)+"/inner0/leaf0"));
+		_bench_lookup("wide nested",get_root(),paths,leaf);
+
+		_bench_node_ref(get_root(),paths[0],leaf);
+
+		//removing from the end and the middle must keep lookups right
+		for(int i=0;i<WIDE_CHILDREN/2;i++) {
+			Node *c=wide->get_child(wide->get_child_count()/2);
+			wide->remove_child(c);
+			memdelete(c);
+		}
+		for(int i=0;i<wide->get_child_count();i++) {
+			Node *c=wide->get_child(i);
+			ok = ok && wide->get_node(NodePath(c->get_name()))==c;
+		}
+
+		print_line(String("node paths ")+(ok?"OK":"FAILED"));
+	}
+
+	virtual bool idle(float p_time) {
+
+		return true;
+	}
+
+};
+
+MainLoop* test() {
+
+	return memnew( TestMainLoop );
+}
+
+}
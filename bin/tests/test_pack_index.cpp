@@ -0,0 +1,222 @@
+/*************************************************************************/
+/*  test_pack_index.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_pack_index.h"
+
+#include "io/file_access_pack.h"
+#include "io/marshalls.h"
+#include "io/md5.h"
+#include "os/dir_access.h"
+#include "os/file_access.h"
+#include "os/os.h"
+#include "print_string.h"
+#include "version.h"
+
+/* Startup and lookup cost of a big pack, with and without the hash index */
+
+namespace TestPackIndex {
+
+enum {
+	FILE_COUNT=40000
+};
+
+static String _res_path(const String& p_prefix,int p_idx) {
+
+	return "res://"+p_prefix+"/dir_"+itos(p_idx%100)+"/file_"+itos(p_idx)+".res";
+}
+
+static String _decoy_path(const String& p_prefix) {
+
+	return "res://"+p_prefix+"/decoy.res";
+}
+
+static String _missing_path(const String& p_prefix) {
+
+	return "res://"+p_prefix+"/missing.res";
+}
+
+static void _write_pack(const String& p_path,const String& p_prefix,bool p_index) {
+
+	FileAccess *f = FileAccess::open(p_path,FileAccess::WRITE);
+	ERR_FAIL_COND(!f);
+
+	// indexed packs get one more file, its index entry has the hash of a path that is not in the pack
+	int count = p_index ? FILE_COUNT+1 : FILE_COUNT;
+
+	Vector<CharString> paths;
+	uint64_t dir_size=0;
+	for(int i=0;i<count;i++) {
+		paths.push_back((i<FILE_COUNT?_res_path(p_prefix,i):_decoy_path(p_prefix)).utf8());
+		dir_size+=4+paths[i].length()+8+8+16;
+	}
+
+	uint64_t data_ofs = (88+dir_size+3)&~3;
+	uint64_t index_ofs = p_index ? data_ofs+count*4 : 0;
+
+	f->store_32(0x43504447); //GDPK
+	f->store_32(0);
+	f->store_32(VERSION_MAJOR);
+	f->store_32(VERSION_MINOR);
+	f->store_32(VERSION_REVISION);
+	f->store_32(index_ofs&0xFFFFFFFF);
+	f->store_32(index_ofs>>32);
+	for(int i=2;i<16;i++)
+		f->store_32(0);
+	f->store_32(count);
+
+	uint8_t md5[16]={0};
+	for(int i=0;i<count;i++) {
+		f->store_32(paths[i].length());
+		f->store_buffer((const uint8_t*)paths[i].get_data(),paths[i].length());
+		f->store_64(data_ofs+i*4);
+		f->store_64(4);
+		f->store_buffer(md5,16);
+	}
+	while(f->get_pos()<data_ofs)
+		f->store_8(0);
+	for(int i=0;i<count;i++)
+		f->store_32(i);
+
+	if (p_index) {
+
+		Vector<uint64_t> hashes;
+		Map<uint64_t,int> by_hash;
+		uint32_t paths_size=0;
+		for(int i=0;i<count;i++) {
+			uint64_t h=PackedData::hash_path(i<FILE_COUNT?_res_path(p_prefix,i):_missing_path(p_prefix));
+			hashes.push_back(h);
+			by_hash[h]=i;
+			paths_size+=paths[i].length();
+		}
+		hashes.sort();
+
+		Vector<uint8_t> entries;
+		entries.resize(count*PackedData::INDEX_ENTRY_SIZE+paths_size);
+		uint8_t *w=entries.ptr();
+		uint8_t *wp=&w[count*PackedData::INDEX_ENTRY_SIZE];
+		uint32_t path_ofs=0;
+		for(int i=0;i<count;i++) {
+			int idx=by_hash[hashes[i]];
+			encode_uint64(hashes[i],&w[0]);
+			encode_uint64(data_ofs+idx*4,&w[8]);
+			encode_uint64(4,&w[16]);
+			for(int j=0;j<16;j++)
+				w[24+j]=0;
+			encode_uint32(path_ofs,&w[40]);
+			encode_uint32(paths[idx].length(),&w[44]);
+			copymem(&wp[path_ofs],paths[idx].get_data(),paths[idx].length());
+			path_ofs+=paths[idx].length();
+			w+=PackedData::INDEX_ENTRY_SIZE;
+		}
+
+		MD5_CTX ctx;
+		MD5Init(&ctx);
+		MD5Update(&ctx,entries.ptr(),entries.size());
+		MD5Final(&ctx);
+
+		f->store_32(PackedData::INDEX_MAGIC);
+		f->store_32(count);
+		f->store_32(paths_size);
+		f->store_buffer(ctx.digest,16);
+		f->store_buffer(entries.ptr(),entries.size());
+	}
+
+	memdelete(f);
+}
+
+static void _bench(const String& p_pack,const String& p_prefix,const String& p_name) {
+
+	PackedData *pd = PackedData::get_singleton();
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	pd->add_pack(p_pack);
+	uint64_t open_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	Vector<String> paths;
+	for(int i=0;i<FILE_COUNT;i++)
+		paths.push_back(_res_path(p_prefix,(i*7919)%FILE_COUNT));
+
+	int found=0;
+	from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<FILE_COUNT;i++) {
+		if (pd->has_path(paths[i]))
+			found++;
+	}
+	uint64_t lookup_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	int errors=FILE_COUNT-found;
+	for(int i=0;i<FILE_COUNT;i+=997) {
+		FileAccess *f = pd->try_open_path(_res_path(p_prefix,i));
+		if (!f || f->get_32()!=uint32_t(i))
+			errors++;
+		if (f)
+			memdelete(f);
+	}
+
+	print_line(p_name+": "+itos(FILE_COUNT)+" files, add_pack "+itos(open_usec/1000)+" msec, lookups "+itos(lookup_usec*1000/FILE_COUNT)+" nsec each, "+itos(errors)+" errors");
+}
+
+MainLoop* test() {
+
+	if (!PackedData::get_singleton())
+		memnew(PackedData);
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->change_dir("user://");
+	String dir = da->get_current_dir();
+
+	String legacy = dir+"/test_pack_legacy.pck";
+	String indexed = dir+"/test_pack_indexed.pck";
+	_write_pack(legacy,"legacy",false);
+	_write_pack(indexed,"indexed",true);
+
+	// legacy first, an indexed pack added later never folds into the map
+	_bench(legacy,"legacy","directory");
+	_bench(indexed,"indexed","hash index");
+
+	// a path whose hash is in the index, but whose name is not in the pack
+	PackedData *pd = PackedData::get_singleton();
+	FileAccess *mf = pd->try_open_path(_missing_path("indexed"));
+	bool missing = !pd->has_path(_missing_path("indexed")) && !mf;
+	if (mf)
+		memdelete(mf);
+	print_line("pack index hash collision with a missing path: "+String(missing?"OK":"FAILED"));
+
+	DirAccess *pda = memnew( DirAccessPack );
+	bool listed = pda->change_dir("res://indexed/dir_7")==OK && pda->file_exists("file_7.res");
+	print_line("pack index directory listing: "+String(listed?"OK":"FAILED"));
+	memdelete(pda);
+
+	da->remove(legacy);
+	da->remove(indexed);
+	memdelete(da);
+
+	return NULL;
+}
+
+}
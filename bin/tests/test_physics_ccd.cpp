@@ -0,0 +1,135 @@
+/*************************************************************************/
+/*  test_physics_ccd.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_physics_ccd.h"
+
+#include "servers/physics_server.h"
+#include "print_string.h"
+
+/* Tunnelling regression tests: small, fast bodies fired at thin geometry must never end up on the other side */
+
+namespace TestPhysicsCCD {
+
+struct BulletTest {
+
+	const char *name;
+	PhysicsServer::ShapeType shape_type;
+	Variant shape_data;
+	float speed;
+	float wall_thickness;
+	float wall_angle; //around z, a tilted wall is long along the motion but still thin
+};
+
+static RID _create_shape(PhysicsServer::ShapeType p_type,const Variant& p_data) {
+
+	RID shape = PhysicsServer::get_singleton()->shape_create(p_type);
+	PhysicsServer::get_singleton()->shape_set_data(shape,p_data);
+	return shape;
+}
+
+static bool _run_bullet_test(const BulletTest& p_test,bool p_ccd,float *r_final_x) {
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space,true);
+
+	// thin wall through x=10
+	Transform wall_xform(Matrix3(Vector3(0,0,1),p_test.wall_angle),Vector3(10,0,0));
+	RID wall_shape = _create_shape(PhysicsServer::SHAPE_BOX,Vector3(p_test.wall_thickness*0.5,1000,5));
+	RID wall = ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+	ps->body_set_space(wall,space);
+	ps->body_add_shape(wall,wall_shape);
+	ps->body_set_state(wall,PhysicsServer::BODY_STATE_TRANSFORM,wall_xform);
+
+	RID bullet_shape = _create_shape(p_test.shape_type,p_test.shape_data);
+	RID bullet = ps->body_create(PhysicsServer::BODY_MODE_RIGID);
+	ps->body_set_space(bullet,space);
+	ps->body_add_shape(bullet,bullet_shape);
+	ps->body_set_enable_continuous_collision_detection(bullet,p_ccd);
+	ps->body_set_state(bullet,PhysicsServer::BODY_STATE_TRANSFORM,Transform());
+	ps->body_set_state(bullet,PhysicsServer::BODY_STATE_LINEAR_VELOCITY,Vector3(p_test.speed,0,0));
+
+	for(int i=0;i<60;i++) {
+
+		ps->step(1.0/60.0);
+		ps->flush_queries();
+	}
+
+	Transform xform = ps->body_get_state(bullet,PhysicsServer::BODY_STATE_TRANSFORM);
+	*r_final_x=xform.origin.x;
+
+	ps->free(bullet);
+	ps->free(bullet_shape);
+	ps->free(wall);
+	ps->free(wall_shape);
+	ps->space_set_active(space,false);
+	ps->free(space);
+
+	//still on the near side of the wall
+	return (xform.origin-wall_xform.origin).dot(wall_xform.basis.get_axis(0)) < 0;
+}
+
+MainLoop* test() {
+
+	Dictionary capsule_data;
+	capsule_data["radius"]=0.1;
+	capsule_data["height"]=0.2;
+
+	BulletTest tests[]={
+		{ "sphere 100m/s", PhysicsServer::SHAPE_SPHERE, 0.1, 100, 0.05, 0 },
+		{ "sphere 1000m/s", PhysicsServer::SHAPE_SPHERE, 0.1, 1000, 0.05, 0 },
+		{ "box 300m/s", PhysicsServer::SHAPE_BOX, Vector3(0.1,0.1,0.1), 300, 0.02, 0 },
+		{ "capsule 500m/s", PhysicsServer::SHAPE_CAPSULE, capsule_data, 500, 0.05, 0 },
+		{ "sphere 1000m/s, tilted wall", PhysicsServer::SHAPE_SPHERE, 0.05, 1000, 0.02, Math_PI*0.3 },
+		{ "box 600m/s, tilted wall", PhysicsServer::SHAPE_BOX, Vector3(0.1,0.1,0.1), 600, 0.02, Math_PI*0.35 },
+	};
+
+	int count = sizeof(tests)/sizeof(BulletTest);
+	int failed=0;
+
+	for(int i=0;i<count;i++) {
+
+		float x_ccd,x_discrete;
+		bool ok=_run_bullet_test(tests[i],true,&x_ccd);
+		bool discrete_ok=_run_bullet_test(tests[i],false,&x_discrete);
+
+		print_line(String(tests[i].name)+": "+(ok?"OK":"TUNNELLED")+" (x="+rtos(x_ccd)+", without CCD "+(discrete_ok?"stopped":"tunnelled")+" at x="+rtos(x_discrete)+")");
+		if (!ok)
+			failed++;
+	}
+
+	if (failed)
+		print_line("CCD: "+itos(failed)+" of "+itos(count)+" tunnelling tests FAILED");
+	else
+		print_line("CCD: all tunnelling tests passed");
+
+	return NULL;
+}
+
+}
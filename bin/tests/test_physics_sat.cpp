@@ -0,0 +1,261 @@
+/*************************************************************************/
+/*  test_physics_sat.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_physics_sat.h"
+
+#include "servers/physics/shape_sw.h"
+#include "servers/physics/collision_solver_sat.h"
+#include "os/os.h"
+#include "math_funcs.h"
+#include "print_string.h"
+
+/* Narrowphase checks: the four-wide SAT path must give the same contacts as the scalar one */
+
+namespace TestPhysicsSAT {
+
+struct ContactList {
+
+	enum {
+		MAX_CONTACTS=32
+	};
+
+	Vector3 points[MAX_CONTACTS][2];
+	int count;
+};
+
+static void _contact_cbk(const Vector3& p_point_A,const Vector3& p_point_B,void *p_userdata) {
+
+	ContactList *cl=(ContactList*)p_userdata;
+	if (cl->count>=ContactList::MAX_CONTACTS)
+		return;
+	cl->points[cl->count][0]=p_point_A;
+	cl->points[cl->count][1]=p_point_B;
+	cl->count++;
+}
+
+static Transform _random_transform(float p_spread) {
+
+	Vector3 axis(Math::random(-1,1),Math::random(-1,1),Math::random(-1,1));
+	if (axis.length()<0.01)
+		axis=Vector3(0,1,0);
+	Matrix3 basis(axis.normalized(),Math::random(0,Math_PI*2.0));
+	return Transform(basis,Vector3(Math::random(-p_spread,p_spread),Math::random(-p_spread,p_spread),Math::random(-p_spread,p_spread)));
+}
+
+static ShapeSW *_create_shape(int p_kind) {
+
+	switch(p_kind) {
+
+		case 0: {
+
+			ShapeSW *box = memnew( BoxShapeSW );
+			box->set_data(Vector3(Math::random(0.2,1.5),Math::random(0.2,1.5),Math::random(0.2,1.5)));
+			return box;
+		} break;
+		case 1: {
+
+			ShapeSW *capsule = memnew( CapsuleShapeSW );
+			Dictionary d;
+			d["radius"]=Math::random(0.2,0.8);
+			d["height"]=Math::random(0.2,2.0);
+			capsule->set_data(d);
+			return capsule;
+		} break;
+		default: {
+
+			// random debris-like hull
+			ShapeSW *convex = memnew( ConvexPolygonShapeSW );
+			DVector<Vector3> points;
+			int count=Math::rand()%20+6;
+			for(int i=0;i<count;i++)
+				points.push_back(Vector3(Math::random(-1,1),Math::random(-1,1),Math::random(-1,1)));
+			convex->set_data(points);
+			return convex;
+		} break;
+	}
+
+	return NULL;
+}
+
+static const char *_kind_names[3]={"box","capsule","convex"};
+
+static bool _solve(bool p_simd,ShapeSW *p_A,const Transform& p_xform_A,ShapeSW *p_B,const Transform& p_xform_B,ContactList *r_contacts) {
+
+	sat_set_simd_enabled(p_simd);
+	r_contacts->count=0;
+	return sat_calculate_penetration(p_A,p_xform_A,p_B,p_xform_B,_contact_cbk,r_contacts);
+}
+
+static bool _check_convex_kernels(const ConvexPolygonShapeSW *p_convex) {
+
+	const Vector<Vector3> &vertices=p_convex->get_mesh().vertices;
+	if (vertices.size()==0)
+		return true;
+
+	for(int i=0;i<8;i++) {
+
+		Vector3 n=Vector3(Math::random(-1,1),Math::random(-1,1),Math::random(-1,1)).normalized();
+		Transform xform=_random_transform(4);
+
+		real_t min,max;
+		p_convex->project_range(n,xform,min,max);
+		real_t ref_min=1e20,ref_max=-1e20;
+		int ref_support=0;
+		for(int j=0;j<vertices.size();j++) {
+
+			real_t d=n.dot(xform.xform(vertices[j]));
+			ref_min=MIN(ref_min,d);
+			ref_max=MAX(ref_max,d);
+			if (n.dot(vertices[j])>n.dot(vertices[ref_support]))
+				ref_support=j;
+		}
+
+		if (Math::abs(min-ref_min)>0.001 || Math::abs(max-ref_max)>0.001)
+			return false;
+		if (p_convex->get_support(n)!=vertices[ref_support])
+			return false;
+	}
+
+	return true;
+}
+
+static int _compare(int p_pairs) {
+
+	int errors=0;
+	int collided=0;
+
+	for(int i=0;i<p_pairs;i++) {
+
+		int kind_A=Math::rand()%3;
+		int kind_B=Math::rand()%3;
+		ShapeSW *A=_create_shape(kind_A);
+		ShapeSW *B=_create_shape(kind_B);
+		Transform xform_A=_random_transform(0.5);
+		Transform xform_B=_random_transform(1.5);
+
+		if (kind_B==2 && !_check_convex_kernels(static_cast<ConvexPolygonShapeSW*>(B))) {
+			print_line("convex kernel mismatch");
+			errors++;
+		}
+
+		ContactList scalar,simd;
+		bool col_scalar=_solve(false,A,xform_A,B,xform_B,&scalar);
+		bool col_simd=_solve(true,A,xform_A,B,xform_B,&simd);
+
+		bool ok = col_scalar==col_simd && scalar.count==simd.count;
+		for(int j=0;ok && j<scalar.count;j++) {
+
+			for(int k=0;k<2;k++) {
+				if (scalar.points[j][k].distance_to(simd.points[j][k])>0.001)
+					ok=false;
+			}
+		}
+
+		if (col_scalar)
+			collided++;
+
+		if (!ok) {
+			print_line(String("mismatch ")+_kind_names[kind_A]+"-"+_kind_names[kind_B]+": collided "+itos(col_scalar)+"/"+itos(col_simd)+", contacts "+itos(scalar.count)+"/"+itos(simd.count));
+			errors++;
+		}
+
+		memdelete(A);
+		memdelete(B);
+	}
+
+	print_line("SAT compare: "+itos(p_pairs)+" pairs, "+itos(collided)+" colliding, "+itos(errors)+" mismatches");
+	return errors;
+}
+
+static void _benchmark(int p_kind_A,int p_kind_B,int p_iterations) {
+
+	enum {
+		PAIRS=64
+	};
+
+	ShapeSW *shapes[PAIRS][2];
+	Transform xforms[PAIRS][2];
+
+	for(int i=0;i<PAIRS;i++) {
+
+		shapes[i][0]=_create_shape(p_kind_A);
+		shapes[i][1]=_create_shape(p_kind_B);
+		xforms[i][0]=_random_transform(0.3);
+		xforms[i][1]=_random_transform(0.8); // mostly touching, like a debris pile
+	}
+
+	uint64_t usec[2];
+	int hits=0;
+
+	for(int s=0;s<2;s++) {
+
+		sat_set_simd_enabled(s==1);
+		uint64_t t=OS::get_singleton()->get_ticks_usec();
+
+		for(int j=0;j<p_iterations;j++) {
+
+			for(int i=0;i<PAIRS;i++) {
+
+				ContactList cl;
+				cl.count=0;
+				if (sat_calculate_penetration(shapes[i][0],xforms[i][0],shapes[i][1],xforms[i][1],_contact_cbk,&cl))
+					hits++;
+			}
+		}
+
+		usec[s]=OS::get_singleton()->get_ticks_usec()-t;
+	}
+
+	for(int i=0;i<PAIRS;i++) {
+		memdelete(shapes[i][0]);
+		memdelete(shapes[i][1]);
+	}
+
+	double calls=double(p_iterations)*PAIRS;
+	print_line(String(_kind_names[p_kind_A])+"-"+_kind_names[p_kind_B]+": scalar "+rtos(usec[0]*1000.0/calls)+"ns/pair, simd "+rtos(usec[1]*1000.0/calls)+"ns/pair ("+itos(hits/2)+" colliding)");
+}
+
+MainLoop* test() {
+
+	Math::seed(4321);
+	bool was_enabled=sat_is_simd_enabled();
+
+	_compare(20000);
+
+	for(int i=0;i<3;i++) {
+		for(int j=i;j<3;j++) {
+			_benchmark(i,j,2000);
+		}
+	}
+
+	sat_set_simd_enabled(was_enabled);
+
+	return NULL;
+}
+
+}
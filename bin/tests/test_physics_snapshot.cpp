@@ -0,0 +1,292 @@
+/*************************************************************************/
+/*  test_physics_snapshot.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_physics_snapshot.h"
+
+#include "servers/physics_server.h"
+#include "servers/physics_2d_server.h"
+#include "os/os.h"
+#include "print_string.h"
+
+/* Rollback tests: a restored space must replay exactly the same steps it did after the snapshot was taken */
+
+namespace TestPhysicsSnapshot {
+
+enum {
+	BODY_COUNT=1000,
+	WARMUP_STEPS=60,
+	REPLAY_STEPS=60,
+	BENCH_ITERATIONS=20
+};
+
+static void _step(PhysicsServer *ps,int p_steps) {
+
+	for(int i=0;i<p_steps;i++) {
+
+		ps->step(1.0/60.0);
+		ps->flush_queries();
+	}
+}
+
+static void _step_2d(Physics2DServer *ps,int p_steps) {
+
+	for(int i=0;i<p_steps;i++) {
+
+		ps->step(1.0/60.0);
+		ps->flush_queries();
+	}
+}
+
+static void _test_3d() {
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space,true);
+
+	RID floor_shape = ps->shape_create(PhysicsServer::SHAPE_PLANE);
+	ps->shape_set_data(floor_shape,Plane(Vector3(0,1,0),0));
+	RID floor = ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+	ps->body_set_space(floor,space);
+	ps->body_add_shape(floor,floor_shape);
+
+	// a low gravity zone in the middle, so area pairs are part of the state too
+	RID area_shape = ps->shape_create(PhysicsServer::SHAPE_BOX);
+	ps->shape_set_data(area_shape,Vector3(4,2,4));
+	RID area = ps->area_create();
+	ps->area_set_space(area,space);
+	ps->area_add_shape(area,area_shape);
+	ps->area_set_space_override_mode(area,PhysicsServer::AREA_SPACE_OVERRIDE_REPLACE);
+	ps->area_set_param(area,PhysicsServer::AREA_PARAM_GRAVITY,2.0);
+	ps->area_set_param(area,PhysicsServer::AREA_PARAM_PRIORITY,1);
+	ps->area_set_transform(area,Transform(Matrix3(),Vector3(0,2,0)));
+
+	RID box_shape = ps->shape_create(PhysicsServer::SHAPE_BOX);
+	ps->shape_set_data(box_shape,Vector3(0.5,0.5,0.5));
+	RID sphere_shape = ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+	ps->shape_set_data(sphere_shape,0.5);
+
+	Vector<RID> bodies;
+	for(int i=0;i<BODY_COUNT;i++) {
+
+		RID body = ps->body_create(PhysicsServer::BODY_MODE_RIGID);
+		ps->body_set_space(body,space);
+		ps->body_add_shape(body,(i&1)?box_shape:sphere_shape);
+		int x=i%10;
+		int z=(i/10)%10;
+		int y=i/100;
+		ps->body_set_state(body,PhysicsServer::BODY_STATE_TRANSFORM,Transform(Matrix3(Vector3(0,1,0),i*0.1),Vector3(x*1.1-5,1+y*1.2,z*1.1-5)));
+		bodies.push_back(body);
+	}
+
+	_step(ps,WARMUP_STEPS);
+
+	int size = ps->space_get_snapshot_size(space);
+	Vector<uint8_t> buffer;
+	buffer.resize(size);
+	ps->space_snapshot(space,buffer.ptr(),size);
+
+	_step(ps,REPLAY_STEPS);
+
+	Vector<Transform> expected;
+	expected.resize(BODY_COUNT);
+	for(int i=0;i<BODY_COUNT;i++)
+		expected[i]=ps->body_get_state(bodies[i],PhysicsServer::BODY_STATE_TRANSFORM);
+
+	Error err = ps->space_restore_snapshot(space,buffer.ptr(),size);
+	_step(ps,REPLAY_STEPS);
+
+	int mismatches=0;
+	for(int i=0;i<BODY_COUNT;i++) {
+
+		Transform t = ps->body_get_state(bodies[i],PhysicsServer::BODY_STATE_TRANSFORM);
+		if (t.origin!=expected[i].origin || t.basis!=expected[i].basis)
+			mismatches++;
+	}
+
+	print_line("3D snapshot: "+itos(size)+" bytes, restore "+(err==OK?"OK":"FAILED")+", "+itos(mismatches)+" of "+itos(BODY_COUNT)+" bodies diverged after "+itos(REPLAY_STEPS)+" replayed steps");
+
+	// rollback pattern: save, simulate ahead, go back
+	uint64_t snapshot_usec=0;
+	uint64_t restore_usec=0;
+	uint64_t step_usec=0;
+	for(int i=0;i<BENCH_ITERATIONS;i++) {
+
+		size = ps->space_get_snapshot_size(space);
+		if (buffer.size()<size)
+			buffer.resize(size);
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		ps->space_snapshot(space,buffer.ptr(),size);
+		snapshot_usec+=OS::get_singleton()->get_ticks_usec()-from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		_step(ps,1);
+		step_usec+=OS::get_singleton()->get_ticks_usec()-from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		ps->space_restore_snapshot(space,buffer.ptr(),size);
+		restore_usec+=OS::get_singleton()->get_ticks_usec()-from;
+
+		_step(ps,1);
+	}
+
+	print_line("3D snapshot: "+itos(BODY_COUNT)+" bodies, snapshot "+itos(snapshot_usec/BENCH_ITERATIONS)+" usec, restore "+itos(restore_usec/BENCH_ITERATIONS)+" usec (one step takes "+itos(step_usec/BENCH_ITERATIONS)+" usec)");
+
+	for(int i=0;i<BODY_COUNT;i++)
+		ps->free(bodies[i]);
+	ps->free(box_shape);
+	ps->free(sphere_shape);
+	ps->free(area);
+	ps->free(area_shape);
+	ps->free(floor);
+	ps->free(floor_shape);
+	ps->space_set_active(space,false);
+	ps->free(space);
+}
+
+static void _test_2d() {
+
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+	ps->set_active(true);
+
+	RID space = ps->space_create();
+	ps->space_set_active(space,true);
+	ps->area_set_param(space,Physics2DServer::AREA_PARAM_GRAVITY_VECTOR,Vector2(0,1));
+	ps->area_set_param(space,Physics2DServer::AREA_PARAM_GRAVITY,98);
+
+	Array floor_data;
+	floor_data.push_back(Vector2(0,-1));
+	floor_data.push_back(0);
+	RID floor_shape = ps->shape_create(Physics2DServer::SHAPE_LINE);
+	ps->shape_set_data(floor_shape,floor_data);
+	RID floor = ps->body_create(Physics2DServer::BODY_MODE_STATIC);
+	ps->body_set_space(floor,space);
+	ps->body_add_shape(floor,floor_shape);
+
+	RID area_shape = ps->shape_create(Physics2DServer::SHAPE_RECTANGLE);
+	ps->shape_set_data(area_shape,Vector2(100,40));
+	RID area = ps->area_create();
+	ps->area_set_space(area,space);
+	ps->area_add_shape(area,area_shape);
+	ps->area_set_space_override_mode(area,Physics2DServer::AREA_SPACE_OVERRIDE_REPLACE);
+	ps->area_set_param(area,Physics2DServer::AREA_PARAM_GRAVITY,20);
+	ps->area_set_param(area,Physics2DServer::AREA_PARAM_PRIORITY,1);
+	ps->area_set_transform(area,Matrix32(0,Vector2(0,-40)));
+
+	RID box_shape = ps->shape_create(Physics2DServer::SHAPE_RECTANGLE);
+	ps->shape_set_data(box_shape,Vector2(8,8));
+	RID circle_shape = ps->shape_create(Physics2DServer::SHAPE_CIRCLE);
+	ps->shape_set_data(circle_shape,8);
+
+	Vector<RID> bodies;
+	for(int i=0;i<BODY_COUNT;i++) {
+
+		RID body = ps->body_create(Physics2DServer::BODY_MODE_RIGID);
+		ps->body_set_space(body,space);
+		ps->body_add_shape(body,(i&1)?box_shape:circle_shape);
+		int x=i%40;
+		int y=i/40;
+		ps->body_set_state(body,Physics2DServer::BODY_STATE_TRANSFORM,Matrix32(i*0.1,Vector2(x*17-340,-10-y*18)));
+		bodies.push_back(body);
+	}
+
+	_step_2d(ps,WARMUP_STEPS);
+
+	int size = ps->space_get_snapshot_size(space);
+	Vector<uint8_t> buffer;
+	buffer.resize(size);
+	ps->space_snapshot(space,buffer.ptr(),size);
+
+	_step_2d(ps,REPLAY_STEPS);
+
+	Vector<Matrix32> expected;
+	expected.resize(BODY_COUNT);
+	for(int i=0;i<BODY_COUNT;i++)
+		expected[i]=ps->body_get_state(bodies[i],Physics2DServer::BODY_STATE_TRANSFORM);
+
+	Error err = ps->space_restore_snapshot(space,buffer.ptr(),size);
+	_step_2d(ps,REPLAY_STEPS);
+
+	int mismatches=0;
+	for(int i=0;i<BODY_COUNT;i++) {
+
+		Matrix32 t = ps->body_get_state(bodies[i],Physics2DServer::BODY_STATE_TRANSFORM);
+		if (t!=expected[i])
+			mismatches++;
+	}
+
+	print_line("2D snapshot: "+itos(size)+" bytes, restore "+(err==OK?"OK":"FAILED")+", "+itos(mismatches)+" of "+itos(BODY_COUNT)+" bodies diverged after "+itos(REPLAY_STEPS)+" replayed steps");
+
+	uint64_t snapshot_usec=0;
+	uint64_t restore_usec=0;
+	uint64_t step_usec=0;
+	for(int i=0;i<BENCH_ITERATIONS;i++) {
+
+		size = ps->space_get_snapshot_size(space);
+		if (buffer.size()<size)
+			buffer.resize(size);
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		ps->space_snapshot(space,buffer.ptr(),size);
+		snapshot_usec+=OS::get_singleton()->get_ticks_usec()-from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		_step_2d(ps,1);
+		step_usec+=OS::get_singleton()->get_ticks_usec()-from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		ps->space_restore_snapshot(space,buffer.ptr(),size);
+		restore_usec+=OS::get_singleton()->get_ticks_usec()-from;
+
+		_step_2d(ps,1);
+	}
+
+	print_line("2D snapshot: "+itos(BODY_COUNT)+" bodies, snapshot "+itos(snapshot_usec/BENCH_ITERATIONS)+" usec, restore "+itos(restore_usec/BENCH_ITERATIONS)+" usec (one step takes "+itos(step_usec/BENCH_ITERATIONS)+" usec)");
+
+	for(int i=0;i<BODY_COUNT;i++)
+		ps->free(bodies[i]);
+	ps->free(box_shape);
+	ps->free(circle_shape);
+	ps->free(area);
+	ps->free(area_shape);
+	ps->free(floor);
+	ps->free(floor_shape);
+	ps->space_set_active(space,false);
+	ps->free(space);
+}
+
+MainLoop* test() {
+
+	_test_3d();
+	_test_2d();
+
+	return NULL;
+}
+
+}
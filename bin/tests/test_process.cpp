@@ -0,0 +1,155 @@
+/*************************************************************************/
+/*  test_process.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_process.h"
+
+#include "os/os.h"
+#include "print_string.h"
+#include "scene/main/scene_main_loop.h"
+#include "scene/main/viewport.h"
+
+/* Per node cost of fixed_process and idle_process dispatch, running and paused */
+
+namespace TestProcess {
+
+enum {
+	PARENT_COUNT=100,
+	NODES_PER_PARENT=100, // 10k processing nodes
+	FRAME_COUNT=200
+};
+
+class ProcessNode : public Node {
+
+	OBJ_TYPE( ProcessNode, Node );
+public:
+
+	int fixed_count;
+	int idle_count;
+
+	void _notification(int p_what) {
+
+		switch(p_what) {
+
+			case NOTIFICATION_FIXED_PROCESS: fixed_count++; break;
+			case NOTIFICATION_PROCESS: idle_count++; break;
+		}
+	}
+
+	ProcessNode() { fixed_count=0; idle_count=0; }
+};
+
+class TestMainLoop : public SceneMainLoop {
+
+	Vector<ProcessNode*> nodes;
+	int frame;
+	uint64_t fixed_usec[2];
+	uint64_t idle_usec[2];
+
+	bool _check_counts() {
+
+		for(int i=0;i<nodes.size();i++) {
+
+			//only half of the parents keep processing while paused
+			int expected = nodes[i]->get_parent()->get_pause_mode()==Node::PAUSE_MODE_PROCESS ? FRAME_COUNT*2 : FRAME_COUNT;
+			if (nodes[i]->fixed_count!=expected || nodes[i]->idle_count!=expected)
+				return false;
+		}
+
+		return true;
+	}
+
+	void _report(const String& p_name,int p_pass,int p_node_count) {
+
+		uint64_t calls=uint64_t(p_node_count)*FRAME_COUNT;
+		print_line(p_name+": fixed_process "+rtos(fixed_usec[p_pass]*1000.0/calls)+" nsec per node, idle_process "+rtos(idle_usec[p_pass]*1000.0/calls)+" nsec per node");
+	}
+
+public:
+
+	virtual void init() {
+
+		SceneMainLoop::init();
+
+		frame=0;
+		for(int i=0;i<2;i++) {
+			fixed_usec[i]=0;
+			idle_usec[i]=0;
+		}
+
+		for(int i=0;i<PARENT_COUNT;i++) {
+
+			Node *parent = memnew( Node );
+			parent->set_pause_mode(i%2 ? Node::PAUSE_MODE_PROCESS : Node::PAUSE_MODE_INHERIT);
+			get_root()->add_child(parent);
+
+			for(int j=0;j<NODES_PER_PARENT;j++) {
+
+				ProcessNode *n = memnew( ProcessNode );
+				n->set_fixed_process(true);
+				n->set_process(true);
+				parent->add_child(n);
+				nodes.push_back(n);
+			}
+		}
+	}
+
+	virtual bool iteration(float p_time) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		bool quit = SceneMainLoop::iteration(p_time);
+		fixed_usec[frame/FRAME_COUNT]+=OS::get_singleton()->get_ticks_usec()-from;
+		return quit;
+	}
+
+	virtual bool idle(float p_time) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		bool quit = SceneMainLoop::idle(p_time);
+		idle_usec[frame/FRAME_COUNT]+=OS::get_singleton()->get_ticks_usec()-from;
+
+		frame++;
+		if (frame==FRAME_COUNT)
+			set_pause(true);
+
+		if (frame<FRAME_COUNT*2)
+			return quit;
+
+		_report("running",0,nodes.size());
+		_report("paused",1,nodes.size());
+		print_line(String("process counts ")+(_check_counts()?"OK":"FAILED"));
+		return true;
+	}
+
+};
+
+MainLoop* test() {
+
+	return memnew( TestMainLoop );
+}
+
+}
@@ -0,0 +1,188 @@
+/*************************************************************************/
+/*  test_resource_load.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_resource_load.h"
+
+#include "io/resource_loader.h"
+#include "io/resource_saver.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "os/thread.h"
+#include "print_string.h"
+
+/* Threaded loading must produce the same resources as ResourceLoader::load, sharing dependencies */
+
+namespace TestResourceLoad {
+
+enum {
+	LEAF_COUNT=64,
+	LEAF_SIZE=20000,
+	TOP_COUNT=16,
+	TOP_DEPENDENCIES=8
+};
+
+static String _leaf_path(const String& p_dir,int p_idx) {
+
+	return p_dir+"/leaf_"+itos(p_idx)+(p_idx&1?".xml":".res");
+}
+
+static String _top_path(const String& p_dir,int p_idx) {
+
+	return p_dir+"/top_"+itos(p_idx)+(p_idx&1?".xml":".res");
+}
+
+static void _create_files(const String& p_dir) {
+
+	Vector<RES> leaves;
+
+	for(int i=0;i<LEAF_COUNT;i++) {
+
+		RES leaf = memnew( Resource );
+		Array data;
+		for(int j=0;j<LEAF_SIZE;j++)
+			data.push_back(i*LEAF_SIZE+j);
+		leaf->set_meta("data",data);
+		leaf->set_path(_leaf_path(p_dir,i));
+		ResourceSaver::save(leaf->get_path(),leaf);
+		leaves.push_back(leaf);
+	}
+
+	for(int i=0;i<TOP_COUNT;i++) {
+
+		RES top = memnew( Resource );
+		Array deps;
+		for(int j=0;j<TOP_DEPENDENCIES;j++)
+			deps.push_back(leaves[(i*3+j*7)%LEAF_COUNT]);
+		top->set_meta("deps",deps);
+		ResourceSaver::save(_top_path(p_dir,i),top);
+	}
+}
+
+// loads any ".mtc" path, setting up the resource through call_on_main_thread like shapes do
+class _MainThreadCallLoader : public ResourceFormatLoader {
+public:
+
+	static void _set_up(void *p_ud) {
+
+		((Resource*)p_ud)->set_meta("main_thread",Thread::get_caller_ID()==Thread::get_main_ID());
+	}
+
+	virtual RES load(const String &p_path,const String& p_original_path="") {
+
+		RES res = memnew( Resource );
+		ResourceLoader::call_on_main_thread(_set_up,res.ptr());
+		return res;
+	}
+	virtual void get_recognized_extensions(List<String> *p_extensions) const { p_extensions->push_back("mtc"); }
+	virtual bool handles_type(const String& p_type) const { return p_type=="Resource"; }
+	virtual String get_resource_type(const String &p_path) const { return p_path.extension()=="mtc"?"Resource":""; }
+};
+
+static _MainThreadCallLoader main_thread_call_loader;
+
+static int _check(const String& p_dir,const Vector<RES>& p_tops) {
+
+	int errors=0;
+
+	for(int i=0;i<TOP_COUNT;i++) {
+
+		if (p_tops[i].is_null() || !p_tops[i]->has_meta("deps")) {
+			errors++;
+			continue;
+		}
+
+		Array deps = p_tops[i]->get_meta("deps");
+		for(int j=0;j<TOP_DEPENDENCIES;j++) {
+
+			int leaf = (i*3+j*7)%LEAF_COUNT;
+			RES dep = j<deps.size()?RES(deps[j]):RES();
+			if (dep.is_null() || !dep->has_meta("data")) {
+				errors++;
+				continue;
+			}
+			Array data = dep->get_meta("data");
+			if (data.size()!=LEAF_SIZE || int(data[LEAF_SIZE-1])!=leaf*LEAF_SIZE+LEAF_SIZE-1)
+				errors++;
+			if (RES(ResourceCache::get(_leaf_path(p_dir,leaf)))!=dep)
+				errors++; // dependencies must be shared through the cache
+		}
+	}
+
+	return errors;
+}
+
+MainLoop* test() {
+
+	String dir = "user://test_resource_load";
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->change_dir("user://");
+	da->make_dir("test_resource_load");
+	memdelete(da);
+
+	_create_files(dir);
+
+	Vector<RES> tops;
+	tops.resize(TOP_COUNT);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<TOP_COUNT;i++)
+		tops[i]=ResourceLoader::load(_top_path(dir,i));
+	uint64_t load_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	int errors = _check(dir,tops);
+	print_line("load: "+itos(TOP_COUNT)+" resources with "+itos(LEAF_COUNT)+" dependencies in "+itos(load_usec)+" usec, "+itos(errors)+" errors");
+
+	tops.clear();
+	tops.resize(TOP_COUNT);
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<TOP_COUNT;i++)
+		ResourceLoader::load_threaded_request(_top_path(dir,i));
+	for(int i=0;i<TOP_COUNT;i++)
+		tops[i]=ResourceLoader::load_threaded_get(_top_path(dir,i));
+	uint64_t threaded_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	errors = _check(dir,tops);
+	print_line("threaded load: "+itos(TOP_COUNT)+" resources with "+itos(LEAF_COUNT)+" dependencies in "+itos(threaded_usec)+" usec, "+itos(errors)+" errors");
+
+	ResourceLoader::load_threaded_request(_top_path(dir,0));
+	float progress;
+	ResourceLoader::ThreadLoadStatus status = ResourceLoader::load_threaded_get_status(_top_path(dir,0),&progress);
+	RES cached = ResourceLoader::load_threaded_get(_top_path(dir,0));
+	print_line("threaded load of a cached resource: "+String(status==ResourceLoader::THREAD_LOAD_LOADED && cached==tops[0]?"OK":"FAILED"));
+
+	ResourceLoader::add_resource_format_loader(&main_thread_call_loader);
+	ResourceLoader::load_threaded_request(dir+"/main_thread_call.mtc");
+	RES called = ResourceLoader::load_threaded_get(dir+"/main_thread_call.mtc");
+	bool on_main = called.is_valid() && called->has_meta("main_thread") && bool(called->get_meta("main_thread"));
+	print_line("threaded load calling the main thread: "+String(on_main?"OK":"FAILED"));
+
+	return NULL;
+}
+
+}
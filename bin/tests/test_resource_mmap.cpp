@@ -0,0 +1,159 @@
+/*************************************************************************/
+/*  test_resource_mmap.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_resource_mmap.h"
+
+#include "io/resource_loader.h"
+#include "io/resource_saver.h"
+#include "os/dir_access.h"
+#include "os/file_access.h"
+#include "os/os.h"
+#include "print_string.h"
+
+/* Load benchmark over a big set of binary resources, whose arrays are used straight from the file mapping */
+
+namespace TestResourceMMap {
+
+enum {
+	RESOURCE_COUNT=50,
+	RESOURCE_SIZE=10*1024*1024 // 500mb in total
+};
+
+static String _path(const String& p_dir,int p_idx) {
+
+	return p_dir+"/big_"+itos(p_idx)+".res";
+}
+
+static void _create_files(const String& p_dir) {
+
+	for(int i=0;i<RESOURCE_COUNT;i++) {
+
+		RES res = memnew( Resource );
+
+		if (i&1) {
+
+			DVector<Vector3> vertices;
+			vertices.resize(RESOURCE_SIZE/sizeof(Vector3));
+			DVector<Vector3>::Write w = vertices.write();
+			for(int j=0;j<vertices.size();j++)
+				w[j]=Vector3(i,j,-j);
+			w=DVector<Vector3>::Write();
+			res->set_meta("data",vertices);
+		} else {
+
+			DVector<uint8_t> bytes;
+			bytes.resize(RESOURCE_SIZE);
+			DVector<uint8_t>::Write w = bytes.write();
+			for(int j=0;j<bytes.size();j++)
+				w[j]=(i+j)&0xFF;
+			w=DVector<uint8_t>::Write();
+			res->set_meta("data",bytes);
+		}
+
+		ResourceSaver::save(_path(p_dir,i),res);
+	}
+}
+
+static bool _check(const RES& p_res,int p_idx) {
+
+	if (p_res.is_null())
+		return false;
+
+	Variant data = p_res->get_meta("data");
+
+	if (p_idx&1) {
+
+		DVector<Vector3> vertices = data;
+		int last = vertices.size()-1;
+		return last==RESOURCE_SIZE/sizeof(Vector3)-1 && vertices[last]==Vector3(p_idx,last,-last);
+	} else {
+
+		DVector<uint8_t> bytes = data;
+		int last = bytes.size()-1;
+		return last==RESOURCE_SIZE-1 && bytes[last]==((p_idx+last)&0xFF);
+	}
+}
+
+MainLoop* test() {
+
+	String dir = "user://test_resource_mmap";
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->change_dir("user://");
+	da->make_dir("test_resource_mmap");
+
+	_create_files(dir);
+
+	// what loading costs when every array is copied out of the file
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<RESOURCE_COUNT;i++) {
+
+		FileAccess *f = FileAccess::open(_path(dir,i),FileAccess::READ);
+		DVector<uint8_t> bytes;
+		bytes.resize(f->get_len());
+		DVector<uint8_t>::Write w = bytes.write();
+		f->get_buffer(w.ptr(),bytes.size());
+		memdelete(f);
+	}
+	uint64_t copy_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	Vector<RES> loaded;
+	size_t dynamic_usage = Memory::get_dynamic_mem_usage();
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<RESOURCE_COUNT;i++)
+		loaded.push_back(ResourceLoader::load(_path(dir,i)));
+	uint64_t load_usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	size_t load_usage = Memory::get_dynamic_mem_usage()-dynamic_usage;
+
+	int errors=0;
+	for(int i=0;i<RESOURCE_COUNT;i++) {
+		if (!_check(loaded[i],i))
+			errors++;
+	}
+
+	print_line("mmap load: "+itos(RESOURCE_COUNT*(RESOURCE_SIZE/(1024*1024)))+"mb in "+itos(load_usec/1000)+" msec, dynamic memory used "+itos(load_usage/1024)+"kb (reading with copies takes "+itos(copy_usec/1000)+" msec), "+itos(errors)+" errors");
+
+	// modifying a loaded array must never reach the file
+	DVector<uint8_t> bytes = loaded[0]->get_meta("data");
+	bytes.set(RESOURCE_SIZE-1,~bytes[RESOURCE_SIZE-1]);
+	loaded.clear();
+
+	RES reloaded = ResourceLoader::load(_path(dir,0));
+	print_line("mmap copy on write: "+String(_check(reloaded,0)?"OK":"FAILED"));
+	reloaded=RES();
+	bytes.resize(0);
+
+	for(int i=0;i<RESOURCE_COUNT;i++)
+		da->remove(_path(dir,i));
+	memdelete(da);
+
+	return NULL;
+}
+
+}
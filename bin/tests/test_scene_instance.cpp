@@ -0,0 +1,115 @@
+/*************************************************************************/
+/*  test_scene_instance.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_scene_instance.h"
+
+#include "os/os.h"
+#include "print_string.h"
+#include "scene/main/timer.h"
+#include "scene/resources/packed_scene.h"
+
+/* Spawn rate of a small scene (a projectile with a few timers), instancing directly and from a pre-filled pool */
+
+namespace TestSceneInstance {
+
+enum {
+	TIMER_COUNT=6,
+	SPAWN_COUNT=20000
+};
+
+static Node *_make_bullet() {
+
+	Node *root = memnew( Node );
+	root->set_name("bullet");
+	root->add_to_group("bullets",true);
+	root->set_meta("damage",10);
+
+	for(int i=0;i<TIMER_COUNT;i++) {
+
+		Timer *t = memnew( Timer );
+		t->set_name("timer_"+itos(i));
+		t->set_wait_time(0.5+i);
+		t->set_one_shot(true);
+		root->add_child(t);
+		t->set_owner(root);
+	}
+
+	return root;
+}
+
+static bool _check(Node *p_node) {
+
+	if (!p_node || p_node->get_child_count()!=TIMER_COUNT || !p_node->is_in_group("bullets"))
+		return false;
+	Timer *t = p_node->get_child(TIMER_COUNT-1)->cast_to<Timer>();
+	return t && t->is_one_shot() && t->get_wait_time()==0.5+(TIMER_COUNT-1);
+}
+
+static void _report(const String& p_name,uint64_t p_usec,bool p_ok) {
+
+	print_line(p_name+": "+itos(SPAWN_COUNT)+" instances, "+itos(p_usec/1000)+" msec, "+itos(uint64_t(SPAWN_COUNT)*1000000/MAX(p_usec,1))+" instances/sec, "+(p_ok?"OK":"FAILED"));
+}
+
+MainLoop* test() {
+
+	Node *bullet = _make_bullet();
+	Ref<PackedScene> ps = memnew( PackedScene );
+	ps->pack(bullet);
+	memdelete(bullet);
+
+	Vector<Node*> spawned;
+	spawned.resize(SPAWN_COUNT);
+	bool ok=true;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<SPAWN_COUNT;i++)
+		spawned[i]=ps->instance();
+	_report("instance",OS::get_singleton()->get_ticks_usec()-from,_check(spawned[SPAWN_COUNT-1]));
+	for(int i=0;i<SPAWN_COUNT;i++)
+		memdelete(spawned[i]);
+
+	from = OS::get_singleton()->get_ticks_usec();
+	ps->fill_pool(SPAWN_COUNT);
+	uint64_t fill_usec=OS::get_singleton()->get_ticks_usec()-from;
+	print_line("pool filled in "+itos(fill_usec/1000)+" msec");
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<SPAWN_COUNT;i++)
+		spawned[i]=ps->instance();
+	uint64_t pooled_usec=OS::get_singleton()->get_ticks_usec()-from;
+	ok = ps->get_pool_size()==0;
+	for(int i=0;i<SPAWN_COUNT && ok;i++)
+		ok=_check(spawned[i]);
+	_report("instance from pool",pooled_usec,ok);
+	for(int i=0;i<SPAWN_COUNT;i++)
+		memdelete(spawned[i]);
+
+	return NULL;
+}
+
+}
@@ -0,0 +1,201 @@
+/*************************************************************************/
+/*  test_scene_load.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_scene_load.h"
+
+#include "io/resource_loader.h"
+#include "io/resource_saver.h"
+#include "os/dir_access.h"
+#include "os/os.h"
+#include "print_string.h"
+#include "scene/resources/packed_scene.h"
+
+/* Load and instance time of a big scene, saved with the flat bundle and with the old per-node records */
+
+namespace TestSceneLoad {
+
+enum {
+	NODE_COUNT=50000,
+	LOAD_PASSES=5
+};
+
+static Node *_make_scene() {
+
+	Node *root = memnew( Node );
+	root->set_name("root");
+	Vector<Node*> all;
+	all.push_back(root);
+
+	for(int i=1;i<NODE_COUNT;i++) {
+
+		Node *n = memnew( Node );
+		n->set_name("node_"+itos(i));
+		if (i%3==0)
+			n->set_meta("id",i);
+		n->add_to_group("group_"+itos(i%50),true);
+		all[(i-1)/8]->add_child(n);
+		n->set_owner(root);
+		if (i%10==0) {
+			Vector<Variant> binds;
+			binds.push_back(i);
+			n->connect("renamed",all[(i-1)/8],"_on_renamed",binds,Object::CONNECT_PERSIST);
+		}
+		all.push_back(n);
+	}
+
+	return root;
+}
+
+//rewrite a bundle with the version 1 layout, as older scenes were saved
+static Dictionary _to_version_1(const Dictionary& p_bundle) {
+
+	DVector<int> data = p_bundle["data"];
+	DVector<int>::Read r = data.read();
+	int nc=r[0],pc=r[1],gc=r[2],cc=r[3];
+	const int *nodes=&r[5];
+	const int *props=nodes+nc*9;
+	const int *groups=props+pc*2;
+	const int *conns=groups+gc;
+	const int *binds=conns+cc*7;
+
+	Vector<int> rnodes;
+	for(int i=0;i<nc;i++) {
+
+		const int *n=&nodes[i*9];
+		for(int j=0;j<5;j++)
+			rnodes.push_back(n[j]);
+		rnodes.push_back(n[6]);
+		for(int j=0;j<n[6]*2;j++)
+			rnodes.push_back(props[n[5]*2+j]);
+		rnodes.push_back(n[8]);
+		for(int j=0;j<n[8];j++)
+			rnodes.push_back(groups[n[7]+j]);
+	}
+
+	Vector<int> rconns;
+	for(int i=0;i<cc;i++) {
+
+		const int *c=&conns[i*7];
+		for(int j=0;j<5;j++)
+			rconns.push_back(c[j]);
+		rconns.push_back(c[6]);
+		for(int j=0;j<c[6];j++)
+			rconns.push_back(binds[c[5]+j]);
+	}
+
+	Dictionary d;
+	d["names"]=p_bundle["names"];
+	d["variants"]=p_bundle["variants"];
+	d["node_count"]=nc;
+	d["nodes"]=rnodes;
+	d["conn_count"]=cc;
+	d["conns"]=rconns;
+	d["version"]=1;
+	return d;
+}
+
+static bool _same_scene(Node *p_a,Node *p_b) {
+
+	if (p_a->get_name()!=p_b->get_name() || p_a->get_child_count()!=p_b->get_child_count())
+		return false;
+	if (p_a->has_meta("id")!=p_b->has_meta("id") || (p_a->has_meta("id") && !(p_a->get_meta("id")==p_b->get_meta("id"))))
+		return false;
+	List<Node::GroupInfo> ga,gb;
+	p_a->get_groups(&ga);
+	p_b->get_groups(&gb);
+	if (ga.size()!=gb.size())
+		return false;
+	List<Node::Connection> ca,cb;
+	p_a->get_signal_connection_list("renamed",&ca);
+	p_b->get_signal_connection_list("renamed",&cb);
+	if (ca.size()!=cb.size())
+		return false;
+	for(int i=0;i<p_a->get_child_count();i++) {
+		if (!_same_scene(p_a->get_child(i),p_b->get_child(i)))
+			return false;
+	}
+	return true;
+}
+
+static void _bench(const String& p_path,const String& p_name,Node *p_reference) {
+
+	uint64_t load_usec=0;
+	uint64_t instance_usec=0;
+	bool ok=true;
+
+	for(int i=0;i<LOAD_PASSES;i++) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		Ref<PackedScene> ps = ResourceLoader::load(p_path,"",true);
+		load_usec += OS::get_singleton()->get_ticks_usec()-from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		Node *n = ps.is_valid() ? ps->instance() : NULL;
+		instance_usec += OS::get_singleton()->get_ticks_usec()-from;
+
+		if (!n) {
+			ok=false;
+			break;
+		}
+		if (i==0)
+			ok=_same_scene(p_reference,n);
+		memdelete(n);
+	}
+
+	print_line(p_name+": "+itos(NODE_COUNT)+" nodes, load "+itos(load_usec/LOAD_PASSES/1000)+" msec, instance "+itos(instance_usec/LOAD_PASSES/1000)+" msec, "+(ok?"OK":"FAILED"));
+}
+
+MainLoop* test() {
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->change_dir("user://");
+	String dir = da->get_current_dir();
+	String path_v1 = dir+"/test_scene_v1.scn";
+	String path_v2 = dir+"/test_scene_v2.scn";
+
+	Node *scene = _make_scene();
+	Ref<PackedScene> ps = memnew( PackedScene );
+	ps->pack(scene);
+	ResourceSaver::save(path_v2,ps);
+
+	Ref<PackedScene> old = memnew( PackedScene );
+	old->set("_bundled",_to_version_1(ps->get("_bundled")));
+	ResourceSaver::save(path_v1,old);
+
+	_bench(path_v1,"per node records (v1)",scene);
+	_bench(path_v2,"flat tables (v2)",scene);
+
+	memdelete(scene);
+	da->remove(path_v1);
+	da->remove(path_v2);
+	memdelete(da);
+
+	return NULL;
+}
+
+}
@@ -0,0 +1,200 @@
+/*************************************************************************/
+/*  test_signal.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_signal.h"
+
+#include "os/os.h"
+#include "print_string.h"
+#include "object_type_db.h"
+
+/* Signal emission throughput, plus connections changing while a signal is being emitted */
+
+namespace TestSignal {
+
+enum {
+	EMIT_COUNT=1000000,
+	FANOUT=8
+};
+
+class SignalReceiver : public Object {
+
+	OBJ_TYPE( SignalReceiver, Object );
+protected:
+
+	static void _bind_methods() {
+
+		ObjectTypeDB::bind_method(_MD("_on_value","value"),&SignalReceiver::_on_value);
+		ObjectTypeDB::bind_method(_MD("_on_value_bound","value","index","name"),&SignalReceiver::_on_value_bound);
+		ObjectTypeDB::bind_method(_MD("_on_value_disconnect","value"),&SignalReceiver::_on_value_disconnect);
+		ObjectTypeDB::bind_method(_MD("_on_value_free","value"),&SignalReceiver::_on_value_free);
+	}
+
+public:
+
+	int calls;
+	int64_t sum;
+	Object *source;
+	Object *other;
+
+	void _on_value(int p_value) {
+
+		calls++;
+		sum+=p_value;
+	}
+
+	void _on_value_bound(int p_value,int p_index,const String& p_name) {
+
+		calls++;
+		sum+=p_value+p_index+p_name.length();
+	}
+
+	void _on_value_disconnect(int p_value) {
+
+		//disconnect both itself and the next receiver from inside the emission
+		calls++;
+		source->disconnect("value_changed",this,"_on_value_disconnect");
+		if (other)
+			source->disconnect("value_changed",other,"_on_value");
+	}
+
+	void _on_value_free(int p_value) {
+
+		calls++;
+		memdelete(source);
+	}
+
+	SignalReceiver() { calls=0; sum=0; source=NULL; other=NULL; }
+};
+
+static Object *_make_source() {
+
+	Object *source = memnew( Object );
+	source->add_user_signal(MethodInfo("value_changed",PropertyInfo(Variant::INT,"value")));
+	return source;
+}
+
+static void _report(const String& p_name,int p_connections,uint64_t p_usec,bool p_ok) {
+
+	print_line(p_name+": "+itos(EMIT_COUNT)+" emits to "+itos(p_connections)+" connections, "+itos(p_usec/1000)+" msec, "+rtos(p_usec*1000.0/(uint64_t(EMIT_COUNT)*p_connections))+" nsec per call, "+(p_ok?"OK":"FAILED"));
+}
+
+static void _emit_bench(const String& p_name,int p_connections,bool p_binds) {
+
+	Object *source = _make_source();
+	Vector<SignalReceiver*> receivers;
+
+	for(int i=0;i<p_connections;i++) {
+
+		SignalReceiver *r = memnew( SignalReceiver );
+		if (p_binds) {
+			Vector<Variant> binds;
+			binds.push_back(i);
+			binds.push_back("bound");
+			source->connect("value_changed",r,"_on_value_bound",binds);
+		} else {
+			source->connect("value_changed",r,"_on_value");
+		}
+		receivers.push_back(r);
+	}
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for(int i=0;i<EMIT_COUNT;i++) {
+
+		source->emit_signal("value_changed",i&0xFF);
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec()-from;
+
+	bool ok=true;
+	for(int i=0;i<p_connections;i++) {
+
+		ok = ok && receivers[i]->calls==EMIT_COUNT;
+	}
+
+	memdelete(source);
+	for(int i=0;i<p_connections;i++) {
+		memdelete(receivers[i]);
+	}
+
+	_report(p_name,p_connections,usec,ok);
+}
+
+static bool _check_disconnect() {
+
+	//connections removed during emission must not be called, others must be called once
+
+	Object *source = _make_source();
+	SignalReceiver *a = memnew( SignalReceiver );
+	SignalReceiver *b = memnew( SignalReceiver );
+	SignalReceiver *c = memnew( SignalReceiver );
+
+	a->source=source;
+	a->other=b;
+	source->connect("value_changed",a,"_on_value_disconnect");
+	source->connect("value_changed",b,"_on_value");
+	source->connect("value_changed",c,"_on_value");
+	source->connect("value_changed",c,"_on_value_bound",varray(1,"x"),Object::CONNECT_ONESHOT);
+
+	source->emit_signal("value_changed",1);
+	source->emit_signal("value_changed",1);
+
+	//calls to b depend on the order of the connections, it goes either before or after a
+	bool ok = a->calls==1 && b->calls<=1 && c->calls==3 && !source->is_connected("value_changed",c,"_on_value_bound");
+
+	memdelete(source);
+
+	//source freed by one of its own receivers
+	source = _make_source();
+	a->source=source;
+	a->calls=0;
+	c->calls=0;
+	source->connect("value_changed",a,"_on_value_free");
+	source->connect("value_changed",c,"_on_value");
+	source->emit_signal("value_changed",1);
+
+	ok = ok && a->calls==1 && c->calls<=1;
+
+	memdelete(a);
+	memdelete(b);
+	memdelete(c);
+
+	return ok;
+}
+
+MainLoop* test() {
+
+	ObjectTypeDB::register_type<SignalReceiver>();
+
+	_emit_bench("single",1,false);
+	_emit_bench("fanout",FANOUT,false);
+	_emit_bench("binds",1,true);
+	print_line(String("changes during emission ")+(_check_disconnect()?"OK":"FAILED"));
+
+	return NULL;
+}
+
+}
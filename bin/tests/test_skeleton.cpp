@@ -0,0 +1,214 @@
+/*************************************************************************/
+/*  test_skeleton.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_skeleton.h"
+
+#include "os/os.h"
+#include "print_string.h"
+#include "message_queue.h"
+#include "servers/visual_server.h"
+#include "scene/main/scene_main_loop.h"
+#include "scene/main/viewport.h"
+#include "scene/3d/skeleton.h"
+
+/* Skeleton update cost when all, some or a single bone are posed each frame, and per bone vs bulk server uploads */
+
+namespace TestSkeleton {
+
+enum {
+	SKELETONS=100,
+	BONES=60,
+	LIMB=10,
+	FRAMES=300
+};
+
+enum Scenario {
+	POSE_ALL,
+	POSE_LIMB,
+	POSE_BONE,
+	POSE_MAX
+};
+
+static const char *scenario_names[POSE_MAX]={
+	"all bones posed",
+	"one limb posed",
+	"one bone posed"
+};
+
+class TestMainLoop : public SceneMainLoop {
+
+	Vector<Skeleton*> skeletons;
+	int scenario;
+	int frame;
+	uint64_t update_usec;
+
+	static int _bone_parent(int p_bone) {
+
+		//a spine of LIMB bones, the other limbs hang from its top
+		if (p_bone==0)
+			return -1;
+		if (p_bone<LIMB || p_bone%LIMB)
+			return p_bone-1;
+		return LIMB-1;
+	}
+
+	void _pose(int p_frame) {
+
+		int from=0;
+		if (scenario==POSE_LIMB)
+			from=BONES-LIMB;
+		else if (scenario==POSE_BONE)
+			from=BONES-1;
+
+		for(int i=0;i<skeletons.size();i++) {
+
+			for(int j=from;j<BONES;j++) {
+
+				Vector3 axis = Vector3(Math::sin(j*0.7),Math::cos(j*1.3),0.5).normalized();
+				skeletons[i]->set_bone_pose(j,Transform(Matrix3(axis,0.5*Math::sin(p_frame*0.05+i+j)),Vector3()));
+			}
+		}
+	}
+
+	bool _check() {
+
+		//what partial updates left must match a full recompute, on the node and on the server
+		Vector<Transform> partial;
+		for(int i=0;i<skeletons.size();i++) {
+			for(int j=0;j<BONES;j++)
+				partial.push_back(skeletons[i]->get_bone_transform(j));
+			skeletons[i]->set_bone_rest(0,skeletons[i]->get_bone_rest(0));
+		}
+
+		MessageQueue::get_singleton()->flush();
+
+		VisualServer *vs=VisualServer::get_singleton();
+		bool ok=true;
+
+		for(int i=0;i<skeletons.size();i++) {
+			for(int j=0;j<BONES;j++) {
+
+				Transform full=skeletons[i]->get_bone_transform(j);
+				ok = ok && full==partial[i*BONES+j];
+				ok = ok && full==vs->skeleton_bone_get_transform(skeletons[i]->get_skeleton(),j);
+			}
+		}
+
+		return ok;
+	}
+
+	void _bench_server() {
+
+		VisualServer *vs=VisualServer::get_singleton();
+
+		Vector<float> transforms;
+		transforms.resize(BONES*12);
+		for(int i=0;i<BONES*12;i++)
+			transforms[i]=(i%12)%5==0 ? 1.0 : 0.0; //identity, row major 3x4
+		const float *ptr=transforms.ptr();
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+		for(int f=0;f<FRAMES;f++) {
+			for(int i=0;i<skeletons.size();i++) {
+				for(int j=0;j<BONES;j++)
+					vs->skeleton_bone_set_transform(skeletons[i]->get_skeleton(),j,Transform());
+			}
+		}
+
+		uint64_t per_bone = OS::get_singleton()->get_ticks_usec()-from;
+		from = OS::get_singleton()->get_ticks_usec();
+
+		for(int f=0;f<FRAMES;f++) {
+			for(int i=0;i<skeletons.size();i++)
+				vs->skeleton_set_bone_transforms(skeletons[i]->get_skeleton(),ptr,BONES);
+		}
+
+		uint64_t bulk = OS::get_singleton()->get_ticks_usec()-from;
+
+		print_line("server upload, per bone: "+rtos(per_bone/float(FRAMES))+" usec, bulk: "+rtos(bulk/float(FRAMES))+" usec per frame");
+	}
+
+public:
+
+	virtual void init() {
+
+		SceneMainLoop::init();
+
+		for(int i=0;i<SKELETONS;i++) {
+
+			Skeleton *skeleton = memnew( Skeleton );
+			skeleton->set_name("skeleton"+itos(i));
+			for(int j=0;j<BONES;j++) {
+				skeleton->add_bone("bone"+itos(j));
+				skeleton->set_bone_parent(j,_bone_parent(j));
+				skeleton->set_bone_rest(j,Transform(Matrix3(),Vector3(0,0.1,0)));
+			}
+
+			get_root()->add_child(skeleton);
+			skeletons.push_back(skeleton);
+		}
+
+		scenario=POSE_ALL;
+		frame=0;
+		update_usec=0;
+	}
+
+	virtual bool idle(float p_time) {
+
+		_pose(frame);
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		MessageQueue::get_singleton()->flush(); //skeletons update here
+		update_usec+=OS::get_singleton()->get_ticks_usec()-from;
+
+		bool quit = SceneMainLoop::idle(p_time);
+
+		if (++frame<FRAMES)
+			return quit;
+
+		print_line(itos(SKELETONS)+" skeletons of "+itos(BONES)+" bones, "+scenario_names[scenario]+": "+rtos(update_usec/float(FRAMES))+" usec per frame");
+
+		frame=0;
+		update_usec=0;
+		if (++scenario<POSE_MAX)
+			return quit;
+
+		print_line(String("skeleton update ")+(_check()?"OK":"FAILED"));
+		_bench_server();
+		return true;
+	}
+
+};
+
+MainLoop* test() {
+
+	return memnew( TestMainLoop );
+}
+
+}
@@ -0,0 +1,183 @@
+/*************************************************************************/
+/*  test_transform.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_transform.h"
+
+#include "os/os.h"
+#include "print_string.h"
+#include "scene/main/scene_main_loop.h"
+#include "scene/main/viewport.h"
+#include "scene/3d/spatial.h"
+
+/* Cost of moving the root of a deep chain and of a wide fan several times per frame, including the transform notifications */
+
+namespace TestTransform {
+
+enum {
+	CHAIN_DEPTH=1000,
+	FAN_WIDTH=10000,
+	MOVES_PER_FRAME=4,
+	FRAME_COUNT=200
+};
+
+static int frame=0; //notifications are stamped with it
+
+class TransformNode : public Spatial {
+
+	OBJ_TYPE( TransformNode, Spatial );
+public:
+
+	int notify_count;
+	int notified_frame;
+	bool order_ok;
+
+	void _notification(int p_what) {
+
+		if (p_what!=NOTIFICATION_TRANSFORM_CHANGED)
+			return;
+
+		//what a visual instance does with it
+		get_global_transform();
+
+		notify_count++;
+		notified_frame=frame;
+
+		TransformNode *parent = get_parent() ? get_parent()->cast_to<TransformNode>() : NULL;
+		if (parent && parent->notified_frame!=frame)
+			order_ok=false; //parents must hear about a change before their children
+	}
+
+	TransformNode() { notify_count=0; notified_frame=-1; order_ok=true; }
+};
+
+class TestMainLoop : public SceneMainLoop {
+
+	Vector<TransformNode*> chain;
+	Vector<TransformNode*> fan;
+	TransformNode *fan_root;
+	uint64_t move_usec[2];
+	uint64_t flush_usec[2];
+	bool values_ok;
+
+	TransformNode *_make_node(Node *p_parent,const Vector3& p_translation) {
+
+		TransformNode *n = memnew( TransformNode );
+		n->set_translation(p_translation);
+		p_parent->add_child(n);
+		return n;
+	}
+
+	bool _check(const Vector<TransformNode*>& p_nodes) {
+
+		for(int i=0;i<p_nodes.size();i++) {
+
+			//once when entering, then once per frame moved
+			if (p_nodes[i]->notify_count!=FRAME_COUNT+1 || !p_nodes[i]->order_ok)
+				return false;
+		}
+
+		return true;
+	}
+
+	void _report(const String& p_name,int p_pass,int p_node_count) {
+
+		uint64_t count=uint64_t(p_node_count)*FRAME_COUNT;
+		print_line(p_name+": "+itos(p_node_count)+" nodes, "+itos(MOVES_PER_FRAME)+" moves per frame, moves "+rtos(move_usec[p_pass]*1000.0/count)+" nsec per node, flush "+rtos(flush_usec[p_pass]*1000.0/count)+" nsec per node");
+	}
+
+public:
+
+	virtual void init() {
+
+		SceneMainLoop::init();
+
+		frame=0;
+		values_ok=true;
+		for(int i=0;i<2;i++) {
+			move_usec[i]=0;
+			flush_usec[i]=0;
+		}
+
+		Node *parent=get_root();
+		for(int i=0;i<CHAIN_DEPTH;i++) {
+
+			TransformNode *n = _make_node(parent,Vector3(0,1,0));
+			chain.push_back(n);
+			parent=n;
+		}
+
+		fan_root = _make_node(get_root(),Vector3());
+		fan.push_back(fan_root);
+		for(int i=0;i<FAN_WIDTH;i++) {
+
+			fan.push_back( _make_node(fan_root,Vector3(0,i,0)) );
+		}
+	}
+
+	virtual bool idle(float p_time) {
+
+		frame++;
+		int pass=(frame-1)/FRAME_COUNT;
+		Spatial *moved = pass==0 ? chain[0] : fan_root;
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		for(int i=0;i<MOVES_PER_FRAME;i++) {
+
+			moved->set_translation(Vector3(frame,i,0));
+		}
+		uint64_t mid = OS::get_singleton()->get_ticks_usec();
+		bool quit = SceneMainLoop::idle(p_time);
+		uint64_t to = OS::get_singleton()->get_ticks_usec();
+
+		move_usec[pass]+=mid-from;
+		flush_usec[pass]+=to-mid;
+
+		//last move wins, all the way down
+		Vector3 expected = pass==0 ? Vector3(frame,MOVES_PER_FRAME-1+CHAIN_DEPTH-1,0) : Vector3(frame,MOVES_PER_FRAME-1+FAN_WIDTH-1,0);
+		Spatial *tip = pass==0 ? chain[CHAIN_DEPTH-1] : fan[FAN_WIDTH];
+		if (tip->get_global_transform().origin.distance_to(expected)>0.001)
+			values_ok=false;
+
+		if (frame<FRAME_COUNT*2)
+			return quit;
+
+		_report("chain",0,chain.size());
+		_report("fan",1,fan.size());
+		print_line(String("transform notifications ")+(_check(chain) && _check(fan) && values_ok?"OK":"FAILED"));
+		return true;
+	}
+
+};
+
+MainLoop* test() {
+
+	ObjectTypeDB::register_type<TransformNode>();
+	return memnew( TestMainLoop );
+}
+
+}
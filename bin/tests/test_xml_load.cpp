@@ -0,0 +1,206 @@
+/*************************************************************************/
+/*  test_xml_load.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_xml_load.h"
+
+#include "io/resource_loader.h"
+#include "io/resource_saver.h"
+#include "io/xml_parser.h"
+#include "os/dir_access.h"
+#include "os/file_access.h"
+#include "os/os.h"
+#include "print_string.h"
+#include "scene/resources/packed_scene.h"
+
+/* Load time of a big text scene, through the resource loader and through a plain XMLParser pass */
+
+namespace TestXMLLoad {
+
+enum {
+	NODE_COUNT=10000,
+	LOAD_PASSES=3
+};
+
+static Node *_make_scene() {
+
+	Node *root = memnew( Node );
+	root->set_name("root");
+
+	for(int i=1;i<NODE_COUNT;i++) {
+
+		Node *n = memnew( Node );
+		n->set_name("node_"+itos(i));
+
+		Transform t;
+		t.basis.rotate(Vector3(0,1,0),i*0.01);
+		t.origin=Vector3(i*0.5,-i*0.25,i);
+		n->set_meta("transform",t);
+		n->set_meta("label","node <"+itos(i)+"> & \"friends\"");
+		n->set_meta("color",Color(i%7/7.0,0.5,1,0.25));
+
+		DVector<Vector3> points;
+		DVector<real_t> weights;
+		DVector<int> ids;
+		for(int j=0;j<32;j++) {
+			points.push_back(Vector3(j*1.5,i*0.001,-j));
+			if (j<16) {
+				weights.push_back(j/16.0+i);
+				ids.push_back(i*j-100);
+			}
+		}
+		n->set_meta("points",points);
+		n->set_meta("weights",weights);
+		n->set_meta("ids",ids);
+
+		root->add_child(n);
+		n->set_owner(root);
+	}
+
+	return root;
+}
+
+//values go through text, so reals are only compared approximately
+static bool _same_reals(const real_t *p_a,const real_t *p_b,int p_count) {
+
+	for(int i=0;i<p_count;i++) {
+		if (Math::abs(p_a[i]-p_b[i])>CMP_EPSILON*MAX(1.0,Math::abs(p_a[i])))
+			return false;
+	}
+	return true;
+}
+
+static bool _same_node(Node *p_a,Node *p_b) {
+
+	if (p_a->get_name()!=p_b->get_name() || p_a->has_meta("transform")!=p_b->has_meta("transform"))
+		return false;
+	if (!p_a->has_meta("transform"))
+		return true;
+
+	Transform ta=p_a->get_meta("transform");
+	Transform tb=p_b->get_meta("transform");
+	Color ca=p_a->get_meta("color");
+	Color cb=p_b->get_meta("color");
+	if (!_same_reals(&ta.basis[0][0],&tb.basis[0][0],9) || !_same_reals(&ta.origin.x,&tb.origin.x,3) || !_same_reals(&ca.r,&cb.r,4))
+		return false;
+	if (String(p_a->get_meta("label"))!=String(p_b->get_meta("label")))
+		return false;
+
+	DVector<Vector3> pa=p_a->get_meta("points");
+	DVector<Vector3> pb=p_b->get_meta("points");
+	DVector<real_t> wa=p_a->get_meta("weights");
+	DVector<real_t> wb=p_b->get_meta("weights");
+	DVector<int> ia=p_a->get_meta("ids");
+	DVector<int> ib=p_b->get_meta("ids");
+	if (pa.size()!=pb.size() || wa.size()!=wb.size() || ia.size()!=ib.size())
+		return false;
+	if (!_same_reals(&pa.read()[0].x,&pb.read()[0].x,pa.size()*3) || !_same_reals(&wa.read()[0],&wb.read()[0],wa.size()))
+		return false;
+	for(int i=0;i<ia.size();i++) {
+		if (ia[i]!=ib[i])
+			return false;
+	}
+	return true;
+}
+
+static bool _same_scene(Node *p_a,Node *p_b) {
+
+	if (!_same_node(p_a,p_b) || p_a->get_child_count()!=p_b->get_child_count())
+		return false;
+	for(int i=0;i<p_a->get_child_count();i++) {
+		if (!_same_node(p_a->get_child(i),p_b->get_child(i)))
+			return false;
+	}
+	return true;
+}
+
+MainLoop* test() {
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	da->change_dir("user://");
+	String dir = da->get_current_dir();
+	String path = dir+"/test_xml_load.xscn";
+
+	Node *scene = _make_scene();
+	Ref<PackedScene> ps = memnew( PackedScene );
+	ps->pack(scene);
+	memdelete(scene);
+	ResourceSaver::save(path,ps);
+	ps=Ref<PackedScene>();
+
+	FileAccess *f = FileAccess::open(path,FileAccess::READ);
+	int file_size = f ? f->get_len() : 0;
+	if (f)
+		memdelete(f);
+
+	uint64_t load_usec=0;
+	Ref<PackedScene> loaded;
+	for(int i=0;i<LOAD_PASSES;i++) {
+
+		loaded=Ref<PackedScene>();
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		loaded = ResourceLoader::load(path,"",true);
+		load_usec += OS::get_singleton()->get_ticks_usec()-from;
+	}
+
+	bool ok=false;
+	if (loaded.is_valid()) {
+		Node *n = loaded->instance();
+		Node *reference = _make_scene();
+		ok = n && _same_scene(reference,n);
+		if (n)
+			memdelete(n);
+		memdelete(reference);
+	}
+
+	print_line("resource loader: "+itos(file_size/1024)+" kb, load "+itos(load_usec/LOAD_PASSES/1000)+" msec, "+(ok?"OK":"FAILED"));
+
+	uint64_t parse_usec=0;
+	int node_count=0;
+	for(int i=0;i<LOAD_PASSES;i++) {
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		Ref<XMLParser> parser = memnew( XMLParser );
+		node_count=0;
+		if (parser->open(path)==OK) {
+			while(parser->read()==OK) {
+				if (parser->get_node_type()==XMLParser::NODE_ELEMENT)
+					node_count+=1+parser->get_attribute_count();
+			}
+		}
+		parse_usec += OS::get_singleton()->get_ticks_usec()-from;
+	}
+
+	print_line("xml parser: "+itos(node_count)+" elements and attributes, "+itos(parse_usec/LOAD_PASSES/1000)+" msec");
+
+	da->remove(path);
+	memdelete(da);
+
+	return NULL;
+}
+
+}
@@ -54,6 +54,28 @@ bool _ResourceLoader::has(const String &p_path) {
 	return ResourceCache::has(local_path);
 };
 
+Error _ResourceLoader::load_threaded_request(const String& p_path,const String& p_type_hint) {
+
+	return ResourceLoader::load_threaded_request(p_path,p_type_hint);
+}
+
+int _ResourceLoader::load_threaded_get_status(const String& p_path) {
+
+	return ResourceLoader::load_threaded_get_status(p_path);
+}
+
+float _ResourceLoader::load_threaded_get_progress(const String& p_path) {
+
+	float progress;
+	ResourceLoader::load_threaded_get_status(p_path,&progress);
+	return progress;
+}
+
+RES _ResourceLoader::load_threaded_get(const String& p_path) {
+
+	return ResourceLoader::load_threaded_get(p_path);
+}
+
 void _ResourceLoader::_bind_methods() {
 
 
@@ -63,6 +85,15 @@ void _ResourceLoader::_bind_methods() {
 	ObjectTypeDB::bind_method(_MD("set_abort_on_missing_resources","abort"),&_ResourceLoader::set_abort_on_missing_resources);
 	ObjectTypeDB::bind_method(_MD("get_dependencies"),&_ResourceLoader::get_dependencies);
 	ObjectTypeDB::bind_method(_MD("has"),&_ResourceLoader::has);
+	ObjectTypeDB::bind_method(_MD("load_threaded_request","path","type_hint"),&_ResourceLoader::load_threaded_request,DEFVAL(""));
+	ObjectTypeDB::bind_method(_MD("load_threaded_get_status","path"),&_ResourceLoader::load_threaded_get_status);
+	ObjectTypeDB::bind_method(_MD("load_threaded_get_progress","path"),&_ResourceLoader::load_threaded_get_progress);
+	ObjectTypeDB::bind_method(_MD("load_threaded_get:Resource","path"),&_ResourceLoader::load_threaded_get);
+
+	BIND_CONSTANT( THREAD_LOAD_INVALID_RESOURCE );
+	BIND_CONSTANT( THREAD_LOAD_IN_PROGRESS );
+	BIND_CONSTANT( THREAD_LOAD_FAILED );
+	BIND_CONSTANT( THREAD_LOAD_LOADED );
 }
 
 _ResourceLoader::_ResourceLoader() {
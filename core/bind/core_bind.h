@@ -18,6 +18,12 @@ protected:
 	static _ResourceLoader *singleton;
 public:
 
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE=ResourceLoader::THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS=ResourceLoader::THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED=ResourceLoader::THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED=ResourceLoader::THREAD_LOAD_LOADED
+	};
 
 	static _ResourceLoader *get_singleton() { return singleton; }
 	Ref<ResourceInteractiveLoader> load_interactive(const String& p_path,const String& p_type_hint="");
@@ -27,6 +33,11 @@ public:
 	StringArray get_dependencies(const String& p_path);
 	bool has(const String& p_path);
 
+	Error load_threaded_request(const String& p_path,const String& p_type_hint="");
+	int load_threaded_get_status(const String& p_path);
+	float load_threaded_get_progress(const String& p_path);
+	RES load_threaded_get(const String& p_path);
+
 	_ResourceLoader();
 };
 
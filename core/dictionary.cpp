@@ -53,8 +53,8 @@ void Dictionary::get_key_list( List<Variant> *p_keys) const {
 
 void Dictionary::_copy_on_write() const {
 
-	//make a copy of what we have
-	if (_p->shared)
+	//make a copy of what we have, unless nobody else has it
+	if (_p->shared || _p->refcount.get()==1)
 		return;
 
 	DictionaryPrivate *p = memnew(DictionaryPrivate);
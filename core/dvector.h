@@ -263,6 +263,22 @@ public:
 	}
 
 	bool is_locked() const { return mem.is_locked(); }
+
+	/** Use external memory (ie, a file mapping) until resized. p_block must be writable and hold an int
+	 * (used as reference count) followed by p_size elements, p_release(p_release_ud) is called once it's unused.
+	 * Returns false if the memory pool can't handle external memory.
+	 */
+	bool alias(void *p_block,int p_size,void (*p_release)(void*),void *p_release_ud) {
+
+		MID new_mem = Memory::alloc_dynamic_external(p_block,p_size*sizeof(T)+sizeof(int),p_release,p_release_ud,"DVector alias");
+		if (!new_mem.is_valid())
+			return false;
+
+		unreference();
+		*(int*)p_block=1;
+		mem=new_mem;
+		return true;
+	}
 	
 	inline const T operator[](int p_index) const;
 
@@ -29,6 +29,8 @@
 #include "compression.h"
 
 #include "fastlz.h"
+#include "lz4.h"
+#include "zstd/zstd.h"
 #include "zlib.h"
 #include "zip_io.h"
 #include "os/copymem.h"
@@ -69,6 +71,16 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,M
 			return aout;
 
 		} break;
+		case MODE_LZ4: {
+
+			return lz4_compress(p_src,p_src_size,p_dst);
+		} break;
+		case MODE_ZSTD: {
+
+			size_t ret = ZSTD_compress(p_dst,ZSTD_compressBound(p_src_size),p_src,p_src_size,3);
+			ERR_FAIL_COND_V(ZSTD_isError(ret),-1);
+			return ret;
+		} break;
 	}
 
 	ERR_FAIL_V(-1);
@@ -99,6 +111,14 @@ int Compression::get_max_compressed_buffer_size(int p_src_size,Mode p_mode){
 			deflateEnd(&strm);
 			return aout;
 		} break;
+		case MODE_LZ4: {
+
+			return lz4_compress_bound(p_src_size);
+		} break;
+		case MODE_ZSTD: {
+
+			return ZSTD_compressBound(p_src_size);
+		} break;
 	}
 
 	ERR_FAIL_V(-1);
@@ -142,6 +162,18 @@ void Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *
 			ERR_FAIL_COND(err!=Z_STREAM_END);
 			return;
 		} break;
+		case MODE_LZ4: {
+
+			int ret = lz4_decompress(p_src,p_src_size,p_dst,p_dst_max_size);
+			ERR_FAIL_COND(ret<0);
+			return;
+		} break;
+		case MODE_ZSTD: {
+
+			size_t ret = ZSTD_decompress(p_dst,p_dst_max_size,p_src,p_src_size);
+			ERR_FAIL_COND(ZSTD_isError(ret));
+			return;
+		} break;
 	}
 
 	ERR_FAIL();
@@ -37,7 +37,9 @@ public:
 
 	enum Mode {
 		MODE_FASTLZ,
-		MODE_DEFLATE
+		MODE_DEFLATE,
+		MODE_LZ4,
+		MODE_ZSTD
 	};
 
 
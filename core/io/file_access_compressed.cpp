@@ -28,6 +28,8 @@
 /*************************************************************************/
 #include "file_access_compressed.h"
 #include "print_string.h"
+#include "os/os.h"
+#include "file_io_queue.h"
 void FileAccessCompressed::configure(const String& p_magic, Compression::Mode p_mode, int p_block_size) {
 
 	magic=p_magic.ascii().get_data();
@@ -57,6 +59,85 @@ if (write_max > write_buffer_size) {\
 }
 
 
+void FileAccessCompressed::_decompress_block(int p_block,uint8_t *p_dst,uint8_t *p_comp) const {
+
+	Compression::decompress(p_dst,read_blocks.size()==1?read_total:block_size,p_comp,read_blocks[p_block].csize,cmode);
+}
+
+void FileAccessCompressed::_read_ahead_done(void *p_userdata,int p_request,int p_read) {
+
+	FileAccessCompressed *fac = (FileAccessCompressed*)p_userdata;
+	if (p_read==fac->read_blocks[fac->ahead_block].csize)
+		fac->_decompress_block(fac->ahead_block,fac->ahead_ptr,fac->ahead_comp_ptr);
+}
+
+void FileAccessCompressed::_wait_read_ahead() const {
+
+	if (ahead_block==-1)
+		return;
+
+	int read = ahead_request==-1 ? -1 : FileIOQueue::get_singleton()->wait(ahead_request);
+	if (read!=read_blocks[ahead_block].csize)
+		ahead_block=-1; //short read, fetch it again
+	ahead_request=-1;
+}
+
+void FileAccessCompressed::_fetch_block(int p_block) const {
+
+	bool fetched=false;
+
+	_wait_read_ahead();
+	if (ahead_block==p_block) {
+		SWAP(read_ptr,ahead_ptr);
+		fetched=true;
+	}
+	ahead_block=-1;
+
+	if (!fetched) {
+		f->seek(read_blocks[p_block].offset);
+		f->get_buffer(comp_buffer.ptr(),read_blocks[p_block].csize);
+		_decompress_block(p_block,read_ptr,comp_buffer.ptr());
+	}
+
+	read_block=p_block;
+	read_block_size=read_block==read_block_count-1?read_total%block_size:block_size;
+
+	if (read_ahead && p_block+1<read_block_count) {
+
+		ahead_block=p_block+1;
+		ahead_request=f->read_async(read_blocks[ahead_block].offset,read_blocks[ahead_block].csize,ahead_comp_ptr,_read_ahead_done,(void*)this);
+	}
+}
+
+void FileAccessCompressed::_stop_read_ahead() {
+
+	if (!read_ahead)
+		return;
+
+	_wait_read_ahead();
+	ahead_block=-1;
+	read_ahead=false;
+	ahead_buffer.clear();
+	ahead_comp_buffer.clear();
+}
+
+void FileAccessCompressed::_compress_func(void *p_userdata) {
+
+	CompressJob *job = (CompressJob*)p_userdata;
+	const FileAccessCompressed *fac = job->fac;
+
+	for(int i=job->first;i<job->count;i+=job->step) {
+
+		int bl = i==(job->count-1) ? fac->write_max % fac->block_size : fac->block_size;
+		const uint8_t *bp = &fac->write_ptr[i*fac->block_size];
+
+		Vector<uint8_t> &cblock = job->blocks[i];
+		cblock.resize(Compression::get_max_compressed_buffer_size(bl,fac->cmode));
+		int s = Compression::compress(cblock.ptr(),bp,bl,fac->cmode);
+		cblock.resize(s);
+	}
+}
+
 Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 
 
@@ -82,14 +163,20 @@ Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
 	read_ptr=buffer.ptr();
-	f->get_buffer(comp_buffer.ptr(),read_blocks[0].csize);
 	at_end=false;
 	read_eof=false;
 	read_block_count=bc;
-	read_block_size=read_blocks.size()==1?read_total:block_size;
 
-	Compression::decompress(buffer.ptr(),read_block_size,comp_buffer.ptr(),read_blocks[0].csize,cmode);
-	read_block=0;
+	if (use_threads && bc>1 && read_total>=READ_AHEAD_MIN_SIZE && FileIOQueue::get_singleton()) {
+
+		ahead_buffer.resize(block_size);
+		ahead_comp_buffer.resize(max_bs);
+		ahead_ptr=ahead_buffer.ptr();
+		ahead_comp_ptr=ahead_comp_buffer.ptr();
+		read_ahead=true;
+	}
+
+	_fetch_block(0);
 	read_pos=0;
 
 	return OK;
@@ -128,6 +215,7 @@ Error FileAccessCompressed::_open(const String& p_path, int p_mode_flags){
 		//don't store anything else unless it's done saving!
 	} else {
 
+		writing=false;
 		char rmagic[5];
 		f->get_buffer((uint8_t*)rmagic,4);
 		rmagic[4]=0;
@@ -165,23 +253,47 @@ void FileAccessCompressed::close(){
 		}
 
 
-		Vector<int> block_sizes;
-		for(int i=0;i<bc;i++) {
+		//blocks are independent, compress them in parallel
+		Vector< Vector<uint8_t> > cblocks;
+		cblocks.resize(bc);
+
+		int threads = use_threads ? MIN(OS::get_singleton()->get_processor_count(),bc) : 1;
+		Vector<CompressJob> jobs;
+		jobs.resize(threads);
+		Vector<Thread*> workers;
+		for(int i=0;i<threads;i++) {
 
-			int bl = i==(bc-1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i*block_size];
+			jobs[i].fac=this;
+			jobs[i].blocks=cblocks.ptr();
+			jobs[i].count=bc;
+			jobs[i].first=i;
+			jobs[i].step=threads;
+		}
+
+		for(int i=1;i<threads;i++) {
+
+			Thread *t = Thread::create(_compress_func,&jobs[i]);
+			if (!t)
+				break;
+			workers.push_back(t);
+		}
 
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl,cmode));
-			int s = Compression::compress(cblock.ptr(),bp,bl,cmode);
+		//jobs that could not get a thread run here
+		_compress_func(&jobs[0]);
+		for(int i=workers.size()+1;i<threads;i++)
+			_compress_func(&jobs[i]);
 
-			f->store_buffer(cblock.ptr(),s);
-			block_sizes.push_back(s);
+		for(int i=0;i<workers.size();i++) {
+			Thread::wait_to_finish(workers[i]);
+			memdelete(workers[i]);
 		}
 
+		for(int i=0;i<bc;i++)
+			f->store_buffer(cblocks[i].ptr(),cblocks[i].size());
+
 		f->seek(16); //ok write block sizes
 		for(int i=0;i<bc;i++)
-			f->store_32(block_sizes[i]);
+			f->store_32(cblocks[i].size());
 		f->seek_end();
 		f->store_buffer((const uint8_t*)mgc.get_data(),mgc.length()); //magic at the end too
 
@@ -189,7 +301,7 @@ void FileAccessCompressed::close(){
 
 	} else {
 
-
+		_stop_read_ahead();
 		comp_buffer.clear();
 		buffer.clear();
 		read_blocks.clear();
@@ -224,14 +336,12 @@ void FileAccessCompressed::seek(size_t p_position){
 			int block_idx = p_position/block_size;
 			if (block_idx!=read_block) {
 
-				read_block=block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptr(),read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptr(),read_blocks.size()==1?read_total:block_size,comp_buffer.ptr(),read_blocks[read_block].csize,cmode);
-				read_block_size=read_block==read_block_count-1?read_total%block_size:block_size;
+				_fetch_block(block_idx);
 			}
 
 			read_pos=p_position%block_size;
+			at_end=false;
+			read_eof=false;
 		}
 	}
 }
@@ -298,17 +408,13 @@ uint8_t FileAccessCompressed::get_8() const{
 
 	read_pos++;
 	if (read_pos>=read_block_size) {
-		read_block++;
 
-		if (read_block<read_block_count) {
+		if (read_block+1<read_block_count) {
 			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptr(),read_blocks[read_block].csize);
-			Compression::decompress(buffer.ptr(),read_blocks.size()==1?read_total:block_size,comp_buffer.ptr(),read_blocks[read_block].csize,cmode);
-			read_block_size=read_block==read_block_count-1?read_total%block_size:block_size;
+			_fetch_block(read_block+1);
 			read_pos=0;
 
 		} else {
-			read_block--;
 			at_end=true;
 			ret =0;
 		}
@@ -328,27 +434,26 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const{
 	}
 
 
-	for(int i=0;i<p_length;i++) {
+	int read=0;
+	while(read<p_length) {
 
+		int to_copy = MIN(p_length-read,read_block_size-read_pos);
+		copymem(&p_dst[read],&read_ptr[read_pos],to_copy);
+		read+=to_copy;
+		read_pos+=to_copy;
 
-		p_dst[i]=read_ptr[read_pos];
-		read_pos++;
 		if (read_pos>=read_block_size) {
-			read_block++;
 
-			if (read_block<read_block_count) {
+			if (read_block+1<read_block_count) {
 				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptr(),read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptr(),read_blocks.size()==1?read_total:block_size,comp_buffer.ptr(),read_blocks[read_block].csize,cmode);
-				read_block_size=read_block==read_block_count-1?read_total%block_size:block_size;
+				_fetch_block(read_block+1);
 				read_pos=0;
 
 			} else {
-				read_block--;
 				at_end=true;
-				if (i<p_length-1)
-				 read_eof=true;
-				return i;
+				if (read<p_length)
+					read_eof=true;
+				return read;
 
 			}
 		}
@@ -374,6 +479,16 @@ void FileAccessCompressed::store_8(uint8_t p_dest){
 
 }
 
+void FileAccessCompressed::store_buffer(const uint8_t *p_src,int p_length){
+
+	ERR_FAIL_COND(!f);
+	ERR_FAIL_COND(!writing);
+
+	WRITE_FIT(p_length);
+	copymem(&write_ptr[write_pos],p_src,p_length);
+	write_pos+=p_length;
+}
+
 bool FileAccessCompressed::file_exists(const String& p_name){
 
 	FileAccess *fa = FileAccess::open(p_name,FileAccess::READ);
@@ -410,6 +525,12 @@ FileAccessCompressed::FileAccessCompressed() {
 	read_block_count=0;
 	read_block_size=0;
 	read_pos=0;
+	read_ahead=false;
+	ahead_request=-1;
+	ahead_ptr=NULL;
+	ahead_comp_ptr=NULL;
+	ahead_block=-1;
+	use_threads=true;
 
 }
 
@@ -31,6 +31,7 @@
 
 #include "io/compression.h"
 #include "os/file_access.h"
+#include "os/thread.h"
 
 class FileAccessCompressed : public FileAccess {
 
@@ -50,7 +51,7 @@ class FileAccessCompressed : public FileAccess {
 	};
 
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr;
+	mutable uint8_t *read_ptr;
 	mutable int read_block;
 	int read_block_count;
 	mutable int read_block_size;
@@ -58,15 +59,44 @@ class FileAccessCompressed : public FileAccess {
 	Vector<ReadBlock> read_blocks;
 	int read_total;
 
+	//the block after the current one is read and decompressed by the I/O queue while reading
+	bool read_ahead;
+	Vector<uint8_t> ahead_buffer;
+	Vector<uint8_t> ahead_comp_buffer;
+	mutable uint8_t *ahead_ptr;
+	uint8_t *ahead_comp_ptr;
+	mutable int ahead_block;
+	mutable int ahead_request;
+
+	struct CompressJob {
+
+		const FileAccessCompressed *fac;
+		Vector<uint8_t> *blocks;
+		int count;
+		int first;
+		int step;
+	};
 
-
+	bool use_threads;
 
 	String magic;
 	mutable Vector<uint8_t> buffer;
 	FileAccess *f;
+
+	void _decompress_block(int p_block,uint8_t *p_dst,uint8_t *p_comp) const;
+	void _fetch_block(int p_block) const;
+	void _wait_read_ahead() const;
+	void _stop_read_ahead();
+	static void _read_ahead_done(void *p_userdata,int p_request,int p_read);
+	static void _compress_func(void *p_userdata);
 public:
 
+	enum {
+		READ_AHEAD_MIN_SIZE=262144
+	};
+
 	void configure(const String& p_magic, Compression::Mode p_mode=Compression::MODE_FASTLZ, int p_block_size=4096);
+	void set_use_threads(bool p_enable) { use_threads=p_enable; }
 
 	Error open_after_magic(FileAccess *p_base);
 
@@ -87,6 +117,7 @@ public:
 	virtual Error get_error() const; ///< get last error
 
 	virtual void store_8(uint8_t p_dest); ///< store a byte
+	virtual void store_buffer(const uint8_t *p_src,int p_length); ///< store an array of bytes
 
 	virtual bool file_exists(const String& p_name); ///< return true if a file exists
 
@@ -158,6 +158,19 @@ int FileAccessMemory::get_buffer(uint8_t *p_dst,int p_length) const {
 	return read;
 };
 
+int FileAccessMemory::read_at(size_t p_offset,uint8_t *p_dst,int p_length) const {
+
+	ERR_FAIL_COND_V(!data, -1);
+
+	if (p_offset>=(size_t)length)
+		return 0;
+
+	int read = MIN(p_length, int(length-p_offset));
+	copymem(p_dst, &data[p_offset], read);
+
+	return read;
+}
+
 Error FileAccessMemory::get_error() const {
 
 	return pos >= length ? ERR_FILE_EOF : OK;
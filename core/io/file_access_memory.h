@@ -58,6 +58,8 @@ public:
 	virtual uint8_t get_8() const; ///< get a byte
 
 	virtual int get_buffer(uint8_t *p_dst,int p_length) const; ///< get an array of bytes
+	virtual int read_at(size_t p_offset,uint8_t *p_dst,int p_length) const;
+	virtual bool is_read_at_concurrent() const { return true; }
 
 	virtual Error get_error() const; ///< get last error
 
@@ -34,46 +34,52 @@
 
 
 
-#define DEBUG_PRINT(m_p) print_line(m_p)
+//#define DEBUG_PRINT(m_p) print_line(m_p)
 //#define DEBUG_TIME(m_what) printf("MS: %s - %lli\n",m_what,OS::get_singleton()->get_ticks_usec());
-//#define DEBUG_PRINT(m_p)
+#define DEBUG_PRINT(m_p)
 #define DEBUG_TIME(m_what)
 
 
-void FileAccessNetworkClient::lock_mutex() {
+void FileAccessNetworkClient::_put_32(Vector<uint8_t>& r_msg,int p_32) {
 
-	mutex->lock();
-	lockcount++;
+	int ofs=r_msg.size();
+	r_msg.resize(ofs+4);
+	encode_uint32(p_32,&r_msg[ofs]);
 }
 
-void FileAccessNetworkClient::unlock_mutex() {
-
-	lockcount--;
-	mutex->unlock();
+void FileAccessNetworkClient::_put_64(Vector<uint8_t>& r_msg,int64_t p_64) {
 
+	int ofs=r_msg.size();
+	r_msg.resize(ofs+8);
+	encode_uint64(p_64,&r_msg[ofs]);
 }
 
-void FileAccessNetworkClient::put_32(int p_32) {
+void FileAccessNetworkClient::_put_string(Vector<uint8_t>& r_msg,const String& p_string) {
 
-	uint8_t buf[4];
-	encode_uint32(p_32,buf);
-	client->put_data(buf,4);
-	DEBUG_PRINT("put32: "+itos(p_32));
+	CharString cs=p_string.utf8();
+	_put_32(r_msg,cs.length());
+	if (cs.length()==0)
+		return;
+	int ofs=r_msg.size();
+	r_msg.resize(ofs+cs.length());
+	copymem(&r_msg[ofs],cs.get_data(),cs.length());
 }
 
-void FileAccessNetworkClient::put_64(int64_t p_64) {
-
-	uint8_t buf[8];
-	encode_uint64(p_64,buf);
-	client->put_data(buf,8);
-	DEBUG_PRINT("put64: "+itos(p_64));
+void FileAccessNetworkClient::_send(const Vector<uint8_t>& p_msg) {
 
+	//whole messages only, so requests from different threads never interleave
+	mutex->lock();
+	client->put_data(p_msg.ptr(),p_msg.size());
+	mutex->unlock();
 }
 
 int FileAccessNetworkClient::get_32() {
 
 	uint8_t buf[4];
-	client->get_data(buf,4);
+	if (client->get_data(buf,4)!=OK) {
+		read_error=true;
+		return 0;
+	}
 	return decode_uint32(buf);
 
 }
@@ -81,110 +87,135 @@ int FileAccessNetworkClient::get_32() {
 int64_t FileAccessNetworkClient::get_64() {
 
 	uint8_t buf[8];
-	client->get_data(buf,8);
+	if (client->get_data(buf,8)!=OK) {
+		read_error=true;
+		return 0;
+	}
 	return decode_uint64(buf);
 
 }
 
 void FileAccessNetworkClient::_thread_func() {
 
+	//only reads responses, requests are sent by the threads that need them so they can pipeline
 	client->set_nodelay(true);
-	while(!quit) {
-
-		DEBUG_PRINT("SEM WAIT - "+itos(sem->get()));
-		Error err = sem->wait();
-		DEBUG_TIME("sem_unlock");
-		//DEBUG_PRINT("semwait returned "+itos(werr));
-		DEBUG_PRINT("MUTEX LOCK "+itos(lockcount));
-		DEBUG_PRINT("POPO");
-		DEBUG_PRINT("PEPE");
-		lock_mutex();
-		DEBUG_PRINT("MUTEX PASS");
-
-		blockrequest_mutex->lock();
-		while(block_requests.size()) {
-			put_32(block_requests.front()->get().id);
-			put_32(FileAccessNetwork::COMMAND_READ_BLOCK);
-			put_64(block_requests.front()->get().offset);
-			put_32(block_requests.front()->get().size);
-			block_requests.pop_front();
-		}
-		blockrequest_mutex->unlock();
-
-		DEBUG_PRINT("THREAD ITER");
+	Vector<uint8_t> block;
+	Vector<uint64_t> times;
 
-		DEBUG_TIME("sem_read");
-		int id = get_32();
+	read_error=false;
 
-		int response = get_32();
-		DEBUG_PRINT("GET RESPONSE: "+itos(response));
-
-		FileAccessNetwork *fa=NULL;
+	while(!quit && !read_error) {
 
-		if (response!=FileAccessNetwork::RESPONSE_DATA) {
-			ERR_FAIL_COND(!accesses.has(id));
-		}
+		uint8_t header[8];
+		if (client->get_data(header,8)!=OK)
+			break;
 
-		if (accesses.has(id))
-			fa=accesses[id];
+		int id = decode_uint32(&header[0]);
+		int response = decode_uint32(&header[4]);
+		DEBUG_PRINT("GET RESPONSE: "+itos(response));
 
+		int status=OK;
+		uint64_t value=0;
+		int64_t offset=0;
 
+		//read the whole response before looking for its file, which may be gone by now
 		switch(response) {
 
 			case FileAccessNetwork::RESPONSE_OPEN: {
 
-
-				DEBUG_TIME("sem_open");
-				int status = get_32();
-				if (status!=OK) {
-					fa->_respond(0,Error(status));
-				} else {
-					uint64_t len = get_64();
-					fa->_respond(len,Error(status));
-				}
-
-				fa->sem->post();
-
-
+				status = get_32();
+				if (status==OK)
+					value = get_64();
 			} break;
 			case FileAccessNetwork::RESPONSE_DATA: {
 
-				int64_t offset = get_64();
+				offset = get_64();
 				uint32_t len = get_32();
-
-				Vector<uint8_t> block;
+				if (len>FileAccessNetwork::MAX_BLOCK_SIZE) {
+					ERR_PRINT("Block from file server is too large");
+					read_error=true;
+					break;
+				}
 				block.resize(len);
-				client->get_data(block.ptr(),len);
+				if (len && client->get_data(block.ptr(),len)!=OK)
+					read_error=true;
+			} break;
+			case FileAccessNetwork::RESPONSE_FILE_EXISTS: {
 
-				if (fa) //may have been queued
-					fa->_set_block(offset,block);
+				value = get_32();
+			} break;
+			case FileAccessNetwork::RESPONSE_GET_MODTIME: {
 
+				value = get_64();
 			} break;
-			case FileAccessNetwork::RESPONSE_FILE_EXISTS: {
+			case FileAccessNetwork::RESPONSE_GET_MODTIMES: {
+
+				int count = get_32();
+				if (count<0 || count>FileAccessNetwork::MAX_MODTIMES) {
+					ERR_PRINT("Invalid modification time count from file server");
+					read_error=true;
+					break;
+				}
+				times.resize(count);
+				for(int i=0;i<count;i++)
+					times[i]=get_64();
+			} break;
+			default: {
 
+				ERR_PRINT(String("Unknown response from file server: "+itos(response)).utf8().get_data());
+				read_error=true;
+			}
+		}
 
-				int status = get_32();
-				fa->exists_modtime=status!=0;
-				fa->sem->post();
+		if (read_error)
+			break; //stream is out of sync, nothing after this can be trusted
 
+		access_mutex->lock();
 
+		FileAccessNetwork *fa=NULL;
+		if (accesses.has(id))
+			fa=accesses[id];
 
-			} break;
-			case FileAccessNetwork::RESPONSE_GET_MODTIME: {
+		if (fa) {
 
+			switch(response) {
 
-				uint64_t status = get_64();
-				fa->exists_modtime=status;
-				fa->sem->post();
+				case FileAccessNetwork::RESPONSE_OPEN: {
 
-			} break;
+					fa->_respond(value,Error(status));
+					fa->sem->post();
+				} break;
+				case FileAccessNetwork::RESPONSE_DATA: {
 
+					fa->_set_block(offset,block);
+				} break;
+				case FileAccessNetwork::RESPONSE_FILE_EXISTS: {
+
+					fa->exists_modtime=value!=0;
+					fa->sem->post();
+				} break;
+				case FileAccessNetwork::RESPONSE_GET_MODTIME: {
+
+					fa->exists_modtime=value;
+					fa->sem->post();
+				} break;
+				case FileAccessNetwork::RESPONSE_GET_MODTIMES: {
+
+					fa->modtimes=times;
+					fa->sem->post();
+				} break;
+			}
 		}
 
-
-		unlock_mutex();
+		access_mutex->unlock();
 	}
 
+	//no more answers will come, wake up everyone still waiting for one
+	access_mutex->lock();
+	failed=true;
+	for(Map<int,FileAccessNetwork*>::Element *E=accesses.front();E;E=E->next())
+		E->get()->_fail();
+	access_mutex->unlock();
 }
 
 void FileAccessNetworkClient::_thread_func(void *s) {
@@ -217,9 +248,9 @@ Error FileAccessNetworkClient::connect(const String& p_host,int p_port,const Str
 		return ERR_CANT_CONNECT;
 	}
 
-	CharString cs = p_password.utf8();	
-	put_32(cs.length());
-	client->put_data((const uint8_t*)cs.ptr(),cs.length());
+	Vector<uint8_t> msg;
+	_put_string(msg,p_password);
+	_send(msg);
 
 	int e = get_32();
 
@@ -232,6 +263,29 @@ Error FileAccessNetworkClient::connect(const String& p_host,int p_port,const Str
 	return OK;
 }
 
+Vector<uint64_t> FileAccessNetworkClient::get_modified_times(const Vector<String>& p_paths) {
+
+	Vector<uint64_t> times;
+	ERR_FAIL_COND_V(p_paths.size()>FileAccessNetwork::MAX_MODTIMES,times);
+	if (failed)
+		return times;
+
+	FileAccessNetwork *fa = memnew( FileAccessNetwork );
+
+	Vector<uint8_t> msg;
+	_put_32(msg,fa->id);
+	_put_32(msg,FileAccessNetwork::COMMAND_GET_MODTIMES);
+	_put_32(msg,p_paths.size());
+	for(int i=0;i<p_paths.size();i++)
+		_put_string(msg,p_paths[i]);
+	_send(msg);
+	fa->sem->wait();
+
+	times=fa->modtimes;
+	memdelete(fa);
+	return times;
+}
+
 FileAccessNetworkClient *FileAccessNetworkClient::singleton=NULL;
 
 
@@ -239,66 +293,125 @@ FileAccessNetworkClient::FileAccessNetworkClient() {
 
 	thread=NULL;
 	mutex = Mutex::create();
-	blockrequest_mutex = Mutex::create();
+	access_mutex = Mutex::create();
 	quit=false;
+	failed=false;
+	read_error=false;
 	singleton=this;
 	last_id=0;
 	client = Ref<StreamPeerTCP>( StreamPeerTCP::create_ref() );
-	sem=Semaphore::create();
-	lockcount=0;
 }
 
 FileAccessNetworkClient::~FileAccessNetworkClient() {
 
 	if (thread) {
 		quit=true;
-		sem->post();
+		//the reader is blocked on the connection, wake it up with an empty query
+		Vector<uint8_t> msg;
+		_put_32(msg,-1);
+		_put_32(msg,FileAccessNetwork::COMMAND_GET_MODTIMES);
+		_put_32(msg,0);
+		_send(msg);
 		Thread::wait_to_finish(thread);
+		memdelete(thread);
 	}
 
-	memdelete(blockrequest_mutex);
+	client->disconnect();
+	memdelete(access_mutex);
 	memdelete(mutex);
-	memdelete(sem);
-
+	singleton=NULL;
 
 }
 
 void FileAccessNetwork::_set_block(size_t p_offset,const Vector<uint8_t>& p_block) {
 
+	buffer_mutex->lock();
+
+	if (!opened) {
+		//answer to a read from before the file was closed
+		buffer_mutex->unlock();
+		return;
+	}
 
 	int page = p_offset/page_size;
-	ERR_FAIL_INDEX(page,pages.size());
-	if (page<pages.size()-1) {
-		ERR_FAIL_COND(p_block.size()!=page_size);
-	} else {
-		ERR_FAIL_COND( (p_block.size() != (total_size%page_size)));
+	int ofs=0;
+
+	//a block may hold several pages
+	while(ofs<p_block.size()) {
+
+		if (page>=pages.size() || ofs+_get_page_len(page)>p_block.size()) {
+			ERR_PRINT("Invalid block from file server");
+			break;
+		}
+
+		int len=_get_page_len(page);
+		Page &p=pages[page];
+		if (p.buffer.empty()) {
+			p.buffer.resize(len);
+			copymem(p.buffer.ptr(),&p_block[ofs],len);
+			loaded_pages.push_back(page);
+		}
+		p.queued=false;
+		p.activity=++last_activity_val;
+
+		if (waiting_on_page==page) {
+			waiting_on_page=-1;
+			page_sem->post();
+		}
+
+		ofs+=len;
+		page++;
 	}
 
-	buffer_mutex->lock();
-	pages[page].buffer=p_block;
-	pages[page].queued=false;
+	_evict_pages();
 	buffer_mutex->unlock();
+}
+
+void FileAccessNetwork::_evict_pages() const {
+
+	while(loaded_pages.size()>max_pages) {
 
-	if (waiting_on_page==page) {
+		//least recently used goes first
+		int idx=0;
+		for(int i=1;i<loaded_pages.size();i++) {
+			if (pages[loaded_pages[i]].activity<pages[loaded_pages[idx]].activity)
+				idx=i;
+		}
+
+		pages[loaded_pages[idx]].buffer.clear();
+		loaded_pages.remove(idx);
+	}
+}
+
+
+void FileAccessNetwork::_fail() {
+
+	response=ERR_CANT_CONNECT;
+	exists_modtime=0;
+	modtimes.clear();
+	sem->post();
+
+	buffer_mutex->lock();
+	if (waiting_on_page!=-1) {
 		waiting_on_page=-1;
 		page_sem->post();
 	}
+	buffer_mutex->unlock();
 }
 
-
 void FileAccessNetwork::_respond(size_t p_len,Error p_status) {
 
 	DEBUG_PRINT("GOT RESPONSE - len: "+itos(p_len)+" status: "+itos(p_status));
 	response=p_status;
 	if (response!=OK)
 		return;
+	buffer_mutex->lock();
 	opened=true;
 	total_size=p_len;
-	int pc = ((total_size-1)/page_size)+1;
+	int pc = total_size ? ((total_size-1)/page_size)+1 : 0;
 	pages.resize(pc);
-
-
-
+	loaded_pages.clear();
+	buffer_mutex->unlock();
 
 }
 
@@ -308,27 +421,23 @@ Error FileAccessNetwork::_open(const String& p_path, int p_mode_flags) {
 	if (opened)
 		close();
 	FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
+	if (nc->failed)
+		return ERR_CANT_CONNECT;
 	DEBUG_PRINT("open: "+p_path);
 
 	DEBUG_TIME("open_begin");
 
-	nc->lock_mutex();
-	nc->put_32(id);
-	nc->accesses[id]=this;
-	nc->put_32(COMMAND_OPEN_FILE);
-	CharString cs =p_path.utf8();
-	nc->put_32(cs.length());
-	nc->client->put_data((const uint8_t*)cs.ptr(),cs.length());
 	pos=0;
 	eof_flag=false;
 	last_page=-1;
-	last_page_buff=NULL;
+	window=read_ahead;
+
+	Vector<uint8_t> msg;
+	nc->_put_32(msg,id);
+	nc->_put_32(msg,COMMAND_OPEN_FILE);
+	nc->_put_string(msg,p_path);
+	nc->_send(msg);
 
-//	buffers.clear();
-	nc->unlock_mutex();
-	DEBUG_PRINT("OPEN POST");
-	DEBUG_TIME("open_post");
-	nc->sem->post(); //awaiting answer
 	DEBUG_PRINT("WAIT...");
 	sem->wait();
 	DEBUG_TIME("open_end");
@@ -341,16 +450,21 @@ void FileAccessNetwork::close(){
 
 	if (!opened)
 		return;
+	ERR_FAIL_COND(_async_locked());
 
 	FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
 
 	DEBUG_PRINT("CLOSE");
-	nc->lock_mutex();
-	nc->put_32(id);
-	nc->put_32(COMMAND_CLOSE);
+	Vector<uint8_t> msg;
+	nc->_put_32(msg,id);
+	nc->_put_32(msg,COMMAND_CLOSE);
+	nc->_send(msg);
+
+	buffer_mutex->lock();
 	pages.clear();
+	loaded_pages.clear();
 	opened=false;
-	nc->unlock_mutex();
+	buffer_mutex->unlock();
 
 
 }
@@ -362,6 +476,7 @@ bool FileAccessNetwork::is_open() const{
 void FileAccessNetwork::seek(size_t p_position){
 
 	ERR_FAIL_COND(!opened);
+	ERR_FAIL_COND(_async_locked());
 	eof_flag=p_position>total_size;
 
 	if (p_position>=total_size) {
@@ -395,90 +510,138 @@ bool FileAccessNetwork::eof_reached() const{
 
 uint8_t FileAccessNetwork::get_8() const{
 
-	uint8_t v;
+	uint8_t v=0;
 	get_buffer(&v,1);
 	return v;
 
 }
 
 
-void FileAccessNetwork::_queue_page(int p_page) const {
+void FileAccessNetwork::_queue_pages(int p_page,int p_count) const {
 
-	if (p_page>=pages.size())
-		return;
-	if (pages[p_page].buffer.empty() && !pages[p_page].queued) {
-
-
-		FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
-
-		nc->blockrequest_mutex->lock();
-		FileAccessNetworkClient::BlockRequest br;
-		br.id=id;
-		br.offset=size_t(p_page)*page_size;
-		br.size=page_size;
-		nc->block_requests.push_back(br);
-		pages[p_page].queued=true;
-		nc->blockrequest_mutex->unlock();
-		DEBUG_PRINT("QUEUE PAGE POST");
-		nc->sem->post();
-		DEBUG_PRINT("queued "+itos(p_page));
+	enum {
+		MAX_RUNS=8
+	};
+
+	int run_from[MAX_RUNS];
+	int run_len[MAX_RUNS];
+	int runs=0;
+
+	buffer_mutex->lock();
+
+	int end=MIN(p_page+p_count,pages.size());
+	int first_missing=-1;
+	for(int i=p_page;i<end;i++) {
+		if (pages[i].buffer.empty() && !pages[i].queued) {
+			first_missing=i;
+			break;
+		}
 	}
 
+	//top up the window only once half of it is used, so requests stay large
+	if (first_missing!=-1 && (first_missing==p_page || first_missing-p_page<=p_count/2)) {
+
+		int from=-1;
+		for(int i=first_missing;i<=end && runs<MAX_RUNS;i++) {
+
+			if (i<end && pages[i].buffer.empty() && !pages[i].queued) {
+				if (from==-1)
+					from=i;
+				pages[i].queued=true;
+			} else if (from!=-1) {
+				run_from[runs]=from;
+				run_len[runs]=i-from;
+				runs++;
+				from=-1;
+			}
+		}
+	}
+
+	buffer_mutex->unlock();
+
+	if (!runs)
+		return;
+
+	//one message for all runs, the server answers each with a single block
+	FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
+	Vector<uint8_t> msg;
+	for(int i=0;i<runs;i++) {
+
+		uint64_t ofs=uint64_t(run_from[i])*page_size;
+		uint64_t last=uint64_t(run_from[i]+run_len[i]-1);
+		int size=last*page_size+_get_page_len(last)-ofs;
+		nc->_put_32(msg,id);
+		nc->_put_32(msg,COMMAND_READ_BLOCK);
+		nc->_put_64(msg,ofs);
+		nc->_put_32(msg,size);
+		DEBUG_PRINT("queued "+itos(run_from[i])+" x"+itos(run_len[i]));
+	}
+	nc->_send(msg);
 }
 
 int FileAccessNetwork::get_buffer(uint8_t *p_dst, int p_length) const{
 
-	//bool eof=false;
+	ERR_FAIL_COND_V(!opened,-1);
+	ERR_FAIL_COND_V(_async_locked(),-1);
+
 	if (pos+p_length>total_size) {
 		eof_flag=true;
-	}
-	if (pos+p_length>=total_size) {
-		p_length=total_size-pos;
+		p_length=pos<total_size ? total_size-pos : 0;
 	}
 
-//	FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
+	int read=0;
 
-	uint8_t *buff=last_page_buff;
-
-	for(int i=0;i<p_length;i++) {
+	while(read<p_length) {
 
 		int page=pos/page_size;
 
 		if (page!=last_page) {
-			buffer_mutex->lock();
-			if (pages[page].buffer.empty()) {
-				//fuck
 
-				waiting_on_page=page;
-				for(int j=0;j<read_ahead;j++) {
-
-					_queue_page(page+j);
-				}
-				buffer_mutex->unlock();
-				DEBUG_PRINT("wait");
-				page_sem->wait();
-				DEBUG_PRINT("done");
-			} else {
+			//sequential reads widen the window, anything else resets it
+			if (page==last_page+1)
+				window=MIN(window*2,max_read_ahead);
+			else
+				window=read_ahead;
+			last_page=page;
+			_queue_pages(page,window);
+		}
 
-				for(int j=0;j<read_ahead;j++) {
+		buffer_mutex->lock();
+		while(pages[page].buffer.empty()) {
 
-					_queue_page(page+j);
-				}
-				buff=pages[page].buffer.ptr();
-				//queue pages
+			if (FileAccessNetworkClient::singleton->failed) {
+				//connection lost, the page will never arrive
 				buffer_mutex->unlock();
+				eof_flag=true;
+				return read;
 			}
-
-			buff=pages[page].buffer.ptr();
-			last_page_buff=buff;
-			last_page=page;
+			if (!pages[page].queued) {
+				//evicted before it could be read
+				buffer_mutex->unlock();
+				_queue_pages(page,window);
+				buffer_mutex->lock();
+				continue;
+			}
+			waiting_on_page=page;
+			buffer_mutex->unlock();
+			DEBUG_PRINT("wait");
+			page_sem->wait();
+			DEBUG_PRINT("done");
+			buffer_mutex->lock();
 		}
 
-		p_dst[i]=buff[pos-uint64_t(page)*page_size];
-		pos++;
+		Page &p=pages[page];
+		p.activity=++last_activity_val;
+		int ofs=pos-uint64_t(page)*page_size;
+		int to_copy=MIN(p_length-read,p.buffer.size()-ofs);
+		copymem(&p_dst[read],&p.buffer[ofs],to_copy);
+		buffer_mutex->unlock();
+
+		read+=to_copy;
+		pos+=to_copy;
 	}
 
-	return p_length;
+	return read;
 }
 
 Error FileAccessNetwork::get_error() const{
@@ -494,15 +657,14 @@ void FileAccessNetwork::store_8(uint8_t p_dest) {
 bool FileAccessNetwork::file_exists(const String& p_path){
 
 	FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
-	nc->lock_mutex();
-	nc->put_32(id);
-	nc->put_32(COMMAND_FILE_EXISTS);
-	CharString cs=p_path.utf8();
-	nc->put_32(cs.length());
-	nc->client->put_data((const uint8_t*)cs.ptr(),cs.length());
-	nc->unlock_mutex();
+	if (nc->failed)
+		return false;
+	Vector<uint8_t> msg;
+	nc->_put_32(msg,id);
+	nc->_put_32(msg,COMMAND_FILE_EXISTS);
+	nc->_put_string(msg,p_path);
+	nc->_send(msg);
 	DEBUG_PRINT("FILE EXISTS POST");
-	nc->sem->post();
 	sem->wait();
 
 	return exists_modtime!=0;
@@ -512,15 +674,14 @@ bool FileAccessNetwork::file_exists(const String& p_path){
 uint64_t FileAccessNetwork::_get_modified_time(const String& p_file){
 
 	FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
-	nc->lock_mutex();
-	nc->put_32(id);
-	nc->put_32(COMMAND_GET_MODTIME);
-	CharString cs=p_file.utf8();
-	nc->put_32(cs.length());
-	nc->client->put_data((const uint8_t*)cs.ptr(),cs.length());
-	nc->unlock_mutex();
+	if (nc->failed)
+		return 0;
+	Vector<uint8_t> msg;
+	nc->_put_32(msg,id);
+	nc->_put_32(msg,COMMAND_GET_MODTIME);
+	nc->_put_string(msg,p_file);
+	nc->_send(msg);
 	DEBUG_PRINT("MODTIME POST");
-	nc->sem->post();
 	sem->wait();
 
 	return exists_modtime;
@@ -532,17 +693,23 @@ FileAccessNetwork::FileAccessNetwork() {
 	eof_flag=false;
 	opened=false;
 	pos=0;
+	total_size=0;
 	sem=Semaphore::create();
 	page_sem=Semaphore::create();
 	buffer_mutex=Mutex::create();
 	FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
-	nc->lock_mutex();
+	nc->access_mutex->lock();
 	id=nc->last_id++;
 	nc->accesses[id]=this;
-	nc->unlock_mutex();
+	nc->access_mutex->unlock();
 	page_size = GLOBAL_DEF("remote_fs/page_size",65536);
 	read_ahead = GLOBAL_DEF("remote_fs/page_read_ahead",4);
-	max_pages = GLOBAL_DEF("remote_fs/max_pages",20);
+	max_read_ahead = GLOBAL_DEF("remote_fs/max_page_read_ahead",32);
+	max_pages = GLOBAL_DEF("remote_fs/max_pages",64);
+	read_ahead=MAX(read_ahead,1);
+	max_read_ahead=MAX(max_read_ahead,read_ahead);
+	max_pages=MAX(max_pages,max_read_ahead*2);
+	window=read_ahead;
 	last_activity_val=0;
 	waiting_on_page=-1;
 	last_page=-1;
@@ -553,14 +720,14 @@ FileAccessNetwork::FileAccessNetwork() {
 FileAccessNetwork::~FileAccessNetwork() {
 
 	close();
-	memdelete(sem);
-	memdelete(page_sem);
-	memdelete(buffer_mutex);
 
 	FileAccessNetworkClient *nc = FileAccessNetworkClient::singleton;
-	nc->lock_mutex();
-	id=nc->last_id++;
+	nc->access_mutex->lock();
 	nc->accesses.erase(id);
-	nc->unlock_mutex();
+	nc->access_mutex->unlock();
+
+	memdelete(sem);
+	memdelete(page_sem);
+	memdelete(buffer_mutex);
 
 }
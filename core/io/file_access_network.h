@@ -39,38 +39,25 @@ class FileAccessNetwork;
 class FileAccessNetworkClient {
 
 
-	struct BlockRequest {
-
-		int id;
-		uint64_t offset;
-		int size;
-	};
-
-	int ml;
-
-	List<BlockRequest> block_requests;
-
-	Semaphore *sem;
 	Thread *thread;
 	bool quit;
-	Mutex *mutex;
-	Mutex *blockrequest_mutex;
+	volatile bool failed; //reader thread is gone, nothing will be answered anymore
+	bool read_error;
+	Mutex *mutex; //requests from any thread, one message at a time
+	Mutex *access_mutex;
 	Map<int,FileAccessNetwork*> accesses;
 	Ref<StreamPeerTCP> client;
 	int last_id;
 
-	Vector<uint8_t> block;
-
 	void _thread_func();
 	static void _thread_func(void *s);
 
-	void put_32(int p_32);
-	void put_64(int64_t p_64);
+	static void _put_32(Vector<uint8_t>& r_msg,int p_32);
+	static void _put_64(Vector<uint8_t>& r_msg,int64_t p_64);
+	static void _put_string(Vector<uint8_t>& r_msg,const String& p_string);
+	void _send(const Vector<uint8_t>& p_msg);
 	int get_32();
 	int64_t get_64();
-	int lockcount;
-	void lock_mutex();
-	void unlock_mutex();
 
 friend class FileAccessNetwork;
 	static FileAccessNetworkClient *singleton;
@@ -80,6 +67,7 @@ public:
 	static FileAccessNetworkClient *get_singleton() { return singleton; }
 
 	Error connect(const String& p_host,int p_port,const String& p_password="");
+	Vector<uint64_t> get_modified_times(const Vector<String>& p_paths); ///< one round trip for many files, 0 for missing ones, empty if the connection is lost
 
 	FileAccessNetworkClient();
 	~FileAccessNetworkClient();
@@ -97,11 +85,12 @@ class FileAccessNetwork : public FileAccess {
 	int id;
 	mutable bool eof_flag;
 	mutable int last_page;
-	mutable uint8_t *last_page_buff;
 
 	uint32_t page_size;
 	int read_ahead;
+	int max_read_ahead;
 	int max_pages;
+	mutable int window; //pages requested ahead, grows while reading sequentially
 
 	mutable int waiting_on_page;
 	mutable int last_activity_val;
@@ -113,13 +102,18 @@ class FileAccessNetwork : public FileAccess {
 	};
 
 	mutable Vector<	Page > pages;
+	mutable Vector<int> loaded_pages;
 
 	mutable Error response;
 
 	uint64_t exists_modtime;
+	Vector<uint64_t> modtimes;
 friend class FileAccessNetworkClient;
-	void _queue_page(int p_page) const;
+	_FORCE_INLINE_ int _get_page_len(int p_page) const { return MIN(uint64_t(page_size),total_size-uint64_t(p_page)*page_size); }
+	void _queue_pages(int p_page,int p_count) const;
+	void _evict_pages() const;
 	void _respond(size_t p_len,Error p_status);
+	void _fail();
 	void _set_block(size_t p_offset,const Vector<uint8_t>& p_block);
 
 public:
@@ -130,6 +124,7 @@ public:
 		COMMAND_CLOSE,
 		COMMAND_FILE_EXISTS,
 		COMMAND_GET_MODTIME,
+		COMMAND_GET_MODTIMES,
 	};
 
 	enum Response {
@@ -137,6 +132,12 @@ public:
 		RESPONSE_DATA,
 		RESPONSE_FILE_EXISTS,
 		RESPONSE_GET_MODTIME,
+		RESPONSE_GET_MODTIMES,
+	};
+
+	enum {
+		MAX_BLOCK_SIZE=16*1024*1024,
+		MAX_MODTIMES=4096
 	};
 
 
@@ -28,8 +28,11 @@
 /*************************************************************************/
 #include "file_access_pack.h"
 #include "version.h"
+#include "io/marshalls.h"
+#include "io/md5.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #define PACK_VERSION 0
 
@@ -46,8 +49,149 @@ Error PackedData::add_pack(const String& p_path) {
 	return ERR_FILE_UNRECOGNIZED;
 };
 
+uint64_t PackedData::hash_path(const String& p_path) {
+
+	//FNV-1a, stored in pack indices so it must never change
+	const CharType *c=p_path.c_str();
+	uint64_t h=14695981039346656037ULL;
+	while(*c) {
+		h^=uint32_t(*c);
+		h*=1099511628211ULL;
+		c++;
+	}
+	return h;
+}
+
+static bool _index_path_matches(const String& p_path,const uint8_t *p_utf8,uint32_t p_len) {
+
+	const CharType *c=p_path.c_str();
+	for(uint32_t i=0;i<p_len;i++) {
+
+		if (c[i]>=0x80) {
+			//not ascii, compare the encoded path
+			CharString cs=p_path.utf8();
+			return uint32_t(cs.length())==p_len && memcmp(cs.get_data(),p_utf8,p_len)==0;
+		}
+		if (c[i]!=p_utf8[i])
+			return false; //also stops at the end of a shorter path
+	}
+
+	return c[p_len]==0;
+}
+
+bool PackedData::_find_indexed(const String& p_path,PackedFile *r_file) const {
+
+	uint64_t h=hash_path(p_path);
+
+	for(int i=indices.size()-1;i>=0;i--) {
+
+		const PackIndex *pi=indices[i];
+		const uint8_t *e=pi->entries.ptr();
+		const uint8_t *paths=&e[pi->count*INDEX_ENTRY_SIZE];
+		int lo=0;
+		int hi=pi->count;
+		while(lo<hi) {
+			int mid=(lo+hi)>>1;
+			if (decode_uint64(&e[mid*INDEX_ENTRY_SIZE])<h)
+				lo=mid+1;
+			else
+				hi=mid;
+		}
+
+		//the hash can match a path that is not in the pack, so the name must match too
+		for(;lo<pi->count && decode_uint64(&e[lo*INDEX_ENTRY_SIZE])==h;lo++) {
+
+			const uint8_t *ent=&e[lo*INDEX_ENTRY_SIZE];
+			uint32_t path_ofs=decode_uint32(&ent[40]);
+			uint32_t path_len=decode_uint32(&ent[44]);
+			if (uint64_t(path_ofs)+path_len>pi->paths_size)
+				continue;
+
+			if (!_index_path_matches(p_path,&paths[path_ofs],path_len))
+				continue;
+
+			if (r_file) {
+				r_file->pack=pi->pack;
+				r_file->offset=decode_uint64(&ent[8]);
+				r_file->size=decode_uint64(&ent[16]);
+				for(int j=0;j<16;j++)
+					r_file->md5[j]=ent[24+j];
+				r_file->src=pi->src;
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void PackedData::_read_index_dir(PackIndex *p_index,bool p_add_files) {
+
+	p_index->dirs_added=true;
+
+	FileAccess *f = FileAccess::open(p_index->pack,FileAccess::READ);
+	ERR_FAIL_COND(!f);
+	f->seek(p_index->dir_ofs);
+
+	for(int i=0;i<p_index->count;i++) {
+
+		uint32_t sl = f->get_32();
+		CharString cs;
+		cs.resize(sl+1);
+		f->get_buffer((uint8_t*)cs.ptr(),sl);
+		cs[sl]=0;
+
+		String path;
+		path.parse_utf8(cs.ptr());
+
+		uint64_t ofs = f->get_64();
+		uint64_t size = f->get_64();
+		uint8_t md5[16];
+		f->get_buffer(md5,16);
+
+		if (p_add_files)
+			add_path(p_index->pack, path, ofs, size, md5, p_index->src);
+		else
+			_add_dir_entry(path);
+	}
+
+	memdelete(f);
+}
+
+void PackedData::_build_dirs() {
+
+	for(int i=0;i<indices.size();i++) {
+
+		if (!indices[i]->dirs_added)
+			_read_index_dir(indices[i],false);
+	}
+}
+
+void PackedData::add_index(const String& pkg_path, uint64_t p_dir_ofs, int p_count, const Vector<uint8_t>& p_entries, uint32_t p_paths_size, PackSource* p_src) {
+
+	PackIndex *pi = memnew( PackIndex );
+	pi->pack=pkg_path;
+	pi->src=p_src;
+	pi->dir_ofs=p_dir_ofs;
+	pi->count=p_count;
+	pi->entries=p_entries;
+	pi->paths_size=p_paths_size;
+	pi->dirs_added=false;
+	indices.push_back(pi);
+}
+
 void PackedData::add_path(const String& pkg_path, const String& path, uint64_t ofs, uint64_t size,const uint8_t* p_md5, PackSource* p_src) {
 
+	if (indices.size()) {
+		//this pack overrides the indexed ones loaded before it, so move them to the map first
+		Vector<PackIndex*> older=indices;
+		indices.clear();
+		for(int i=0;i<older.size();i++) {
+			_read_index_dir(older[i],true);
+			memdelete(older[i]);
+		}
+	}
+
 	bool exists = files.has(path);
 
 	PackedFile pf;
@@ -60,31 +204,35 @@ void PackedData::add_path(const String& pkg_path, const String& path, uint64_t o
 
 	files[path]=pf;
 
-	if (!exists) {
-		//search for dir
-		String p = path.replace_first("res://","");
-		PackedDir *cd=root;
+	if (!exists)
+		_add_dir_entry(path);
+}
 
-		if (p.find("/")!=-1) { //in a subdir
+void PackedData::_add_dir_entry(const String& path) {
 
-			Vector<String> ds=p.get_base_dir().split("/");
+	//search for dir
+	String p = path.replace_first("res://","");
+	PackedDir *cd=root;
 
-			for(int j=0;j<ds.size();j++) {
+	if (p.find("/")!=-1) { //in a subdir
 
-				if (!cd->subdirs.has(ds[j])) {
+		Vector<String> ds=p.get_base_dir().split("/");
 
-					PackedDir *pd = memnew( PackedDir );
-					pd->name=ds[j];
-					pd->parent=cd;
-					cd->subdirs[pd->name]=pd;
-					cd=pd;
-				} else {
-					cd=cd->subdirs[ds[j]];
-				}
+		for(int j=0;j<ds.size();j++) {
+
+			if (!cd->subdirs.has(ds[j])) {
+
+				PackedDir *pd = memnew( PackedDir );
+				pd->name=ds[j];
+				pd->parent=cd;
+				cd->subdirs[pd->name]=pd;
+				cd=pd;
+			} else {
+				cd=cd->subdirs[ds[j]];
 			}
 		}
-		cd->files.insert(path.get_file());
 	}
+	cd->files.insert(path.get_file());
 }
 
 void PackedData::add_pack_source(PackSource *p_source) {
@@ -150,13 +298,48 @@ bool PackedSourcePCK::try_open_pack(const String& p_path) {
 	ERR_EXPLAIN("Pack created with a newer version of the engine: "+itos(ver_major)+"."+itos(ver_minor)+"."+itos(ver_rev));
 	ERR_FAIL_COND_V( ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), ERR_INVALID_DATA);
 
+	uint32_t reserved[16];
 	for(int i=0;i<16;i++) {
-		//reserved
-		f->get_32();
+		reserved[i]=f->get_32();
 	}
+	uint64_t index_ofs = uint64_t(reserved[0])|(uint64_t(reserved[1])<<32);
 
 	int file_count = f->get_32();
 
+	if (index_ofs) {
+		//hash index, one read and no per file allocations
+		uint64_t dir_ofs = f->get_pos();
+		f->seek(index_ofs);
+		if (f->get_32()==PackedData::INDEX_MAGIC && int(f->get_32())==file_count) {
+
+			uint32_t paths_size = f->get_32();
+			uint8_t md5[16];
+			f->get_buffer(md5,16);
+
+			uint64_t index_size = uint64_t(file_count)*PackedData::INDEX_ENTRY_SIZE+paths_size;
+			Vector<uint8_t> entries;
+			if (index_size<=f->get_len()-f->get_pos())
+				entries.resize(index_size);
+			if (entries.size() && f->get_buffer(entries.ptr(),entries.size())==entries.size()) {
+
+				MD5_CTX ctx;
+				MD5Init(&ctx);
+				MD5Update(&ctx,entries.ptr(),entries.size());
+				MD5Final(&ctx);
+
+				if (memcmp(ctx.digest,md5,16)==0) {
+
+					PackedData::get_singleton()->add_index(p_path,dir_ofs,file_count,entries,paths_size,this);
+					memdelete(f);
+					return true;
+				}
+			}
+		}
+
+		WARN_PRINT(String("Corrupt pack index, reading directory instead: "+p_path).utf8().get_data());
+		f->seek(dir_ofs);
+	}
+
 	for(int i=0;i<file_count;i++) {
 
 		uint32_t sl = f->get_32();
@@ -175,6 +358,7 @@ bool PackedSourcePCK::try_open_pack(const String& p_path) {
 		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5,this);
 	};
 
+	memdelete(f);
 	return true;
 };
 
@@ -194,6 +378,11 @@ Error FileAccessPack::_open(const String& p_path, int p_mode_flags) {
 
 void FileAccessPack::close() {
 
+	ERR_FAIL_COND(_async_locked());
+	if (mmap_slice) {
+		mmap_unref(mmap_slice);
+		mmap_slice=NULL;
+	}
 	f->close();
 }
 
@@ -204,12 +393,14 @@ bool FileAccessPack::is_open() const{
 
 void FileAccessPack::seek(size_t p_position){
 
+	ERR_FAIL_COND(_async_locked());
 	if (p_position>pf.size) {
 		eof=true;
 	} else {
 		eof=false;
 	}
 
+	pos=p_position;
 	f->seek(pf.offset+p_position);
 }
 void FileAccessPack::seek_end(int64_t p_position){
@@ -233,6 +424,7 @@ bool FileAccessPack::eof_reached() const{
 
 uint8_t FileAccessPack::get_8() const {
 
+	ERR_FAIL_COND_V(_async_locked(),0);
 	if (pos>=pf.size) {
 		eof=true;
 		return 0;
@@ -245,6 +437,7 @@ uint8_t FileAccessPack::get_8() const {
 
 int FileAccessPack::get_buffer(uint8_t *p_dst,int p_length) const {
 
+	ERR_FAIL_COND_V(_async_locked(),-1);
 	if (eof)
 		return 0;
 
@@ -263,6 +456,41 @@ int FileAccessPack::get_buffer(uint8_t *p_dst,int p_length) const {
 	return to_read;
 }
 
+struct MMapSlice : public FileAccess::MMap {
+
+	FileAccess::MMap *parent;
+
+	MMapSlice(FileAccess::MMap *p_parent,uint64_t p_offset,uint64_t p_size) {
+		parent=p_parent;
+		parent->refcount.ref();
+		ptr=parent->ptr+p_offset;
+		size=p_size;
+	}
+	~MMapSlice() { FileAccess::mmap_unref(parent); }
+};
+
+FileAccess::MMap *FileAccessPack::get_mmap() {
+
+	if (mmap_slice)
+		return mmap_slice;
+
+	MMap *pack_mmap = f->get_mmap();
+	if (!pack_mmap || pf.offset+pf.size>pack_mmap->size)
+		return NULL;
+
+	mmap_slice = memnew( MMapSlice(pack_mmap,pf.offset,pf.size) );
+	return mmap_slice;
+}
+
+int FileAccessPack::read_at(size_t p_offset,uint8_t *p_dst,int p_length) const {
+
+	if (p_offset>=pf.size)
+		return 0;
+
+	int to_read = MIN(uint64_t(p_length),pf.size-p_offset);
+	return f->read_at(pf.offset+p_offset,p_dst,to_read);
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
 	f->set_endian_swap(p_swap);
@@ -296,6 +524,7 @@ bool FileAccessPack::file_exists(const String& p_name) {
 FileAccessPack::FileAccessPack(const String& p_path, const PackedData::PackedFile& p_file) {
 
 	pf=p_file;
+	mmap_slice=NULL;
 	f=FileAccess::open(pf.pack,FileAccess::READ);
 	if (!f) {
 		ERR_EXPLAIN("Can't open pack-referenced file: "+String(pf.pack));
@@ -307,6 +536,8 @@ FileAccessPack::FileAccessPack(const String& p_path, const PackedData::PackedFil
 }
 
 FileAccessPack::~FileAccessPack() {
+	if (mmap_slice)
+		mmap_unref(mmap_slice);
 	if (f)
 		memdelete(f);
 }
@@ -319,6 +550,7 @@ FileAccessPack::~FileAccessPack() {
 
 bool DirAccessPack::list_dir_begin() {
 
+	PackedData::get_singleton()->_build_dirs();
 
 	list_dirs.clear();
 	list_files.clear();
@@ -373,6 +605,8 @@ String DirAccessPack::get_drive(int p_drive) {
 
 Error DirAccessPack::change_dir(String p_dir) {
 
+	PackedData::get_singleton()->_build_dirs();
+
 	String nd = p_dir.replace("\\","/");
 	bool absolute=false;
 	if (nd.begins_with("res://")) {
@@ -439,6 +673,7 @@ String DirAccessPack::get_current_dir() {
 
 bool DirAccessPack::file_exists(String p_file){
 
+	PackedData::get_singleton()->_build_dirs();
 	return current->files.has(p_file);
 }
 
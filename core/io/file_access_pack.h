@@ -61,8 +61,21 @@ private:
 	};
 
 
+	struct PackIndex {
+
+		String pack;
+		PackSource* src;
+		uint64_t dir_ofs; //legacy directory, only parsed when listing dirs
+		int count;
+		Vector<uint8_t> entries; //sorted by hash, INDEX_ENTRY_SIZE each, followed by the utf8 paths
+		uint32_t paths_size;
+		bool dirs_added;
+	};
+
+
 	Map<String,PackedFile> files;
 	Vector<PackSource*> sources;
+	Vector<PackIndex*> indices; //always newer than anything in files
 
 	PackedDir *root;
 	//Map<String,PackedDir*> dirs;
@@ -70,10 +83,23 @@ private:
 	static PackedData *singleton;
 	bool disabled;
 
+	void _add_dir_entry(const String& path);
+	void _read_index_dir(PackIndex *p_index,bool p_add_files);
+	void _build_dirs();
+	bool _find_indexed(const String& p_path,PackedFile *r_file) const;
+
 public:
 
+	enum {
+		INDEX_MAGIC=0x48504447, //GDPH
+		INDEX_ENTRY_SIZE=48 // u64 hash, u64 ofs, u64 size, md5[16], u32 path ofs, u32 path len
+	};
+
+	static uint64_t hash_path(const String& p_path);
+
 	void add_pack_source(PackSource* p_source);
 	void add_path(const String& pkg_path, const String& path, uint64_t ofs, uint64_t size,const uint8_t* p_md5, PackSource* p_src); // for PackSource
+	void add_index(const String& pkg_path, uint64_t p_dir_ofs, int p_count, const Vector<uint8_t>& p_entries, uint32_t p_paths_size, PackSource* p_src); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled=p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -112,6 +138,7 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	MMap *mmap_slice;
 	virtual Error _open(const String& p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String& p_file) { return 0; }
 
@@ -132,6 +159,9 @@ public:
 
 
 	virtual int get_buffer(uint8_t *p_dst,int p_length) const;
+	virtual MMap *get_mmap();
+	virtual int read_at(size_t p_offset,uint8_t *p_dst,int p_length) const;
+	virtual bool is_read_at_concurrent() const { return f->is_read_at_concurrent(); }
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -151,6 +181,15 @@ public:
 
 FileAccess *PackedData::try_open_path(const String& p_path) {
 
+	if (indices.size()) {
+		PackedFile pf;
+		if (_find_indexed(p_path,&pf)) {
+			if (pf.offset==0)
+				return NULL;
+			return pf.src->get_file(p_path,&pf);
+		}
+	}
+
 	Map<String,PackedFile>::Element *E=files.find(p_path);
 	if (!E)
 		return NULL; //not found
@@ -162,6 +201,8 @@ FileAccess *PackedData::try_open_path(const String& p_path) {
 
 bool PackedData::has_path(const String& p_path) {
 
+	if (indices.size() && _find_indexed(p_path,NULL))
+		return true;
 	return files.has(p_path);
 }
 
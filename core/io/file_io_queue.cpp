@@ -0,0 +1,316 @@
+/*************************************************************************/
+/*  file_io_queue.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "file_io_queue.h"
+
+void FileIOQueue::CompletionQueue::_push(const Completion& p_completion) {
+
+	mutex->lock();
+	if (count==completions.size()) {
+
+		Vector<Completion> grown;
+		grown.resize(MAX(16,count*2));
+		for(int i=0;i<count;i++)
+			grown[i]=completions[(first+i)%count];
+		completions=grown;
+		first=0;
+	}
+	completions[(first+count)%completions.size()]=p_completion;
+	count++;
+	mutex->unlock();
+}
+
+bool FileIOQueue::CompletionQueue::poll(Completion *r_completion) {
+
+	mutex->lock();
+	if (count==0) {
+		mutex->unlock();
+		return false;
+	}
+	*r_completion=completions[first];
+	first=(first+1)%completions.size();
+	count--;
+	mutex->unlock();
+	return true;
+}
+
+FileIOQueue::CompletionQueue::CompletionQueue() {
+
+	mutex=Mutex::create();
+	first=0;
+	count=0;
+}
+
+FileIOQueue::CompletionQueue::~CompletionQueue() {
+
+	memdelete(mutex);
+}
+
+
+FileIOQueue *FileIOQueue::singleton=NULL;
+
+FileIOQueue *FileIOQueue::get_singleton() {
+
+	return singleton;
+}
+
+FileIOQueue::Request *FileIOQueue::_get_request(int p_request) const {
+
+	int idx = p_request&SLOT_MASK;
+	if (p_request<0 || idx>=slots.size())
+		return NULL;
+	Request *r = slots[idx];
+	return r->id==p_request ? r : NULL;
+}
+
+void FileIOQueue::_release(Request *p_request) {
+
+	p_request->id=-1;
+	p_request->file=NULL;
+	p_request->next=free_list;
+	free_list=p_request;
+}
+
+void FileIOQueue::_thread_func(void *p_userdata) {
+
+	FileIOQueue *ioq = (FileIOQueue*)p_userdata;
+
+	while(true) {
+
+		ioq->pending_sem->wait();
+
+		ioq->mutex->lock();
+		if (ioq->exit_threads) {
+			ioq->mutex->unlock();
+			break;
+		}
+		Request *r = ioq->pending_first;
+		ioq->pending_first=r->next;
+		if (!ioq->pending_first)
+			ioq->pending_last=NULL;
+		r->next=NULL;
+		ioq->mutex->unlock();
+
+		bool serialize = r->serialized;
+		if (serialize) {
+			ioq->serial_mutex->lock();
+			r->file->async_reader=Thread::get_caller_ID();
+		}
+		r->read=r->file->read_at(r->offset,r->dst,r->length);
+		if (serialize) {
+			r->file->async_reader=0;
+			ioq->serial_mutex->unlock();
+		}
+
+		if (r->callback)
+			r->callback(r->userdata,r->id,r->read);
+
+		ioq->mutex->lock();
+		if (serialize)
+			r->file->async_pending--;
+		r->done=true;
+		if (r->cqueue) {
+
+			Completion c;
+			c.request=r->id;
+			c.read=r->read;
+			c.userdata=r->userdata;
+			r->cqueue->_push(c);
+			ioq->_release(r);
+		} else {
+			r->sem->post();
+		}
+		ioq->mutex->unlock();
+	}
+}
+
+void FileIOQueue::_start_threads() {
+
+	exit_threads=false;
+	while(thread_count<wanted_threads) {
+
+		Thread *t = Thread::create(_thread_func,this);
+		if (!t)
+			break;
+		threads[thread_count++]=t;
+	}
+}
+
+void FileIOQueue::_stop_threads() {
+
+	if (thread_count==0)
+		return;
+
+	mutex->lock();
+	exit_threads=true;
+	mutex->unlock();
+	for(int i=0;i<thread_count;i++)
+		pending_sem->post();
+	for(int i=0;i<thread_count;i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	thread_count=0;
+	exit_threads=false;
+}
+
+int FileIOQueue::read(const FileAccess *p_file,size_t p_offset,int p_length,uint8_t *p_dst,Callback p_callback,void *p_userdata,CompletionQueue *p_cqueue) {
+
+	ERR_FAIL_COND_V(!p_file,-1);
+	ERR_FAIL_COND_V(p_length<0,-1);
+
+	mutex->lock();
+
+	if (thread_count==0)
+		_start_threads();
+
+	if (thread_count==0) {
+		//no threads on this platform, read right away
+		mutex->unlock();
+		int read = p_file->read_at(p_offset,p_dst,p_length);
+		if (p_callback)
+			p_callback(p_userdata,-1,read);
+		if (p_cqueue) {
+			Completion c;
+			c.request=-1;
+			c.read=read;
+			c.userdata=p_userdata;
+			p_cqueue->_push(c);
+		}
+		return -1;
+	}
+
+	Request *r = free_list;
+	if (r) {
+		free_list=r->next;
+	} else {
+		if (slots.size()>SLOT_MASK) {
+			mutex->unlock();
+			ERR_EXPLAIN("Too many pending I/O requests");
+			ERR_FAIL_V(-1);
+		}
+		r = memnew( Request );
+		r->sem=Semaphore::create();
+		r->index=slots.size();
+		slots.push_back(r);
+	}
+
+	serial=(serial+1)&0x7FFF;
+	r->id=r->index|(serial<<SLOT_BITS);
+	r->file=p_file;
+	r->offset=p_offset;
+	r->dst=p_dst;
+	r->length=p_length;
+	r->callback=p_callback;
+	r->userdata=p_userdata;
+	r->cqueue=p_cqueue;
+	r->serialized=!p_file->is_read_at_concurrent();
+	if (r->serialized)
+		p_file->async_pending++;
+	r->read=0;
+	r->done=false;
+	r->next=NULL;
+
+	if (pending_last)
+		pending_last->next=r;
+	else
+		pending_first=r;
+	pending_last=r;
+
+	int id = r->id;
+	mutex->unlock();
+	pending_sem->post();
+
+	return id;
+}
+
+bool FileIOQueue::is_done(int p_request) const {
+
+	mutex->lock();
+	Request *r = _get_request(p_request);
+	bool done = !r || r->done;
+	mutex->unlock();
+	return done;
+}
+
+int FileIOQueue::wait(int p_request) {
+
+	mutex->lock();
+	Request *r = _get_request(p_request);
+	if (!r || r->cqueue) {
+		mutex->unlock();
+		ERR_FAIL_V(-1);
+	}
+	mutex->unlock();
+
+	r->sem->wait();
+
+	mutex->lock();
+	int read = r->read;
+	_release(r);
+	mutex->unlock();
+
+	return read;
+}
+
+void FileIOQueue::set_thread_count(int p_threads) {
+
+	ERR_FAIL_COND(p_threads<1 || p_threads>MAX_THREADS);
+	ERR_FAIL_COND(pending_first!=NULL);
+
+	_stop_threads();
+	wanted_threads=p_threads;
+}
+
+FileIOQueue::FileIOQueue() {
+
+	singleton=this;
+	mutex=Mutex::create();
+	serial_mutex=Mutex::create();
+	pending_sem=Semaphore::create();
+	free_list=NULL;
+	pending_first=NULL;
+	pending_last=NULL;
+	serial=0;
+	thread_count=0;
+	exit_threads=false;
+	wanted_threads=DEFAULT_THREADS;
+}
+
+FileIOQueue::~FileIOQueue() {
+
+	_stop_threads();
+	for(int i=0;i<slots.size();i++) {
+		memdelete(slots[i]->sem);
+		memdelete(slots[i]);
+	}
+	memdelete(pending_sem);
+	memdelete(serial_mutex);
+	memdelete(mutex);
+	singleton=NULL;
+}
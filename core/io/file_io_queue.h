@@ -0,0 +1,141 @@
+/*************************************************************************/
+/*  file_io_queue.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef FILE_IO_QUEUE_H
+#define FILE_IO_QUEUE_H
+
+#include "os/file_access.h"
+#include "os/thread.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "vector.h"
+
+/**
+ * Pool of I/O threads running FileAccess::read_at() in the background.
+ * A request is either waited on by id (and released by wait()), or pushed
+ * to a CompletionQueue that its owner drains with poll().
+ * The FileAccess and the destination buffer must outlive the request.
+ * Files that aren't FileAccess::is_read_at_concurrent() are read one request
+ * at a time by moving their position, so their owner must not use them until
+ * all of their requests are finished. Backends enforce it with
+ * FileAccess::_async_locked().
+ */
+
+class FileIOQueue {
+public:
+
+	typedef FileAccess::AsyncCallback Callback; ///< called from an I/O thread, right after the read
+
+	struct Completion {
+
+		int request;
+		int read;
+		void *userdata;
+	};
+
+	class CompletionQueue {
+	friend class FileIOQueue;
+
+		Mutex *mutex;
+		Vector<Completion> completions; //ring
+		int first;
+		int count;
+
+		void _push(const Completion& p_completion);
+	public:
+
+		bool poll(Completion *r_completion); ///< pop a finished request, false if none
+
+		CompletionQueue();
+		~CompletionQueue();
+	};
+
+private:
+
+	enum {
+		SLOT_BITS=16,
+		SLOT_MASK=(1<<SLOT_BITS)-1,
+		MAX_THREADS=32,
+		DEFAULT_THREADS=4
+	};
+
+	struct Request {
+
+		int id;
+		int index;
+		const FileAccess *file;
+		size_t offset;
+		uint8_t *dst;
+		int length;
+		Callback callback;
+		void *userdata;
+		CompletionQueue *cqueue;
+		bool serialized;
+		int read;
+		bool done;
+		Semaphore *sem;
+		Request *next;
+	};
+
+	static FileIOQueue *singleton;
+
+	Mutex *mutex;
+	Mutex *serial_mutex; //read_at() of files that can't read concurrently
+	Semaphore *pending_sem;
+	Vector<Request*> slots;
+	Request *free_list;
+	Request *pending_first;
+	Request *pending_last;
+	int serial;
+
+	Thread *threads[MAX_THREADS];
+	int thread_count;
+	int wanted_threads;
+	bool exit_threads;
+
+	Request *_get_request(int p_request) const;
+	void _release(Request *p_request);
+	void _start_threads();
+	void _stop_threads();
+	static void _thread_func(void *p_userdata);
+public:
+
+	static FileIOQueue *get_singleton();
+
+	int read(const FileAccess *p_file,size_t p_offset,int p_length,uint8_t *p_dst,Callback p_callback=NULL,void *p_userdata=NULL,CompletionQueue *p_cqueue=NULL); ///< queue a read, returns the request id or -1
+	bool is_done(int p_request) const;
+	int wait(int p_request); ///< block until done, release it and return the bytes read
+
+	void set_thread_count(int p_threads); ///< only while no request is pending
+	int get_thread_count() const { return wanted_threads; }
+
+	FileIOQueue();
+	~FileIOQueue();
+};
+
+#endif // FILE_IO_QUEUE_H
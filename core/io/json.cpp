@@ -29,449 +29,684 @@
 #include "json.h"
 #include "print_string.h"
 
-const char * JSON::tk_name[TK_MAX] = {
-	"'{'",
-	"'}'",
-	"'['",
-	"']'",
-	"identifier",
-	"string",
-	"number",
-	"':'",
-	"','",
-	"EOF",
-};
+/* Output is written as UTF-8 into a byte buffer that grows by doubling */
+
+static _FORCE_INLINE_ uint8_t *_reserve(Vector<uint8_t>& r_buffer,int p_len,int p_bytes) {
+
+	if (p_len+p_bytes>r_buffer.size())
+		r_buffer.resize(MAX(r_buffer.size()*2,p_len+p_bytes));
+	return &r_buffer[p_len];
+}
 
+static void _write(Vector<uint8_t>& r_buffer,int &r_len,const char *p_str,int p_count) {
 
+	uint8_t *w=_reserve(r_buffer,r_len,p_count);
+	for(int i=0;i<p_count;i++)
+		w[i]=p_str[i];
+	r_len+=p_count;
+}
 
-String JSON::_print_var(const Variant& p_var) {
+static void _write_int(Vector<uint8_t>& r_buffer,int &r_len,int64_t p_int) {
+
+	char buf[24];
+	int pos=24;
+	uint64_t n = p_int<0 ? -uint64_t(p_int) : uint64_t(p_int);
+	do {
+		buf[--pos]='0'+n%10;
+		n/=10;
+	} while(n);
+	if (p_int<0)
+		buf[--pos]='-';
+	_write(r_buffer,r_len,&buf[pos],24-pos);
+}
+
+static void _write_string(Vector<uint8_t>& r_buffer,int &r_len,const String& p_str) {
+
+	static const char hex[]="0123456789abcdef";
+
+	int len=p_str.length();
+	const CharType *c=p_str.c_str();
+	//worst case is \u00XX for every character
+	uint8_t *w=_reserve(r_buffer,r_len,len*6+2);
+	uint8_t *from=w;
+
+	*w++='"';
+	for(int i=0;i<len;i++) {
+
+		uint32_t ch=c[i];
+		if (ch>0x10FFFF)
+			ch=0xFFFD; //not unicode, can't be encoded
+		if (ch>=32 && ch!='"' && ch!='\\') {
+
+			if (ch<0x80) {
+				*w++=ch;
+			} else if (ch<0x800) {
+				*w++=0xC0|(ch>>6);
+				*w++=0x80|(ch&0x3F);
+			} else if (ch<0x10000) {
+				*w++=0xE0|(ch>>12);
+				*w++=0x80|((ch>>6)&0x3F);
+				*w++=0x80|(ch&0x3F);
+			} else {
+				*w++=0xF0|((ch>>18)&0x07);
+				*w++=0x80|((ch>>12)&0x3F);
+				*w++=0x80|((ch>>6)&0x3F);
+				*w++=0x80|(ch&0x3F);
+			}
+			continue;
+		}
+
+		*w++='\\';
+		switch(ch) {
+			case '"': *w++='"'; break;
+			case '\\': *w++='\\'; break;
+			case '\b': *w++='b'; break;
+			case '\f': *w++='f'; break;
+			case '\n': *w++='n'; break;
+			case '\r': *w++='r'; break;
+			case '\t': *w++='t'; break;
+			default: {
+				*w++='u';
+				*w++='0';
+				*w++='0';
+				*w++=hex[ch>>4];
+				*w++=hex[ch&0xF];
+			}
+		}
+	}
+	*w++='"';
+
+	r_len+=w-from;
+}
+
+void JSON::_print_var(const Variant& p_var,Vector<uint8_t>& r_buffer,int &r_len) {
 
 	switch(p_var.get_type()) {
 
-		case Variant::NIL: return "null";
-		case Variant::BOOL: return p_var.operator bool() ? "true": "false";
-		case Variant::INT: return itos(p_var);
-		case Variant::REAL: return rtos(p_var);
-		case Variant::INT_ARRAY:
+		case Variant::NIL: _write(r_buffer,r_len,"null",4); break;
+		case Variant::BOOL: {
+			if (p_var.operator bool())
+				_write(r_buffer,r_len,"true",4);
+			else
+				_write(r_buffer,r_len,"false",5);
+		} break;
+		case Variant::INT: _write_int(r_buffer,r_len,p_var.operator int()); break;
+		case Variant::REAL: {
+			CharString cs=rtos(p_var).ascii();
+			_write(r_buffer,r_len,cs.get_data(),cs.length());
+		} break;
+		case Variant::INT_ARRAY: {
+
+			DVector<int> a = p_var;
+			DVector<int>::Read r = a.read();
+			_write(r_buffer,r_len,"[",1);
+			for(int i=0;i<a.size();i++) {
+				if (i>0)
+					_write(r_buffer,r_len,", ",2);
+				_write_int(r_buffer,r_len,r[i]);
+			}
+			_write(r_buffer,r_len,"]",1);
+		} break;
 		case Variant::REAL_ARRAY:
 		case Variant::STRING_ARRAY:
 		case Variant::ARRAY: {
 
-			String s = "[";
 			Array a = p_var;
+			_write(r_buffer,r_len,"[",1);
 			for(int i=0;i<a.size();i++) {
 				if (i>0)
-					s+=", ";
-				s+=_print_var(a[i]);
+					_write(r_buffer,r_len,", ",2);
+				_print_var(a[i],r_buffer,r_len);
 			}
-			s+="]";
-			return s;
-		};
+			_write(r_buffer,r_len,"]",1);
+		} break;
 		case Variant::DICTIONARY: {
 
-			String s = "{";
 			Dictionary d = p_var;
 			List<Variant> keys;
 			d.get_key_list(&keys);
 
+			_write(r_buffer,r_len,"{",1);
 			for (List<Variant>::Element *E=keys.front();E;E=E->next()) {
 
 				if (E!=keys.front())
-					s+=", ";
-				s+=_print_var(String(E->get()));
-				s+=":";
-				s+=_print_var(d[E->get()]);
+					_write(r_buffer,r_len,", ",2);
+				_write_string(r_buffer,r_len,E->get());
+				_write(r_buffer,r_len,":",1);
+				_print_var(d[E->get()],r_buffer,r_len);
 			}
-
-			s+="}";
-			return s;
-		};
-		default: return "\""+String(p_var).c_escape()+"\"";
+			_write(r_buffer,r_len,"}",1);
+		} break;
+		default: _write_string(r_buffer,r_len,p_var); break;
 
 	}
 
 }
 
-String JSON::print(const Dictionary& p_dict) {
+void JSON::print_utf8(const Variant& p_var,Vector<uint8_t>& r_buffer) {
 
-	return _print_var(p_dict);
+	int len=0;
+	r_buffer.resize(256);
+	_print_var(p_var,r_buffer,len);
+	r_buffer.resize(len);
 }
 
+String JSON::print(const Dictionary& p_dict) {
 
-Error JSON::_get_token(const CharType *p_str, int &idx, int p_len, Token& r_token,int &line,String &r_err_str) {
+	Vector<uint8_t> buffer;
+	print_utf8(p_dict,buffer);
+	String s;
+	if (buffer.size())
+		s.parse_utf8((const char*)buffer.ptr(),buffer.size());
+	return s;
+}
 
-	while (true) {
-		switch(p_str[idx]) {
 
-			case '\n': {
+/* The parser is the same for String and UTF-8 input, it only differs in how characters are read */
 
-				line++;
-				idx++;
-				break;
-			};
-			case 0: {
-				r_token.type=TK_EOF;
-				return OK;
-			} break;
-			case '{': {
-
-				r_token.type=TK_CURLY_BRACKET_OPEN;
-				idx++;
-				return OK;
-			};
-			case '}': {
+static _FORCE_INLINE_ double _to_double(const CharType *p_str,const CharType **r_end) {
 
-				r_token.type=TK_CURLY_BRACKET_CLOSE;
-				idx++;
-				return OK;
-			};
-			case '[': {
+	return String::to_double(p_str,-1,r_end);
+}
 
-				r_token.type=TK_BRACKET_OPEN;
-				idx++;
-				return OK;
-			};
-			case ']': {
+static _FORCE_INLINE_ double _to_double(const uint8_t *p_str,const uint8_t **r_end) {
 
-				r_token.type=TK_BRACKET_CLOSE;
-				idx++;
-				return OK;
-			};
-			case ':': {
+	return String::to_double((const char*)p_str,(const char**)r_end);
+}
 
-				r_token.type=TK_COLON;
-				idx++;
-				return OK;
-			};
-			case ',': {
+template<class C>
+class JSONReader {
 
-				r_token.type=TK_COMMA;
-				idx++;
-				return OK;
-			};
-			case '"': {
-
-				idx++;
-				String str;
-				while(true) {
-					if (p_str[idx]==0) {
-						r_err_str="Unterminated String";
-						return ERR_PARSE_ERROR;
-					} else if (p_str[idx]=='"') {
-						idx++;
-						break;
-					} else if (p_str[idx]=='\\') {
-						//escaped characters...
-						idx++;
-						CharType next = p_str[idx];
-						if (next==0) {
-							r_err_str="Unterminated String";
-							return  ERR_PARSE_ERROR;
-						}
-						CharType res=0;
-
-						switch(next) {
-
-							case 'b': res=8; break;
-							case 't': res=9; break;
-							case 'n': res=10; break;
-							case 'f': res=12; break;
-							case 'r': res=13; break;
-							case '\"': res='\"'; break;
-							case '\\': res='\\'; break;
-							case '/': res='/'; break; //wtf
-							case 'u': {
-								//hexnumbarh - oct is deprecated
-
-
-								for(int j=0;j<4;j++) {
-									CharType c = p_str[idx+j+1];
-									if (c==0) {
-										r_err_str="Unterminated String";
-										return ERR_PARSE_ERROR;
-									}
-									if (!((c>='0' && c<='9') || (c>='a' && c<='f') || (c>='A' && c<='F'))) {
-
-										r_err_str="Malformed hex constant in string";
-										return ERR_PARSE_ERROR;
-									}
-									CharType v;
-									if (c>='0' && c<='9') {
-										v=c-'0';
-									} else if (c>='a' && c<='f') {
-										v=c-'a';
-										v+=10;
-									} else if (c>='A' && c<='F') {
-										v=c-'A';
-										v+=10;
-									} else {
-										ERR_PRINT("BUG");
-										v=0;
-									}
-
-									res<<=4;
-									res|=v;
-
-
-								}
-								idx+=4; //will add at the end anyway
-
-
-							} break;
-							default: {
-
-								r_err_str="Invalid escape sequence";
-								return ERR_PARSE_ERROR;
-							} break;
-						}
+	const C *str;
+	int len;
+	int idx;
+	int line;
+	JSON::Handler *handler;
+	String err_str;
 
-						str+=res;
+	//strings are decoded here, so no String is built per token
+	Vector<CharType> scratch;
+	int scratch_len;
 
-					} else {
-						if (p_str[idx]=='\n')
-							line++;
-						str+=p_str[idx];
-					}
-					idx++;
-				}
+	_FORCE_INLINE_ void _push_char(CharType p_char) {
 
-				r_token.type=TK_STRING;
-				r_token.value=str;
-				return OK;
+		if (scratch_len==scratch.size())
+			scratch.resize(MAX(64,scratch.size()*2));
+		scratch[scratch_len++]=p_char;
+	}
 
-			} break;
-			default: {
+	_FORCE_INLINE_ bool _read_utf8(CharType &r_char);
 
-				if (p_str[idx]<=32) {
-					idx++;
-					break;
-				}
+	_FORCE_INLINE_ void _skip_space() {
 
-				if (p_str[idx]=='-' || (p_str[idx]>='0' && p_str[idx]<='9')) {
-					//a number
-					const CharType *rptr;
-					double number = String::to_double(&p_str[idx],-1,&rptr);
-					idx+=(rptr - &p_str[idx]);
-					r_token.type=TK_NUMBER;
-					r_token.value=number;
-					return OK;
+		while(idx<len && str[idx]<=32) {
+			if (str[idx]=='\n')
+				line++;
+			idx++;
+		}
+	}
 
-				} else if ((p_str[idx]>='A' && p_str[idx]<='Z') || (p_str[idx]>='a' && p_str[idx]<='z')) {
+	Error _error(const String& p_err) {
 
-					String id;
+		err_str=p_err;
+		return ERR_PARSE_ERROR;
+	}
 
-					while((p_str[idx]>='A' && p_str[idx]<='Z') || (p_str[idx]>='a' && p_str[idx]<='z')) {
+	Error _parse_string();
+	Error _parse_number();
+	Error _parse_value(int p_depth);
 
-						id+=p_str[idx];
-						idx++;
-					}
+public:
 
-					r_token.type=TK_IDENTIFIER;
-					r_token.value=id;
-					return OK;
-				} else {
-					r_err_str="Unexpected character.";
-					return ERR_PARSE_ERROR;
-				}
-			}
+	Error parse(bool p_object_only) {
 
-		}
+		_skip_space();
+		if (p_object_only && (idx>=len || str[idx]!='{'))
+			return _error("Expected '{'");
+		return _parse_value(0);
 	}
 
-	return ERR_PARSE_ERROR;
-}
-
-
-
-Error JSON::_parse_value(Variant &value,Token& token,const CharType *p_str,int &index, int p_len,int &line,String &r_err_str) {
+	void get_error(String &r_err_str,int &r_err_line) const {
 
+		r_err_str=err_str;
+		r_err_line=line;
+	}
 
-	if (token.type==TK_CURLY_BRACKET_OPEN) {
+	JSONReader(const C *p_str,int p_len,JSON::Handler *p_handler) {
 
-		Dictionary d;
-		Error err = _parse_object(d,p_str,index,p_len,line,r_err_str);
-		if (err)
-			return err;
-		value=d;
-		return OK;
-	} else if (token.type==TK_BRACKET_OPEN) {
+		str=p_str;
+		len=p_len;
+		idx=0;
+		line=0;
+		handler=p_handler;
+		scratch_len=0;
+	}
+};
 
-		Array a;
-		Error err = _parse_array(a,p_str,index,p_len,line,r_err_str);
-		if (err)
-			return err;
-		value=a;
-		return OK;
+template<>
+bool JSONReader<CharType>::_read_utf8(CharType &r_char) {
 
-	} else if (token.type==TK_IDENTIFIER) {
-
-		String id = token.value;
-		if (id=="true")
-			value=true;
-		else if (id=="false")
-			value=false;
-		else if (id=="null")
-			value=Variant();
-		else {
-			r_err_str="Expected 'true','false' or 'null', got '"+id+"'.";
-			return ERR_PARSE_ERROR;
-		}
-		return OK;
+	r_char=str[idx++];
+	return true;
+}
 
-	} else if (token.type==TK_NUMBER) {
+template<>
+bool JSONReader<uint8_t>::_read_utf8(CharType &r_char) {
 
-		value=token.value;
-		return OK;
-	} else if (token.type==TK_STRING) {
+	uint32_t c=str[idx++];
+	if (c<0x80) {
+		r_char=c;
+		return true;
+	}
 
-		value=token.value;
-		return OK;
+	int extra;
+	if ((c&0xE0)==0xC0) {
+		extra=1;
+		c&=0x1F;
+	} else if ((c&0xF0)==0xE0) {
+		extra=2;
+		c&=0x0F;
+	} else if ((c&0xF8)==0xF0) {
+		extra=3;
+		c&=0x07;
 	} else {
-		r_err_str="Expected value, got "+String(tk_name[token.type])+".";
-		return ERR_PARSE_ERROR;
+		return false;
 	}
 
-	return ERR_PARSE_ERROR;
-}
-
+	if (idx+extra>len)
+		return false;
+	for(int i=0;i<extra;i++) {
+		uint32_t cc=str[idx++];
+		if ((cc&0xC0)!=0x80)
+			return false;
+		c=(c<<6)|(cc&0x3F);
+	}
 
-Error JSON::_parse_array(Array &array,const CharType *p_str,int &index, int p_len,int &line,String &r_err_str) {
+	r_char=c;
+	return true;
+}
 
-	Token token;
-	bool need_comma=false;
+template<class C>
+Error JSONReader<C>::_parse_string() {
+
+	idx++; //opening quote
+	scratch_len=0;
+
+	while(true) {
+
+		if (idx>=len || str[idx]==0)
+			return _error("Unterminated String");
+
+		uint32_t c=str[idx];
+		if (c=='"') {
+			idx++;
+			break;
+		} else if (c=='\\') {
+			//escaped characters...
+			idx++;
+			if (idx>=len || str[idx]==0)
+				return _error("Unterminated String");
+
+			CharType res=0;
+			switch(str[idx]) {
+
+				case 'b': res=8; break;
+				case 't': res=9; break;
+				case 'n': res=10; break;
+				case 'f': res=12; break;
+				case 'r': res=13; break;
+				case '\"': res='\"'; break;
+				case '\\': res='\\'; break;
+				case '/': res='/'; break; //wtf
+				case 'u': {
+					//hexnumbarh - oct is deprecated
+					for(int j=0;j<4;j++) {
+
+						if (idx+j+1>=len || str[idx+j+1]==0)
+							return _error("Unterminated String");
+						uint32_t h=str[idx+j+1];
+						CharType v;
+						if (h>='0' && h<='9') {
+							v=h-'0';
+						} else if (h>='a' && h<='f') {
+							v=h-'a'+10;
+						} else if (h>='A' && h<='F') {
+							v=h-'A'+10;
+						} else {
+							return _error("Malformed hex constant in string");
+						}
 
+						res<<=4;
+						res|=v;
+					}
+					idx+=4; //will add at the end anyway
 
-	while(index<p_len) {
+				} break;
+				default: {
 
-		Error err = _get_token(p_str,index,p_len,token,line,r_err_str);
-		if (err!=OK)
-			return err;
+					return _error("Invalid escape sequence");
+				} break;
+			}
 
-		if (token.type==TK_BRACKET_CLOSE) {
+			idx++;
+			_push_char(res);
 
-			return OK;
+		} else {
+			if (c=='\n')
+				line++;
+			CharType ch;
+			if (!_read_utf8(ch))
+				return _error("Invalid UTF-8 in string");
+			_push_char(ch);
 		}
+	}
 
-		if (need_comma) {
+	_push_char(0);
+	return OK;
+}
 
-			if (token.type!=TK_COMMA) {
+template<class C>
+Error JSONReader<C>::_parse_number() {
 
-				r_err_str="Expected ','";
-				return ERR_PARSE_ERROR;
-			} else {
-				need_comma=false;
-				continue;
-			}
-		}
+	int from=idx;
+	bool negative=false;
+	if (str[idx]=='-') {
+		negative=true;
+		idx++;
+	}
 
-		Variant v;
-		err = _parse_value(v,token,p_str,index,p_len,line,r_err_str);
-		if (err)
-			return err;
+	//integers are read directly, anything with a fraction, exponent or too many digits as real
+	uint64_t n=0;
+	int digits=0;
+	while(idx<len && str[idx]>='0' && str[idx]<='9') {
+		n=n*10+(str[idx]-'0');
+		digits++;
+		idx++;
+	}
 
-		array.push_back(v);
-		need_comma=true;
+	if (digits>0 && digits<=18 && (idx>=len || (str[idx]!='.' && str[idx]!='e' && str[idx]!='E')))
+		return handler->value_int(negative ? -int64_t(n) : int64_t(n));
 
-	}
+	//the input is not always zero terminated, so a number ending the buffer is parsed from a copy
+	int to=idx;
+	while(to<len && ((str[to]>='0' && str[to]<='9') || str[to]=='.' || str[to]=='e' || str[to]=='E' || str[to]=='+' || str[to]=='-'))
+		to++;
 
-	return OK;
+	double number;
+	int used;
+	if (to<len) {
+		const C *end;
+		number = _to_double(&str[from],&end);
+		used=end-&str[from];
+	} else {
+		C buf[64];
+		int l=MIN(to-from,63);
+		for(int i=0;i<l;i++)
+			buf[i]=str[from+i];
+		buf[l]=0;
+		const C *end;
+		number = _to_double(buf,&end);
+		used=end-buf;
+	}
 
+	if (used==0)
+		return _error("Unexpected character.");
+	idx=from+used;
+	return handler->value_real(number);
 }
 
-Error JSON::_parse_object(Dictionary &object,const CharType *p_str,int &index, int p_len,int &line,String &r_err_str) {
+template<class C>
+Error JSONReader<C>::_parse_value(int p_depth) {
 
-	bool at_key=true;
-	String key;
-	Token token;
-	bool need_comma=false;
+	if (p_depth>JSON::MAX_DEPTH)
+		return _error("Too many nested objects or arrays");
 
+	_skip_space();
+	if (idx>=len || str[idx]==0)
+		return _error("Expected value, got EOF.");
 
-	while(index<p_len) {
+	Error err;
+	uint32_t c=str[idx];
 
+	switch(c) {
 
-		if (at_key) {
+		case '{': {
 
-			Error err = _get_token(p_str,index,p_len,token,line,r_err_str);
-			if (err!=OK)
+			idx++;
+			err=handler->object_begin();
+			if (err)
 				return err;
 
-			if (token.type==TK_CURLY_BRACKET_CLOSE) {
-
-				return OK;
+			_skip_space();
+			if (idx<len && str[idx]=='}') {
+				idx++;
+				return handler->object_end();
 			}
 
-			if (need_comma) {
+			while(true) {
+
+				_skip_space();
+				if (idx>=len || str[idx]!='"')
+					return _error("Expected key");
+				err=_parse_string();
+				if (err)
+					return err;
+				err=handler->object_key(scratch.ptr(),scratch_len-1);
+				if (err)
+					return err;
+
+				_skip_space();
+				if (idx>=len || str[idx]!=':')
+					return _error("Expected ':'");
+				idx++;
 
-				if (token.type!=TK_COMMA) {
+				err=_parse_value(p_depth+1);
+				if (err)
+					return err;
 
-					r_err_str="Expected '}' or ','";
-					return ERR_PARSE_ERROR;
+				_skip_space();
+				if (idx<len && str[idx]==',') {
+					idx++;
+				} else if (idx<len && str[idx]=='}') {
+					idx++;
+					return handler->object_end();
 				} else {
-					need_comma=false;
-					continue;
+					return _error("Expected '}' or ','");
 				}
 			}
+		} break;
+		case '[': {
 
-			if (token.type!=TK_STRING) {
+			idx++;
+			err=handler->array_begin();
+			if (err)
+				return err;
 
+			_skip_space();
+			if (idx<len && str[idx]==']') {
+				idx++;
+				return handler->array_end();
+			}
+
+			while(true) {
+
+				err=_parse_value(p_depth+1);
+				if (err)
+					return err;
 
-				r_err_str="Expected key";
-				return ERR_PARSE_ERROR;
+				_skip_space();
+				if (idx<len && str[idx]==',') {
+					idx++;
+				} else if (idx<len && str[idx]==']') {
+					idx++;
+					return handler->array_end();
+				} else {
+					return _error("Expected ','");
+				}
 			}
+		} break;
+		case '"': {
 
-			key=token.value;
-			err = _get_token(p_str,index,p_len,token,line,r_err_str);
-			if (err!=OK)
+			err=_parse_string();
+			if (err)
 				return err;
-			if (token.type!=TK_COLON) {
+			return handler->value_string(scratch.ptr(),scratch_len-1);
+		} break;
+		default: {
 
-				r_err_str="Expected ':'";
-				return ERR_PARSE_ERROR;
-			}
-			at_key=false;
-		} else {
+			if (c=='-' || (c>='0' && c<='9'))
+				return _parse_number();
 
+			if ((c>='A' && c<='Z') || (c>='a' && c<='z')) {
 
-			Error err = _get_token(p_str,index,p_len,token,line,r_err_str);
-			if (err!=OK)
-				return err;
+				int from=idx;
+				while(idx<len && ((str[idx]>='A' && str[idx]<='Z') || (str[idx]>='a' && str[idx]<='z')))
+					idx++;
 
-			Variant v;
-			err = _parse_value(v,token,p_str,index,p_len,line,r_err_str);
-			if (err)
-				return err;
-			object[key]=v;
-			need_comma=true;
-			at_key=true;
+				int l=idx-from;
+				const C *id=&str[from];
+				if (l==4 && id[0]=='t' && id[1]=='r' && id[2]=='u' && id[3]=='e')
+					return handler->value_bool(true);
+				if (l==5 && id[0]=='f' && id[1]=='a' && id[2]=='l' && id[3]=='s' && id[4]=='e')
+					return handler->value_bool(false);
+				if (l==4 && id[0]=='n' && id[1]=='u' && id[2]=='l' && id[3]=='l')
+					return handler->value_null();
+
+				String ids;
+				for(int i=0;i<l;i++)
+					ids+=CharType(id[i]);
+				return _error("Expected 'true','false' or 'null', got '"+ids+"'.");
+			}
+
+			return _error("Unexpected character.");
 		}
 	}
 
-	return OK;
+	return ERR_PARSE_ERROR;
 }
 
+/* Builds the Variant tree, used by parse() */
 
-Error JSON::parse(const String& p_json,Dictionary& r_ret,String &r_err_str,int &r_err_line) {
+class JSONTreeBuilder : public JSON::Handler {
 
+	struct Level {
+		bool is_dict;
+		Dictionary dict;
+		String key;
+		//array items are gathered here and the Array is sized once at the end
+		Vector<Variant> items;
+		int item_count;
+	};
 
-	const CharType *str = p_json.ptr();
-	int idx = 0;
-	int len = p_json.length();
-	Token token;
-	int line=0;
-	String aux_key;
+	Dictionary *root;
+	Vector<Level> stack;
+	int depth;
 
-	Error err = _get_token(str,idx,len,token,line,r_err_str);
-	if (err)
-		return err;
+	_FORCE_INLINE_ Dictionary &_dict(int p_level) {
 
-	if (token.type!=TK_CURLY_BRACKET_OPEN) {
+		//the outermost object is the result dictionary itself
+		return p_level==0 ? *root : stack[p_level].dict;
+	}
 
-		r_err_str="Expected '{'";
-		return ERR_PARSE_ERROR;
+	Error _add(const Variant& p_value) {
+
+		if (depth==0)
+			return OK;
+		Level &l=stack[depth-1];
+		if (l.is_dict) {
+			_dict(depth-1)[l.key]=p_value;
+		} else {
+			if (l.item_count==l.items.size())
+				l.items.resize(MAX(16,l.items.size()*2));
+			l.items[l.item_count++]=p_value;
+		}
+		return OK;
+	}
+
+	Error _begin(bool p_dict) {
+
+		if (depth==stack.size())
+			stack.resize(depth+1);
+		stack[depth].is_dict=p_dict;
+		stack[depth].item_count=0;
+		depth++;
+		return OK;
 	}
 
-	return _parse_object(r_ret,str,idx,len,r_err_line,r_err_str);
+	Error _end() {
+
+		depth--;
+		if (depth==0)
+			return OK;
+
+		Level &l=stack[depth];
+		if (l.is_dict) {
+			Error err=_add(l.dict);
+			l.dict=Dictionary();
+			return err;
+		}
 
+		Array a;
+		a.resize(l.item_count);
+		for(int i=0;i<l.item_count;i++) {
+			a[i]=l.items[i];
+			l.items[i]=Variant();
+		}
+		return _add(a);
+	}
+
+public:
+
+	virtual Error object_begin() { return _begin(true); }
+	virtual Error object_key(const CharType *p_key,int p_len) { stack[depth-1].key=String(p_key,p_len); return OK; }
+	virtual Error object_end() { return _end(); }
+	virtual Error array_begin() { return _begin(false); }
+	virtual Error array_end() { return _end(); }
+	virtual Error value_string(const CharType *p_str,int p_len) { return _add(String(p_str,p_len)); }
+	//numbers stay reals as before, ints in Variant are 32 bits
+	virtual Error value_int(int64_t p_int) { return _add(double(p_int)); }
+	virtual Error value_real(double p_real) { return _add(p_real); }
+	virtual Error value_bool(bool p_bool) { return _add(p_bool); }
+	virtual Error value_null() { return _add(Variant()); }
+
+	JSONTreeBuilder(Dictionary *p_root) { root=p_root; depth=0; }
+};
+
+
+Error JSON::parse_events(const String& p_json,Handler *p_handler,String &r_err_str,int &r_err_line) {
+
+	JSONReader<CharType> reader(p_json.c_str(),p_json.length(),p_handler);
+	Error err = reader.parse(false);
+	if (err)
+		reader.get_error(r_err_str,r_err_line);
+	return err;
+}
+
+Error JSON::parse_events_utf8(const uint8_t *p_json,int p_len,Handler *p_handler,String &r_err_str,int &r_err_line) {
+
+	JSONReader<uint8_t> reader(p_json,p_len,p_handler);
+	Error err = reader.parse(false);
+	if (err)
+		reader.get_error(r_err_str,r_err_line);
+	return err;
+}
+
+Error JSON::parse(const String& p_json,Dictionary& r_ret,String &r_err_str,int &r_err_line) {
+
+	JSONTreeBuilder builder(&r_ret);
+	JSONReader<CharType> reader(p_json.c_str(),p_json.length(),&builder);
+	Error err = reader.parse(true);
+	if (err)
+		reader.get_error(r_err_str,r_err_line);
+	return err;
 }
 
+Error JSON::parse_utf8(const uint8_t *p_json,int p_len,Dictionary& r_ret,String &r_err_str,int &r_err_line) {
 
+	JSONTreeBuilder builder(&r_ret);
+	JSONReader<uint8_t> reader(p_json,p_len,&builder);
+	Error err = reader.parse(true);
+	if (err)
+		reader.get_error(r_err_str,r_err_line);
+	return err;
+}
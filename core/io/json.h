@@ -35,47 +35,42 @@
 
 
 class JSON {
+public:
 
-	enum TokenType {
-		TK_CURLY_BRACKET_OPEN,
-		TK_CURLY_BRACKET_CLOSE,
-		TK_BRACKET_OPEN,
-		TK_BRACKET_CLOSE,
-		TK_IDENTIFIER,
-		TK_STRING,
-		TK_NUMBER,
-		TK_COLON,
-		TK_COMMA,
-		TK_EOF,
-		TK_MAX
-	};
+	//receives a document as it is parsed, without building Variants. Strings are only valid
+	//during the call. Returning anything but OK stops the parse with that error.
+	class Handler {
+	public:
 
-	enum Expecting {
+		virtual Error object_begin() { return OK; }
+		virtual Error object_key(const CharType *p_key,int p_len) { return OK; }
+		virtual Error object_end() { return OK; }
+		virtual Error array_begin() { return OK; }
+		virtual Error array_end() { return OK; }
+		virtual Error value_string(const CharType *p_str,int p_len) { return OK; }
+		virtual Error value_int(int64_t p_int) { return OK; } ///< numbers without fraction or exponent that fit
+		virtual Error value_real(double p_real) { return OK; }
+		virtual Error value_bool(bool p_bool) { return OK; }
+		virtual Error value_null() { return OK; }
 
-		EXPECT_OBJECT,
-		EXPECT_OBJECT_KEY,
-		EXPECT_COLON,
-		EXPECT_OBJECT_VALUE,
+		virtual ~Handler() {}
 	};
 
-	struct Token {
-
-		TokenType type;
-		Variant value;
+	enum {
+		MAX_DEPTH=512
 	};
 
-	static const char * tk_name[TK_MAX];
-
-	static String _print_var(const Variant& p_var);
+private:
 
-	static Error _get_token(const CharType *p_str,int &index, int p_len,Token& r_token,int &line,String &r_err_str);
-	static Error _parse_value(Variant &value,Token& token,const CharType *p_str,int &index, int p_len,int &line,String &r_err_str);
-	static Error _parse_array(Array &array,const CharType *p_str,int &index, int p_len,int &line,String &r_err_str);
-	static Error _parse_object(Dictionary &object,const CharType *p_str,int &index, int p_len,int &line,String &r_err_str);
+	static void _print_var(const Variant& p_var,Vector<uint8_t>& r_buffer,int &r_len);
 
 public:
 	static String print(const Dictionary& p_dict);
+	static void print_utf8(const Variant& p_var,Vector<uint8_t>& r_buffer); ///< r_buffer is resized to the output
 	static Error parse(const String& p_json,Dictionary& r_ret,String &r_err_str,int &r_err_line);
+	static Error parse_utf8(const uint8_t *p_json,int p_len,Dictionary& r_ret,String &r_err_str,int &r_err_line);
+	static Error parse_events(const String& p_json,Handler *p_handler,String &r_err_str,int &r_err_line);
+	static Error parse_events_utf8(const uint8_t *p_json,int p_len,Handler *p_handler,String &r_err_str,int &r_err_line);
 };
 
 #endif // JSON_H
@@ -0,0 +1,210 @@
+/*************************************************************************/
+/*  lz4.c                                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "lz4.h"
+
+#include <string.h>
+
+#define LZ4_HASH_LOG 12
+#define LZ4_MIN_MATCH 4
+#define LZ4_MF_LIMIT 12 /* no match may start closer than this to the end */
+#define LZ4_LAST_LITERALS 5 /* nor end closer than this */
+#define LZ4_MAX_OFFSET 65535
+
+typedef unsigned char lz4_u8;
+typedef unsigned int lz4_u32;
+
+static lz4_u32 lz4_read32(const lz4_u8 *p) {
+
+	lz4_u32 v;
+	memcpy(&v,p,4);
+	return v;
+}
+
+static lz4_u32 lz4_hash(lz4_u32 v) {
+
+	return (v*2654435761U)>>(32-LZ4_HASH_LOG);
+}
+
+static lz4_u8 *lz4_write_len(lz4_u8 *op, int len) {
+
+	while(len>=255) {
+		*op++=255;
+		len-=255;
+	}
+	*op++=(lz4_u8)len;
+	return op;
+}
+
+static lz4_u8 *lz4_write_literals(lz4_u8 *op, const lz4_u8 *lit, int len, int match_len) {
+
+	lz4_u8 *token=op++;
+	*token=(lz4_u8)(((len>=15?15:len)<<4)|(match_len>=15?15:match_len));
+	if (len>=15)
+		op=lz4_write_len(op,len-15);
+	memcpy(op,lit,len);
+	return op+len;
+}
+
+int lz4_compress_bound(int length) {
+
+	return length+length/255+16;
+}
+
+int lz4_compress(const void* input, int length, void* output) {
+
+	const lz4_u8 *src=(const lz4_u8*)input;
+	const lz4_u8 *ip=src;
+	const lz4_u8 *anchor=src;
+	const lz4_u8 *end=src+length;
+	const lz4_u8 *mf_limit=end-LZ4_MF_LIMIT;
+	const lz4_u8 *match_limit=end-LZ4_LAST_LITERALS;
+	lz4_u8 *op=(lz4_u8*)output;
+	int table[1<<LZ4_HASH_LOG];
+	int misses=0;
+
+	if (length>LZ4_MF_LIMIT) {
+
+		memset(table,0,sizeof(table));
+		ip++;
+
+		while(ip<mf_limit) {
+
+			lz4_u32 seq=lz4_read32(ip);
+			lz4_u32 h=lz4_hash(seq);
+			const lz4_u8 *ref=src+table[h];
+			const lz4_u8 *m;
+			const lz4_u8 *r;
+			int match_len;
+			int offset;
+			table[h]=(int)(ip-src);
+
+			if (ref>=ip || ip-ref>LZ4_MAX_OFFSET || lz4_read32(ref)!=seq) {
+				/* skip faster over data that does not compress */
+				ip+=1+(misses++>>6);
+				continue;
+			}
+
+			while(ip>anchor && ref>src && ip[-1]==ref[-1]) {
+				ip--;
+				ref--;
+			}
+
+			m=ip+LZ4_MIN_MATCH;
+			r=ref+LZ4_MIN_MATCH;
+			while(m<match_limit && *m==*r) {
+				m++;
+				r++;
+			}
+
+			match_len=(int)(m-ip)-LZ4_MIN_MATCH;
+			offset=(int)(ip-ref);
+			op=lz4_write_literals(op,anchor,(int)(ip-anchor),match_len);
+			*op++=(lz4_u8)(offset&0xFF);
+			*op++=(lz4_u8)(offset>>8);
+			if (match_len>=15)
+				op=lz4_write_len(op,match_len-15);
+
+			ip=m;
+			anchor=ip;
+			misses=0;
+			if (ip<mf_limit)
+				table[lz4_hash(lz4_read32(ip-2))]=(int)(ip-2-src);
+		}
+	}
+
+	op=lz4_write_literals(op,anchor,(int)(end-anchor),0);
+	return (int)(op-(lz4_u8*)output);
+}
+
+int lz4_decompress(const void* input, int length, void* output, int maxout) {
+
+	const lz4_u8 *ip=(const lz4_u8*)input;
+	const lz4_u8 *iend=ip+length;
+	lz4_u8 *dst=(lz4_u8*)output;
+	lz4_u8 *op=dst;
+	lz4_u8 *oend=dst+maxout;
+
+	while(ip<iend) {
+
+		int token=*ip++;
+		int len=token>>4;
+		int offset;
+		const lz4_u8 *ref;
+		if (len==15) {
+			int b;
+			do {
+				if (ip>=iend)
+					return -1;
+				b=*ip++;
+				len+=b;
+			} while(b==255);
+		}
+
+		if (len>iend-ip || len>oend-op)
+			return -1;
+		memcpy(op,ip,len);
+		op+=len;
+		ip+=len;
+
+		if (ip>=iend)
+			break; /* last sequence has no match */
+
+		if (iend-ip<2)
+			return -1;
+		offset=ip[0]|(ip[1]<<8);
+		ip+=2;
+		if (offset==0 || offset>op-dst)
+			return -1;
+
+		len=token&15;
+		if (len==15) {
+			int b;
+			do {
+				if (ip>=iend)
+					return -1;
+				b=*ip++;
+				len+=b;
+			} while(b==255);
+		}
+		len+=LZ4_MIN_MATCH;
+		if (len>oend-op)
+			return -1;
+
+		ref=op-offset;
+		if (offset>=len) {
+			memcpy(op,ref,len);
+			op+=len;
+		} else {
+			while(len--)
+				*op++=*ref++;
+		}
+	}
+
+	return (int)(op-dst);
+}
@@ -0,0 +1,51 @@
+/*************************************************************************/
+/*  lz4.h                                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef LZ4_H
+#define LZ4_H
+
+/* Minimal codec for the LZ4 block format (no frames), output is readable by any LZ4 implementation */
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/* worst case size of the compressed output for a block of p_length bytes */
+int lz4_compress_bound(int length);
+
+/* returns the compressed size, output must hold at least lz4_compress_bound(length) bytes */
+int lz4_compress(const void* input, int length, void* output);
+
+/* returns the decompressed size, or -1 if the input is malformed or does not fit in maxout */
+int lz4_decompress(const void* input, int length, void* output, int maxout);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* LZ4_H */
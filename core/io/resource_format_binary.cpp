@@ -115,6 +115,38 @@ void ResourceInteractiveLoaderBinary::_advance_padding(uint32_t p_len) {
 
 }
 
+template<class T>
+bool ResourceInteractiveLoaderBinary::_alias_array(DVector<T>& r_array,uint32_t p_len,uint32_t p_elem_size) {
+
+	// big arrays are used straight from the file mapping, the length that
+	// precedes them is overwritten with the DVector reference count
+#ifdef BIG_ENDIAN_ENABLED
+	return false;
+#else
+	if (sizeof(T)!=p_elem_size)
+		return false; //in memory layout differs from the file (ie, real_t is double)
+	if (!mmap || f->get_endian_swap() || p_len*sizeof(T)<MMAP_ALIAS_MIN_SIZE)
+		return false;
+
+	size_t pos = f->get_pos();
+	if (pos<sizeof(int) || pos+p_len*sizeof(T)>mmap->size)
+		return false;
+
+	uint8_t *block = mmap->ptr+pos-sizeof(int);
+	if (((size_t)block)%sizeof(int))
+		return false;
+
+	mmap->refcount.ref();
+	if (!r_array.alias(block,p_len,FileAccess::mmap_unref,mmap)) {
+		FileAccess::mmap_unref(mmap);
+		return false;
+	}
+
+	f->seek(pos+p_len*sizeof(T));
+	return true;
+#endif
+}
+
 Error ResourceInteractiveLoaderBinary::parse_variant(Variant& r_v)  {
 
 
@@ -301,11 +333,13 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant& r_v)  {
 				uint32_t datalen = f->get_32();
 
 				DVector<uint8_t> imgdata;
-				imgdata.resize(datalen);
-				DVector<uint8_t>::Write w = imgdata.write();
-				f->get_buffer(w.ptr(),datalen);
+				if (!_alias_array(imgdata,datalen,1)) {
+
+					imgdata.resize(datalen);
+					DVector<uint8_t>::Write w = imgdata.write();
+					f->get_buffer(w.ptr(),datalen);
+				}
 				_advance_padding(datalen);
-				w=DVector<uint8_t>::Write();
 
 				r_v=Image(width,height,mipmaps,fmt,imgdata);
 
@@ -448,6 +482,11 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant& r_v)  {
 			uint32_t len = f->get_32();
 
 			DVector<uint8_t> array;
+			if (_alias_array(array,len,1)) {
+				_advance_padding(len);
+				r_v=array;
+				break;
+			}
 			array.resize(len);
 			DVector<uint8_t>::Write w = array.write();
 			f->get_buffer(w.ptr(),len);
@@ -461,6 +500,10 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant& r_v)  {
 			uint32_t len = f->get_32();
 
 			DVector<int> array;
+			if (_alias_array(array,len,4)) {
+				r_v=array;
+				break;
+			}
 			array.resize(len);
 			DVector<int>::Write w = array.write();
 			f->get_buffer((uint8_t*)w.ptr(),len*4);
@@ -482,6 +525,10 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant& r_v)  {
 			uint32_t len = f->get_32();
 
 			DVector<real_t> array;
+			if (_alias_array(array,len,4)) {
+				r_v=array;
+				break;
+			}
 			array.resize(len);
 			DVector<real_t>::Write w = array.write();
 			f->get_buffer((uint8_t*)w.ptr(),len*sizeof(real_t));
@@ -517,6 +564,10 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant& r_v)  {
 			uint32_t len = f->get_32();
 
 			DVector<Vector2> array;
+			if (_alias_array(array,len,8)) {
+				r_v=array;
+				break;
+			}
 			array.resize(len);
 			DVector<Vector2>::Write w = array.write();
 			if (sizeof(Vector2)==8) {
@@ -545,6 +596,10 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant& r_v)  {
 			uint32_t len = f->get_32();
 
 			DVector<Vector3> array;
+			if (_alias_array(array,len,12)) {
+				r_v=array;
+				break;
+			}
 			array.resize(len);
 			DVector<Vector3>::Write w = array.write();
 			if (sizeof(Vector3)==12) {
@@ -573,6 +628,10 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant& r_v)  {
 			uint32_t len = f->get_32();
 
 			DVector<Color> array;
+			if (_alias_array(array,len,16)) {
+				r_v=array;
+				break;
+			}
 			array.resize(len);
 			DVector<Color>::Write w = array.write();
 			if (sizeof(Color)==16) {
@@ -839,6 +898,8 @@ void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 		ERR_FAIL_V();
 	}
 
+	mmap=f->get_mmap();
+
 	bool big_endian = f->get_32();
 #ifdef BIG_ENDIAN_ENABLED
 	endian_swap = !big_endian;
@@ -981,6 +1042,7 @@ String ResourceInteractiveLoaderBinary::recognize(FileAccess *p_f) {
 ResourceInteractiveLoaderBinary::ResourceInteractiveLoaderBinary() {
 
 	f=NULL;
+	mmap=NULL;
 	stage=0;
 	endian_swap=false;
 	use_real64=false;
@@ -1710,8 +1772,13 @@ void ResourceFormatSaverBinaryInstance::save_unicode_string(const String& p_stri
 
 
 	CharString utf8 = p_string.utf8();
-	f->store_32(utf8.length()+1);
-	f->store_buffer((const uint8_t*)utf8.get_data(),utf8.length()+1);
+	// zero padded so what follows stays 32 bits aligned (arrays can be mapped in place), parsing stops at the first zero
+	int len = utf8.length()+1;
+	int padded_len = (len+3)&~3;
+	f->store_32(padded_len);
+	f->store_buffer((const uint8_t*)utf8.get_data(),len);
+	for(int i=len;i<padded_len;i++)
+		f->store_8(0);
 }
 
 int ResourceFormatSaverBinaryInstance::get_string_index(const String& p_string) {
@@ -1731,7 +1798,9 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path,const RES& p_
 	Error err;
 	if (p_flags&ResourceSaver::FLAG_COMPRESS) {
 		FileAccessCompressed *fac = memnew( FileAccessCompressed );
-		fac->configure("RSCC");
+		int mode = GLOBAL_DEF("resource/compression_mode",Compression::MODE_FASTLZ);
+		int block_size = GLOBAL_DEF("resource/compression_block_size",4096);
+		fac->configure("RSCC",Compression::Mode(mode),block_size);
 		f=fac;
 		err = fac->_open(p_path,FileAccess::WRITE);
 		if (err)
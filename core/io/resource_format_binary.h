@@ -42,6 +42,7 @@ class ResourceInteractiveLoaderBinary : public ResourceInteractiveLoader {
 	Ref<Resource> resource;
 
 	FileAccess *f;
+	FileAccess::MMap *mmap;
 
 
 	bool endian_swap;
@@ -68,8 +69,14 @@ class ResourceInteractiveLoaderBinary : public ResourceInteractiveLoader {
 
 	Vector<IntResoucre> internal_resources;
 
+	enum {
+		MMAP_ALIAS_MIN_SIZE=65536
+	};
+
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
+	template<class T>
+	bool _alias_array(DVector<T>& r_array,uint32_t p_len,uint32_t p_elem_size);
 
 	Error error;
 
@@ -30,41 +30,108 @@
 #include "globals.h"
 #include "version.h"
 
+#include <string.h>
 
 
-ResourceInteractiveLoaderXML::Tag* ResourceInteractiveLoaderXML::parse_tag(bool *r_exit,bool p_printerr) {
 
+const ResourceInteractiveLoaderXML::Tag::Args::Arg *ResourceInteractiveLoaderXML::Tag::Args::find(const char *p_name) const {
 
-	while(get_char()!='<' && !f->eof_reached()) {}
-	if (f->eof_reached()) {
-		return NULL;
+	for(int i=0;i<count;i++) {
+
+		const Arg &a=args[i];
+		if (strncmp(a.name,p_name,a.name_len)==0 && p_name[a.name_len]==0)
+			return &a;
+	}
+
+	return NULL;
+}
+
+String ResourceInteractiveLoaderXML::Tag::Args::operator[](const char *p_name) const {
+
+	const Arg *a=find(p_name);
+	String value;
+	if (a)
+		value.parse_utf8(a->value,a->value_len);
+	return value;
+}
+
+bool ResourceInteractiveLoaderXML::_fill() {
+
+	if (buffer_len>=file_len)
+		return false;
+
+	//chunks grow with what was read so far, so small reads (recognize, dependencies) stay small
+	int chunk=MIN(MAX(int(READ_CHUNK_SIZE),buffer_len),file_len-buffer_len);
+	int read=f->get_buffer((uint8_t*)&buffer[buffer_len],chunk);
+	if (read<=0) {
+		file_len=buffer_len;
+		return false;
+	}
+
+	buffer_len+=read;
+	buffer[buffer_len]=0;
+	return true;
+}
+
+int ResourceInteractiveLoaderXML::_find(char p_char) {
+
+	int from=pos;
+	while(true) {
+
+		const char *found=(const char*)memchr(&buffer[from],p_char,buffer_len-from);
+		if (found)
+			return found-buffer;
+		from=buffer_len;
+		if (!_fill()) {
+			eof=true;
+			return -1;
+		}
 	}
+}
+
+void ResourceInteractiveLoaderXML::_open_buffer(FileAccess *p_f) {
+
+	error=OK;
+	lines=1;
+	line_pos=0;
+	f=p_f;
+
+	if (buffer)
+		memdelete_arr(buffer);
+	file_len=f->get_len();
+	buffer=memnew_arr(char,file_len+1);
+	buffer[0]=0;
+	buffer_len=0;
+	pos=0;
+	eof=false;
+}
+
+ResourceInteractiveLoaderXML::Tag* ResourceInteractiveLoaderXML::parse_tag(bool *r_exit,bool p_printerr) {
+
+	int from=_find('<');
+	if (from<0)
+		return NULL;
+	pos=from+1;
 
 	Tag tag;
 	bool exit=false;
 	if (r_exit)
 		*r_exit=false;
 
-	bool complete=false;
-	while(!f->eof_reached()) {
-
-		CharType c=get_char();
-		if (c<33 && tag.name.length() && !exit) {
-			break;
-		} else if (c=='>') {
-			complete=true;
-			break;
-		} else if (c=='/') {
-			exit=true;
-		} else {
-			tag.name+=c;
-		}
+	if (_peek()=='/') {
+		exit=true;
+		pos++;
 	}
 
-	if (f->eof_reached()) {
+	int c;
+	int name_from=pos;
+	while((c=_peek())>32 && c!='>' && c!='/')
+		pos++;
 
+	if (c<0)
 		return NULL;
-	}
+
+	tag.name.parse_utf8(&buffer[name_from],pos-name_from);
 
 	if (exit) {
 		if (!tag_stack.size()) {
@@ -81,11 +148,10 @@ ResourceInteractiveLoaderXML::Tag* ResourceInteractiveLoaderXML::parse_tag(bool
 			ERR_FAIL_COND_V(tag_stack.back()->get().name!=tag.name,NULL);
 		}
 
-		if (!complete) {
-			while(get_char()!='>' && !f->eof_reached()) {}
-			if (f->eof_reached())
-				return NULL;
-		}
+		int end=_find('>');
+		if (end<0)
+			return NULL;
+		pos=end+1;
 
 		if (r_exit)
 			*r_exit=true;
@@ -95,47 +161,65 @@ ResourceInteractiveLoaderXML::Tag* ResourceInteractiveLoaderXML::parse_tag(bool
 
 	}
 
-	if (!complete) {
-		String name;
-		CharString r_value;
-		bool reading_value=false;
-
-		while(!f->eof_reached()) {
-
-			CharType c=get_char();
-			if (c=='>') {
-				if (r_value.size()) {
+	while(true) {
 
-					r_value.push_back(0);
-					tag.args[name].parse_utf8(r_value.get_data());
-				}
-				break;
+		c=_peek();
+		if (c<0)
+			return NULL;
+		if (c=='>') {
+			pos++;
+			break;
+		}
+		if (c<33 || c=='/' || c=='?') {
+			pos++;
+			continue;
+		}
 
-			} else if ( ((!reading_value && (c<33)) || c=='=' || c=='"' || c=='\'') && tag.name.length()) {
+		int arg_from=pos;
+		while((c=_peek())>32 && c!='=' && c!='>' && c!='/')
+			pos++;
+		int arg_len=pos-arg_from;
 
-				if (!reading_value && name.length()) {
+		while((c=_peek())>=0 && c<33)
+			pos++;
+		if (c!='=')
+			continue; //no value, ignore
 
-					reading_value=true;
-				} else if (reading_value && r_value.size()) {
+		pos++;
+		while((c=_peek())>=0 && c<33)
+			pos++;
+		if (c<0)
+			return NULL;
 
-					r_value.push_back(0);
-					tag.args[name].parse_utf8(r_value.get_data());
-					name="";
-					r_value.clear();
-					reading_value=false;
-				}
+		int value_from;
+		int value_len;
+		if (c=='"' || c=='\'') {
 
-			} else if (reading_value) {
+			pos++;
+			int end=_find(c);
+			if (end<0)
+				return NULL;
+			value_from=pos;
+			value_len=end-pos;
+			pos=end+1;
+		} else {
 
-				r_value.push_back(c);
-			} else {
+			value_from=pos;
+			while((c=_peek())>32 && c!='>')
+				pos++;
+			value_len=pos-value_from;
+		}
 
-				name+=c;
-			}
+		if (tag.args.count==MAX_TAG_ARGS) {
+			WARN_PRINT(String(local_path+":"+itos(get_current_line())+": Too many arguments in tag <"+tag.name+">").utf8().get_data());
+			continue;
 		}
 
-		if (f->eof_reached())
-			return NULL;
+		Tag::Args::Arg &arg=tag.args.args[tag.args.count++];
+		arg.name=&buffer[arg_from];
+		arg.name_len=arg_len;
+		arg.value=&buffer[value_from];
+		arg.value_len=value_len;
 	}
 
 	tag_stack.push_back(tag);
@@ -147,45 +231,36 @@ ResourceInteractiveLoaderXML::Tag* ResourceInteractiveLoaderXML::parse_tag(bool
 Error ResourceInteractiveLoaderXML::close_tag(const String& p_name) {
 
 	int level=0;
-	bool inside_tag=false;
 
 	while(true) {
 
-		if (f->eof_reached()) {
-
-			ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": EOF found while attempting to find  </"+p_name+">");
-			ERR_FAIL_COND_V( f->eof_reached(), ERR_FILE_CORRUPT );
+		int from=_find('<');
+		int end=-1;
+		if (from>=0) {
+			pos=from+1;
+			if (get_char()=='/')
+				--level;
+			else
+				++level;
+			end=_find('>');
 		}
 
-		uint8_t c = get_char();
-
-		if (c == '<') {
+		if (end<0) {
 
-			if (inside_tag) {
-				ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": Malformed XML. Already inside Tag.");
-				ERR_FAIL_COND_V(inside_tag,ERR_FILE_CORRUPT);
-			}
-			inside_tag=true;
-			c = get_char();
-			if (c == '/') {
-
-				--level;
-			} else {
+			ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": EOF found while attempting to find  </"+p_name+">");
+			ERR_FAIL_V( ERR_FILE_CORRUPT );
+		}
 
-				++level;
-			};
-		} else if (c == '>') {
+		if (memchr(&buffer[pos],'<',end-pos)) {
+			ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": Malformed XML. Already inside Tag.");
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
 
-			if (!inside_tag) {
-				ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": Malformed XML. Already outside Tag");
-				ERR_FAIL_COND_V(!inside_tag,ERR_FILE_CORRUPT);
-			}
-			inside_tag=false;
-			if (level == -1) {
-				tag_stack.pop_back();
-				return OK;
-			};
-		};
+		pos=end+1;
+		if (level == -1) {
+			tag_stack.pop_back();
+			return OK;
+		}
 	}
 
 	return OK;
@@ -195,6 +270,8 @@ void ResourceInteractiveLoaderXML::unquote(String& p_str) {
 
 	p_str=p_str.strip_edges();
 	p_str=p_str.replace("\"","");
+	if (p_str.find("&")==-1)
+		return;
 	p_str=p_str.replace("&gt;","<");
 	p_str=p_str.replace("&lt;",">");
 	p_str=p_str.replace("&apos;","'");
@@ -212,19 +289,13 @@ void ResourceInteractiveLoaderXML::unquote(String& p_str) {
 
 Error ResourceInteractiveLoaderXML::goto_end_of_tag() {
 
-	uint8_t c;
-	while(true) {
-
-		c=get_char();
-		if (c=='>') //closetag
-			break;
-		if (f->eof_reached()) {
-
-			ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": EOF found while attempting to find close tag.");
-			ERR_FAIL_COND_V( f->eof_reached(), ERR_FILE_CORRUPT );
-		}
+	int end=_find('>');
+	if (end<0) {
 
+		ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": EOF found while attempting to find close tag.");
+		ERR_FAIL_V( ERR_FILE_CORRUPT );
 	}
+	pos=end+1;
 	tag_stack.pop_back();
 
 	return OK;
@@ -233,27 +304,19 @@ Error ResourceInteractiveLoaderXML::goto_end_of_tag() {
 
 Error ResourceInteractiveLoaderXML::parse_property_data(String &r_data) {
 
-	r_data="";
-	CharString cs;
-	while(true) {
+	int end=_find('<');
+	ERR_FAIL_COND_V(end<0,ERR_FILE_CORRUPT);
 
-		CharType c=get_char();
-		if (c=='<')
-			break;
-		ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-		cs.push_back(c);
-	}
-
-	cs.push_back(0);
+	r_data.parse_utf8(&buffer[pos],end-pos);
+	pos=end;
 
-	r_data.parse_utf8(cs.get_data());
-
-	while(get_char()!='>' && !f->eof_reached()) {}
-	if (f->eof_reached()) {
+	end=_find('>');
+	if (end<0) {
 
 		ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": Malformed XML.");
-		ERR_FAIL_COND_V( f->eof_reached(), ERR_FILE_CORRUPT );
+		ERR_FAIL_V( ERR_FILE_CORRUPT );
 	}
+	pos=end+1;
 
 	r_data=r_data.strip_edges();
 	tag_stack.pop_back();
@@ -261,69 +324,41 @@ Error ResourceInteractiveLoaderXML::parse_property_data(String &r_data) {
 	return OK;
 }
 
+//reads numbers separated by commas or spaces straight from the buffer, up to the next '<'
+template<class T>
+Error ResourceInteractiveLoaderXML::_parse_number_array(T *r_dst,int p_count,int *r_read) {
 
-Error ResourceInteractiveLoaderXML::_parse_array_element(Vector<char> &buff,bool p_number_only,FileAccess *f,bool *end) {
-
-	if (buff.empty())
-		buff.resize(32); // optimi
+	int idx=0;
 
-	int buff_max=buff.size();
-	int buff_size=0;
-	*end=false;
-	char *buffptr=&buff[0];
-	bool found=false;
-	bool quoted=false;
+	while(idx<p_count) {
 
-	while(true) {
-
-		char c=get_char();
+		int c=_peek();
+		while(c==',' || (c>=0 && c<33)) {
+			pos++;
+			c=_peek();
+		}
 
-		if (c==0) {
-			ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": File corrupt (zero found).");
+		if (c<0) {
+			ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": File corrupt (unexpected EOF).");
 			ERR_FAIL_V(ERR_FILE_CORRUPT);
-		} else if (c=='"') {
-			quoted=!quoted;
-		} else if ((!quoted && ((p_number_only && c<33) || c==',')) || c=='<') {
-
-
-			if (c=='<') {
-				*end=true;
-				break;
-			}
-			if (c<32 && f->eof_reached()) {
-				*end=true;
-				ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": File corrupt (unexpected EOF).");
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
-
-			if (found)
-				break;
-
-		} else {
-
-			found=true;
-			if (buff_size>=buff_max) {
-
-				buff_max++;
-				buff.resize(buff_max);
-
-			}
-
-			buffptr[buff_size]=c;
-			buff_size++;
 		}
-	}
+		if (c=='<')
+			break;
 
-	if (buff_size>=buff_max) {
+		//make sure the whole number is in the buffer, no number is this long
+		while(buffer_len-pos<64 && _fill()) {}
 
-		buff_max++;
-		buff.resize(buff_max);
+		const char *from=&buffer[pos];
+		const char *end=from;
+		r_dst[idx++]=String::to_double(from,&end);
+		pos+=end-from;
 
+		//skip whatever could not be parsed as a number
+		while((c=_peek())>32 && c!=',' && c!='<')
+			pos++;
 	}
 
-	buff[buff_size]=0;
-	buff_size++;
-
+	*r_read=idx;
 	return OK;
 }
 
@@ -603,7 +638,7 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 
 				CharType c=get_char();
 
-				ERR_FAIL_COND_V(c=='<',ERR_FILE_CORRUPT);
+				ERR_FAIL_COND_V(c=='<' || eof,ERR_FILE_CORRUPT);
 
 				if ( (c>='0' && c<='9') || (c>='A' && c<='F') || (c>='a' && c<='f') ) {
 
@@ -620,7 +655,7 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 				}
 
 			}
-			ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
+			ERR_FAIL_COND_V(eof,ERR_FILE_CORRUPT);
 
 			wb=DVector<uint8_t>::Write();
 
@@ -665,7 +700,7 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 			idx++;
 		}
 
-		ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(eof,ERR_FILE_CORRUPT);
 
 		w=DVector<uint8_t>::Write();
 		r_v=bytes;
@@ -687,60 +722,15 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 		DVector<int> ints;
 		ints.resize(len);
 		DVector<int>::Write w=ints.write();
-		int *intsptr=w.ptr();
-		int idx=0;
-		String str;
-#if 0
-		while( idx<len ) {
-
-
-			CharType c=get_char();
-			ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-
-			if (c<33 || c==',' || c=='<') {
-
-				if (str.length()) {
-
-					intsptr[idx]=str.to_int();
-					str="";
-					idx++;
-				}
-
-				if (c=='<') {
-
-					while(get_char()!='>' && !f->eof_reached()) {}
-					ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-					break;
-				}
-
-			} else {
-
-				str+=c;
-			}
-		}
-
-#else
-
-		Vector<char> tmpdata;
-
-		while( idx<len ) {
-
-			bool end=false;
-			Error err = _parse_array_element(tmpdata,true,f,&end);
-			ERR_FAIL_COND_V(err,err);
-
-			intsptr[idx]=String::to_int(&tmpdata[0]);
-			idx++;
-			if (end)
-				break;
-
-		}
-
-#endif
+		int read;
+		Error err=_parse_number_array(w.ptr(),len,&read);
+		ERR_FAIL_COND_V(err,err);
+		for(int i=read;i<len;i++)
+			w[i]=0;
 		w=DVector<int>::Write();
 
 		r_v=ints;
-		Error err=goto_end_of_tag();
+		err=goto_end_of_tag();
 		ERR_FAIL_COND_V(err,err);
 		r_name=name;
 
@@ -756,66 +746,15 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 		DVector<real_t> reals;
 		reals.resize(len);
 		DVector<real_t>::Write w=reals.write();
-		real_t *realsptr=w.ptr();
-		int idx=0;
-		String str;
-
-
-#if 0
-		while( idx<len ) {
-
-
-			CharType c=get_char();
-			ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-
-
-			if (c<33 || c==',' || c=='<') {
-
-				if (str.length()) {
-
-					realsptr[idx]=str.to_double();
-					str="";
-					idx++;
-				}
-
-				if (c=='<') {
-
-					while(get_char()!='>' && !f->eof_reached()) {}
-					ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-					break;
-				}
-
-			} else {
-
-				str+=c;
-			}
-		}
-
-#else
-
-
-
-		Vector<char> tmpdata;
-
-		while( idx<len ) {
-
-			bool end=false;
-			Error err = _parse_array_element(tmpdata,true,f,&end);
-			ERR_FAIL_COND_V(err,err);
-
-			realsptr[idx]=String::to_double(&tmpdata[0]);
-			idx++;
-
-			if (end)
-				break;
-		}
-
-#endif
-
+		int read;
+		Error err=_parse_number_array(w.ptr(),len,&read);
+		ERR_FAIL_COND_V(err,err);
+		for(int i=read;i<len;i++)
+			w[i]=0;
 		w=DVector<real_t>::Write();
 		r_v=reals;
 
-		Error err=goto_end_of_tag();
+		err=goto_end_of_tag();
 		ERR_FAIL_COND_V(err,err);
 		r_name=name;
 
@@ -934,84 +873,16 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 		DVector<Vector3> vectors;
 		vectors.resize(len);
 		DVector<Vector3>::Write w=vectors.write();
-		Vector3 *vectorsptr=w.ptr();
-		int idx=0;
-		int subidx=0;
-		Vector3 auxvec;
-		String str;
-
-//		uint64_t tbegin = OS::get_singleton()->get_ticks_usec();
-#if 0
-		while( idx<len ) {
-
-
-			CharType c=get_char();
-			ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-
-
-			if (c<33 || c==',' || c=='<') {
-
-				if (str.length()) {
-
-					auxvec[subidx]=str.to_double();
-					subidx++;
-					str="";
-					if (subidx==3) {
-						vectorsptr[idx]=auxvec;
-
-						idx++;
-						subidx=0;
-					}
-				}
-
-				if (c=='<') {
-
-					while(get_char()!='>' && !f->eof_reached()) {}
-					ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-					break;
-				}
-
-			} else {
-
-				str+=c;
-			}
-		}
-#else
-
-		Vector<char> tmpdata;
-
-		while( idx<len ) {
-
-			bool end=false;
-			Error err = _parse_array_element(tmpdata,true,f,&end);
-			ERR_FAIL_COND_V(err,err);
-
-
-			auxvec[subidx]=String::to_double(&tmpdata[0]);
-			subidx++;
-			if (subidx==3) {
-				vectorsptr[idx]=auxvec;
-
-				idx++;
-				subidx=0;
-			}
-
-			if (end)
-				break;
-		}
-
-
+		int read;
+		Error err=_parse_number_array((real_t*)w.ptr(),len*3,&read);
+		ERR_FAIL_COND_V(err,err);
 
-#endif
 		ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": Premature end of vector3 array");
-		ERR_FAIL_COND_V(idx<len,ERR_FILE_CORRUPT);
-//		double time_taken = (OS::get_singleton()->get_ticks_usec() - tbegin)/1000000.0;
-
+		ERR_FAIL_COND_V(read<len*3,ERR_FILE_CORRUPT);
 
 		w=DVector<Vector3>::Write();
 		r_v=vectors;
-		String sdfsdfg;
-		Error err=goto_end_of_tag();
+		err=goto_end_of_tag();
 		ERR_FAIL_COND_V(err,err);
 		r_name=name;
 
@@ -1028,84 +899,16 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 		DVector<Vector2> vectors;
 		vectors.resize(len);
 		DVector<Vector2>::Write w=vectors.write();
-		Vector2 *vectorsptr=w.ptr();
-		int idx=0;
-		int subidx=0;
-		Vector2 auxvec;
-		String str;
-
-//		uint64_t tbegin = OS::get_singleton()->get_ticks_usec();
-#if 0
-		while( idx<len ) {
-
-
-			CharType c=get_char();
-			ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-
-
-			if (c<22 || c==',' || c=='<') {
-
-				if (str.length()) {
-
-					auxvec[subidx]=str.to_double();
-					subidx++;
-					str="";
-					if (subidx==2) {
-						vectorsptr[idx]=auxvec;
-
-						idx++;
-						subidx=0;
-					}
-				}
-
-				if (c=='<') {
-
-					while(get_char()!='>' && !f->eof_reached()) {}
-					ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-					break;
-				}
-
-			} else {
-
-				str+=c;
-			}
-		}
-#else
-
-		Vector<char> tmpdata;
-
-		while( idx<len ) {
-
-			bool end=false;
-			Error err = _parse_array_element(tmpdata,true,f,&end);
-			ERR_FAIL_COND_V(err,err);
-
-
-			auxvec[subidx]=String::to_double(&tmpdata[0]);
-			subidx++;
-			if (subidx==2) {
-				vectorsptr[idx]=auxvec;
-
-				idx++;
-				subidx=0;
-			}
-
-			if (end)
-				break;
-		}
-
-
+		int read;
+		Error err=_parse_number_array((real_t*)w.ptr(),len*2,&read);
+		ERR_FAIL_COND_V(err,err);
 
-#endif
 		ERR_EXPLAIN(local_path+":"+itos(get_current_line())+": Premature end of vector2 array");
-		ERR_FAIL_COND_V(idx<len,ERR_FILE_CORRUPT);
-//		double time_taken = (OS::get_singleton()->get_ticks_usec() - tbegin)/1000000.0;
-
+		ERR_FAIL_COND_V(read<len*2,ERR_FILE_CORRUPT);
 
 		w=DVector<Vector2>::Write();
 		r_v=vectors;
-		String sdfsdfg;
-		Error err=goto_end_of_tag();
+		err=goto_end_of_tag();
 		ERR_FAIL_COND_V(err,err);
 		r_name=name;
 
@@ -1122,56 +925,100 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 		DVector<Color> colors;
 		colors.resize(len);
 		DVector<Color>::Write w=colors.write();
-		Color *colorsptr=w.ptr();
-		int idx=0;
-		int subidx=0;
-		Color auxcol;
-		String str;
+		int read;
+		Error err=_parse_number_array(w.ptr()->components,len*4,&read);
+		ERR_FAIL_COND_V(err,err);
+		for(int i=read;i<len*4;i++)
+			w[i>>2].components[i&3]=0;
+		w=DVector<Color>::Write();
+		r_v=colors;
+		err=goto_end_of_tag();
+		ERR_FAIL_COND_V(err,err);
+		r_name=name;
 
-		while( idx<len ) {
+		return OK;
+	}
 
+	int real_count=0;
+	if (type=="vector2")
+		real_count=2;
+	else if (type=="vector3")
+		real_count=3;
+	else if (type=="plane" || type=="quaternion" || type=="rect2" || type=="color")
+		real_count=4;
+	else if (type=="aabb" || type=="matrix32")
+		real_count=6;
+	else if (type=="matrix3")
+		real_count=9;
+	else if (type=="transform")
+		real_count=12;
+
+	if (real_count) {
+
+		real_t r[12];
+		int read;
+		Error err=_parse_number_array(r,real_count,&read);
+		ERR_FAIL_COND_V(err,err);
+		for(int i=read;i<real_count;i++)
+			r[i]=0;
 
-			CharType c=get_char();
-			ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
+		if (type=="vector2") {
 
+			r_v=Vector2(r[0],r[1]);
+		} else if (type=="vector3") {
 
-			if (c<33 || c==',' || c=='<') {
+			r_v=Vector3(r[0],r[1],r[2]);
+		} else if (type=="plane") {
 
-				if (str.length()) {
+			r_v=Plane(r[0],r[1],r[2],r[3]);
+		} else if (type=="quaternion") {
 
-					auxcol[subidx]=str.to_double();
-					subidx++;
-					str="";
-					if (subidx==4) {
-						colorsptr[idx]=auxcol;
-						idx++;
-						subidx=0;
-					}
-				}
+			r_v=Quat(r[0],r[1],r[2],r[3]);
+		} else if (type=="rect2") {
 
-				if (c=='<') {
+			r_v=Rect2(Vector2(r[0],r[1]),Vector2(r[2],r[3]));
+		} else if (type=="color") {
 
-					while(get_char()!='>' && !f->eof_reached()) {}
-					ERR_FAIL_COND_V(f->eof_reached(),ERR_FILE_CORRUPT);
-					break;
+			r_v=Color(r[0],r[1],r[2],r[3]);
+		} else if (type=="aabb") {
+
+			r_v=AABB(Vector3(r[0],r[1],r[2]),Vector3(r[3],r[4],r[5]));
+		} else if (type=="matrix32") {
+
+			Matrix32 m3;
+			for (int i=0;i<3;i++) {
+				for (int j=0;j<2;j++) {
+					m3.elements[i][j]=r[i*2+j];
 				}
+			}
+			r_v=m3;
+		} else if (type=="matrix3") {
 
-			} else {
+			Matrix3 m3;
+			for (int i=0;i<3;i++) {
+				for (int j=0;j<3;j++) {
+					m3.elements[i][j]=r[i*3+j];
+				}
+			}
+			r_v=m3;
+		} else {
 
-				str+=c;
+			Transform tr;
+			for (int i=0;i<3;i++) {
+				for (int j=0;j<3;j++) {
+					tr.basis.elements[i][j]=r[i*3+j];
+				}
 			}
+			tr.origin=Vector3(r[9],r[10],r[11]);
+			r_v=tr;
 		}
-		w=DVector<Color>::Write();
-		r_v=colors;
-		String sdfsdfg;
-		Error err=parse_property_data(sdfsdfg);
+
+		err=goto_end_of_tag();
 		ERR_FAIL_COND_V(err,err);
 		r_name=name;
-
 		return OK;
 	}
 
-
 	String data;
 	Error err = parse_property_data(data);
 	ERR_FAIL_COND_V(err!=OK,err);
@@ -1196,115 +1043,6 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 		String str=data;
 		unquote(str);
 		r_v=str;
-	} else if (type=="vector3") {
-
-
-		r_v=Vector3(
-				data.get_slice(",",0).to_double(),
-				data.get_slice(",",1).to_double(),
-				data.get_slice(",",2).to_double()
-			   );
-
-	} else if (type=="vector2") {
-
-
-		r_v=Vector2(
-				data.get_slice(",",0).to_double(),
-				data.get_slice(",",1).to_double()
-			   );
-
-	} else if (type=="plane") {
-
-		r_v=Plane(
-				data.get_slice(",",0).to_double(),
-				data.get_slice(",",1).to_double(),
-				data.get_slice(",",2).to_double(),
-				data.get_slice(",",3).to_double()
-			 );
-
-	} else if (type=="quaternion") {
-
-		r_v=Quat(
-				data.get_slice(",",0).to_double(),
-				data.get_slice(",",1).to_double(),
-				data.get_slice(",",2).to_double(),
-				data.get_slice(",",3).to_double()
-			 );
-
-	} else if (type=="rect2") {
-
-		r_v=Rect2(
-			Vector2(
-				data.get_slice(",",0).to_double(),
-				data.get_slice(",",1).to_double()
-			),
-			Vector2(
-				data.get_slice(",",2).to_double(),
-				data.get_slice(",",3).to_double()
-			)
-		);
-
-
-	} else if (type=="aabb") {
-
-		r_v=AABB(
-			Vector3(
-				data.get_slice(",",0).to_double(),
-				data.get_slice(",",1).to_double(),
-				data.get_slice(",",2).to_double()
-			),
-			Vector3(
-				data.get_slice(",",3).to_double(),
-				data.get_slice(",",4).to_double(),
-				data.get_slice(",",5).to_double()
-			)
-		);
-
-	} else if (type=="matrix32") {
-
-		Matrix32 m3;
-		for (int i=0;i<3;i++) {
-			for (int j=0;j<2;j++) {
-				m3.elements[i][j]=data.get_slice(",",i*2+j).to_double();
-			}
-		}
-		r_v=m3;
-
-	} else if (type=="matrix3") {
-
-		Matrix3 m3;
-		for (int i=0;i<3;i++) {
-			for (int j=0;j<3;j++) {
-				m3.elements[i][j]=data.get_slice(",",i*3+j).to_double();
-			}
-		}
-		r_v=m3;
-
-	} else if (type=="transform") {
-
-		Transform tr;
-		for (int i=0;i<3;i++) {
-			for (int j=0;j<3;j++) {
-				tr.basis.elements[i][j]=data.get_slice(",",i*3+j).to_double();
-			}
-
-		}
-		tr.origin=Vector3(
-			     data.get_slice(",",9).to_double(),
-			     data.get_slice(",",10).to_double(),
-			     data.get_slice(",",11).to_double()
-			   );
-		r_v=tr;
-
-	} else if (type=="color") {
-
-		r_v=Color(
-			   data.get_slice(",",0).to_double(),
-			   data.get_slice(",",1).to_double(),
-			   data.get_slice(",",2).to_double(),
-			   data.get_slice(",",3).to_double()
-			 );
-
 	} else if (type=="node_path") {
 
 		String str=data;
@@ -1325,17 +1063,19 @@ Error ResourceInteractiveLoaderXML::parse_property(Variant& r_v, String &r_name)
 
 int ResourceInteractiveLoaderXML::get_current_line() const {
 
-	return lines;
-}
-
+	//only needed for errors, so lines are counted when asked for
+	while(line_pos<pos) {
 
-uint8_t ResourceInteractiveLoaderXML::get_char() const {
-
-	uint8_t c = f->get_8();
-	if (c=='\n')
+		const char *nl=(const char*)memchr(&buffer[line_pos],'\n',pos-line_pos);
+		if (!nl) {
+			line_pos=pos;
+			break;
+		}
 		lines++;
-	return c;
+		line_pos=nl-buffer+1;
+	}
 
+	return lines;
 }
 
 
@@ -1556,9 +1296,24 @@ int ResourceInteractiveLoaderXML::get_stage_count() const {
 	return resources_total+ext_resources.size();
 }
 
+ResourceInteractiveLoaderXML::ResourceInteractiveLoaderXML() {
+
+	f=NULL;
+	buffer=NULL;
+	buffer_len=0;
+	file_len=0;
+	pos=0;
+	eof=false;
+	lines=1;
+	line_pos=0;
+}
+
 ResourceInteractiveLoaderXML::~ResourceInteractiveLoaderXML() {
 
-	memdelete(f);
+	if (buffer)
+		memdelete_arr(buffer);
+	if (f)
+		memdelete(f);
 }
 
 void ResourceInteractiveLoaderXML::get_dependencies(FileAccess *f,List<String> *p_dependencies) {
@@ -1618,10 +1373,7 @@ void ResourceInteractiveLoaderXML::get_dependencies(FileAccess *f,List<String> *
 
 void ResourceInteractiveLoaderXML::open(FileAccess *p_f) {
 
-	error=OK;	
-
-	lines=1;
-	f=p_f;
+	_open_buffer(p_f);
 
 
 	ResourceInteractiveLoaderXML::Tag *tag = parse_tag();
@@ -1690,10 +1442,7 @@ void ResourceInteractiveLoaderXML::open(FileAccess *p_f) {
 
 String ResourceInteractiveLoaderXML::recognize(FileAccess *p_f) {
 
-	error=OK;
-
-	lines=1;
-	f=p_f;
+	_open_buffer(p_f);
 
 	ResourceInteractiveLoaderXML::Tag *tag = parse_tag();
 	if (!tag || tag->name!="?xml" || !tag->args.has("version") || !tag->args.has("encoding") || tag->args["encoding"]!="UTF-8") {
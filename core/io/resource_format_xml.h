@@ -42,15 +42,50 @@ class ResourceInteractiveLoaderXML : public ResourceInteractiveLoader {
 
 	FileAccess *f;
 
+	enum {
+		READ_CHUNK_SIZE=65536,
+		MAX_TAG_ARGS=8
+	};
+
+	//the file is read into a single buffer, chunk by chunk as parsing advances, and scanned in place
+	char *buffer;
+	int buffer_len;
+	int file_len;
+	int pos;
+	bool eof;
+
 	struct Tag {
 
-		String name;
-		HashMap<String,String> args;
-	};
+		//arguments point into the buffer, values are only decoded when asked for
+		struct Args {
 
-	_FORCE_INLINE_ Error _parse_array_element(Vector<char> &buff,bool p_number_only,FileAccess *f,bool *end);
+			struct Arg {
+				const char *name;
+				int name_len;
+				const char *value;
+				int value_len;
+			};
 
+			Arg args[MAX_TAG_ARGS];
+			int count;
+
+			const Arg *find(const char *p_name) const;
+			bool has(const char *p_name) const { return find(p_name)!=NULL; }
+			String operator[](const char *p_name) const;
+
+			Args() { count=0; }
+		};
+
+		String name;
+		Args args;
+	};
 
+	bool _fill();
+	_FORCE_INLINE_ int _peek() { if (pos<buffer_len || _fill()) return (uint8_t)buffer[pos]; eof=true; return -1; }
+	int _find(char p_char);
+	template<class T>
+	Error _parse_number_array(T *r_dst,int p_count,int *r_read);
+	void _open_buffer(FileAccess *p_f);
 
 	List<StringName> ext_resources;
 
@@ -59,7 +94,8 @@ class ResourceInteractiveLoaderXML : public ResourceInteractiveLoader {
 	String resource_type;
 
 	mutable int lines;
-	uint8_t get_char() const;
+	mutable int line_pos;
+	_FORCE_INLINE_ uint8_t get_char() { if (pos<buffer_len || _fill()) return buffer[pos++]; eof=true; return 0; }
 	int get_current_line() const;
 
 friend class ResourceFormatLoaderXML;
@@ -90,6 +126,7 @@ public:
 	void get_dependencies(FileAccess *p_f,List<String> *p_dependencies);
 
 
+	ResourceInteractiveLoaderXML();
 	~ResourceInteractiveLoaderXML();
 
 };
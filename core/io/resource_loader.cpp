@@ -32,6 +32,11 @@
 #include "path_remap.h"
 #include "os/file_access.h"
 #include "os/os.h"
+#include "os/thread.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "map.h"
+#include "set.h"
 ResourceFormatLoader *ResourceLoader::loader[MAX_LOADERS];
 
 int ResourceLoader::loader_count=0;
@@ -382,9 +387,507 @@ String ResourceLoader::get_resource_type(const String &p_path) {
 	return "";
 
 }
+/* THREADED LOADING */
+
+struct _ThreadLoadTask {
+
+	enum Stage {
+		STAGE_SCAN, // dependencies not known yet
+		STAGE_WAITING, // waiting for dependencies to load
+		STAGE_READY,
+		STAGE_LOADING,
+		STAGE_DONE
+	};
+
+	String local_path;
+	String type_hint;
+	Stage stage;
+	bool main_thread;
+	int users;
+	int pending;
+	Vector<_ThreadLoadTask*> dependencies;
+	Vector<_ThreadLoadTask*> dependents;
+	RES resource;
+	Error error;
+};
+
+static Mutex *thread_load_mutex=NULL;
+static Semaphore *thread_load_semaphore=NULL;
+static Vector<Thread*> thread_load_workers;
+static bool thread_load_exit=false;
+static Map<String,_ThreadLoadTask*> thread_load_tasks;
+static List<_ThreadLoadTask*> thread_load_queue;
+static List<_ThreadLoadTask*> thread_load_main_queue;
+static Set<String> thread_load_main_types;
+static Set<Thread::ID> thread_load_worker_ids;
+static int thread_load_active=0;
+
+struct _ThreadLoadMainCall {
+
+	ResourceMainThreadFunc func;
+	void *userdata;
+	Semaphore *done;
+};
+
+static List<_ThreadLoadMainCall*> thread_load_main_calls;
+
+static void _thread_load_push(_ThreadLoadTask *p_task) {
+
+	if (p_task->stage==_ThreadLoadTask::STAGE_READY && p_task->main_thread) {
+		thread_load_main_queue.push_back(p_task);
+		return;
+	}
+
+	thread_load_queue.push_back(p_task);
+	thread_load_semaphore->post();
+}
+
+static _ThreadLoadTask *_thread_load_create(const String& p_path,const String& p_type_hint) {
+
+	_ThreadLoadTask *task = memnew( _ThreadLoadTask );
+	task->local_path=p_path;
+	task->type_hint=p_type_hint;
+	task->stage=_ThreadLoadTask::STAGE_SCAN;
+	task->main_thread=false;
+	task->users=0;
+	task->pending=0;
+	task->error=OK;
+	thread_load_tasks[p_path]=task;
+	_thread_load_push(task);
+	return task;
+}
+
+static void _thread_load_release(_ThreadLoadTask *p_task) {
+
+	p_task->users--;
+	if (p_task->users>0 || p_task->stage!=_ThreadLoadTask::STAGE_DONE)
+		return;
+
+	thread_load_tasks.erase(p_task->local_path);
+	memdelete(p_task);
+}
+
+static bool _thread_load_depends_on(_ThreadLoadTask *p_task,_ThreadLoadTask *p_on,Set<_ThreadLoadTask*> &r_visited) {
+
+	if (p_task==p_on)
+		return true;
+	if (r_visited.has(p_task))
+		return false;
+	r_visited.insert(p_task);
+
+	for(int i=0;i<p_task->dependencies.size();i++) {
+
+		if (_thread_load_depends_on(p_task->dependencies[i],p_on,r_visited))
+			return true;
+	}
+
+	return false;
+}
+
+static void _thread_load_scan(_ThreadLoadTask *p_task) {
+
+	List<String> deps;
+	ResourceLoader::get_dependencies(p_task->local_path,&deps);
+
+	// without a thread safe visual server, everything is loaded by the main thread
+	bool main_thread = OS::get_singleton()->get_render_thread_mode()==OS::RENDER_THREAD_UNSAFE;
+	if (!main_thread && thread_load_main_types.size()) {
+
+		String type = ResourceLoader::get_resource_type(p_task->local_path);
+		for(Set<String>::Element *E=thread_load_main_types.front();E;E=E->next()) {
+
+			if (ObjectTypeDB::is_type(type,E->get())) {
+				main_thread=true;
+				break;
+			}
+		}
+	}
+
+	thread_load_mutex->lock();
+
+	p_task->main_thread=main_thread;
+
+	for(List<String>::Element *E=deps.front();E;E=E->next()) {
+
+		String path = Globals::get_singleton()->localize_path(E->get());
+		if (ResourceCache::has(path))
+			continue;
+
+		_ThreadLoadTask *dep;
+		Map<String,_ThreadLoadTask*>::Element *F=thread_load_tasks.find(path);
+		if (F) {
+
+			dep=F->get();
+			if (dep->stage==_ThreadLoadTask::STAGE_DONE || p_task->dependencies.find(dep)!=-1)
+				continue;
+
+			Set<_ThreadLoadTask*> visited;
+			if (_thread_load_depends_on(dep,p_task,visited))
+				continue; // cyclic, let the loader resolve it
+
+		} else {
+
+			dep=_thread_load_create(path,"");
+		}
+
+		dep->users++;
+		dep->dependents.push_back(p_task);
+		p_task->dependencies.push_back(dep);
+		p_task->pending++;
+	}
+
+	if (p_task->pending==0) {
+		p_task->stage=_ThreadLoadTask::STAGE_READY;
+		_thread_load_push(p_task);
+	} else {
+		p_task->stage=_ThreadLoadTask::STAGE_WAITING;
+	}
+
+	thread_load_mutex->unlock();
+}
+
+static void _thread_load_run(_ThreadLoadTask *p_task) {
+
+	// dependencies are in the cache by now, so only this resource is parsed here
+	RES res = ResourceLoader::load(p_task->local_path,p_task->type_hint);
+
+	thread_load_mutex->lock();
+
+	p_task->resource=res;
+	p_task->error=res.is_valid()?OK:ERR_CANT_OPEN;
+	p_task->stage=_ThreadLoadTask::STAGE_DONE;
+
+	for(int i=0;i<p_task->dependents.size();i++) {
+
+		_ThreadLoadTask *dependent=p_task->dependents[i];
+		dependent->pending--;
+		if (dependent->pending==0) {
+			dependent->stage=_ThreadLoadTask::STAGE_READY;
+			_thread_load_push(dependent);
+		}
+	}
+	p_task->dependents.clear();
+
+	for(int i=0;i<p_task->dependencies.size();i++) {
+		_thread_load_release(p_task->dependencies[i]);
+	}
+	p_task->dependencies.clear();
+
+	thread_load_mutex->unlock();
+}
+
+static bool _thread_load_poll_calls() {
+
+	thread_load_mutex->lock();
+	List<_ThreadLoadMainCall*> calls=thread_load_main_calls;
+	thread_load_main_calls.clear();
+	thread_load_mutex->unlock();
+
+	for(List<_ThreadLoadMainCall*>::Element *E=calls.front();E;E=E->next()) {
+
+		E->get()->func(E->get()->userdata);
+		E->get()->done->post();
+	}
+
+	return !calls.empty();
+}
+
+static bool _thread_load_poll_main() {
+
+	// workers waiting on the main thread go first, they hold a task each
+	if (_thread_load_poll_calls())
+		return true;
+
+	thread_load_mutex->lock();
+	if (thread_load_main_queue.empty()) {
+		thread_load_mutex->unlock();
+		return false;
+	}
+
+	_ThreadLoadTask *task=thread_load_main_queue.front()->get();
+	thread_load_main_queue.pop_front();
+	task->stage=_ThreadLoadTask::STAGE_LOADING;
+	thread_load_mutex->unlock();
+
+	_thread_load_run(task);
+	return true;
+}
+
+static void _thread_load_worker(void *p_ud) {
+
+	thread_load_mutex->lock();
+	thread_load_worker_ids.insert(Thread::get_caller_ID());
+	thread_load_mutex->unlock();
+
+	while(true) {
+
+		thread_load_semaphore->wait();
+
+		thread_load_mutex->lock();
+		if (thread_load_exit) {
+			thread_load_mutex->unlock();
+			break;
+		}
+
+		if (thread_load_queue.empty()) {
+			thread_load_mutex->unlock();
+			ERR_CONTINUE(true);
+		}
+
+		_ThreadLoadTask *task=thread_load_queue.front()->get();
+		thread_load_queue.pop_front();
+		bool scan = task->stage==_ThreadLoadTask::STAGE_SCAN;
+		if (!scan)
+			task->stage=_ThreadLoadTask::STAGE_LOADING;
+		thread_load_active++;
+		thread_load_mutex->unlock();
+
+		if (scan)
+			_thread_load_scan(task);
+		else
+			_thread_load_run(task);
+
+		thread_load_mutex->lock();
+		thread_load_active--;
+		thread_load_mutex->unlock();
+	}
+}
+
+static void _thread_load_start() {
+
+	GLOBAL_LOCK_FUNCTION
+
+	if (thread_load_mutex)
+		return;
+
+	int threads = GLOBAL_DEF("resource/load_threads",0);
+	if (threads<=0)
+		threads=MAX(OS::get_singleton()->get_processor_count()-1,1);
+
+	thread_load_mutex=Mutex::create();
+	thread_load_semaphore=Semaphore::create();
+	thread_load_exit=false;
+
+	for(int i=0;i<threads;i++) {
+		thread_load_workers.push_back(Thread::create(_thread_load_worker,NULL));
+	}
+}
+
+static String _thread_load_path(const String &p_path,const String& p_type_hint) {
+
+	String local_path = Globals::get_singleton()->localize_path(p_path);
+	return ResourceLoader::guess_full_filename(local_path,p_type_hint);
+}
+
+Error ResourceLoader::load_threaded_request(const String &p_path,const String& p_type_hint) {
+
+	String local_path = _thread_load_path(p_path,p_type_hint);
+	ERR_FAIL_COND_V(local_path=="",ERR_FILE_NOT_FOUND);
+
+	_thread_load_start();
+
+	thread_load_mutex->lock();
+
+	_ThreadLoadTask *task;
+	Map<String,_ThreadLoadTask*>::Element *E=thread_load_tasks.find(local_path);
+
+	if (E) {
+		task=E->get();
+	} else if (ResourceCache::has(local_path)) {
+
+		task = memnew( _ThreadLoadTask );
+		task->local_path=local_path;
+		task->stage=_ThreadLoadTask::STAGE_DONE;
+		task->main_thread=false;
+		task->users=0;
+		task->pending=0;
+		task->resource=RES( ResourceCache::get(local_path) );
+		task->error=OK;
+		thread_load_tasks[local_path]=task;
+	} else {
+		task=_thread_load_create(local_path,p_type_hint);
+	}
+
+	task->users++;
+
+	thread_load_mutex->unlock();
+
+	return OK;
+}
+
+ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path,float *r_progress) {
+
+	if (r_progress)
+		*r_progress=0;
+
+	if (!thread_load_mutex)
+		return THREAD_LOAD_INVALID_RESOURCE;
+
+	if (Thread::get_caller_ID()==Thread::get_main_ID())
+		_thread_load_poll_main();
+
+	String local_path = _thread_load_path(p_path,"");
+
+	thread_load_mutex->lock();
+
+	Map<String,_ThreadLoadTask*>::Element *E=thread_load_tasks.find(local_path);
+	if (!E) {
+		thread_load_mutex->unlock();
+		return THREAD_LOAD_INVALID_RESOURCE;
+	}
+
+	_ThreadLoadTask *task=E->get();
+	ThreadLoadStatus status;
+
+	if (task->stage==_ThreadLoadTask::STAGE_DONE) {
+
+		status = task->error==OK?THREAD_LOAD_LOADED:THREAD_LOAD_FAILED;
+		if (r_progress)
+			*r_progress=1.0;
+	} else {
+
+		status = THREAD_LOAD_IN_PROGRESS;
+		if (r_progress) {
+			int count=task->dependencies.size();
+			*r_progress=float(count-task->pending)/float(count+1);
+		}
+	}
+
+	thread_load_mutex->unlock();
+
+	return status;
+}
+
+RES ResourceLoader::load_threaded_get(const String &p_path,Error *r_error) {
+
+	if (r_error)
+		*r_error=ERR_INVALID_PARAMETER;
+
+	ERR_FAIL_COND_V(!thread_load_mutex,RES());
+
+	String local_path = _thread_load_path(p_path,"");
+	bool main_thread = Thread::get_caller_ID()==Thread::get_main_ID();
+
+	thread_load_mutex->lock();
+
+	Map<String,_ThreadLoadTask*>::Element *E=thread_load_tasks.find(local_path);
+	if (!E) {
+		thread_load_mutex->unlock();
+		ERR_EXPLAIN("Resource was not requested for threaded loading: "+p_path);
+		ERR_FAIL_V(RES());
+	}
+
+	_ThreadLoadTask *task=E->get();
+
+	while(task->stage!=_ThreadLoadTask::STAGE_DONE) {
+
+		thread_load_mutex->unlock();
+
+		if (!main_thread || !_thread_load_poll_main()) {
+
+			// workers may be blocked on the main thread (ie, visual server commands)
+			if (main_thread && thread_load_wait_func)
+				thread_load_wait_func();
+			OS::get_singleton()->delay_usec(1000);
+		}
+
+		thread_load_mutex->lock();
+	}
+
+	RES res = task->resource;
+	if (r_error)
+		*r_error=task->error;
+
+	_thread_load_release(task);
+
+	thread_load_mutex->unlock();
+
+	return res;
+}
+
+void ResourceLoader::add_main_thread_type(const String& p_type) {
+
+	thread_load_main_types.insert(p_type);
+}
+
+void ResourceLoader::call_on_main_thread(ResourceMainThreadFunc p_func,void *p_ud) {
+
+	bool worker=false;
+
+	if (thread_load_mutex) {
+
+		thread_load_mutex->lock();
+		worker=thread_load_worker_ids.has(Thread::get_caller_ID());
+		thread_load_mutex->unlock();
+	}
+
+	if (!worker) {
+		p_func(p_ud);
+		return;
+	}
+
+	_ThreadLoadMainCall call;
+	call.func=p_func;
+	call.userdata=p_ud;
+	call.done=Semaphore::create();
+
+	thread_load_mutex->lock();
+	thread_load_main_calls.push_back(&call);
+	thread_load_mutex->unlock();
+
+	call.done->wait();
+	memdelete(call.done);
+}
+
+void ResourceLoader::finish_threaded_loads() {
+
+	if (!thread_load_mutex)
+		return;
+
+	thread_load_mutex->lock();
+	thread_load_exit=true;
+	thread_load_mutex->unlock();
+
+	// let running tasks finish, they may be waiting on the main thread
+	while(true) {
+
+		thread_load_mutex->lock();
+		bool active=thread_load_active>0;
+		thread_load_mutex->unlock();
+		if (!active)
+			break;
+		if (!_thread_load_poll_calls())
+			OS::get_singleton()->delay_usec(1000);
+	}
+
+	for(int i=0;i<thread_load_workers.size();i++) {
+		thread_load_semaphore->post();
+	}
+
+	for(int i=0;i<thread_load_workers.size();i++) {
+		Thread::wait_to_finish(thread_load_workers[i]);
+		memdelete(thread_load_workers[i]);
+	}
+	thread_load_workers.clear();
+	thread_load_worker_ids.clear();
+
+	for(Map<String,_ThreadLoadTask*>::Element *E=thread_load_tasks.front();E;E=E->next()) {
+		memdelete(E->get());
+	}
+	thread_load_tasks.clear();
+	thread_load_queue.clear();
+	thread_load_main_queue.clear();
+
+	memdelete(thread_load_semaphore);
+	thread_load_semaphore=NULL;
+	memdelete(thread_load_mutex);
+	thread_load_mutex=NULL;
+}
+
 ResourceLoadErrorNotify ResourceLoader::err_notify=NULL;
 void *ResourceLoader::err_notify_ud=NULL;
 
 bool ResourceLoader::abort_on_missing_resource=true;
 bool ResourceLoader::timestamp_on_load=false;
+ResourceThreadLoadWaitFunc ResourceLoader::thread_load_wait_func=NULL;
 
@@ -72,6 +72,8 @@ public:
 
 
 typedef void (*ResourceLoadErrorNotify)(void *p_ud,const String& p_text);
+typedef void (*ResourceThreadLoadWaitFunc)();
+typedef void (*ResourceMainThreadFunc)(void *p_ud);
 
 
 class ResourceLoader {	
@@ -87,10 +89,17 @@ class ResourceLoader {
 	static void* err_notify_ud;
 	static ResourceLoadErrorNotify err_notify;
 	static bool abort_on_missing_resource;
+	static ResourceThreadLoadWaitFunc thread_load_wait_func;
 
 	static String find_complete_path(const String& p_path,const String& p_type);
 public:
 
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED
+	};
 
 	
 	static Ref<ResourceInteractiveLoader> load_interactive(const String &p_path,const String& p_type_hint="",bool p_no_cache=false);
@@ -104,6 +113,14 @@ public:
 
 	static String guess_full_filename(const String &p_path,const String& p_type);
 
+	static Error load_threaded_request(const String &p_path,const String& p_type_hint="");
+	static ThreadLoadStatus load_threaded_get_status(const String &p_path,float *r_progress=NULL);
+	static RES load_threaded_get(const String &p_path,Error *r_error=NULL);
+	static void add_main_thread_type(const String& p_type);
+	static void set_thread_load_wait_func(ResourceThreadLoadWaitFunc p_func) { thread_load_wait_func=p_func; }
+	static void finish_threaded_loads();
+	static void call_on_main_thread(ResourceMainThreadFunc p_func,void *p_ud); ///< from a load thread, blocks until the main thread ran p_func
+
 	static void set_timestamp_on_load(bool p_timestamp) { timestamp_on_load=p_timestamp; }
 
 	static void notify_load_error(const String& p_err) { if (err_notify) err_notify(err_notify_ud,p_err); }
@@ -28,6 +28,8 @@
 /*************************************************************************/
 #include "xml_parser.h"
 #include "print_string.h"
+
+#include <string.h>
 //#define DEBUG_XML
 
 static bool _equalsn(const CharType* str1, const CharType* str2, int len) {
@@ -96,6 +98,35 @@ static inline bool _is_white_space(char c)
 	return (c==' ' || c=='\t' || c=='\n' || c=='\r');
 }
 
+//memchr is vectorized by the C library, so scans go through it instead of byte loops
+char* XMLParser::_find(char *p_from,char p_char) const {
+
+	char *found=(char*)memchr(p_from,p_char,data+length-p_from);
+	return found?found:data+length;
+}
+
+//element and attribute names repeat a lot, so the Strings for them are shared
+String XMLParser::_intern_name(const char *p_name,int p_len) {
+
+	for(int i=0;i<name_cache.size();i++) {
+
+		const String &n=name_cache[i];
+		if (n.length()!=p_len)
+			continue;
+		const CharType *c=n.c_str();
+		int j=0;
+		while(j<p_len && c[j]==(uint8_t)p_name[j])
+			j++;
+		if (j==p_len)
+			return n;
+	}
+
+	String n=String::utf8(p_name,p_len);
+	if (name_cache.size()<MAX_CACHED_NAMES && n.length()==p_len)
+		name_cache.push_back(n);
+	return n;
+}
+
 
 //! sets the state that text was found. Returns true if set should be set
 bool XMLParser::_set_text(char* start, char* end) {
@@ -130,14 +161,14 @@ void XMLParser::_parse_closing_xml_element() {
 	++P;
 	const char* pBeginClose = P;
 
-	while(*P != '>')
-		++P;
+	P=_find(P,'>');
 
-	node_name = String::utf8(pBeginClose, (int)(P - pBeginClose));
+	node_name = _intern_name(pBeginClose, (int)(P - pBeginClose));
 #ifdef DEBUG_XML
 	print_line("XML CLOSE: "+node_name);
 #endif
-	++P;
+	if (*P)
+		++P;
 }
 
 void XMLParser::_ignore_definition() {
@@ -145,10 +176,10 @@ void XMLParser::_ignore_definition() {
 
 	char *F=P;
 	// move until end marked with '>' reached
-	while(*P != '>')
-		++P;
+	P=_find(P,'>');
 	node_name.parse_utf8(F,P-F);
-	++P;
+	if (*P)
+		++P;
 }
 
 bool XMLParser::_parse_cdata() {
@@ -273,8 +304,7 @@ void XMLParser::_parse_opening_xml_element() {
 				++P;
 				const char* attributeValueBegin = P;
 
-				while(*P != attributeQuoteChar && *P)
-					++P;
+				P=_find(P,attributeQuoteChar);
 
 				if (!*P) // malformatted xml file
 					return;
@@ -283,7 +313,7 @@ void XMLParser::_parse_opening_xml_element() {
 				++P;
 
 				Attribute attr;
-				attr.name = String::utf8(attributeNameBegin,
+				attr.name = _intern_name(attributeNameBegin,
 					(int)(attributeNameEnd - attributeNameBegin));
 
 				String s =String::utf8(attributeValueBegin,
@@ -310,7 +340,7 @@ void XMLParser::_parse_opening_xml_element() {
 		endName--;
 	}
 
-	node_name = String::utf8(startName, (int)(endName - startName));
+	node_name = _intern_name(startName, (int)(endName - startName));
 #ifdef DEBUG_XML
 	print_line("XML OPEN: "+node_name);
 #endif
@@ -325,8 +355,7 @@ void XMLParser::_parse_current_node() {
 	node_offset = P - data;
 
 	// more forward until '<' found
-	while(*P != '<' && *P)
-		++P;
+	P=_find(P,'<');
 
 	if (!*P)
 		return;
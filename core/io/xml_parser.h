@@ -81,6 +81,14 @@ private:
 
 	Vector<Attribute> attributes;
 
+	enum {
+		MAX_CACHED_NAMES=64
+	};
+
+	Vector<String> name_cache;
+
+	char* _find(char *p_from,char p_char) const;
+	String _intern_name(const char *p_name,int p_len);
 	String _replace_special_characters(const String& origstr);
 	bool _set_text(char* start, char* end);
 	void _parse_closing_xml_element();
@@ -0,0 +1,131 @@
+/*************************************************************************/
+/*  simd4.h                                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef SIMD4_H
+#define SIMD4_H
+
+#include "typedefs.h"
+#include "math_funcs.h"
+
+#if (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=1)) && !defined(REAL_T_IS_DOUBLE) && !defined(NO_SIMD)
+#define SIMD4_SSE
+#include <xmmintrin.h>
+#endif
+
+/* Four reals worked on at once. Uses SSE when the compiler targets it, plain
+   loops otherwise. Masks returned by the comparisons are only meant to be
+   passed to select() and mask(). */
+
+struct Simd4 {
+
+#ifdef SIMD4_SSE
+
+	__m128 v;
+
+	_FORCE_INLINE_ Simd4() {}
+	_FORCE_INLINE_ Simd4(__m128 p_v) { v=p_v; }
+	_FORCE_INLINE_ explicit Simd4(real_t p_s) { v=_mm_set1_ps(p_s); }
+	_FORCE_INLINE_ Simd4(real_t p_a,real_t p_b,real_t p_c,real_t p_d) { v=_mm_setr_ps(p_a,p_b,p_c,p_d); }
+
+	static _FORCE_INLINE_ Simd4 load(const real_t *p_src) { return _mm_loadu_ps(p_src); }
+	_FORCE_INLINE_ void store(real_t *p_dst) const { _mm_storeu_ps(p_dst,v); }
+
+	_FORCE_INLINE_ Simd4 operator+(const Simd4& p_o) const { return _mm_add_ps(v,p_o.v); }
+	_FORCE_INLINE_ Simd4 operator-(const Simd4& p_o) const { return _mm_sub_ps(v,p_o.v); }
+	_FORCE_INLINE_ Simd4 operator*(const Simd4& p_o) const { return _mm_mul_ps(v,p_o.v); }
+	_FORCE_INLINE_ Simd4 operator/(const Simd4& p_o) const { return _mm_div_ps(v,p_o.v); }
+	_FORCE_INLINE_ Simd4 operator-() const { return _mm_sub_ps(_mm_setzero_ps(),v); }
+
+	_FORCE_INLINE_ Simd4 min(const Simd4& p_o) const { return _mm_min_ps(v,p_o.v); }
+	_FORCE_INLINE_ Simd4 max(const Simd4& p_o) const { return _mm_max_ps(v,p_o.v); }
+	_FORCE_INLINE_ Simd4 abs() const { return _mm_andnot_ps(_mm_set1_ps(-0.0f),v); }
+	_FORCE_INLINE_ Simd4 sqrt() const { return _mm_sqrt_ps(v); }
+
+	_FORCE_INLINE_ Simd4 greater(const Simd4& p_o) const { return _mm_cmpgt_ps(v,p_o.v); }
+	_FORCE_INLINE_ Simd4 less(const Simd4& p_o) const { return _mm_cmplt_ps(v,p_o.v); }
+	_FORCE_INLINE_ Simd4 operator|(const Simd4& p_o) const { return _mm_or_ps(v,p_o.v); }
+	// lane i is set in bit i
+	_FORCE_INLINE_ int mask() const { return _mm_movemask_ps(v); }
+	static _FORCE_INLINE_ Simd4 select(const Simd4& p_mask,const Simd4& p_true,const Simd4& p_false) {
+		return _mm_or_ps(_mm_and_ps(p_mask.v,p_true.v),_mm_andnot_ps(p_mask.v,p_false.v));
+	}
+
+#else
+
+	real_t v[4];
+
+	_FORCE_INLINE_ Simd4() {}
+	_FORCE_INLINE_ explicit Simd4(real_t p_s) { v[0]=v[1]=v[2]=v[3]=p_s; }
+	_FORCE_INLINE_ Simd4(real_t p_a,real_t p_b,real_t p_c,real_t p_d) { v[0]=p_a; v[1]=p_b; v[2]=p_c; v[3]=p_d; }
+
+	static _FORCE_INLINE_ Simd4 load(const real_t *p_src) { return Simd4(p_src[0],p_src[1],p_src[2],p_src[3]); }
+	_FORCE_INLINE_ void store(real_t *p_dst) const { for(int i=0;i<4;i++) p_dst[i]=v[i]; }
+
+#define SIMD4_OP(m_expr) Simd4 r; for(int i=0;i<4;i++) { r.v[i]=(m_expr); } return r;
+
+	_FORCE_INLINE_ Simd4 operator+(const Simd4& p_o) const { SIMD4_OP(v[i]+p_o.v[i]) }
+	_FORCE_INLINE_ Simd4 operator-(const Simd4& p_o) const { SIMD4_OP(v[i]-p_o.v[i]) }
+	_FORCE_INLINE_ Simd4 operator*(const Simd4& p_o) const { SIMD4_OP(v[i]*p_o.v[i]) }
+	_FORCE_INLINE_ Simd4 operator/(const Simd4& p_o) const { SIMD4_OP(v[i]/p_o.v[i]) }
+	_FORCE_INLINE_ Simd4 operator-() const { SIMD4_OP(-v[i]) }
+
+	_FORCE_INLINE_ Simd4 min(const Simd4& p_o) const { SIMD4_OP(v[i]<p_o.v[i]?v[i]:p_o.v[i]) }
+	_FORCE_INLINE_ Simd4 max(const Simd4& p_o) const { SIMD4_OP(v[i]>p_o.v[i]?v[i]:p_o.v[i]) }
+	_FORCE_INLINE_ Simd4 abs() const { SIMD4_OP(Math::abs(v[i])) }
+	_FORCE_INLINE_ Simd4 sqrt() const { SIMD4_OP(Math::sqrt(v[i])) }
+
+	_FORCE_INLINE_ Simd4 greater(const Simd4& p_o) const { SIMD4_OP(v[i]>p_o.v[i]?1.0:0.0) }
+	_FORCE_INLINE_ Simd4 less(const Simd4& p_o) const { SIMD4_OP(v[i]<p_o.v[i]?1.0:0.0) }
+	_FORCE_INLINE_ Simd4 operator|(const Simd4& p_o) const { SIMD4_OP((v[i]!=0 || p_o.v[i]!=0)?1.0:0.0) }
+	_FORCE_INLINE_ int mask() const { int m=0; for(int i=0;i<4;i++) { if (v[i]!=0) m|=1<<i; } return m; }
+	static _FORCE_INLINE_ Simd4 select(const Simd4& p_mask,const Simd4& p_true,const Simd4& p_false) {
+		SIMD4_OP(p_mask.v[i]!=0?p_true.v[i]:p_false.v[i])
+	}
+
+#undef SIMD4_OP
+
+#endif
+
+	_FORCE_INLINE_ real_t get(int p_lane) const { real_t r[4]; store(r); return r[p_lane]; }
+
+	_FORCE_INLINE_ real_t horizontal_min() const {
+		real_t r[4]; store(r);
+		real_t a=r[0]<r[1]?r[0]:r[1];
+		real_t b=r[2]<r[3]?r[2]:r[3];
+		return a<b?a:b;
+	}
+
+	_FORCE_INLINE_ real_t horizontal_max() const {
+		real_t r[4]; store(r);
+		real_t a=r[0]>r[1]?r[0]:r[1];
+		real_t b=r[2]>r[3]?r[2]:r[3];
+		return a>b?a:b;
+	}
+};
+
+#endif // SIMD4_H
@@ -28,6 +28,10 @@
 /*************************************************************************/
 #include "message_queue.h"
 #include "globals.h"
+#include "object_type_db.h"
+#include "core_string_names.h"
+#include "os/thread.h"
+#include "hashfuncs.h"
 
 MessageQueue *MessageQueue::singleton=NULL;
 
@@ -36,11 +40,55 @@ MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
-Error MessageQueue::push_call(ObjectID p_id, const StringName& p_method, VARIANT_ARG_DECLARE) {
+MessageQueue::Queue *MessageQueue::_get_queue() {
+
+	//each thread pushes to its own queue (threads may share one if they collide), so producers don't fight over a lock
+	Thread::ID id = Thread::get_caller_ID();
+	if (id==Thread::get_main_ID())
+		return &queues[0];
+
+	return &queues[1+hash_djb2_one_64(id)%(QUEUE_COUNT-1)];
+}
+
+uint8_t *MessageQueue::_alloc(Queue *p_queue,uint32_t p_size) {
+
+	//queue must be locked, grows a page at a time so nothing is dropped
+	Page *page = p_queue->last;
+
+	if (!page || page->used+p_size > PAGE_SIZE) {
+
+		Page *new_page = p_queue->free_pages;
+		if (new_page)
+			p_queue->free_pages=new_page->next;
+		else
+			new_page = memnew( Page );
+
+		new_page->next=NULL;
+		new_page->used=0;
+
+		if (page)
+			page->next=new_page;
+		else
+			p_queue->first=new_page;
+		p_queue->last=new_page;
+		page=new_page;
+	}
+
+	uint8_t *ptr = &page->get_data()[ page->used ];
+	page->used+=p_size;
+	return ptr;
+}
 
-	_THREAD_SAFE_METHOD_
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+
+	if (p_message->type==TYPE_NOTIFICATION)
+		return sizeof(Message);
+
+	return sizeof(Message)+sizeof(StringName)+sizeof(Variant)*p_message->args;
+}
+
+Error MessageQueue::push_call(ObjectID p_id, const StringName& p_method, VARIANT_ARG_DECLARE) {
 
-	uint8_t room_needed=sizeof(Message);
 	int args=0;
 	if (p_arg5.get_type()!=Variant::NIL)
 		args=5;
@@ -55,128 +103,70 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName& p_method, VARIANT
 	else
 		args=0;
 
-	room_needed+=sizeof(Variant)*args;
+	VARIANT_ARGPTRS;
 
-	if ((buffer_end+room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type=ObjectDB::get_instance(p_id)->get_type();
-		print_line("failed method: "+type+":"+p_method+" target ID: "+itos(p_id));
-		statistics();
+	Queue *queue = _get_queue();
+	queue->lock();
 
-	}
-	ERR_FAIL_COND_V( (buffer_end+room_needed) >= buffer_size , ERR_OUT_OF_MEMORY );
-	Message * msg = memnew_placement( &buffer[ buffer_end ], Message );
+	uint8_t *ptr = _alloc(queue,sizeof(Message)+sizeof(StringName)+sizeof(Variant)*args);
+
+	Message * msg = memnew_placement( ptr, Message );
 	msg->args=args;
 	msg->instance_ID=p_id;
-	msg->target=p_method;
 	msg->type=TYPE_CALL;
-	buffer_end+=sizeof(Message);
-
-
-	if (args>=1) {
 
-		Variant * v = memnew_placement( &buffer[ buffer_end ], Variant );
-		buffer_end+=sizeof(Variant);
-		*v=p_arg1;
-	}
+	StringName *name = memnew_placement( msg+1, StringName );
+	*name=p_method;
 
-	if (args>=2) {
+	Variant *v = (Variant*)(name+1);
+	for(int i=0;i<args;i++) {
 
-		Variant * v = memnew_placement( &buffer[ buffer_end ], Variant );
-		buffer_end+=sizeof(Variant);
-		*v=p_arg2;
-	}
-
-	if (args>=3) {
-
-		Variant * v = memnew_placement( &buffer[ buffer_end ], Variant );
-		buffer_end+=sizeof(Variant);
-		*v=p_arg3;
-
-	}
-
-	if (args>=4) {
-
-		Variant * v = memnew_placement( &buffer[ buffer_end ], Variant );
-		buffer_end+=sizeof(Variant);
-		*v=p_arg4;
-	}
-
-	if (args>=5) {
-
-		Variant * v = memnew_placement( &buffer[ buffer_end ], Variant );
-		buffer_end+=sizeof(Variant);
-		*v=p_arg5;
+		memnew_placement( &v[i], Variant );
+		v[i]=*argptr[i];
 	}
 
+	queue->unlock();
 
 	return OK;
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName& p_prop, const Variant& p_value) {
 
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed=sizeof(Message)+sizeof(Variant);
-
-	if ((buffer_end+room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type=ObjectDB::get_instance(p_id)->get_type();
-		print_line("failed set: "+type+":"+p_prop+" target ID: "+itos(p_id));
-		statistics();
-
-	}
+	Queue *queue = _get_queue();
+	queue->lock();
 
-	ERR_FAIL_COND_V( (buffer_end+room_needed) >= buffer_size , ERR_OUT_OF_MEMORY );
+	uint8_t *ptr = _alloc(queue,sizeof(Message)+sizeof(StringName)+sizeof(Variant));
 
-	Message * msg = memnew_placement( &buffer[ buffer_end ], Message );
+	Message * msg = memnew_placement( ptr, Message );
 	msg->args=1;
 	msg->instance_ID=p_id;
-	msg->target=p_prop;
 	msg->type=TYPE_SET;
 
-	buffer_end+=sizeof(Message);
+	StringName *name = memnew_placement( msg+1, StringName );
+	*name=p_prop;
 
-	Variant * v = memnew_placement( &buffer[ buffer_end ], Variant );
-	buffer_end+=sizeof(Variant);
+	Variant * v = memnew_placement( name+1, Variant );
 	*v=p_value;
 
+	queue->unlock();
 
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
 
-	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND_V(p_notification<0 || p_notification>0x7FFF, ERR_INVALID_PARAMETER );
 
-	ERR_FAIL_COND_V(p_notification<0, ERR_INVALID_PARAMETER );
+	Queue *queue = _get_queue();
+	queue->lock();
 
-	uint8_t room_needed=sizeof(Message);
-
-	if ((buffer_end+room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id))
-			type=ObjectDB::get_instance(p_id)->get_type();
-		print_line("failed notification: "+itos(p_notification)+" target ID: "+itos(p_id));
-		statistics();
-
-	}
-
-
-
-
-	ERR_FAIL_COND_V( (buffer_end+room_needed) >= buffer_size , ERR_OUT_OF_MEMORY );
-	Message * msg = memnew_placement( &buffer[ buffer_end ], Message );
+	Message * msg = memnew_placement( _alloc(queue,sizeof(Message)), Message );
 
 	msg->type=TYPE_NOTIFICATION;
 	msg->instance_ID=p_id;
-	//msg->target;
 	msg->notification=p_notification;
 
-	buffer_end+=sizeof(Message);
-
+	queue->unlock();
 
 	return OK;
 }
@@ -202,61 +192,72 @@ void MessageQueue::statistics() {
 	Map<int,int> notify_count;
 	Map<StringName,int> call_count;
 	int null_count=0;
+	uint32_t total=0;
 
-	uint32_t read_pos=0;
-	while (read_pos < buffer_end ) {
-		Message *message = (Message*)&buffer[ read_pos ];
+	for(int i=0;i<QUEUE_COUNT;i++) {
 
-		Object *target = ObjectDB::get_instance(message->instance_ID);
+		queues[i].lock();
 
-		if (target!=NULL) {
+		for(Page *page=queues[i].first;page;page=page->next) {
 
+			uint32_t read_pos=0;
+			while (read_pos < page->used ) {
+				Message *message = (Message*)&page->get_data()[ read_pos ];
 
-			switch(message->type) {
+				Object *target = ObjectDB::get_instance(message->instance_ID);
 
-				case TYPE_CALL: {
+				if (target!=NULL) {
 
-					if (!call_count.has(message->target))
-						call_count[message->target]=0;
+					switch(message->type) {
 
-					call_count[message->target]++;
+						case TYPE_CALL: {
 
-				} break;
-				case TYPE_NOTIFICATION: {
+							StringName &name = *(StringName*)(message+1);
+							if (!call_count.has(name))
+								call_count[name]=0;
 
-					if (!notify_count.has(message->notification))
-						notify_count[message->notification]=0;
+							call_count[name]++;
 
-					notify_count[message->notification]++;
+						} break;
+						case TYPE_NOTIFICATION: {
 
-				} break;
-				case TYPE_SET: {
+							if (!notify_count.has(message->notification))
+								notify_count[message->notification]=0;
 
-					if (!set_count.has(message->target))
-						set_count[message->target]=0;
+							notify_count[message->notification]++;
 
-					set_count[message->target]++;
+						} break;
+						case TYPE_SET: {
 
-				} break;
+							StringName &name = *(StringName*)(message+1);
+							if (!set_count.has(name))
+								set_count[name]=0;
 
-			}
+							set_count[name]++;
 
-			//object was deleted
-			//WARN_PRINT("Object was deleted while awaiting a callback")
-			//should it print a warning?
-		} else {
+						} break;
 
-			null_count++;
-		}
+					}
+
+					//object was deleted
+					//WARN_PRINT("Object was deleted while awaiting a callback")
+					//should it print a warning?
+				} else {
 
+					null_count++;
+				}
 
-		read_pos+=sizeof(Message);
-		if (message->type!=TYPE_NOTIFICATION)
-			read_pos+=sizeof(Variant)*message->args;
+				read_pos+=_get_message_size(message);
+			}
+
+			total+=page->used;
+		}
+
+		queues[i].unlock();
 	}
 
 
-	print_line("TOTAL BYTES: "+itos(buffer_end));
+	print_line("TOTAL BYTES: "+itos(total));
 	print_line("NULL count: "+itos(null_count));
 
 	for(Map<StringName,int>::Element *E=set_count.front();E;E=E->next()) {
@@ -277,120 +278,144 @@ void MessageQueue::statistics() {
 }
 
 bool MessageQueue::print() {
-#if 0
-	uint32_t read_pos=0;
-	while (read_pos < buffer_end ) {
-		Message *message = (Message*)&buffer[ read_pos ];
 
-		Object *target = ObjectDB::get_instance(message->instance_ID);
-		String cname;
-		String cfunc;
+	return false;
+}
 
-		if (target==NULL) {
-			//object was deleted
-			//WARN_PRINT("Object was deleted while awaiting a callback")
-			//should it print a warning?
-		} else if (message->notification>=0) {
+int MessageQueue::get_max_buffer_usage() const {
 
-			// messages don't expect a return value
-			cfunc="notification # "+itos(message->notification);
-			cname=target->get_type();
+	return buffer_max_used;
+}
 
-		} else if (!message->target.empty()) {
+void MessageQueue::_dispatch(Message *p_message,CallCache *p_cache) {
 
-			cfunc="property:  "+message->target;
-			cname=target->get_type();
+	Object *target = ObjectDB::get_instance(p_message->instance_ID);
 
+	switch(p_message->type) {
+		case TYPE_CALL: {
 
-		} else if (message->target) {
+			StringName *name = (StringName*)(p_message+1);
+			Variant *args= (Variant*)(name+1);
 
-			cfunc=String(message->target)+"()";
-			cname=target->get_type();
-		}
+			if (target!=NULL) {
 
+				const Variant *argptr[VARIANT_ARG_MAX];
+				for(int i=0;i<p_message->args;i++)
+					argptr[i]=&args[i];
 
-		read_pos+=sizeof(Message);
-		if (message->type!=TYPE_NOTIFICATION)
-			read_pos+=sizeof(Variant)*message->args;
-	}
-#endif
-	return false;
-}
+				// messages don't expect a return value
+				Variant::CallError ce;
 
-int MessageQueue::get_max_buffer_usage() const {
+				MethodBind *bind=NULL;
 
-	return buffer_max_used;
-}
+				if (!target->get_script_instance() && *name!=CoreStringNames::get_singleton()->_free) {
 
-void MessageQueue::flush() {
+					//resolve the bind once for consecutive calls to the same method on the same type
+					if (p_cache->type!=target->get_type_name() || p_cache->method!=*name) {
+						p_cache->type=target->get_type_name();
+						p_cache->method=*name;
+						p_cache->bind=ObjectTypeDB::get_method(p_cache->type,p_cache->method);
+					}
+					bind=p_cache->bind;
+				}
+
+				if (bind) {
+					bind->call(target,argptr,p_message->args,ce);
+				} else {
+					target->call(*name,argptr,p_message->args,ce);
+				}
+			}
+
+			for(int i=0;i<p_message->args;i++) {
+				args[i].~Variant();
+			}
+			name->~StringName();
+
+		} break;
+		case TYPE_NOTIFICATION: {
 
-	if (buffer_max_used<buffer_end); {
-		buffer_max_used=buffer_end;
-		//statistics();
+			// messages don't expect a return value
+			if (target!=NULL)
+				target->notification(p_message->notification);
+
+		} break;
+		case TYPE_SET: {
+
+			StringName *name = (StringName*)(p_message+1);
+			Variant *arg= (Variant*)(name+1);
+			// messages don't expect a return value
+			if (target!=NULL)
+				target->set(*name,*arg);
+
+			arg->~Variant();
+			name->~StringName();
+		} break;
 	}
 
-	uint32_t read_pos=0;
+	p_message->~Message();
+}
+
+void MessageQueue::_free_pages(Page *p_page) {
 
-	while (read_pos < buffer_end ) {
-		//lock on each interation, so a call can re-add itself to the message queue
-		_THREAD_SAFE_LOCK_
+	while(p_page) {
+		Page *next=p_page->next;
+		memdelete(p_page);
+		p_page=next;
+	}
+}
 
-		Message *message = (Message*)&buffer[ read_pos ];
+void MessageQueue::flush() {
 
-		Object *target = ObjectDB::get_instance(message->instance_ID);
+	CallCache cache;
+	cache.bind=NULL;
+	uint32_t used=0;
 
-		if (target!=NULL) {
+	bool pending=true;
 
-			switch(message->type) {
-				case TYPE_CALL: {
+	while(pending) {
 
-					Variant *args= (Variant*)(message+1);
+		//messages pushed while dispatching (or from other threads) are picked up in the next pass
+		pending=false;
 
-					// messages don't expect a return value
+		for(int i=0;i<QUEUE_COUNT;i++) {
 
+			Queue &queue=queues[i];
 
-					target->call( message->target,
-						(message->args>=1) ? args[0] : Variant(),
-						(message->args>=2) ? args[1] : Variant(),
-						(message->args>=3) ? args[2] : Variant(),
-						(message->args>=4) ? args[3] : Variant(),
-						(message->args>=5) ? args[4] : Variant() );
+			queue.lock();
+			Page *first=queue.first;
+			queue.first=NULL;
+			queue.last=NULL;
+			queue.unlock();
 
-					for(int i=0;i<message->args;i++) {
-						args[i].~Variant();
-					}
+			if (!first)
+				continue;
 
-				} break;
-				case TYPE_NOTIFICATION: {
+			pending=true;
+			Page *last=NULL;
 
-					// messages don't expect a return value
-					target->notification(message->notification);
+			for(Page *page=first;page;page=page->next) {
 
-				} break;
-				case TYPE_SET: {
+				uint32_t read_pos=0;
+				while (read_pos < page->used ) {
 
-					Variant *arg= (Variant*)(message+1);
-					// messages don't expect a return value
-					target->set(message->target,*arg);
+					Message *message = (Message*)&page->get_data()[ read_pos ];
+					read_pos+=_get_message_size(message);
+					_dispatch(message,&cache);
+				}
 
-					arg->~Variant();
-				} break;
+				used+=page->used;
+				last=page;
 			}
 
+			queue.lock();
+			last->next=queue.free_pages;
+			queue.free_pages=first;
+			queue.unlock();
 		}
-		message->~Message();
-
-		read_pos+=sizeof(Message);
-		if (message->type!=TYPE_NOTIFICATION)
-			read_pos+=sizeof(Variant)*message->args;
-		_THREAD_SAFE_UNLOCK_
-
 	}
 
-	_THREAD_SAFE_LOCK_
-	buffer_end=0; // reset buffer
-	_THREAD_SAFE_UNLOCK_
-
+	if (buffer_max_used<used)
+		buffer_max_used=used;
 }
 
 MessageQueue::MessageQueue() {
@@ -398,34 +423,56 @@ MessageQueue::MessageQueue() {
 	ERR_FAIL_COND(singleton!=NULL);
 	singleton=this;
 
-	buffer_end=0;
 	buffer_max_used=0;
-	buffer_size=GLOBAL_DEF( "core/message_queue_size_kb", DEFAULT_QUEUE_SIZE_KB );
-	buffer_size*=1024;
-	buffer = memnew_arr( uint8_t, buffer_size );
+
+	for(int i=0;i<QUEUE_COUNT;i++) {
+
+		queues[i].mutex=Mutex::create();
+		queues[i].first=NULL;
+		queues[i].last=NULL;
+		queues[i].free_pages=NULL;
+	}
+
+	//preallocate the main thread queue, more pages are added if it ever fills up
+	int prealloc_kb=GLOBAL_DEF( "core/message_queue_size_kb", DEFAULT_QUEUE_SIZE_KB );
+	int pages=prealloc_kb*1024/PAGE_SIZE;
+	for(int i=0;i<pages;i++) {
+
+		Page *page = memnew( Page );
+		page->next=queues[0].free_pages;
+		queues[0].free_pages=page;
+	}
 }
 
 
 MessageQueue::~MessageQueue() {
 
-	uint32_t read_pos=0;
+	for(int i=0;i<QUEUE_COUNT;i++) {
 
-	while (read_pos < buffer_end ) {
+		for(Page *page=queues[i].first;page;page=page->next) {
 
-		Message *message = (Message*)&buffer[ read_pos ];
-		Variant *args= (Variant*)(message+1);
-		int argc = message->args;
-		if (message->type!=TYPE_NOTIFICATION) {
-			for (int i=0;i<argc;i++)
-				args[i].~Variant();
+			uint32_t read_pos=0;
+			while (read_pos < page->used ) {
+
+				Message *message = (Message*)&page->get_data()[ read_pos ];
+				read_pos+=_get_message_size(message);
+
+				if (message->type!=TYPE_NOTIFICATION) {
+					StringName *name = (StringName*)(message+1);
+					Variant *args= (Variant*)(name+1);
+					for (int j=0;j<message->args;j++)
+						args[j].~Variant();
+					name->~StringName();
+				}
+				message->~Message();
+			}
 		}
-		message->~Message();
 
-		read_pos+=sizeof(Message);
-		if (message->type!=TYPE_NOTIFICATION)
-			read_pos+=sizeof(Variant)*message->args;
+		_free_pages(queues[i].first);
+		_free_pages(queues[i].free_pages);
+		if (queues[i].mutex)
+			memdelete(queues[i].mutex);
 	}
 
 	singleton=NULL;
-	memdelete_arr( buffer );
 }
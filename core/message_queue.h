@@ -31,40 +31,70 @@
 
 #include "object.h"
 #include "os/mutex.h"
-#include "os/thread_safe.h"
-class MessageQueue {
 
-	_THREAD_SAFE_CLASS_
+class MethodBind;
+
+class MessageQueue {
 
 	enum {
 
-        DEFAULT_QUEUE_SIZE_KB=1024
+		DEFAULT_QUEUE_SIZE_KB=1024,
+		PAGE_SIZE=65536,
+		QUEUE_COUNT=16 //first one belongs to the main thread, other threads are spread over the rest
 	};
 
-	Mutex *mutex;
-
 	enum {
 		TYPE_CALL,
 		TYPE_NOTIFICATION,
 		TYPE_SET
 	};
 
+	//notifications are only this header, calls and sets are followed by the StringName and the arguments
 	struct Message {
 
 		ObjectID instance_ID;
-		StringName target;
-		int16_t type;
+		uint16_t type;
 		union {
 			int16_t notification;
-			int16_t args;
+			uint16_t args;
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end;
+	struct Page {
+
+		Page *next;
+		uint32_t used;
+		uint64_t data[PAGE_SIZE/sizeof(uint64_t)];
+
+		_FORCE_INLINE_ uint8_t *get_data() { return (uint8_t*)data; }
+	};
+
+	struct Queue {
+
+		Mutex *mutex;
+		Page *first;
+		Page *last;
+		Page *free_pages;
+
+		_FORCE_INLINE_ void lock() { if (mutex) mutex->lock(); }
+		_FORCE_INLINE_ void unlock() { if (mutex) mutex->unlock(); }
+	};
+
+	struct CallCache {
+
+		StringName type;
+		StringName method;
+		MethodBind *bind;
+	};
+
+	Queue queues[QUEUE_COUNT];
 	uint32_t buffer_max_used;
-	uint32_t buffer_size;
 
+	_FORCE_INLINE_ Queue *_get_queue();
+	uint8_t *_alloc(Queue *p_queue,uint32_t p_size);
+	static uint32_t _get_message_size(const Message *p_message);
+	void _dispatch(Message *p_message,CallCache *p_cache);
+	void _free_pages(Page *p_page);
 
 	static MessageQueue *singleton;
 public:
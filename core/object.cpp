@@ -990,14 +990,6 @@ void Object::add_user_signal(const MethodInfo& p_signal) {
 	signal_map[p_signal.name]=s;
 }
 
-struct _ObjectSignalDisconnectData {
-
-	StringName signal;
-	Object *target;
-	StringName method;
-
-};
-
 #if 0
 void Object::_emit_signal(const StringName& p_name,const Array& p_pargs){
 
@@ -1055,110 +1047,84 @@ void Object::emit_signal(const StringName& p_name,VARIANT_ARG_DECLARE) {
 		return;
 	}
 
+	//connections are walked in place, nothing is copied. connecting or disconnecting while
+	//emitting moves the position of the emissions in progress, and deleting this object
+	//from a receiver stops them. see connect(), disconnect() and ~Object().
+	SignalEmission emission;
+	emission.signal=s;
+	emission.pos=0;
+	emission.deleted=false;
+	emission.prev=_emissions;
+	_emissions=&emission;
+	s->lock++;
 
-	List<_ObjectSignalDisconnectData> disconnect_data;
-
-
-	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Signal::Target,Signal::Slot> slot_map = s->slot_map;
+	const VMap<Signal::Target,Signal::Slot> &slot_map = s->slot_map;
 
-	int ssize = slot_map.size();
+	for(;emission.pos<slot_map.size();emission.pos++) {
 
-	for(int i=0;i<ssize;i++) {
+		const Signal::Slot &slot = slot_map.getv(emission.pos);
+		const Connection &c = slot.conn;
+		Object *target = c.target;
+		bool oneshot = c.flags&CONNECT_ONESHOT;
+		emission.removed=false;
 
-		const Connection &c = slot_map.getv(i).conn;
 		VARIANT_ARGPTRS
 
-		Object *target;
-#ifdef DEBUG_ENABLED
-		target = ObjectDB::get_instance(slot_map.getk(i)._id);
-		ERR_CONTINUE(!target);
-#else
-		target=c.target;
-#endif
+		//keep the binds alive even if the receiver disconnects itself, the
+		//vector is shared so read it only through a const reference
+		Vector<Variant> bind_ref;
+		if (c.binds.size()) {
 
+			bind_ref=c.binds;
+			const Vector<Variant> &binds=bind_ref;
+			int bind_count=binds.size();
+			int bind=0;
 
-		int bind_count=c.binds.size();
-		int bind=0;
+			for(int i=0;bind < bind_count && i<VARIANT_ARG_MAX;i++) {
 
-		for(int i=0;bind < bind_count && i<VARIANT_ARG_MAX;i++) {
-
-			if (argptr[i]->get_type()==Variant::NIL) {
-				argptr[i]=&c.binds[bind];
-				bind++;
+				if (argptr[i]->get_type()==Variant::NIL) {
+					argptr[i]=&binds[bind];
+					bind++;
+				}
 			}
 		}
 
 		if (c.flags&CONNECT_DEFERRED) {
 			MessageQueue::get_singleton()->push_call(target->get_instance_ID(),c.method,VARIANT_ARGPTRS_PASS);
 		} else {
-			target->call( c.method, VARIANT_ARGPTRS_PASS );
-		}
 
-		if (c.flags&CONNECT_ONESHOT) {
-			_ObjectSignalDisconnectData dd;
-			dd.signal=p_name;
-			dd.target=target;
-			dd.method=c.method;
-			disconnect_data.push_back(dd);
-		}
+			int argc=0;
+			while(argc<VARIANT_ARG_MAX && argptr[argc]->get_type()!=Variant::NIL)
+				argc++;
 
-	}
-
-#if 0
-
-	//old (deprecated and dangerous code)
-	s->lock++;
-	for( Map<Signal::Target,Signal::Slot>::Element *E = s->slot_map.front();E;E=E->next() ) {
-
-		const Signal::Target& t = E->key();
-		const Signal::Slot& s = E->get();
-		const Connection &c = s.cE->get();
-
-		VARIANT_ARGPTRS
-
-		int bind_count=c.binds.size();
-		int bind=0;
-
-		for(int i=0;bind < bind_count && i<VARIANT_ARG_MAX;i++) {
-
-			if (argptr[i]->get_type()==Variant::NIL) {
-				argptr[i]=&c.binds[bind];
-				bind++;
+			Variant::CallError ce;
+			if (slot.method && !target->script_instance) {
+				//no script in the way, call the bound method directly
+				slot.method->call(target,argptr,argc,ce);
+			} else {
+				StringName method = c.method;
+				target->call(method,argptr,argc,ce);
 			}
 		}
 
-		if (c.flags&CONNECT_DEFERRED) {
-			MessageQueue::get_singleton()->push_call(t._id,t.method,VARIANT_ARGPTRS_PASS);
-		} else {
-			Object *obj = ObjectDB::get_instance(t._id);
-			ERR_CONTINUE(!obj); //yeah this should always be here
-			obj->call( t.method, VARIANT_ARGPTRS_PASS );
-		}
+		if (emission.deleted)
+			return; //this object was freed by a receiver, don't touch it anymore
 
-		if (c.flags&CONNECT_ONESHOT) {
-			_ObjectSignalDisconnectData dd;
-			dd.signal=p_name;
-			dd.target=ObjectDB::get_instance(t._id);
-			dd.method=t.method;
-			disconnect_data.push_back(dd);
-		}
+		if (oneshot && !emission.removed) {
 
+			const Connection &oc = slot_map.getv(emission.pos).conn;
+			StringName method = oc.method;
+			disconnect(p_name,oc.target,method);
+		}
 	}
 
-
-
 	s->lock--;
-#endif
-	while (!disconnect_data.empty()) {
+	_emissions=emission.prev;
 
-		const _ObjectSignalDisconnectData &dd = disconnect_data.front()->get();
-		disconnect(dd.signal,dd.target,dd.method);
-		disconnect_data.pop_front();
+	if (s->lock==0 && s->slot_map.empty() && ObjectTypeDB::has_signal(get_type_name(),p_name)) {
+		//disconnected while emitting, erase now as disconnect() would have done
+		signal_map.erase(p_name);
 	}
-
 }
 
 
@@ -1273,7 +1239,18 @@ void Object::connect(const StringName& p_signal, Object *p_to_object, const Stri
 	conn.binds=p_binds;
 	slot.conn=conn;
 	slot.cE=p_to_object->connections.push_back(conn);
+	if (p_to_method!=CoreStringNames::get_singleton()->_free)
+		slot.method=ObjectTypeDB::get_method(p_to_object->get_type_name(),p_to_method);
 	s->slot_map[target]=slot;
+
+	if (s->lock>0) {
+		int idx=s->slot_map.find(target);
+		for(SignalEmission *e=_emissions;e;e=e->prev) {
+
+			if (e->signal==s && idx<=e->pos)
+				e->pos++; //inserted before the connection being called, keep pointing to it
+		}
+	}
 }
 
 bool Object::is_connected(const StringName& p_signal, Object *p_to_object, const StringName& p_to_method) const {
@@ -1304,21 +1281,28 @@ void Object::disconnect(const StringName& p_signal, Object *p_to_object, const S
 		ERR_EXPLAIN("Unexisting signal: "+p_signal);
 		ERR_FAIL_COND(!s);
 	}
-	if (s->lock>0) {
-		ERR_EXPLAIN("Attempt to disconnect signal '"+p_signal+"' while emitting (locks: "+itos(s->lock)+")");
-		ERR_FAIL_COND(s->lock>0);
-	}
-
 	Signal::Target target(p_to_object->get_instance_ID(),p_to_method);
 
 	if (!s->slot_map.has(target)) {
 		ERR_EXPLAIN("Disconnecting unexisting signal '"+p_signal+"', slot: "+itos(target._id)+":"+target.method);
 		ERR_FAIL();
 	}
-	int prev = p_to_object->connections.size();
+	int idx=s->slot_map.find(target);
 	p_to_object->connections.erase(s->slot_map[target].cE);
 	s->slot_map.erase(target);
 
+	if (s->lock>0) {
+		for(SignalEmission *e=_emissions;e;e=e->prev) {
+
+			if (e->signal!=s || idx>e->pos)
+				continue;
+			if (idx==e->pos)
+				e->removed=true;
+			e->pos--; //so the next one is not skipped
+		}
+		return; //signal is erased when the emission ends, if needed
+	}
+
 	if (s->slot_map.empty() && ObjectTypeDB::has_signal(get_type_name(),p_signal )) {
 		//not user signal, delete
 		signal_map.erase(p_signal);
@@ -1526,6 +1510,7 @@ Object::Object() {
 	
 
 	_block_signals=false;
+	_emissions=NULL;
 	_predelete_ok=0;
 	_instance_ID=0;
 	_instance_ID = ObjectDB::add_instance(this);
@@ -1543,6 +1528,10 @@ Object::Object() {
 Object::~Object() {
 
 
+	//freed from one of its own receivers, stop the emissions in progress
+	for(SignalEmission *e=_emissions;e;e=e->prev) {
+		e->deleted=true;
+	}
 
 	if (script_instance)
 		memdelete(script_instance);
@@ -1556,9 +1545,6 @@ Object::~Object() {
 
 		Signal *s=&signal_map[*S];
 
-		ERR_EXPLAIN("Attempt to delete an object in the middle of a signal emission from it");
-		ERR_CONTINUE(s->lock>0);
-
 		for(int i=0;i<s->slot_map.size();i++) {
 
 			sconnections.push_back(s->slot_map.getv(i).conn);
@@ -304,6 +304,7 @@ virtual String get_save_type() const { return #m_type; }\
 private:
 
 class ScriptInstance;
+class MethodBind;
 typedef uint32_t ObjectID;
 
 class Object {		
@@ -353,6 +354,8 @@ friend void postinitialize_handler(Object*);
 
 			Connection conn;
 			List<Connection>::Element *cE;
+			MethodBind *method; // resolved on connect, NULL when only a script can answer
+			Slot() { cE=NULL; method=NULL; }
 		};
 
 		MethodInfo user;
@@ -363,8 +366,18 @@ friend void postinitialize_handler(Object*);
 	};
 
 
+	struct SignalEmission {
+
+		const Signal *signal;
+		int pos; // connection being called
+		bool removed; // connection being called was disconnected
+		bool deleted; // emitting object was freed
+		SignalEmission *prev;
+	};
+
 	HashMap< StringName, Signal, StringNameHasher> signal_map;
 	List<Connection> connections;
+	SignalEmission *_emissions; // emissions in progress, innermost first
 
 	bool _block_signals;
 	int _predelete_ok;
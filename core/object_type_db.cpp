@@ -194,6 +194,16 @@ Object *ObjectTypeDB::instance(const String &p_type) {
 
 	return ti->creation_func();
 }
+ObjectTypeDB::CreationFunc ObjectTypeDB::get_creation_func(const StringName &p_type) {
+
+	OBJTYPE_LOCK;
+
+	TypeInfo *ti = types.getptr(p_type);
+	if (!ti || ti->disabled)
+		return NULL;
+	return ti->creation_func;
+}
+
 bool ObjectTypeDB::can_instance(const String &p_type) {
 	
 	OBJTYPE_LOCK;
@@ -576,6 +586,26 @@ bool ObjectTypeDB::set_property(Object* p_object,const StringName& p_property, c
 
 	return false;
 }
+MethodBind *ObjectTypeDB::get_property_setter(const StringName& p_type,const StringName& p_property) {
+
+	OBJTYPE_LOCK;
+
+	TypeInfo *check=types.getptr(p_type);
+	while(check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+
+			if (psg->index>=0 || !psg->setter)
+				return NULL;
+			return psg->_setptr;
+		}
+
+		check=check->inherits_ptr;
+	}
+
+	return NULL;
+}
+
 bool ObjectTypeDB::get_property(Object* p_object,const StringName& p_property, Variant& r_value) {
 
 	TypeInfo *type=types.getptr(p_object->get_type_name());
@@ -230,6 +230,9 @@ public:
 	static bool can_instance(const String &p_type);	
 	static Object *instance(const String &p_type);
 
+	typedef Object* (*CreationFunc)();
+	static CreationFunc get_creation_func(const StringName &p_type); ///< NULL if the type can't be instanced
+
 #if 0
 	template<class N, class M>
 	static MethodBind* bind_method(N p_method_name, M p_method,
@@ -441,6 +444,7 @@ public:
 	static void add_property(StringName p_type,const PropertyInfo& p_pinfo, const StringName& p_setter, const StringName& p_getter, int p_index=-1);
 	static void get_property_list(StringName p_type,List<PropertyInfo> *p_list,bool p_no_inheritance=false);
 	static bool set_property(Object* p_object,const StringName& p_property, const Variant& p_value);
+	static MethodBind *get_property_setter(const StringName& p_type,const StringName& p_property); ///< only for plain setters, to call directly on objects of exactly p_type
 	static bool get_property(Object* p_object,const StringName& p_property, Variant& r_value);
 
 
@@ -32,6 +32,7 @@
 #include "core/io/marshalls.h"
 #include "io/md5.h"
 #include "core/io/file_access_pack.h"
+#include "core/io/file_io_queue.h"
 
 FileAccess::CreateFunc FileAccess::create_func[ACCESS_MAX]={0,0};
 
@@ -337,6 +338,28 @@ int FileAccess::get_buffer(uint8_t *p_dst,int p_length) const{
 	return i;
 }
 
+bool FileAccess::_async_locked() const {
+
+	return async_pending>0 && Thread::get_caller_ID()!=async_reader;
+}
+
+int FileAccess::read_at(size_t p_offset,uint8_t *p_dst,int p_length) const {
+
+	//not safe next to other users of the file, the I/O queue locks it out while this runs
+	FileAccess *fa = const_cast<FileAccess*>(this);
+	size_t pos = get_pos();
+	fa->seek(p_offset);
+	int read = get_buffer(p_dst,p_length);
+	fa->seek(pos);
+	return read;
+}
+
+int FileAccess::read_async(size_t p_offset,int p_length,uint8_t *p_dst,AsyncCallback p_callback,void *p_userdata) const {
+
+	ERR_FAIL_COND_V(!FileIOQueue::get_singleton(),-1);
+	return FileIOQueue::get_singleton()->read(this,p_offset,p_length,p_dst,p_callback,p_userdata);
+}
+
 void FileAccess::store_16(uint16_t p_dest) {
 	
 	uint8_t a,b;
@@ -464,6 +487,13 @@ void FileAccess::store_buffer(const uint8_t *p_src,int p_length) {
 		store_8(p_src[i]);
 }
 
+void FileAccess::mmap_unref(void *p_mmap) {
+
+	MMap *mmap = (MMap*)p_mmap;
+	if (mmap->refcount.unref())
+		memdelete(mmap);
+}
+
 Vector<uint8_t> FileAccess::get_file_as_array(const String& p_file) {
 
 	FileAccess *f=FileAccess::open(p_file,READ);
@@ -516,4 +546,6 @@ FileAccess::FileAccess() {
 	endian_swap=false;
 	real_is_double=false;
 	_access_type=ACCESS_FILESYSTEM;
+	async_pending=0;
+	async_reader=0;
 };
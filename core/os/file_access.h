@@ -33,6 +33,8 @@
 #include "ustring.h"
 #include "os/memory.h"
 #include "math_defs.h"
+#include "safe_refcount.h"
+#include "os/thread.h"
 /**
  * Multi-Platform abstraction for accessing to files.
  */
@@ -48,6 +50,22 @@ public:
 	};
 
 	typedef FileAccess*(*CreateFunc)();
+	typedef void (*AsyncCallback)(void *p_userdata,int p_request,int p_read);
+
+	/** Copy on write memory mapping of a file. The FileAccess holds a reference,
+	 * ref() it to keep the mapping alive after closing and release with mmap_unref().
+	 */
+	struct MMap {
+
+		SafeRefCount refcount;
+		uint8_t *ptr;
+		size_t size;
+
+		MMap() { refcount.init(); ptr=NULL; size=0; }
+		virtual ~MMap() {}
+	};
+
+	static void mmap_unref(void *p_mmap);
 	bool endian_swap;
 	bool real_is_double;
 protected:
@@ -55,6 +73,7 @@ protected:
 	String fix_path(const String& p_path) const;
 	virtual Error _open(const String& p_path, int p_mode_flags)=0; ///< open a file
 	virtual uint64_t _get_modified_time(const String& p_file)=0;
+	bool _async_locked() const; ///< another thread owns the file position, backends whose read_at() moves it fail on this
 
 
 private:
@@ -62,6 +81,10 @@ private:
 	static bool backup_save;
 
 	AccessType _access_type;
+friend class FileIOQueue;
+	mutable int async_pending; //serialized read_async() requests not finished yet
+	mutable volatile Thread::ID async_reader; //I/O thread inside read_at() for one of them
+
 	static CreateFunc create_func[ACCESS_MAX]; /** default file access creation function for a platform */
 	template<class T>
 	static FileAccess* _create_builtin() {
@@ -100,6 +123,14 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst,int p_length) const; ///< get an array of bytes
+	virtual MMap *get_mmap() { return NULL; } ///< map the whole file, NULL if unsupported
+	virtual int read_at(size_t p_offset,uint8_t *p_dst,int p_length) const; ///< read at an offset, the file position is kept
+	virtual bool is_read_at_concurrent() const { return false; } ///< read_at() can run on other threads while the file is used
+	/** read_at() on an I/O thread, see FileIOQueue. Unless is_read_at_concurrent(), read_at() moves
+	 * the file position while it runs, so the file must not be used until the request is finished.
+	 */
+	int read_async(size_t p_offset,int p_length,uint8_t *p_dst,AsyncCallback p_callback=NULL,void *p_userdata=NULL) const;
+	bool is_async_pending() const { return async_pending>0; } ///< read_async() requests still using the file position
 	virtual String get_line() const;
 	virtual Vector<String> get_csv_line() const;
 	
@@ -91,6 +91,15 @@ MID Memory::alloc_dynamic(size_t p_bytes, const char *p_descr) {
 	
 	return MID(id);
 }
+MID Memory::alloc_dynamic_external(void *p_mem,size_t p_bytes,void (*p_release)(void*),void *p_release_ud,const char *p_descr) {
+
+	MemoryPoolDynamic::ID id = MemoryPoolDynamic::get_singleton()->alloc_external(p_mem,p_bytes,p_release,p_release_ud,p_descr);
+	if (id==MemoryPoolDynamic::INVALID_ID)
+		return MID(); // not supported by this pool
+
+	return MID(id);
+}
+
 Error Memory::realloc_dynamic(MID p_mid,size_t p_bytes) {
 
 	MemoryPoolDynamic::ID id = p_mid.data?p_mid.data->id:MemoryPoolDynamic::INVALID_ID;
@@ -184,6 +184,7 @@ public:
 	static void dump_static_mem_to_file(const char* p_file);
 
 	static MID alloc_dynamic(size_t p_bytes, const char *p_descr="");
+	static MID alloc_dynamic_external(void *p_mem,size_t p_bytes,void (*p_release)(void*),void *p_release_ud,const char *p_descr="");
 	static Error realloc_dynamic(MID p_mid,size_t p_bytes);
     
 	static size_t get_dynamic_mem_available();
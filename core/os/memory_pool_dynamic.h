@@ -50,6 +50,7 @@ friend class MID;
 
 
 	virtual ID alloc(size_t p_amount,const char* p_description)=0;
+	virtual ID alloc_external(void *p_mem,size_t p_amount,void (*p_release)(void*),void *p_release_ud,const char* p_description) { return INVALID_ID; }
 	virtual void free(ID p_id)=0;
 	virtual Error realloc(ID p_id, size_t p_amount)=0;
 	virtual bool is_valid(ID p_id)=0;
@@ -32,6 +32,7 @@
 #include "ustring.h"
 #include "print_string.h"
 #include <stdio.h>
+#include <string.h>
 
 MemoryPoolDynamicStatic::Chunk *MemoryPoolDynamicStatic::get_chunk(ID p_id) {
 
@@ -56,12 +57,8 @@ const MemoryPoolDynamicStatic::Chunk *MemoryPoolDynamicStatic::get_chunk(ID p_id
 	return &chunk[idx];
 }
 
-MemoryPoolDynamic::ID MemoryPoolDynamicStatic::alloc(size_t p_amount,const char* p_description) {
+int MemoryPoolDynamicStatic::find_free_chunk() {
 
-	_THREAD_SAFE_METHOD_
-	
-	int idx=-1;
-	
 	for (int i=0;i<MAX_CHUNKS;i++) {
 	
 		last_alloc++;
@@ -70,11 +67,18 @@ MemoryPoolDynamic::ID MemoryPoolDynamicStatic::alloc(size_t p_amount,const char*
 			
 		if ( !chunk[last_alloc].mem ) {
 		
-			idx=last_alloc;
-			break;
+			return last_alloc;
 		}
 	}
+
+	return -1;
+}
+
+MemoryPoolDynamic::ID MemoryPoolDynamicStatic::alloc(size_t p_amount,const char* p_description) {
+
+	_THREAD_SAFE_METHOD_
 	
+	int idx=find_free_chunk();
 
 	if (idx==-1) {
 		ERR_EXPLAIN("Out of dynamic Memory IDs");
@@ -101,6 +105,31 @@ MemoryPoolDynamic::ID MemoryPoolDynamicStatic::alloc(size_t p_amount,const char*
 	return id;
 	
 }
+
+MemoryPoolDynamic::ID MemoryPoolDynamicStatic::alloc_external(void *p_mem,size_t p_amount,void (*p_release)(void*),void *p_release_ud,const char* p_description) {
+
+	_THREAD_SAFE_METHOD_
+
+	ERR_FAIL_COND_V(!p_mem || !p_release,INVALID_ID);
+
+	int idx=find_free_chunk();
+
+	if (idx==-1) {
+		ERR_EXPLAIN("Out of dynamic Memory IDs");
+		ERR_FAIL_V(INVALID_ID);
+	}
+
+	// not counted in total_usage, the memory belongs to someone else
+	chunk[idx].mem=p_mem;
+	chunk[idx].size=p_amount;
+	chunk[idx].check=++last_check;
+	chunk[idx].descr=p_description;
+	chunk[idx].lock=0;
+	chunk[idx].release=p_release;
+	chunk[idx].release_ud=p_release_ud;
+
+	return chunk[idx].check*MAX_CHUNKS + (uint64_t)idx;
+}
 void MemoryPoolDynamicStatic::free(ID p_id) {
 
 	_THREAD_SAFE_METHOD_
@@ -109,8 +138,16 @@ void MemoryPoolDynamicStatic::free(ID p_id) {
 	ERR_FAIL_COND(!c);
 	
 	
-	total_usage-=c->size;
-	memfree(c->mem);
+	if (c->release) {
+
+		c->release(c->release_ud);
+		c->release=NULL;
+		c->release_ud=NULL;
+	} else {
+
+		total_usage-=c->size;
+		memfree(c->mem);
+	}
 
 	c->mem=0;
 	
@@ -128,7 +165,23 @@ Error MemoryPoolDynamicStatic::realloc(ID p_id, size_t p_amount) {
 	ERR_FAIL_COND_V(!c,ERR_INVALID_PARAMETER);
 	ERR_FAIL_COND_V(c->lock > 0 , ERR_LOCKED );
 	
-	
+	if (c->release) {
+
+		// external memory can't be resized, move it to the heap
+		void * new_mem = memalloc(p_amount);
+		ERR_FAIL_COND_V(!new_mem,ERR_OUT_OF_MEMORY);
+		memcpy(new_mem,c->mem,MIN(c->size,p_amount));
+		c->release(c->release_ud);
+		c->release=NULL;
+		c->release_ud=NULL;
+		c->mem=new_mem;
+		c->size=p_amount;
+		total_usage+=c->size;
+		if (total_usage>max_usage)
+			max_usage=total_usage;
+		return OK;
+	}
+
 	void * new_mem = memrealloc(c->mem,p_amount);
 	
 	ERR_FAIL_COND_V(!new_mem,ERR_OUT_OF_MEMORY);
@@ -49,8 +49,10 @@ class MemoryPoolDynamicStatic : public MemoryPoolDynamic {
 		void *mem;
 		size_t size;
 		const char *descr;	
+		void (*release)(void*); // set for external memory
+		void *release_ud;
 		
-		Chunk() { mem=NULL; lock=0; check=0; }
+		Chunk() { mem=NULL; lock=0; check=0; release=NULL; release_ud=NULL; }
 	};
 	
 	Chunk chunk[MAX_CHUNKS];
@@ -61,9 +63,11 @@ class MemoryPoolDynamicStatic : public MemoryPoolDynamic {
 
 	Chunk *get_chunk(ID p_id);
 	const Chunk *get_chunk(ID p_id) const;
+	int find_free_chunk();
 public:
 		
 	virtual ID alloc(size_t p_amount,const char* p_description);
+	virtual ID alloc_external(void *p_mem,size_t p_amount,void (*p_release)(void*),void *p_release_ud,const char* p_description);
 	virtual void free(ID p_id);
 	virtual Error realloc(ID p_id, size_t p_amount);
 	virtual bool is_valid(ID p_id);
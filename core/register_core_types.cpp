@@ -50,6 +50,7 @@
 #include "io/http_client.h"
 #include "packed_data_container.h"
 #include "func_ref.h"
+#include "io/file_io_queue.h"
 
 #ifdef XML_ENABLED
 static ResourceFormatSaverXML *resource_saver_xml=NULL;
@@ -74,6 +75,7 @@ static _Marshalls *_marshalls = NULL;
 static TranslationLoaderPO *resource_format_po=NULL;
 
 static IP* ip = NULL;
+static FileIOQueue *file_io_queue = NULL;
 
 static _Geometry *_geometry=NULL;
 
@@ -167,6 +169,8 @@ void register_core_types() {
 
 	ip = IP::create();
 
+	file_io_queue = memnew( FileIOQueue );
+
 
 	_geometry = memnew(_Geometry);
 
@@ -233,6 +237,8 @@ void unregister_core_types() {
 	if (ip)
 		memdelete(ip);
 
+	memdelete( file_io_queue );
+
 	unregister_variant_methods();
 
 	CoreStringNames::free();
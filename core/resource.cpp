@@ -161,19 +161,23 @@ void Resource::set_path(const String& p_path) {
 
 	if (path_cache==p_path)
 		return;
-		
-	if (path_cache!="") {
-		
-		ResourceCache::resources.erase(path_cache);
-	}
 
-	path_cache="";
-	ERR_FAIL_COND( ResourceCache::resources.has( p_path ) );
-	path_cache=p_path;
-	
-	if (path_cache!="") {
-		
-		ResourceCache::resources[path_cache]=this;;
+	{
+		GLOBAL_LOCK_FUNCTION //resources may be loaded from several threads
+
+		if (path_cache!="") {
+
+			ResourceCache::resources.erase(path_cache);
+		}
+
+		path_cache="";
+		ERR_FAIL_COND( ResourceCache::resources.has( p_path ) );
+		path_cache=p_path;
+
+		if (path_cache!="") {
+
+			ResourceCache::resources[path_cache]=this;;
+		}
 	}
 
 	_change_notify("resource/path");
@@ -310,8 +314,10 @@ Resource::Resource() {
 
 Resource::~Resource() {
 	
-	if (path_cache!="")
+	if (path_cache!="") {
+		GLOBAL_LOCK_FUNCTION
 		ResourceCache::resources.erase(path_cache);
+	}
 	if (owners.size()) {
 		WARN_PRINT("Resource is still owned");
 	}
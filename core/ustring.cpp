@@ -1818,13 +1818,13 @@ static double built_in_strtod(const C *string,         /* A decimal ASCII floati
 #define READING_EXP 3
 #define READING_DONE 4
 
-double String::to_double(const char* p_str)  {
+double String::to_double(const char* p_str, const char **r_end)  {
 
 #ifndef NO_USE_STDLIB
-	return built_in_strtod<char>(p_str);
+	return built_in_strtod<char>(p_str,(char**)r_end);
 	//return atof(p_str); DOES NOT WORK ON ANDROID(??)
 #else
-	return built_in_strtod<char>(p_str);
+	return built_in_strtod<char>(p_str,(char**)r_end);
 #endif
 #if 0
 #if 0
@@ -2897,6 +2897,40 @@ Transform RasterizerGLES2::skeleton_bone_get_transform(RID p_skeleton,int p_bone
 	t.origin[2]=b.mtx[3][2];
 
 	return t;
+}
+
+void RasterizerGLES2::skeleton_set_bone_transforms(RID p_skeleton,const float *p_transforms,int p_count) {
+
+	Skeleton *skeleton = skeleton_owner.get( p_skeleton );
+	ERR_FAIL_COND(!skeleton);
+	ERR_FAIL_COND( p_count<0 || p_count>skeleton->bones.size() );
+
+	Skeleton::Bone *bones = skeleton->bones.ptr();
+
+	for(int i=0;i<p_count;i++) {
+
+		const float *m=&p_transforms[i*12];
+		Skeleton::Bone &b=bones[i];
+
+		b.mtx[0][0]=m[0];
+		b.mtx[1][0]=m[1];
+		b.mtx[2][0]=m[2];
+		b.mtx[3][0]=m[3];
+		b.mtx[0][1]=m[4];
+		b.mtx[1][1]=m[5];
+		b.mtx[2][1]=m[6];
+		b.mtx[3][1]=m[7];
+		b.mtx[0][2]=m[8];
+		b.mtx[1][2]=m[9];
+		b.mtx[2][2]=m[10];
+		b.mtx[3][2]=m[11];
+	}
+
+	if (skeleton->tex_id) {
+		if (!skeleton->dirty_list.in_list()) {
+			_skeleton_dirty_list.add(&skeleton->dirty_list);
+		}
+	}
 
 }
 
@@ -1269,6 +1269,7 @@ public:
 	virtual int skeleton_get_bone_count(RID p_skeleton) const;
 	virtual void skeleton_bone_set_transform(RID p_skeleton,int p_bone, const Transform& p_transform);
 	virtual Transform skeleton_bone_get_transform(RID p_skeleton,int p_bone);
+	virtual void skeleton_set_bone_transforms(RID p_skeleton,const float *p_transforms,int p_count);
 
 
 	/* LIGHT API */
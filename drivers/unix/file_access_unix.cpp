@@ -32,6 +32,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <string.h>
 #include "print_string.h"
 #include "core/os/os.h"
 
@@ -39,6 +40,17 @@
 #include <sys/statvfs.h>
 #endif
 
+#ifdef UNIX_ENABLED
+#include <sys/mman.h>
+#include <unistd.h>
+#include <errno.h>
+
+struct MMapUnix : public FileAccess::MMap {
+
+	~MMapUnix() { munmap(ptr,size); }
+};
+#endif
+
 #ifdef MSVC
  #define S_ISREG(m) ((m)&_S_IFREG)
 #endif
@@ -59,6 +71,10 @@ void FileAccessUnix::check_errors() const {
 
 Error FileAccessUnix::_open(const String& p_path, int p_mode_flags) {
 
+	if (mmap_data) {
+		mmap_unref(mmap_data);
+		mmap_data=NULL;
+	}
 	if (f)
 		fclose(f);
 	f=NULL;
@@ -112,6 +128,11 @@ void FileAccessUnix::close() {
 
 	if (!f)
 		return;
+	ERR_FAIL_COND(_async_locked());
+	if (mmap_data) {
+		mmap_unref(mmap_data);
+		mmap_data=NULL;
+	}
 	fclose(f);
 	f = NULL;
 	if (save_path!="") {
@@ -132,19 +153,32 @@ bool FileAccessUnix::is_open() const{
 void FileAccessUnix::seek(size_t p_position) {
 
 	ERR_FAIL_COND(!f);
+	ERR_FAIL_COND(_async_locked());
 
 	last_error=OK;
+	if (mmap_data) {
+		mmap_pos=p_position;
+		return;
+	}
 	if ( fseek(f,p_position,SEEK_SET) )
 		check_errors();
 }
 void FileAccessUnix::seek_end(int64_t p_position)  {
 
 	ERR_FAIL_COND(!f);
+	ERR_FAIL_COND(_async_locked());
+	if (mmap_data) {
+		last_error=OK;
+		mmap_pos=mmap_data->size+p_position;
+		return;
+	}
 	if ( fseek(f,p_position,SEEK_END) )
 		check_errors();
 }
 size_t FileAccessUnix::get_pos() const{
 
+	if (mmap_data)
+		return mmap_pos;
 
 	size_t aux_position=0;
 	if ( !(aux_position = ftell(f)) ) {
@@ -157,6 +191,9 @@ size_t FileAccessUnix::get_len() const{
 
 	ERR_FAIL_COND_V(!f,0);
 
+	if (mmap_data)
+		return mmap_data->size;
+
 	FileAccessUnix *fau = const_cast<FileAccessUnix*>(this);
 	int pos = fau->get_pos();
 	fau->seek_end();
@@ -174,6 +211,17 @@ bool FileAccessUnix::eof_reached() const{
 uint8_t FileAccessUnix::get_8() const{
 
 	ERR_FAIL_COND_V(!f,0);
+	ERR_FAIL_COND_V(_async_locked(),0);
+
+	if (mmap_data) {
+
+		if (mmap_pos>=mmap_data->size) {
+			last_error=ERR_FILE_EOF;
+			return 0;
+		}
+		return mmap_data->ptr[mmap_pos++];
+	}
+
 	uint8_t b;
 	if (fread(&b,1,1,f) == 0) {
 		check_errors();
@@ -185,11 +233,97 @@ uint8_t FileAccessUnix::get_8() const{
 int FileAccessUnix::get_buffer(uint8_t *p_dst, int p_length) const {
 
 	ERR_FAIL_COND_V(!f,-1);
+	ERR_FAIL_COND_V(_async_locked(),-1);
+
+	if (mmap_data) {
+
+		int read = mmap_pos<mmap_data->size ? MIN(p_length,int(mmap_data->size-mmap_pos)) : 0;
+		memcpy(p_dst,mmap_data->ptr+mmap_pos,read);
+		mmap_pos+=read;
+		if (read<p_length)
+			last_error=ERR_FILE_EOF;
+		return read;
+	}
+
 	int read = fread(p_dst, 1, p_length, f);
 	check_errors();
 	return read;
 };
 
+int FileAccessUnix::read_at(size_t p_offset,uint8_t *p_dst,int p_length) const {
+
+	ERR_FAIL_COND_V(!f,-1);
+
+	if (mmap_data) {
+
+		int read = p_offset<mmap_data->size ? MIN(p_length,int(mmap_data->size-p_offset)) : 0;
+		memcpy(p_dst,mmap_data->ptr+p_offset,read);
+		return read;
+	}
+
+#ifdef UNIX_ENABLED
+	if (flags==READ) {
+
+		//pread() leaves the stream position alone, so it can run next to fread()
+		int fd = fileno(f);
+		int total=0;
+		while(total<p_length) {
+
+			ssize_t r = pread(fd,p_dst+total,p_length-total,p_offset+total);
+			if (r<0 && errno==EINTR)
+				continue;
+			if (r<=0)
+				break;
+			total+=r;
+		}
+		return total;
+	}
+#endif
+
+	return FileAccess::read_at(p_offset,p_dst,p_length);
+}
+
+bool FileAccessUnix::is_read_at_concurrent() const {
+
+#ifdef UNIX_ENABLED
+	return f && flags==READ;
+#else
+	return mmap_data!=NULL;
+#endif
+}
+
+FileAccess::MMap *FileAccessUnix::get_mmap() {
+
+	ERR_FAIL_COND_V(!f,NULL);
+
+#ifdef UNIX_ENABLED
+	if (mmap_data)
+		return mmap_data;
+
+	if (flags!=READ)
+		return NULL;
+
+	size_t pos = get_pos();
+	size_t len = get_len();
+	if (len==0)
+		return NULL;
+
+	// private mapping, writing to it never reaches the file
+	void *ptr = mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE,fileno(f),0);
+	if (ptr==MAP_FAILED)
+		return NULL;
+
+	mmap_data = memnew( MMapUnix );
+	mmap_data->ptr=(uint8_t*)ptr;
+	mmap_data->size=len;
+	mmap_pos=pos;
+
+	return mmap_data;
+#else
+	return NULL;
+#endif
+}
+
 Error FileAccessUnix::get_error() const{
 
 	return last_error;
@@ -198,10 +332,18 @@ Error FileAccessUnix::get_error() const{
 void FileAccessUnix::store_8(uint8_t p_dest) {
 
 	ERR_FAIL_COND(!f);
+	ERR_FAIL_COND(_async_locked());
 	fwrite(&p_dest,1,1,f);
 
 }
 
+void FileAccessUnix::store_buffer(const uint8_t *p_src,int p_length) {
+
+	ERR_FAIL_COND(!f);
+	ERR_FAIL_COND(_async_locked());
+	fwrite(p_src,1,p_length,f);
+}
+
 
 bool FileAccessUnix::file_exists(const String &p_path) {
 
@@ -245,6 +387,8 @@ FileAccessUnix::FileAccessUnix() {
 
 	f=NULL;
 	flags=0;
+	mmap_data=NULL;
+	mmap_pos=0;
 	last_error=OK;
 
 }
@@ -42,6 +42,8 @@ class FileAccessUnix : public FileAccess {
 	
 	FILE *f;
 	int flags;
+	MMap *mmap_data; // once mapped, reads come from memory
+	mutable size_t mmap_pos;
 	void check_errors() const;
 	mutable Error last_error;
 	String save_path;
@@ -62,10 +64,14 @@ public:
 
 	virtual uint8_t get_8() const; ///< get a byte 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual MMap *get_mmap();
+	virtual int read_at(size_t p_offset,uint8_t *p_dst,int p_length) const;
+	virtual bool is_read_at_concurrent() const;
 
 	virtual Error get_error() const; ///< get last error 
 
 	virtual void store_8(uint8_t p_dest); ///< store a byte 
+	virtual void store_buffer(const uint8_t *p_src,int p_length); ///< store an array of bytes
 	
 	virtual bool file_exists(const String& p_path); ///< return true if a file exists 
 
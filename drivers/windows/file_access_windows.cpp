@@ -104,6 +104,7 @@ void FileAccessWindows::close() {
 
 	if (!f)
 		return;
+	ERR_FAIL_COND(_async_locked());
 
 	fclose(f);
 	f = NULL;
@@ -127,6 +128,7 @@ bool FileAccessWindows::is_open() const {
 void FileAccessWindows::seek(size_t p_position) {
 
 	ERR_FAIL_COND(!f);
+	ERR_FAIL_COND(_async_locked());
 	last_error=OK;
 	if ( fseek(f,p_position,SEEK_SET) )
 		check_errors();
@@ -134,6 +136,7 @@ void FileAccessWindows::seek(size_t p_position) {
 void FileAccessWindows::seek_end(int64_t p_position) {
 
 	ERR_FAIL_COND(!f);
+	ERR_FAIL_COND(_async_locked());
 	if ( fseek(f,p_position,SEEK_END) )
 		check_errors();
 }
@@ -168,6 +171,7 @@ bool FileAccessWindows::eof_reached() const {
 uint8_t FileAccessWindows::get_8() const {
 
 	ERR_FAIL_COND_V(!f,0);
+	ERR_FAIL_COND_V(_async_locked(),0);
 	uint8_t b;
 	if (fread(&b,1,1,f) == 0) {
 		check_errors();
@@ -179,6 +183,7 @@ uint8_t FileAccessWindows::get_8() const {
 int FileAccessWindows::get_buffer(uint8_t *p_dst, int p_length) const {
 
 	ERR_FAIL_COND_V(!f,-1);
+	ERR_FAIL_COND_V(_async_locked(),-1);
 	int read = fread(p_dst, 1,p_length, f);
 	check_errors();
 	return read;
@@ -193,6 +198,7 @@ Error FileAccessWindows::get_error() const {
 void FileAccessWindows::store_8(uint8_t p_dest) {
 
 	ERR_FAIL_COND(!f);
+	ERR_FAIL_COND(_async_locked());
 	fwrite(&p_dest,1,1,f);
 
 }
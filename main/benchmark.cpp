@@ -0,0 +1,479 @@
+/*************************************************************************/
+/*  benchmark.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "benchmark.h"
+
+#include "os/os.h"
+#include "os/file_access.h"
+#include "os/dir_access.h"
+#include "io/json.h"
+#include "io/resource_loader.h"
+#include "io/resource_saver.h"
+#include "script_language.h"
+#include "print_string.h"
+#include "version.h"
+#include "scene/main/viewport.h"
+#include "scene/3d/skeleton.h"
+#include "scene/3d/physics_body.h"
+#include "scene/resources/box_shape.h"
+#include "scene/animation/animation_player.h"
+
+// sizes are fixed so results stay comparable between runs and versions
+enum {
+	SPAWN_NODES=100,
+	SIGNAL_EMITTERS=100,
+	SIGNAL_RECEIVERS=20,
+	SIGNAL_EMITS=10,
+	PILE_SIDE=7,
+	PILE_LAYERS=6,
+	CROWD_CHARACTERS=100,
+	CROWD_BONES=40,
+	SCRIPT_NODES=50,
+	RESOURCE_TRACKS=30,
+	RESOURCE_LOADS=2
+};
+
+static const char *script_loop_source=
+"extends Node\n"
+"\n"
+"var total=0\n"
+"\n"
+"func _ready():\n"
+"\tset_process(true)\n"
+"\n"
+"func _process(delta):\n"
+"\tvar acc=0\n"
+"\tfor i in range(1000):\n"
+"\t\tacc+=i*2-1\n"
+"\ttotal+=acc\n";
+
+class BenchmarkReceiver : public Node {
+
+	OBJ_TYPE( BenchmarkReceiver, Node );
+
+	int received;
+protected:
+
+	static void _bind_methods() {
+
+		ObjectTypeDB::bind_method(_MD("_pulse","value"),&BenchmarkReceiver::_pulse);
+	}
+public:
+
+	void _pulse(int p_value) { received+=p_value; }
+
+	BenchmarkReceiver() { received=0; }
+};
+
+
+const char *Benchmark::scenario_names[SCENARIO_MAX]={
+	"node_spawn",
+	"signal_storm",
+	"physics_pile",
+	"animation_crowd",
+	"gdscript_loop",
+	"resource_load"
+};
+
+bool Benchmark::get_scenario(const String& p_name,Scenario *r_scenario) {
+
+	for(int i=0;i<SCENARIO_MAX;i++) {
+
+		if (p_name==scenario_names[i]) {
+			*r_scenario=Scenario(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+String Benchmark::get_scenario_name(Scenario p_scenario) {
+
+	ERR_FAIL_INDEX_V(p_scenario,SCENARIO_MAX,String());
+	return scenario_names[p_scenario];
+}
+
+void Benchmark::set_scenarios(const Vector<Scenario>& p_scenarios) {
+
+	scenarios=p_scenarios;
+}
+
+void Benchmark::set_frames(int p_frames) {
+
+	ERR_FAIL_COND(p_frames<1);
+	frames=p_frames;
+}
+
+void Benchmark::set_output(const String& p_path) {
+
+	output=p_path;
+}
+
+static Ref<Animation> _make_animation(int p_tracks,const String& p_path) {
+
+	Ref<Animation> anim = memnew( Animation );
+	anim->set_length(4);
+	anim->set_loop(true);
+
+	for(int i=0;i<p_tracks;i++) {
+
+		int t = anim->add_track(Animation::TYPE_TRANSFORM);
+		anim->track_set_path(t,p_path+itos(i));
+		Vector3 axis = Vector3(Math::sin(i*0.7),Math::cos(i*1.3),0.5).normalized();
+
+		for(int j=0;j<=120;j++) {
+
+			float time = j/30.0;
+			anim->transform_track_insert_key(t,time,Vector3(0,0.1,0),Quat(axis,0.8*Math::sin(time*(1+i%4)+i)),Vector3(1,1,1));
+		}
+	}
+
+	return anim;
+}
+
+void Benchmark::_setup(Scenario p_scenario) {
+
+	container = memnew( Node );
+	container->set_name(scenario_names[p_scenario]);
+	get_root()->add_child(container);
+
+	switch(p_scenario) {
+
+		case SCENARIO_NODE_SPAWN: {
+
+			//nodes are created in _step
+		} break;
+		case SCENARIO_SIGNAL_STORM: {
+
+			Vector<Node*> receivers;
+			for(int i=0;i<SIGNAL_RECEIVERS;i++) {
+
+				Node *r = memnew( BenchmarkReceiver );
+				container->add_child(r);
+				receivers.push_back(r);
+			}
+
+			for(int i=0;i<SIGNAL_EMITTERS;i++) {
+
+				Node *e = memnew( Node );
+				e->add_user_signal(MethodInfo("pulse",PropertyInfo(Variant::INT,"value")));
+				for(int j=0;j<receivers.size();j++)
+					e->connect("pulse",receivers[j],"_pulse");
+				container->add_child(e);
+				emitters.push_back(e);
+			}
+		} break;
+		case SCENARIO_PHYSICS_PILE: {
+
+			Ref<BoxShape> floor_shape = memnew( BoxShape );
+			floor_shape->set_extents(Vector3(50,1,50));
+
+			StaticBody *floor = memnew( StaticBody );
+			floor->add_shape(floor_shape);
+			floor->set_transform(Transform(Matrix3(),Vector3(0,-1,0)));
+			container->add_child(floor);
+
+			Ref<BoxShape> box_shape = memnew( BoxShape );
+			box_shape->set_extents(Vector3(0.5,0.5,0.5));
+
+			for(int y=0;y<PILE_LAYERS;y++) {
+				for(int x=0;x<PILE_SIDE;x++) {
+					for(int z=0;z<PILE_SIDE;z++) {
+
+						RigidBody *box = memnew( RigidBody );
+						box->add_shape(box_shape);
+						//every layer is a bit shifted, so the pile collapses instead of staying still
+						float shift = (y%2)*0.4;
+						box->set_transform(Transform(Matrix3(),Vector3(x*1.1+shift,0.6+y*1.2,z*1.1+shift)));
+						container->add_child(box);
+					}
+				}
+			}
+		} break;
+		case SCENARIO_ANIMATION_CROWD: {
+
+			animation = _make_animation(CROWD_BONES,"Skeleton:bone");
+
+			for(int i=0;i<CROWD_CHARACTERS;i++) {
+
+				Node *character = memnew( Node );
+
+				Skeleton *skeleton = memnew( Skeleton );
+				skeleton->set_name("Skeleton");
+				for(int j=0;j<CROWD_BONES;j++) {
+					skeleton->add_bone("bone"+itos(j));
+					skeleton->set_bone_parent(j,j-1);
+				}
+				character->add_child(skeleton);
+
+				AnimationPlayer *player = memnew( AnimationPlayer );
+				player->add_animation("walk",animation);
+				character->add_child(player);
+
+				container->add_child(character);
+				player->play("walk");
+				player->seek(float(i%16)/16.0*animation->get_length());
+			}
+		} break;
+		case SCENARIO_SCRIPT_LOOP: {
+
+			ScriptLanguage *language=NULL;
+			for(int i=0;i<ScriptServer::get_language_count();i++) {
+
+				if (ScriptServer::get_language(i)->get_name()=="GDScript")
+					language=ScriptServer::get_language(i);
+			}
+
+			if (!language) {
+				error="GDScript is not available";
+				break;
+			}
+
+			Ref<Script> script = language->create_script();
+			script->set_source_code(script_loop_source);
+			if (script->reload()!=OK) {
+				error="Benchmark script failed to compile";
+				break;
+			}
+
+			for(int i=0;i<SCRIPT_NODES;i++) {
+
+				Node *n = memnew( Node );
+				n->set_script(script.get_ref_ptr());
+				container->add_child(n);
+			}
+		} break;
+		case SCENARIO_RESOURCE_LOAD: {
+
+			resource_path="user://benchmark_resource.xml";
+			Error err = ResourceSaver::save(resource_path,_make_animation(RESOURCE_TRACKS,"Node:track"));
+			if (err!=OK) {
+				error="Can't save "+resource_path;
+				resource_path="";
+			}
+		} break;
+		default: {}
+	}
+}
+
+void Benchmark::_step(Scenario p_scenario) {
+
+	switch(p_scenario) {
+
+		case SCENARIO_NODE_SPAWN: {
+
+			//a batch of small subtrees enters the scene every frame, the previous one is freed
+			if (spawned)
+				memdelete(spawned);
+
+			spawned = memnew( Node );
+			for(int i=0;i<SPAWN_NODES;i++) {
+
+				Spatial *s = memnew( Spatial );
+				s->set_name("spawn"+itos(i));
+				s->add_child(memnew( Spatial ));
+				s->add_child(memnew( Node ));
+				spawned->add_child(s);
+			}
+			container->add_child(spawned);
+		} break;
+		case SCENARIO_SIGNAL_STORM: {
+
+			for(int i=0;i<SIGNAL_EMITS;i++) {
+				for(int j=0;j<emitters.size();j++)
+					emitters[j]->emit_signal("pulse",1);
+			}
+		} break;
+		case SCENARIO_RESOURCE_LOAD: {
+
+			for(int i=0;i<RESOURCE_LOADS;i++) {
+
+				RES res = ResourceLoader::load(resource_path,"",true);
+				if (res.is_null()) {
+					error="Can't load "+resource_path;
+					break;
+				}
+			}
+		} break;
+		default: {} //the scene processes the rest on its own
+	}
+}
+
+void Benchmark::_teardown() {
+
+	if (container) {
+		memdelete(container);
+		container=NULL;
+	}
+
+	spawned=NULL;
+	emitters.clear();
+	animation=Ref<Animation>();
+
+	if (resource_path!="") {
+
+		DirAccess *da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+		if (da) {
+			da->remove(resource_path);
+			memdelete(da);
+		}
+		resource_path="";
+	}
+
+	error="";
+	frame=0;
+	frame_usec.clear();
+}
+
+static uint64_t _percentile(const Vector<uint64_t>& p_sorted,int p_percent) {
+
+	//nearest rank
+	int idx = (p_sorted.size()*p_percent+99)/100-1;
+	return p_sorted[CLAMP(idx,0,p_sorted.size()-1)];
+}
+
+void Benchmark::_store_result(Scenario p_scenario) {
+
+	Dictionary d;
+	d["name"]=scenario_names[p_scenario];
+
+	if (error!="") {
+
+		d["error"]=error;
+		results.push_back(d);
+		return;
+	}
+
+	Vector<uint64_t> sorted=frame_usec;
+	sorted.sort();
+
+	uint64_t total=0;
+	for(int i=0;i<sorted.size();i++)
+		total+=sorted[i];
+
+	d["frames"]=sorted.size();
+	d["mean_usec"]=double(total)/sorted.size();
+	d["min_usec"]=int(sorted[0]);
+	d["p50_usec"]=int(_percentile(sorted,50));
+	d["p90_usec"]=int(_percentile(sorted,90));
+	d["p99_usec"]=int(_percentile(sorted,99));
+	d["max_usec"]=int(sorted[sorted.size()-1]);
+	results.push_back(d);
+
+	//without -benchmark_out, stdout only carries the json results
+	if (output!="")
+		print_line(String("benchmark: ")+scenario_names[p_scenario]+" p50 "+itos(_percentile(sorted,50))+" usec");
+}
+
+void Benchmark::_write_results() {
+
+	Dictionary d;
+	d["engine"]=VERSION_FULL_NAME;
+	d["step"]=1.0/OS::get_singleton()->get_iterations_per_second();
+	d["warmup_frames"]=WARMUP_FRAMES;
+	d["scenarios"]=results;
+
+	String json = JSON::print(d);
+
+	if (output=="") {
+		OS::get_singleton()->print("%s\n",json.utf8().get_data());
+		return;
+	}
+
+	FileAccess *f = FileAccess::open(output,FileAccess::WRITE);
+	ERR_EXPLAIN("Can't write benchmark results to "+output);
+	ERR_FAIL_COND(!f);
+	f->store_string(json);
+	f->store_8('\n');
+	memdelete(f);
+}
+
+void Benchmark::init() {
+
+	SceneMainLoop::init();
+
+	if (scenarios.empty()) {
+		for(int i=0;i<SCENARIO_MAX;i++)
+			scenarios.push_back(Scenario(i));
+	}
+
+	current=0;
+	frame=0;
+	results.clear();
+	_setup(scenarios[0]);
+	last_ticks=OS::get_singleton()->get_ticks_usec();
+}
+
+bool Benchmark::idle(float p_time) {
+
+	//each sample is the whole frame that just ended, from one idle to the next
+	uint64_t ticks=OS::get_singleton()->get_ticks_usec();
+	if (frame>WARMUP_FRAMES)
+		frame_usec.push_back(ticks-last_ticks);
+	last_ticks=ticks;
+
+	bool quit = SceneMainLoop::idle(p_time);
+
+	if (current<scenarios.size() && (frame==WARMUP_FRAMES+frames || error!="")) {
+
+		_store_result(scenarios[current]);
+		_teardown();
+		current++;
+		if (current<scenarios.size())
+			_setup(scenarios[current]);
+	}
+
+	if (current>=scenarios.size()) {
+
+		_write_results();
+		return true;
+	}
+
+	if (error=="")
+		_step(scenarios[current]);
+	frame++;
+
+	return quit;
+}
+
+void Benchmark::finish() {
+
+	_teardown();
+	SceneMainLoop::finish();
+}
+
+Benchmark::Benchmark() {
+
+	frames=600;
+	current=0;
+	frame=0;
+	last_ticks=0;
+	container=NULL;
+	spawned=NULL;
+}
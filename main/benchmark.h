@@ -0,0 +1,100 @@
+/*************************************************************************/
+/*  benchmark.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "scene/main/scene_main_loop.h"
+#include "scene/resources/animation.h"
+
+/* Runs scripted scenarios for a fixed amount of frames (Main steps them with a fixed timestep) and
+   reports the frame times of each one as JSON, so runs can be compared between versions */
+
+class Benchmark : public SceneMainLoop {
+
+	OBJ_TYPE( Benchmark, SceneMainLoop );
+public:
+
+	enum Scenario {
+		SCENARIO_NODE_SPAWN,
+		SCENARIO_SIGNAL_STORM,
+		SCENARIO_PHYSICS_PILE,
+		SCENARIO_ANIMATION_CROWD,
+		SCENARIO_SCRIPT_LOOP,
+		SCENARIO_RESOURCE_LOAD,
+		SCENARIO_MAX
+	};
+
+private:
+
+	enum {
+		WARMUP_FRAMES=10
+	};
+
+	Vector<Scenario> scenarios;
+	int frames;
+	String output;
+
+	int current;
+	int frame;
+	uint64_t last_ticks;
+	Vector<uint64_t> frame_usec;
+	String error;
+	Array results;
+
+	Node *container;
+	Node *spawned;
+	Vector<Node*> emitters;
+	Ref<Animation> animation;
+	String resource_path;
+
+	static const char *scenario_names[SCENARIO_MAX];
+
+	void _setup(Scenario p_scenario);
+	void _step(Scenario p_scenario);
+	void _teardown();
+	void _store_result(Scenario p_scenario);
+	void _write_results();
+
+public:
+
+	static bool get_scenario(const String& p_name,Scenario *r_scenario);
+	static String get_scenario_name(Scenario p_scenario);
+
+	void set_scenarios(const Vector<Scenario>& p_scenarios);
+	void set_frames(int p_frames);
+	void set_output(const String& p_path); ///< empty prints to stdout
+
+	virtual void init();
+	virtual bool idle(float p_time);
+	virtual void finish();
+
+	Benchmark();
+};
+
+#endif // BENCHMARK_H
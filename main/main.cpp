@@ -76,6 +76,7 @@
 #include "version.h"
 
 #include "performance.h"
+#include "benchmark.h"
 
 static Globals *globals=NULL;
 static InputMap *input_map=NULL;
@@ -89,9 +90,16 @@ static PackedData *packed_data=NULL;
 static FileAccessNetworkClient *file_access_network_client=NULL;
 static TranslationServer *translation_server = NULL;
 
+static void _thread_load_wait() {
+
+	// commands pushed by loader threads are only flushed by the main thread
+	VisualServer::get_singleton()->flush();
+}
+
 static OS::VideoMode video_mode;
 static int video_driver_idx=-1;
 static int audio_driver_idx=-1;
+static bool fixed_frame_step=false; //benchmarks, frames advance by the fixed step no matter how long they take
 static String locale;
 
 static String unescape_cmdline(const String& p_str) {
@@ -128,6 +136,15 @@ void Main::print_help(const char* p_binary) {
 		coma = ", ";
 	}
 	OS::get_singleton()->print(")\n");
+#ifdef SERVER_ENABLED
+	OS::get_singleton()->print("\t-benchmark [scenarios] : Run benchmark scenarios (comma separated, all if omitted) and print the results as JSON.\n");
+	OS::get_singleton()->print("\t\t(");
+	for(int i=0;i<Benchmark::SCENARIO_MAX;i++)
+		OS::get_singleton()->print("%s%s",i?", ":"",Benchmark::get_scenario_name(Benchmark::Scenario(i)).utf8().get_data());
+	OS::get_singleton()->print(")\n");
+	OS::get_singleton()->print("\t-benchmark_frames [frames] : Frames measured per scenario (default 600).\n");
+	OS::get_singleton()->print("\t-benchmark_out [file] : Write the benchmark results to a file instead.\n");
+#endif
 	
 	OS::get_singleton()->print("\t-r WIDTHxHEIGHT\t : Request Screen Resolution\n");
 	OS::get_singleton()->print("\t-f\t\t : Request Fullscreen\n");
@@ -758,6 +775,9 @@ Error Main::setup2() {
 	register_scene_types();
 	register_server_types();
 
+	if (OS::get_singleton()->get_render_thread_mode()==OS::RENDER_THREAD_SAFE)
+		ResourceLoader::set_thread_load_wait_func(_thread_load_wait);
+
 #ifdef TOOLS_ENABLED
 	EditorNode::register_editor_types();
 #endif
@@ -808,6 +828,10 @@ bool Main::start() {
 	bool noquit=false;
 	bool convert_old=false;
 	bool export_debug=false;
+	bool benchmark=false;
+	String benchmark_scenarios;
+	int benchmark_frames=0;
+	String benchmark_out;
 	List<String> args = OS::get_singleton()->get_cmdline_args();
 	for (int i=0;i<args.size();i++) {
 		
@@ -863,6 +887,20 @@ bool Main::start() {
 			editor=true;
 		} else if (args[i]=="-convert_old") {
 			convert_old=true;
+#ifdef SERVER_ENABLED
+		} else if (args[i]=="-benchmark" || args[i]=="--benchmark") {
+			benchmark=true;
+			if (i<(args.size()-1) && !args[i+1].begins_with("-")) {
+				benchmark_scenarios=args[i+1];
+				i++;
+			}
+		} else if (args[i]=="-benchmark_frames" && i <(args.size()-1)) {
+			benchmark_frames=args[i+1].to_int();
+			i++;
+		} else if (args[i]=="-benchmark_out" && i <(args.size()-1)) {
+			benchmark_out=args[i+1];
+			i++;
+#endif
 		} else if (args[i].length() && args[i][0] != '-' && game_path == "") {
 
 			game_path=args[i];
@@ -903,7 +941,7 @@ bool Main::start() {
 
 #endif
 
-	if(script=="" && game_path=="" && !editor && String(GLOBAL_DEF("application/main_scene",""))!="") {
+	if(script=="" && game_path=="" && !editor && !benchmark && String(GLOBAL_DEF("application/main_scene",""))!="") {
 		game_path=GLOBAL_DEF("application/main_scene","");
 	}
 
@@ -922,6 +960,34 @@ bool Main::start() {
 
 #endif
 
+	} else if (benchmark) {
+
+		Benchmark *bench = memnew( Benchmark );
+
+		if (benchmark_scenarios!="") {
+
+			Vector<Benchmark::Scenario> scenarios;
+			Vector<String> names = benchmark_scenarios.split(",");
+			for(int i=0;i<names.size();i++) {
+
+				Benchmark::Scenario s;
+				if (!Benchmark::get_scenario(names[i].strip_edges(),&s)) {
+					memdelete(bench);
+					ERR_EXPLAIN("Unknown benchmark scenario: "+names[i]);
+					ERR_FAIL_V(false);
+				}
+				scenarios.push_back(s);
+			}
+			bench->set_scenarios(scenarios);
+		}
+
+		if (benchmark_frames>0)
+			bench->set_frames(benchmark_frames);
+		bench->set_output(benchmark_out);
+
+		fixed_frame_step=true;
+		main_loop=bench;
+
 	} else if (script!="") {
 
 		Ref<Script> script_res = ResourceLoader::load(script);
@@ -1194,7 +1260,7 @@ bool Main::start() {
 			};
 		}
 */
-		if (script=="" && test=="" && game_path=="" && !editor) {
+		if (script=="" && test=="" && game_path=="" && !editor && !benchmark) {
 
 			ProjectManager *pmanager = memnew( ProjectManager );
 			sml->get_root()->add_child(pmanager);
@@ -1230,10 +1296,18 @@ bool Main::iteration() {
 
 	float frame_slice=1.0/OS::get_singleton()->get_iterations_per_second();
 
-	if (step>frame_slice*8)
-		step=frame_slice*8;
+	if (fixed_frame_step) {
+
+		//exactly one fixed iteration per frame, the extra half keeps rounding from ever skipping it
+		step=frame_slice;
+		time_accum=frame_slice*1.5;
+	} else {
+
+		if (step>frame_slice*8)
+			step=frame_slice*8;
 
-	time_accum+=step;
+		time_accum+=step;
+	}
 
 	bool exit=false;
 
@@ -1334,7 +1408,9 @@ bool Main::iteration() {
 		frames=0;
 	}
 
-	if (OS::get_singleton()->is_in_low_processor_usage_mode() || !OS::get_singleton()->can_draw())
+	if (fixed_frame_step) {
+		//measuring, never wait
+	} else if (OS::get_singleton()->is_in_low_processor_usage_mode() || !OS::get_singleton()->can_draw())
 		OS::get_singleton()->delay_usec(25000); //apply some delay to force idle time
 	else {
 		uint32_t frame_delay = OS::get_singleton()->get_frame_delay();
@@ -1360,6 +1436,8 @@ void Main::cleanup() {
 
 	OS::get_singleton()->delete_main_loop();
 
+	ResourceLoader::finish_threaded_loads();
+
 	OS::get_singleton()->_cmdline.clear();
 	OS::get_singleton()->_execpath="";
 	OS::get_singleton()->_local_clipboard="";
@@ -31,6 +31,7 @@
 #include "servers/visual_server.h"
 #include "message_queue.h"
 #include "scene/main/scene_main_loop.h"
+#include "scene/animation/animation_batch.h"
 Performance *Performance::singleton=NULL;
 
 
@@ -61,6 +62,8 @@ void Performance::_bind_methods() {
 	BIND_CONSTANT( RENDER_VIDEO_MEM_USED );
 	BIND_CONSTANT( RENDER_TEXTURE_MEM_USED );
 	BIND_CONSTANT( RENDER_VERTEX_MEM_USED );
+	BIND_CONSTANT( TIME_ANIMATION_SAMPLE );
+	BIND_CONSTANT( TIME_ANIMATION_APPLY );
 	BIND_CONSTANT( MONITOR_MAX );
 
 }
@@ -90,7 +93,9 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"video/video_mem",
 		"video/texure_mem",
 		"video/vertex_mem",
-		"render/mem_max"
+		"render/mem_max",
+		"time/animation_sample",
+		"time/animation_apply"
 	};
 
 	return names[p_monitor];
@@ -133,6 +138,8 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case RENDER_TEXTURE_MEM_USED: return VS::get_singleton()->get_render_info(VS::INFO_TEXTURE_MEM_USED);
 		case RENDER_VERTEX_MEM_USED: return VS::get_singleton()->get_render_info(VS::INFO_VERTEX_MEM_USED);
 		case RENDER_USAGE_VIDEO_MEM_TOTAL: return VS::get_singleton()->get_render_info(VS::INFO_USAGE_VIDEO_MEM_TOTAL);
+		case TIME_ANIMATION_SAMPLE: return (AnimationBatch::get_sample_usec(AnimationBatch::MODE_IDLE)+AnimationBatch::get_sample_usec(AnimationBatch::MODE_FIXED))/1000000.0;
+		case TIME_ANIMATION_APPLY: return (AnimationBatch::get_apply_usec(AnimationBatch::MODE_IDLE)+AnimationBatch::get_apply_usec(AnimationBatch::MODE_FIXED))/1000000.0;
 		default: {}
 	}
 
@@ -69,6 +69,8 @@ public:
 		RENDER_TEXTURE_MEM_USED,
 		RENDER_VERTEX_MEM_USED,
 		RENDER_USAGE_VIDEO_MEM_TOTAL,
+		TIME_ANIMATION_SAMPLE,
+		TIME_ANIMATION_APPLY,
 		//physics
 		MONITOR_MAX
 	};
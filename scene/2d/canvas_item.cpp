@@ -330,7 +330,7 @@ void CanvasItem::_notification(int p_what) {
 			}
 			_enter_canvas();
 			if (!block_transform_notify && !xform_change.in_list()) {
-				get_scene()->xform_change_list.add(&xform_change);
+				get_scene()->_add_xform_change(&xform_change);
 			}
 		} break;
 		case NOTIFICATION_MOVED_IN_PARENT: {
@@ -632,21 +632,21 @@ void CanvasItem::_notify_transform(CanvasItem *p_node) {
 
 	p_node->global_invalid=true;
 
-	if (!p_node->xform_change.in_list()) {
-		if (!p_node->block_transform_notify) {
-			if (p_node->is_inside_scene())
-				get_scene()->xform_change_list.add(&p_node->xform_change);
-		}
-	}
-
-
-	for(List<CanvasItem*>::Element *E=p_node->children_items.front();E;E=E->next()) {
+	//children walked backwards and the node added last, the change list prepends so it ends up in tree order
+	for(List<CanvasItem*>::Element *E=p_node->children_items.back();E;E=E->prev()) {
 
 		CanvasItem* ci=E->get();
 		if (ci->toplevel)
 			continue;
 		_notify_transform(ci);
 	}
+
+	if (!p_node->xform_change.in_list()) {
+		if (!p_node->block_transform_notify) {
+			if (p_node->is_inside_scene())
+				get_scene()->_add_xform_change(&p_node->xform_change);
+		}
+	}
 }
 
 
@@ -158,10 +158,17 @@ void Skeleton::_notification(int p_what) {
 
 
 			VisualServer *vs=VisualServer::get_singleton();
-			Bone *bonesptr=&bones[0];
+			Bone *bonesptr=bones.ptr();
 			int len=bones.size();
 
-			vs->skeleton_resize( skeleton, len ); // if same size, nothin really happens
+			bool update_all=rest_global_inverse_dirty;
+
+			if (bone_transforms.size()!=len*12) {
+
+				vs->skeleton_resize( skeleton, len );
+				bone_transforms.resize(len*12);
+				update_all=true;
+			}
 
 			// pose changed, rebuild cache of inverses
 			if (rest_global_inverse_dirty) {
@@ -183,9 +190,21 @@ void Skeleton::_notification(int p_what) {
 
 			}
 			
+			update_pass++;
+			float *transforms=bone_transforms.ptr();
+			bool updated=false;
+
 			for (int i=0;i<len;i++) {
 			
 				Bone &b=bonesptr[i];
+
+				// parents always come first, so only bones posed since the last update and whatever hangs from them are recomputed
+				if (!update_all && !b.pose_dirty && (b.parent<0 || bonesptr[b.parent].update_pass!=update_pass))
+					continue;
+
+				b.pose_dirty=false;
+				b.update_pass=update_pass;
+				updated=true;
 		
 				if (b.enabled) {
 
@@ -213,7 +232,21 @@ void Skeleton::_notification(int p_what) {
 					}				
 				}
 				
-				vs->skeleton_bone_set_transform( skeleton, i,  b.pose_global * b.rest_global_inverse );
+				Transform xform = b.pose_global * b.rest_global_inverse;
+
+				float *m=&transforms[i*12];
+				m[0]=xform.basis[0][0];
+				m[1]=xform.basis[0][1];
+				m[2]=xform.basis[0][2];
+				m[3]=xform.origin.x;
+				m[4]=xform.basis[1][0];
+				m[5]=xform.basis[1][1];
+				m[6]=xform.basis[1][2];
+				m[7]=xform.origin.y;
+				m[8]=xform.basis[2][0];
+				m[9]=xform.basis[2][1];
+				m[10]=xform.basis[2][2];
+				m[11]=xform.origin.z;
 
 				for(List<uint32_t>::Element *E=b.nodes_bound.front();E;E=E->next()) {
 
@@ -221,10 +254,13 @@ void Skeleton::_notification(int p_what) {
 					ERR_CONTINUE(!obj);
 					Spatial *sp = obj->cast_to<Spatial>();
 					ERR_CONTINUE(!sp);
-					sp->set_transform(b.pose_global * b.rest_global_inverse);
+					sp->set_transform(xform);
 				}
 			}
 
+			if (updated)
+				vs->skeleton_set_bone_transforms( skeleton, transforms, len ); // one command for the whole skeleton
+
 			dirty=false;
 		} break;	
 	}
@@ -345,6 +381,8 @@ void Skeleton::bind_child_node_to_bone(int p_bone,Node *p_node) {
 	}
 	
 	bones[p_bone].nodes_bound.push_back(id);
+	bones[p_bone].pose_dirty=true; // place it on the next update
+	_make_dirty();
 	
 }
 void Skeleton::unbind_child_node_from_bone(int p_bone,Node *p_node) {
@@ -385,6 +423,25 @@ void Skeleton::set_bone_pose(int p_bone, const Transform& p_pose) {
 	
 
 	bones[p_bone].pose=p_pose;
+	bones[p_bone].pose_dirty=true;
+	_make_dirty();
+}
+
+void Skeleton::set_bone_poses(const int *p_bones, const Transform *p_poses, int p_count) {
+
+	ERR_FAIL_COND( !is_inside_scene() );
+
+	int len=bones.size();
+	Bone *bonesptr=bones.ptr();
+
+	for(int i=0;i<p_count;i++) {
+
+		ERR_CONTINUE( p_bones[i]<0 || p_bones[i]>=len );
+		Bone &b=bonesptr[p_bones[i]];
+		b.pose=p_poses[i];
+		b.pose_dirty=true;
+	}
+
 	_make_dirty();
 }
 Transform Skeleton::get_bone_pose(int p_bone) const {
@@ -402,6 +459,7 @@ void Skeleton::set_bone_custom_pose(int p_bone, const Transform& p_custom_pose)
 
 	bones[p_bone].custom_pose_enable=(p_custom_pose!=Transform());
 	bones[p_bone].custom_pose=p_custom_pose;
+	bones[p_bone].pose_dirty=true;
 
 	_make_dirty();
 }
@@ -524,6 +582,7 @@ void Skeleton::_bind_methods() {
 Skeleton::Skeleton() {
 
 	rest_global_inverse_dirty=true;
+	update_pass=0;
 	dirty=false;
 	skeleton=VisualServer::get_singleton()->skeleton_create();
 }
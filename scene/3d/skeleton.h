@@ -56,13 +56,18 @@ class Skeleton : public Spatial {
 		Transform custom_pose;
 		
 		List<uint32_t> nodes_bound;
+
+		bool pose_dirty;
+		uint64_t update_pass;
 		
-		Bone() { parent=-1; enabled=true; custom_pose_enable=false; }
+		Bone() { parent=-1; enabled=true; custom_pose_enable=false; pose_dirty=true; update_pass=0; }
 	};
 
 	bool rest_global_inverse_dirty;
 
 	Vector<Bone> bones;
+	Vector<float> bone_transforms; // what was last sent to the server, 12 floats per bone
+	uint64_t update_pass;
 	
 	RID skeleton;
 	
@@ -130,6 +135,7 @@ public:
 	
 	void set_bone_pose(int p_bone, const Transform& p_pose);
 	Transform get_bone_pose(int p_bone) const;
+	void set_bone_poses(const int *p_bones, const Transform *p_poses, int p_count); ///< many at once, the skeleton is updated only once
 
 	void set_bone_custom_pose(int p_bone, const Transform& p_custom_pose);
 	Transform get_bone_custom_pose(int p_bone) const;
@@ -76,7 +76,7 @@ void Spatial::_notify_dirty() {
 
 	if (!data.ignore_notification && !xform_change.in_list()) {
 
-		get_scene()->xform_change_list.add(&xform_change);
+		get_scene()->_add_xform_change(&xform_change);
 	}
 }
 
@@ -95,12 +95,13 @@ void Spatial::_propagate_transform_changed(Spatial *p_origin) {
 		return;
 	}
 
-//	if (data.dirty&DIRTY_GLOBAL)
-//		return; //already dirty
+	if (xform_change.in_list() && data.dirty&DIRTY_GLOBAL)
+		return; //already dirty and waiting for notification, so is everything below
 
 	data.children_lock++;
 		
-	for (List<Spatial*>::Element *E=data.children.front();E;E=E->next()) {
+	//walked backwards, the change list prepends so it ends up in tree order
+	for (List<Spatial*>::Element *E=data.children.back();E;E=E->prev()) {
 	
 		if (E->get()->data.toplevel_active)
 			continue; //don't propagate to a toplevel
@@ -110,7 +111,7 @@ void Spatial::_propagate_transform_changed(Spatial *p_origin) {
 
 	if (!data.ignore_notification && !xform_change.in_list()) {
 
-		get_scene()->xform_change_list.add(&xform_change);
+		get_scene()->_add_xform_change(&xform_change);
 
 	}
 	data.dirty|=DIRTY_GLOBAL;
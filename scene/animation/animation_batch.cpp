@@ -0,0 +1,311 @@
+/*************************************************************************/
+/*  animation_batch.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "animation_batch.h"
+
+#include "os/os.h"
+#include "os/thread.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "globals.h"
+#include "sort.h"
+#include "scene/main/scene_main_loop.h"
+
+SelfList<AnimationBatch::Player>::List AnimationBatch::players;
+Vector<AnimationBatch::Entry> AnimationBatch::entries;
+uint64_t AnimationBatch::sample_usec[AnimationBatch::MODE_MAX]={0,0};
+uint64_t AnimationBatch::apply_usec[AnimationBatch::MODE_MAX]={0,0};
+
+static Mutex *batch_mutex=NULL;
+static Semaphore *batch_work=NULL;
+static Semaphore *batch_done=NULL;
+static Vector<Thread*> batch_workers;
+static bool batch_started=false;
+static bool batch_exit=false;
+
+static int batch_job_count=0;
+static int batch_next=0;
+
+
+AnimationBatch::Player::Player(Node *p_node) : batch_self(this) {
+
+	batch_node=p_node;
+	batch_pass=0;
+}
+
+AnimationBatch::Player::~Player() {
+
+	_batch_remove();
+}
+
+void AnimationBatch::Player::_batch_add() {
+
+	if (!batch_self.in_list())
+		players.add(&batch_self);
+}
+
+void AnimationBatch::Player::_batch_remove() {
+
+	if (batch_self.in_list())
+		players.remove(&batch_self);
+}
+
+void AnimationBatch::Player::_batch_process(Mode p_mode) {
+
+	AnimationBatch::_process(this,p_mode);
+}
+
+
+void AnimationBatch::SkeletonPoses::set_bone_pose(Skeleton *p_skeleton,int p_bone,const Transform& p_pose) {
+
+	if (p_skeleton!=skeleton) {
+		flush();
+		skeleton=p_skeleton;
+	}
+
+	if (count==bones.size()) {
+		bones.resize(MAX(count*2,16));
+		poses.resize(bones.size());
+	}
+
+	bones[count]=p_bone;
+	poses[count]=p_pose;
+	count++;
+}
+
+void AnimationBatch::SkeletonPoses::flush() {
+
+	if (count)
+		skeleton->set_bone_poses(bones.ptr(),poses.ptr(),count);
+
+	skeleton=NULL;
+	count=0;
+}
+
+AnimationBatch::SkeletonPoses::SkeletonPoses() {
+
+	skeleton=NULL;
+	count=0;
+}
+
+
+void AnimationBatch::_sample_jobs() {
+
+	const Vector<Entry> &jobs=entries;
+
+	while(true) {
+
+		batch_mutex->lock();
+		int idx=batch_next++;
+		batch_mutex->unlock();
+
+		if (idx>=batch_job_count)
+			break;
+
+		jobs[idx].player->_batch_sample();
+	}
+}
+
+void AnimationBatch::_worker_func(void *p_ud) {
+
+	while(true) {
+
+		batch_work->wait();
+		if (batch_exit)
+			break;
+
+		_sample_jobs();
+		batch_done->post();
+	}
+}
+
+bool AnimationBatch::_start_workers() {
+
+	if (batch_started)
+		return batch_workers.size()>0;
+
+	batch_started=true;
+
+	//counts the main thread, which samples too. 1 keeps everything on the main thread
+	int threads = GLOBAL_DEF("animation/process_threads",0);
+	if (threads<=0)
+		threads=OS::get_singleton()->get_processor_count();
+
+	if (threads<=1)
+		return false;
+
+	batch_mutex=Mutex::create();
+	batch_work=Semaphore::create();
+	batch_done=Semaphore::create();
+	ERR_FAIL_COND_V(!batch_mutex || !batch_work || !batch_done, false);
+
+	batch_exit=false;
+	for(int i=0;i<threads-1;i++) {
+
+		Thread *t = Thread::create(_worker_func,NULL);
+		if (!t)
+			break; //no threads in this platform, sample on the main thread
+		batch_workers.push_back(t);
+	}
+
+	return batch_workers.size()>0;
+}
+
+void AnimationBatch::_process(Player *p_caller,Mode p_mode) {
+
+	SceneMainLoop *scene = p_caller->batch_node->get_scene();
+	ERR_FAIL_COND(!scene);
+
+	uint64_t pass=scene->get_process_pass();
+	if (p_caller->batch_pass==pass)
+		return; //already processed along with the first player notified in this pass
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+
+	int count=0;
+
+	for(SelfList<Player> *E=players.first();E;E=E->next()) {
+
+		Player *p = E->self();
+		Node *n = p->batch_node;
+
+		if (p->batch_pass==pass || n->get_scene()!=scene)
+			continue;
+
+		bool processing = p_mode==MODE_IDLE ? n->is_processing() : n->is_fixed_processing();
+		if (!processing || !n->can_process())
+			continue;
+
+		p->batch_pass=pass;
+		if (!p->_batch_begin(p_mode))
+			continue;
+
+		if (count==entries.size())
+			entries.resize(MAX(count*2,16));
+
+		Entry &e=entries[count++];
+		e.player=p;
+		e.node=n;
+		e.id=n->get_instance_ID();
+	}
+
+	if (count==0) {
+		sample_usec[p_mode]=0;
+		apply_usec[p_mode]=0;
+		return;
+	}
+
+	Entry *entryptr=entries.ptr();
+
+	//apply in tree order, as if each player had been processed on its own
+	SortArray<Entry> sorter;
+	sorter.sort(entryptr,count);
+
+	int helpers = count>1 && _start_workers() ? MIN(batch_workers.size(),count-1) : 0;
+
+	if (helpers) {
+
+		batch_job_count=count;
+		batch_next=0;
+
+		for(int i=0;i<helpers;i++)
+			batch_work->post();
+
+		_sample_jobs();
+
+		for(int i=0;i<helpers;i++)
+			batch_done->wait();
+
+		batch_job_count=0;
+
+	} else {
+
+		for(int i=0;i<count;i++)
+			entryptr[i].player->_batch_sample();
+	}
+
+	uint64_t sampled = OS::get_singleton()->get_ticks_usec();
+
+	for(int i=0;i<count;i++) {
+
+		const Entry &e=entryptr[i];
+		if (ObjectDB::get_instance(e.id)!=e.node)
+			continue; //freed by something an earlier player triggered
+
+		e.player->_batch_apply();
+	}
+
+	uint64_t applied = OS::get_singleton()->get_ticks_usec();
+
+	sample_usec[p_mode]=sampled-from;
+	apply_usec[p_mode]=applied-sampled;
+}
+
+uint64_t AnimationBatch::get_sample_usec(Mode p_mode) {
+
+	ERR_FAIL_INDEX_V(p_mode,MODE_MAX,0);
+	return sample_usec[p_mode];
+}
+
+uint64_t AnimationBatch::get_apply_usec(Mode p_mode) {
+
+	ERR_FAIL_INDEX_V(p_mode,MODE_MAX,0);
+	return apply_usec[p_mode];
+}
+
+void AnimationBatch::finish() {
+
+	if (batch_workers.size()) {
+
+		batch_exit=true;
+		for(int i=0;i<batch_workers.size();i++)
+			batch_work->post();
+
+		for(int i=0;i<batch_workers.size();i++) {
+			Thread::wait_to_finish(batch_workers[i]);
+			memdelete(batch_workers[i]);
+		}
+		batch_workers.clear();
+	}
+
+	if (batch_mutex) {
+		memdelete(batch_mutex);
+		batch_mutex=NULL;
+	}
+	if (batch_work) {
+		memdelete(batch_work);
+		batch_work=NULL;
+	}
+	if (batch_done) {
+		memdelete(batch_done);
+		batch_done=NULL;
+	}
+
+	entries.clear();
+	batch_started=false;
+}
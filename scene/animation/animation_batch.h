@@ -0,0 +1,116 @@
+/*************************************************************************/
+/*  animation_batch.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef ANIMATION_BATCH_H
+#define ANIMATION_BATCH_H
+
+#include "self_list.h"
+#include "scene/3d/skeleton.h"
+
+/* Evaluates all animation players of a process pass together: each player samples and blends into
+   its own buffers, in parallel on worker threads, then the results are applied serially in tree order */
+
+class AnimationBatch {
+public:
+
+	enum Mode {
+		MODE_FIXED,
+		MODE_IDLE,
+		MODE_MAX
+	};
+
+	class Player {
+
+		friend class AnimationBatch;
+
+		Node *batch_node;
+		SelfList<Player> batch_self;
+		uint64_t batch_pass;
+
+	protected:
+
+		virtual bool _batch_begin(Mode p_mode)=0; ///< main thread, build caches here. false skips the player this pass
+		virtual void _batch_sample()=0; ///< any thread, may only touch the player's own data
+		virtual void _batch_apply()=0; ///< main thread, write the sampled results to the nodes
+
+		void _batch_add();
+		void _batch_remove();
+		void _batch_process(Mode p_mode);
+
+	public:
+
+		Player(Node *p_node);
+		virtual ~Player();
+	};
+
+	// collects bone poses and hands them to the skeleton in one call, as long as they come in runs per skeleton
+	class SkeletonPoses {
+
+		Skeleton *skeleton;
+		Vector<int> bones;
+		Vector<Transform> poses;
+		int count;
+
+	public:
+
+		void set_bone_pose(Skeleton *p_skeleton,int p_bone,const Transform& p_pose);
+		void flush();
+
+		SkeletonPoses();
+	};
+
+private:
+
+	struct Entry {
+
+		Player *player;
+		Node *node;
+		ObjectID id;
+
+		bool operator<(const Entry& p_entry) const { return p_entry.node->is_greater_than(node); }
+	};
+
+	static SelfList<Player>::List players;
+	static Vector<Entry> entries;
+	static uint64_t sample_usec[MODE_MAX];
+	static uint64_t apply_usec[MODE_MAX];
+
+	static void _sample_jobs();
+	static void _worker_func(void *p_ud);
+	static bool _start_workers();
+	static void _process(Player *p_caller,Mode p_mode);
+
+public:
+
+	static uint64_t get_sample_usec(Mode p_mode);
+	static uint64_t get_apply_usec(Mode p_mode);
+
+	static void finish();
+};
+
+#endif // ANIMATION_BATCH_H
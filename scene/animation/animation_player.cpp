@@ -195,6 +195,7 @@ void AnimationPlayer::_notification(int p_what) {
 			}
 			//_set_process(false);
 			clear_caches();
+			_batch_add();
 		} break;
 		case NOTIFICATION_READY: {
 
@@ -207,7 +208,7 @@ void AnimationPlayer::_notification(int p_what) {
 				break;
 
 			if (processing)
-				_animation_process( get_process_delta_time() );
+				_batch_process(AnimationBatch::MODE_IDLE);
 		} break;
 		case NOTIFICATION_FIXED_PROCESS: {
 		
@@ -215,12 +216,13 @@ void AnimationPlayer::_notification(int p_what) {
 				break;
 
 			if (processing)
-				_animation_process( get_fixed_process_delta_time() );
+				_batch_process(AnimationBatch::MODE_FIXED);
 		} break;
 		case NOTIFICATION_EXIT_SCENE: {
 		
 			stop_all();
 			clear_caches();
+			_batch_remove();
 		} break;
 	}
 }
@@ -329,6 +331,17 @@ void AnimationPlayer::_generate_node_caches(AnimationData* p_anim) {
 			}
 		}
 	}
+
+	p_anim->transform_tracks.clear();
+	for (int i=0;i<a->get_track_count();i++) {
+
+		if (p_anim->node_cache[i] && a->track_get_type(i)==Animation::TYPE_TRANSFORM)
+			p_anim->transform_tracks.push_back(i);
+	}
+
+	p_anim->key_hints.resize(p_anim->transform_tracks.size());
+	for (int i=0;i<p_anim->key_hints.size();i++)
+		p_anim->key_hints[i]=-1;
 }
 
 
@@ -336,6 +349,8 @@ void AnimationPlayer::_animation_process_animation(AnimationData* p_anim,float p
 
 	if (p_anim->node_cache.size() != p_anim->animation->get_track_count()) {
 		// animation hasn't been "node-cached"
+		if (batch_pending)
+			return; // on a worker, caches could not be made in _batch_begin
 		_generate_node_caches(p_anim);
 	}
 
@@ -345,6 +360,51 @@ void AnimationPlayer::_animation_process_animation(AnimationData* p_anim,float p
 
 	Animation *a=p_anim->animation.operator->();
 	bool can_call = is_inside_scene() && !get_scene()->is_editor_hint();
+
+	int ttc = p_anim->transform_tracks.size();
+
+	if (ttc) {
+
+		if (sample_ok.size()<ttc) {
+
+			sample_loc.resize(ttc);
+			sample_rot.resize(ttc);
+			sample_scale.resize(ttc);
+			sample_ok.resize(ttc);
+		}
+
+		a->transform_tracks_interpolate(p_anim->transform_tracks.ptr(),ttc,p_time,sample_loc.ptr(),sample_rot.ptr(),sample_scale.ptr(),sample_ok.ptr(),p_anim->key_hints.ptr());
+
+		const int *transform_tracks = p_anim->transform_tracks.ptr();
+		const Vector3 *locs = sample_loc.ptr();
+		const Quat *rots = sample_rot.ptr();
+		const Vector3 *scales = sample_scale.ptr();
+		const bool *oks = sample_ok.ptr();
+
+		for (int i=0;i<ttc;i++) {
+
+			TrackNodeCache *nc=p_anim->node_cache[transform_tracks[i]];
+
+			if (!nc->spatial || !oks[i])
+				continue;
+
+			if (nc->accum_pass!=accum_pass) {
+				ERR_CONTINUE( cache_update_size >= NODE_CACHE_UPDATE_MAX );
+				cache_update[cache_update_size++]=nc;
+				nc->accum_pass=accum_pass;
+				nc->loc_accum=locs[i];
+				nc->rot_accum=rots[i];
+				nc->scale_accum=scales[i];
+
+			} else {
+
+				nc->loc_accum=nc->loc_accum.linear_interpolate(locs[i],p_interp);
+				nc->rot_accum=nc->rot_accum.slerp(rots[i],p_interp);
+				nc->scale_accum=nc->scale_accum.linear_interpolate(scales[i],p_interp);
+
+			}
+		}
+	}
 	
 	for (int i=0;i<a->get_track_count();i++) {
 	
@@ -359,39 +419,8 @@ void AnimationPlayer::_animation_process_animation(AnimationData* p_anim,float p
 		switch(a->track_get_type(i)) {
 			
 			case Animation::TYPE_TRANSFORM: {
-			
-				if (!nc->spatial)
-					continue;
-			
-				
-				Vector3 loc;
-				Quat rot;
-				Vector3 scale;
-
-
-				Error err = a->transform_track_interpolate(i,p_time,&loc,&rot,&scale);
-				ERR_CONTINUE(err!=OK); //used for testing, should be removed
-
-
-				if (err!=OK)
-					continue;
-
-				if (nc->accum_pass!=accum_pass) {
-					ERR_CONTINUE( cache_update_size >= NODE_CACHE_UPDATE_MAX );
-					cache_update[cache_update_size++]=nc;
-					nc->accum_pass=accum_pass;
-					nc->loc_accum=loc;
-					nc->rot_accum=rot;
-					nc->scale_accum=scale;
 
-				} else {
-
-					nc->loc_accum=nc->loc_accum.linear_interpolate(loc,p_interp);
-					nc->rot_accum=nc->rot_accum.slerp(rot,p_interp);
-					nc->scale_accum=nc->scale_accum.linear_interpolate(scale,p_interp);
-
-				}
-				
+				// sampled above, together with the other transform tracks
 			} break;
 			case Animation::TYPE_VALUE: {
 			
@@ -429,14 +458,11 @@ void AnimationPlayer::_animation_process_animation(AnimationData* p_anim,float p
 
 					for(List<int>::Element *F=indices.front();F;F=F->next()) {
 
-						Variant value=a->track_get_key_value(i,F->get());
-						switch(pa->special) {
-
-							case SP_NONE: pa->object->set(pa->prop,value); break; //you are not speshul
-							case SP_NODE2D_POS: static_cast<Node2D*>(pa->object)->set_pos(value); break;
-							case SP_NODE2D_ROT: static_cast<Node2D*>(pa->object)->set_rot(Math::deg2rad(value)); break;
-							case SP_NODE2D_SCALE: static_cast<Node2D*>(pa->object)->set_scale(value); break;
-						}
+						DeferredCall dc;
+						dc.prop=pa;
+						dc.node=NULL;
+						dc.args.push_back(a->track_get_key_value(i,F->get()));
+						deferred_calls.push_back(dc);
 
 					}
 
@@ -458,23 +484,15 @@ void AnimationPlayer::_animation_process_animation(AnimationData* p_anim,float p
 							
 				for(List<int>::Element *E=indices.front();E;E=E->next()) {
 
-					StringName method=a->method_track_get_name(i,E->get());
-					Vector<Variant> params=a->method_track_get_params(i,E->get());
-
-					int s=params.size();
-
-					ERR_CONTINUE( s > VARIANT_ARG_MAX );
-					if (can_call) {
-						MessageQueue::get_singleton()->push_call(
-									nc->node,
-									method,
-									s>=1 ? params[0] : Variant(),
-									s>=2 ? params[1] : Variant(),
-									s>=3 ? params[2] : Variant(),
-									s>=4 ? params[3] : Variant(),
-									s>=5 ? params[4] : Variant()
-									       );
-					}
+					DeferredCall dc;
+					dc.prop=NULL;
+					dc.node=nc->node;
+					dc.method=a->method_track_get_name(i,E->get());
+					dc.args=a->method_track_get_params(i,E->get());
+
+					ERR_CONTINUE( dc.args.size() > VARIANT_ARG_MAX );
+					if (can_call)
+						deferred_calls.push_back(dc);
 				}
 					
 			
@@ -566,6 +584,43 @@ void AnimationPlayer::_animation_process2(float p_delta) {
 	
 }
 
+void AnimationPlayer::_animation_set_discrete(TrackNodeCache::PropertyAnim *p_prop,const Variant& p_value) {
+
+	switch(p_prop->special) {
+
+		case SP_NONE: p_prop->object->set(p_prop->prop,p_value); break; //you are not speshul
+		case SP_NODE2D_POS: static_cast<Node2D*>(p_prop->object)->set_pos(p_value); break;
+		case SP_NODE2D_ROT: static_cast<Node2D*>(p_prop->object)->set_rot(Math::deg2rad(p_value)); break;
+		case SP_NODE2D_SCALE: static_cast<Node2D*>(p_prop->object)->set_scale(p_value); break;
+	}
+}
+
+void AnimationPlayer::_animation_flush_deferred() {
+
+	for (int i=0;i<deferred_calls.size();i++) {
+
+		const DeferredCall &dc=deferred_calls[i];
+
+		if (dc.prop) {
+			_animation_set_discrete(dc.prop,dc.args[0]);
+			continue;
+		}
+
+		int s=dc.args.size();
+		MessageQueue::get_singleton()->push_call(
+					dc.node,
+					dc.method,
+					s>=1 ? dc.args[0] : Variant(),
+					s>=2 ? dc.args[1] : Variant(),
+					s>=3 ? dc.args[2] : Variant(),
+					s>=4 ? dc.args[3] : Variant(),
+					s>=5 ? dc.args[4] : Variant()
+					       );
+	}
+
+	deferred_calls.clear();
+}
+
 void AnimationPlayer::_animation_update_transforms() {
 
 
@@ -584,16 +639,18 @@ void AnimationPlayer::_animation_update_transforms() {
 
 			if (nc->skeleton && nc->bone_idx>=0) {
 
-				nc->skeleton->set_bone_pose( nc->bone_idx, t );
+				skeleton_poses.set_bone_pose( nc->skeleton, nc->bone_idx, t );
 
 			} else if (nc->spatial) {
 
+				skeleton_poses.flush();
 				nc->spatial->set_transform(t);
 			}
 		}
 		
 	}
-	
+
+	skeleton_poses.flush();
 	cache_update_size=0;
 
 	for (int i=0;i<cache_update_prop_size;i++) {
@@ -620,6 +677,25 @@ void AnimationPlayer::_animation_update_transforms() {
 	cache_update_prop_size=0;
 }
 
+void AnimationPlayer::_animation_check_end() {
+
+	if (!end_notify)
+		return;
+
+	if (queued.size()) {
+		String old = playback.assigned;
+		play(queued.front()->get());
+		String new_name = playback.assigned;
+		queued.pop_front();
+		emit_signal(SceneStringNames::get_singleton()->animation_changed, old, new_name);
+	} else {
+        //stop();
+		playing = false;
+		_set_process(false);
+		emit_signal(SceneStringNames::get_singleton()->finished);
+	}
+}
+
 void AnimationPlayer::_animation_process(float p_delta) {
 
 
@@ -630,22 +706,9 @@ void AnimationPlayer::_animation_process(float p_delta) {
 
 		end_notify=false;
 		_animation_process2(p_delta);
+		_animation_flush_deferred();
 		_animation_update_transforms();
-		if (end_notify) {
-			if (queued.size()) {
-				String old = playback.assigned;
-				play(queued.front()->get());
-				String new_name = playback.assigned;
-				queued.pop_front();
-				emit_signal(SceneStringNames::get_singleton()->animation_changed, old, new_name);
-			} else {
-                //stop();
-				playing = false;
-				_set_process(false);
-				emit_signal(SceneStringNames::get_singleton()->finished);
-			}
-
-		}
+		_animation_check_end();
 
 	} else {
 		_set_process(false);
@@ -653,6 +716,64 @@ void AnimationPlayer::_animation_process(float p_delta) {
 
 }
 
+bool AnimationPlayer::_batch_begin(AnimationBatch::Mode p_mode) {
+
+	AnimationBatch::Mode mode = animation_process_mode==ANIMATION_PROCESS_FIXED ? AnimationBatch::MODE_FIXED : AnimationBatch::MODE_IDLE;
+
+	if (p_mode!=mode || !processing)
+		return false;
+
+	if (!playback.current.from) {
+		_set_process(false);
+		return false;
+	}
+
+	//sampling runs away from the tree, so cache everything it needs from it now
+	AnimationData *cd=playback.current.from;
+	if (cd->node_cache.size()!=cd->animation->get_track_count())
+		_generate_node_caches(cd);
+
+	for (List<Blend>::Element *E=playback.blend.front();E;E=E->next()) {
+
+		AnimationData *bd=E->get().data.from;
+		if (bd->node_cache.size()!=bd->animation->get_track_count())
+			_generate_node_caches(bd);
+	}
+
+	batch_delta = mode==AnimationBatch::MODE_IDLE ? get_process_delta_time() : get_fixed_process_delta_time();
+	batch_pending=true;
+	return true;
+}
+
+void AnimationPlayer::_batch_sample() {
+
+	end_notify=false;
+	_animation_process2(batch_delta);
+}
+
+void AnimationPlayer::_batch_discard() {
+
+	if (!batch_pending)
+		return;
+
+	batch_pending=false;
+	cache_update_size=0;
+	cache_update_prop_size=0;
+	deferred_calls.clear();
+}
+
+void AnimationPlayer::_batch_apply() {
+
+	if (!batch_pending)
+		return; //stopped, replayed or seeked by an earlier player, the sampled pass is stale
+
+	batch_pending=false;
+
+	_animation_flush_deferred();
+	_animation_update_transforms();
+	_animation_check_end();
+}
+
 
 Error AnimationPlayer::add_animation(const StringName& p_name, const Ref<Animation>& p_animation) {
 
@@ -862,6 +983,8 @@ void AnimationPlayer::play(const StringName& p_name, float p_custom_blend, float
 		ERR_EXPLAIN("Animation not found: "+name);
 		ERR_FAIL();
 	}
+
+	_batch_discard();
 	
 	Playback &c=playback;
 
@@ -963,6 +1086,8 @@ String AnimationPlayer::get_current_animation() const {
 
 void AnimationPlayer::stop() {
 	
+	_batch_discard();
+
 	Playback &c=playback;
 	c.blend.clear();
 	c.current.from=NULL;
@@ -999,6 +1124,7 @@ void AnimationPlayer::seek(float p_time,bool p_update) {
 		ERR_FAIL_COND(!playback.current.from);
 	}
 
+	_batch_discard();
 	playback.current.pos=p_time;
 	if (p_update) {
 		_animation_process(0);
@@ -1014,6 +1140,7 @@ void AnimationPlayer::seek_delta(float p_time,float p_delta) {
 	}
 
 
+	_batch_discard();
 	playback.current.pos=p_time-p_delta;
 	if (speed_scale!=0.0)
 		p_delta/=speed_scale;
@@ -1058,10 +1185,14 @@ void AnimationPlayer::clear_caches() {
 	for( Map<StringName, AnimationData>::Element *E=animation_set.front();E;E=E->next()) {
 
 		E->get().node_cache.clear();
+		E->get().transform_tracks.clear();
+		E->get().key_hints.clear();
 	}
 
 	cache_update_size=0;
 	cache_update_prop_size=0;
+	deferred_calls.clear();
+	batch_pending=false;
 }
 
 void AnimationPlayer::set_active(bool p_active) {
@@ -1237,7 +1368,7 @@ void AnimationPlayer::_bind_methods() {
 	BIND_CONSTANT( ANIMATION_PROCESS_IDLE );
 }
 
-AnimationPlayer::AnimationPlayer() {
+AnimationPlayer::AnimationPlayer() : AnimationBatch::Player(this) {
 
 
 	accum_pass=1;
@@ -1251,6 +1382,8 @@ AnimationPlayer::AnimationPlayer() {
 	root=NodePath("..");
 	playing = false;
 	active=true;
+	batch_delta=0;
+	batch_pending=false;
 }
 
 
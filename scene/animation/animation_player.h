@@ -35,11 +35,12 @@
 #include "scene/3d/skeleton.h"
 #include "scene/main/misc.h"
 #include "scene/2d/node_2d.h"
+#include "scene/animation/animation_batch.h"
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
 */
 
-class AnimationPlayer : public Node {
+class AnimationPlayer : public Node, public AnimationBatch::Player {
 	OBJ_TYPE( AnimationPlayer, Node );
 	OBJ_CATEGORY("Animation Nodes");
 
@@ -132,10 +133,31 @@ private:
 		String name;
 		StringName next;
 		Vector<TrackNodeCache*> node_cache;
+		Vector<int> transform_tracks; // cached transform tracks, sampled together
+		Vector<int> key_hints; // last key sampled on each of them
 		Ref<Animation> animation;
 	
 	};
 
+	Vector<Vector3> sample_loc;
+	Vector<Quat> sample_rot;
+	Vector<Vector3> sample_scale;
+	Vector<bool> sample_ok;
+
+	struct DeferredCall {
+
+		TrackNodeCache::PropertyAnim *prop; // discrete value key, NULL for a method key
+		Node *node;
+		StringName method;
+		Vector<Variant> args;
+	};
+
+	//discrete keys and method calls found while sampling, done when applying
+	Vector<DeferredCall> deferred_calls;
+	AnimationBatch::SkeletonPoses skeleton_poses;
+	float batch_delta;
+	bool batch_pending;
+
 	Map<StringName, AnimationData> animation_set;
 	struct BlendKey {
 
@@ -201,7 +223,10 @@ private:
 	void _generate_node_caches(AnimationData* p_anim);	
 	void _animation_process_data(PlaybackData &cd,float p_delta,float p_blend);
 	void _animation_process2(float p_delta);
+	void _animation_set_discrete(TrackNodeCache::PropertyAnim *p_prop,const Variant& p_value);
+	void _animation_flush_deferred();
 	void _animation_update_transforms();
+	void _animation_check_end();
 	void _animation_process(float p_delta);
 	
 	void _node_removed(Node *p_node);
@@ -236,6 +261,11 @@ protected:
 	void _notification(int p_what);
 		
 	static void _bind_methods();	
+
+	virtual bool _batch_begin(AnimationBatch::Mode p_mode);
+	virtual void _batch_sample();
+	virtual void _batch_apply();
+	void _batch_discard();
 	
 public:
 
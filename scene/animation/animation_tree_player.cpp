@@ -346,6 +346,10 @@ void AnimationTreePlayer::_notification(int p_what) {
 
 	switch(p_what) {
 
+		case NOTIFICATION_ENTER_SCENE: {
+
+			_batch_add();
+		} break;
 		case NOTIFICATION_READY: {
 			dirty_caches=true;
 			if (master!=NodePath()) {
@@ -353,7 +357,13 @@ void AnimationTreePlayer::_notification(int p_what) {
 			}
 		} break;
 		case NOTIFICATION_PROCESS: {
-			_process_animation();
+			_batch_process(AnimationBatch::MODE_IDLE);
+		} break;
+		case NOTIFICATION_EXIT_SCENE: {
+
+			_batch_remove();
+			batch_pending=false;
+			deferred_count=0;
 		} break;
 	}
 
@@ -666,6 +676,25 @@ void AnimationTreePlayer::_process_animation() {
 	if (dirty_caches)
 		_recompute_caches();
 
+	if (_sample_animation(get_process_delta_time()))
+		_apply_animation();
+}
+
+void AnimationTreePlayer::_defer_call(Track *p_track,const StringName& p_method,const Variant& p_value,const Vector<Variant>& p_args) {
+
+	if (deferred_count==deferred_calls.size())
+		deferred_calls.resize(MAX(deferred_count*2,8));
+
+	DeferredCall &dc=deferred_calls[deferred_count++];
+	dc.track=p_track;
+	dc.method=p_method;
+	dc.value=p_value;
+	dc.args=p_args;
+}
+
+bool AnimationTreePlayer::_sample_animation(float p_delta) {
+
+	deferred_count=0;
 
 	active_list=NULL;
 	AnimationNode *prev=NULL;
@@ -674,11 +703,11 @@ void AnimationTreePlayer::_process_animation() {
 		_process_node(out_name,&prev, 1.0, 0, true );
 		reset_request=false;
 	} else
-		_process_node(out_name,&prev, 1.0, get_process_delta_time(), false );
+		_process_node(out_name,&prev, 1.0, p_delta, false );
 
 	if (dirty_caches) {
 		//some animation changed.. ignore this pass
-		return;
+		return false;
 	}
 
 	//update the tracks..
@@ -745,7 +774,7 @@ void AnimationTreePlayer::_process_animation() {
 
 						if (a->value_track_is_continuous(tr.local_track)) {
 							Variant value = a->value_track_interpolate(tr.local_track,anim_list->time);
-							tr.track->node->set(tr.track->property,value);
+							_defer_call(tr.track,StringName(),value);
 						} else {
 
 							List<int> indices;
@@ -753,7 +782,7 @@ void AnimationTreePlayer::_process_animation() {
 							for(List<int>::Element *E=indices.front();E;E=E->next()) {
 
 								Variant value = a->track_get_key_value(tr.local_track,E->get());
-								tr.track->node->set(tr.track->property,value);
+								_defer_call(tr.track,StringName(),value);
 							}
 						}
 					} break;
@@ -766,7 +795,7 @@ void AnimationTreePlayer::_process_animation() {
 							StringName method = a->method_track_get_name(tr.local_track,E->get());
 							Vector<Variant> args=a->method_track_get_params(tr.local_track,E->get());
 							ERR_CONTINUE(args.size()!=VARIANT_ARG_MAX);
-							tr.track->node->call(method,args[0],args[1],args[2],args[3],args[4]);
+							_defer_call(tr.track,method,Variant(),args);
 						}
 					} break;
 				}
@@ -777,8 +806,28 @@ void AnimationTreePlayer::_process_animation() {
 		anim_list=anim_list->next;
 	}
 
+	return true;
+}
+
+void AnimationTreePlayer::_apply_animation() {
+
 	/* STEP 3 APPLY TRACKS */
 
+	for(int i=0;i<deferred_count;i++) {
+
+		DeferredCall &dc=deferred_calls[i];
+		if (dc.method==StringName()) {
+			dc.track->node->set(dc.track->property,dc.value);
+		} else {
+			const Vector<Variant> &args=dc.args;
+			dc.track->node->call(dc.method,args[0],args[1],args[2],args[3],args[4]);
+		}
+		dc.value=Variant();
+		dc.args.clear();
+	}
+
+	deferred_count=0;
+
 	for(TrackMap::Element *E=track_map.front();E;E=E->next()) {
 
 		Track &t = E->get();
@@ -799,18 +848,55 @@ void AnimationTreePlayer::_process_animation() {
 
 		if (t.bone_idx>=0) {
 			if (t.skeleton)
-				t.skeleton->set_bone_pose(t.bone_idx,xform);
+				skeleton_poses.set_bone_pose(t.skeleton,t.bone_idx,xform);
 
 		} else if (t.spatial) {
 
+			skeleton_poses.flush();
 			t.spatial->set_transform(xform);
 		}
 	}
 
+	skeleton_poses.flush();
 
 
 }
 
+bool AnimationTreePlayer::_batch_begin(AnimationBatch::Mode p_mode) {
+
+	if (p_mode!=AnimationBatch::MODE_IDLE || !active || last_error!=CONNECT_OK)
+		return false;
+
+	if (dirty_caches)
+		_recompute_caches();
+
+	batch_delta=get_process_delta_time();
+	batch_pending=true;
+	return true;
+}
+
+void AnimationTreePlayer::_batch_sample() {
+
+	if (!_sample_animation(batch_delta))
+		batch_pending=false;
+}
+
+void AnimationTreePlayer::_batch_apply() {
+
+	if (!batch_pending)
+		return;
+
+	batch_pending=false;
+
+	if (dirty_caches) {
+		//changed by an earlier player, tracks may be gone
+		deferred_count=0;
+		return;
+	}
+
+	_apply_animation();
+}
+
 
 void AnimationTreePlayer::add_node(NodeType p_type, const StringName& p_node) {
 
@@ -1755,7 +1841,7 @@ void AnimationTreePlayer::_bind_methods() {
 }
 
 
-AnimationTreePlayer::AnimationTreePlayer() {
+AnimationTreePlayer::AnimationTreePlayer() : AnimationBatch::Player(this) {
 
 	active_list=NULL;
 	out = memnew( NodeOut ) ;
@@ -1767,6 +1853,9 @@ AnimationTreePlayer::AnimationTreePlayer() {
 	reset_request=false;
 	last_error=CONNECT_INCOMPLETE;
 	base_path=String("..");
+	deferred_count=0;
+	batch_delta=0;
+	batch_pending=false;
 }
 
 
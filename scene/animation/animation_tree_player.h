@@ -34,9 +34,10 @@
 #include "scene/3d/spatial.h"
 #include "scene/3d/skeleton.h"
 #include "scene/main/misc.h"
+#include "scene/animation/animation_batch.h"
 
 
-class AnimationTreePlayer : public Node {
+class AnimationTreePlayer : public Node, public AnimationBatch::Player {
 
 	OBJ_TYPE( AnimationTreePlayer, Node );
 	OBJ_CATEGORY("Animation Nodes");
@@ -112,6 +113,21 @@ private:
 
 	TrackMap track_map;
 
+	struct DeferredCall {
+
+		Track *track;
+		StringName method; // empty to set the track property to value
+		Variant value;
+		Vector<Variant> args;
+	};
+
+	//value and method keys found while sampling, done when applying
+	Vector<DeferredCall> deferred_calls;
+	int deferred_count;
+	AnimationBatch::SkeletonPoses skeleton_poses;
+	float batch_delta;
+	bool batch_pending;
+
 
 	struct Input {
 
@@ -263,6 +279,9 @@ private:
 	// return time left to finish animation
 	float _process_node(const StringName& p_node,AnimationNode **r_prev_anim, float p_weight,float p_step, bool p_seek=false,const HashMap<NodePath,bool> *p_filter=NULL, float p_reverse_weight=0);
 	void _process_animation();
+	bool _sample_animation(float p_delta);
+	void _apply_animation();
+	void _defer_call(Track *p_track,const StringName& p_method,const Variant& p_value,const Vector<Variant>& p_args=Vector<Variant>());
 	bool reset_request;
 
 	ConnectError _cycle_test(const StringName &p_at_node);
@@ -284,6 +303,10 @@ protected:
 
 	static void _bind_methods();
 
+	virtual bool _batch_begin(AnimationBatch::Mode p_mode);
+	virtual void _batch_sample();
+	virtual void _batch_apply();
+
 
 public:
 
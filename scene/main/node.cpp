@@ -33,6 +33,7 @@
 #include "scene/scene_string_names.h"
 #include "scene/resources/packed_scene.h"
 #include "io/resource_loader.h"
+#include "node_ref.h"
 
 VARIANT_ENUM_CAST(Node::PauseMode);
 
@@ -75,6 +76,7 @@ void Node::_notification(int p_notification) {
 			} else {
 				data.pause_owner=this;
 			}
+			_update_process_paused();
 
 			get_scene()->node_count++;
 
@@ -158,6 +160,11 @@ void Node::_propagate_enter_scene() {
 		data.scene->add_to_group(*K,this);
 	}
 
+	if (data.fixed_process)
+		data.scene->add_to_process(SceneMainLoop::PROCESS_FIXED,this);
+	if (data.idle_process)
+		data.scene->add_to_process(SceneMainLoop::PROCESS_IDLE,this);
+
 	notification(NOTIFICATION_ENTER_SCENE);
 
 	if (get_script_instance()) {
@@ -216,12 +223,18 @@ void Node::_propagate_exit_scene() {
 		data.scene->remove_from_group(*K,this);
 	}
 
+	if (data.fixed_process)
+		data.scene->remove_from_process(SceneMainLoop::PROCESS_FIXED,this);
+	if (data.idle_process)
+		data.scene->remove_from_process(SceneMainLoop::PROCESS_IDLE,this);
+
 	if (data.scene)
 		data.scene->tree_changed();
 
 	data.inside_scene=false;
 	data.scene=NULL;
 	data.depth=-1;
+	data.order=0;
 
 }
 
@@ -251,6 +264,10 @@ void Node::move_child(Node *p_child,int p_pos) {
 		
 		data.children[i]->data.pos=i;
 	}
+
+	if (data.scene && p_child->data.order) {
+		data.scene->_move_tree_order(p_child);
+	}
 	// notification second
 	for (int i=0;i<data.children.size();i++) {
 		data.children[i]->notification( NOTIFICATION_MOVED_IN_PARENT );
@@ -298,12 +315,13 @@ void Node::set_fixed_process(bool p_process) {
 
 	data.fixed_process=p_process;
 	
-	if (data.fixed_process)
-		add_to_group("fixed_process",false);
-	else
-		remove_from_group("fixed_process");
-				
-	data.fixed_process=p_process;
+	if (data.scene) {
+		if (data.fixed_process)
+			data.scene->add_to_process(SceneMainLoop::PROCESS_FIXED,this);
+		else
+			data.scene->remove_from_process(SceneMainLoop::PROCESS_FIXED,this);
+	}
+
 	_change_notify("fixed_process");
 }
 
@@ -312,19 +330,18 @@ void Node::set_pause_mode(PauseMode p_mode) {
 	if (data.pause_mode==p_mode)
 		return;
 
-	bool prev_inherits=data.pause_mode==PAUSE_MODE_INHERIT;
 	data.pause_mode=p_mode;
 	if (!is_inside_scene())
 		return; //pointless
-	if ((data.pause_mode==PAUSE_MODE_INHERIT) == prev_inherits)
-		return; ///nothing changed
+
+	//propagate even if the owner stays the same, the nodes under it cache its mode
 
 	Node *owner=NULL;
 
 	if (data.pause_mode==PAUSE_MODE_INHERIT) {
 
 		if (data.parent)
-			data.parent->data.pause_owner;
+			owner=data.parent->data.pause_owner;
 	} else {
 		owner=this;
 	}
@@ -342,33 +359,36 @@ Node::PauseMode Node::get_pause_mode() const {
 
 void Node::_propagate_pause_owner(Node*p_owner) {
 
-	if (data.pause_mode!=PAUSE_MODE_INHERIT)
+	if (this!=p_owner && data.pause_mode!=PAUSE_MODE_INHERIT)
 		return;
 	data.pause_owner=p_owner;
+	_update_process_paused();
 	for(int i=0;i<data.children.size();i++) {
 
 		data.children[i]->_propagate_pause_owner(p_owner);
 	}
 }
 
-bool Node::can_process() const {
+void Node::_update_process_paused() {
 
-	ERR_FAIL_COND_V( !is_inside_scene(), false );
+	switch(data.pause_mode) {
 
-	if (get_scene()->is_paused()) {
+		case PAUSE_MODE_INHERIT: {
 
-		if (data.pause_mode==PAUSE_MODE_PROCESS)
-			return true;
-		if (data.pause_mode==PAUSE_MODE_INHERIT) {
+			//clearly no pause owner by default
+			data.process_paused = data.pause_owner && data.pause_owner->data.pause_mode==PAUSE_MODE_PROCESS;
+		} break;
+		case PAUSE_MODE_STOP: data.process_paused=false; break;
+		case PAUSE_MODE_PROCESS: data.process_paused=true; break;
+	}
+}
 
-			if (!data.pause_owner)
-				return false; //clearly no pause owner by default
+bool Node::can_process() const {
 
-			if (data.pause_owner->data.pause_mode==PAUSE_MODE_PROCESS)
-				return true;
-		}
+	ERR_FAIL_COND_V( !is_inside_scene(), false );
 
-	}
+	if (get_scene()->is_paused())
+		return data.process_paused;
 
 	return true;
 }
@@ -389,12 +409,13 @@ void Node::set_process(bool p_idle_process) {
 
 	data.idle_process=p_idle_process;
 
-	if (data.idle_process)
-		add_to_group("idle_process",false);
-	else
-		remove_from_group("idle_process");
+	if (data.scene) {
+		if (data.idle_process)
+			data.scene->add_to_process(SceneMainLoop::PROCESS_IDLE,this);
+		else
+			data.scene->remove_from_process(SceneMainLoop::PROCESS_IDLE,this);
+	}
 
-	data.idle_process=p_idle_process;
 	_change_notify("idle_process");
 }
 
@@ -456,8 +477,13 @@ StringName Node::get_name() const {
 
 void Node::_set_name_nocheck(const StringName& p_name) {
 
+	StringName old_name=data.name;
 	data.name=p_name;
 
+	if (data.parent) {
+		data.parent->_unindex_child(this,old_name);
+		data.parent->_index_child(this);
+	}
 }
 
 void Node::set_name(const String& p_name) {
@@ -465,11 +491,14 @@ void Node::set_name(const String& p_name) {
 	String name=p_name.replace(":","").replace("/","").replace("@","");
 
 	ERR_FAIL_COND(name=="");
+	StringName old_name=data.name;
 	data.name=XL_MESSAGE(name);
 	
 	if (data.parent) {
 		
 		data.parent->_validate_child_name(this);
+		data.parent->_unindex_child(this,old_name);
+		data.parent->_index_child(this);
 	}
 
 	if (is_inside_scene()) {
@@ -514,18 +543,8 @@ void Node::_validate_child_name(Node *p_child) {
 
 			String attempted = val > 1 ? (basename + " " +itos(val) ) : basename;
 
-			bool found=false;
-
-			for (int i=0;i<data.children.size();i++) {
-
-				if (data.children[i]==p_child)
-					continue;
-				if (data.children[i]->get_name() == attempted) {
-					found=true;
-					break;
-				}
-
-			}
+			Node *existing = _get_child_by_name(attempted);
+			bool found = existing && existing!=p_child;
 
 			if (found) {
 
@@ -548,17 +567,9 @@ void Node::_validate_child_name(Node *p_child) {
 			unique=false;
 		} else {
 			//check if exists
-			Node **childs=data.children.ptr();
-			int cc = data.children.size();
-
-			for(int i=0;i<cc;i++) {
-				if (childs[i]==p_child)
-					continue;
-				if (childs[i]->data.name==p_child->data.name) {
-					unique=false;
-					break;
-				}
-			}
+			Node *existing = _get_child_by_name(p_child->data.name);
+			if (existing && existing!=p_child)
+				unique=false;
 		}
 
 		if (!unique) {
@@ -574,6 +585,65 @@ void Node::_validate_child_name(Node *p_child) {
 	}
 }
 
+Node *Node::_get_child_by_name(const StringName& p_name) const {
+
+	if (data.child_index) {
+
+		Node **child = data.child_index->getptr(p_name);
+		return child ? *child : NULL;
+	}
+
+	int cc = data.children.size();
+	Node * const *children = data.children.ptr();
+
+	if (cc<CHILD_INDEX_MIN) {
+
+		for(int i=0;i<cc;i++) {
+			if (children[i]->data.name==p_name)
+				return children[i];
+		}
+		return NULL;
+	}
+
+	//too many to scan, index them from now on (backwards, so the first child with a name wins like in the scan)
+	data.child_index = memnew( ChildIndex );
+	for(int i=cc-1;i>=0;i--) {
+		data.child_index->set(children[i]->data.name,children[i]);
+	}
+
+	Node **child = data.child_index->getptr(p_name);
+	return child ? *child : NULL;
+}
+
+void Node::_index_child(Node *p_child) {
+
+	if (!data.child_index || data.child_index->has(p_child->data.name))
+		return;
+
+	data.child_index->set(p_child->data.name,p_child);
+}
+
+void Node::_unindex_child(Node *p_child,const StringName& p_name) {
+
+	if (!data.child_index)
+		return;
+
+	Node **child = data.child_index->getptr(p_name);
+	if (!child || *child!=p_child)
+		return;
+
+	data.child_index->erase(p_name);
+
+	//siblings may share the name (see _add_child_nocheck), the next one takes over
+	const Vector<Node*> &children=data.children;
+	for(int i=0;i<children.size();i++) {
+		if (children[i]!=p_child && children[i]->data.name==p_name) {
+			data.child_index->set(p_name,children[i]);
+			break;
+		}
+	}
+}
+
 void Node::_add_child_nocheck(Node* p_child,const StringName& p_name) {
 	//add a child node quickly, without name validation
 
@@ -581,6 +651,7 @@ void Node::_add_child_nocheck(Node* p_child,const StringName& p_name) {
 	p_child->data.pos=data.children.size();
 	data.children.push_back( p_child );
 	p_child->data.parent=this;
+	_index_child(p_child);
 
 	if (data.scene) {
 		p_child->_set_scene(data.scene);
@@ -678,6 +749,13 @@ void Node::remove_child(Node *p_child) {
 	p_child->notification(NOTIFICATION_UNPARENTED);
 		
 	data.children.remove(idx);
+	_unindex_child(p_child,p_child->data.name);
+
+	if (data.child_index && data.children.size()<CHILD_INDEX_MIN/2) {
+		//few enough to scan again
+		memdelete(data.child_index);
+		data.child_index=NULL;
+	}
 	
 	for (int i=idx;i<data.children.size();i++) {
 		
@@ -745,18 +823,8 @@ Node *Node::_get_node(const NodePath& p_path) const {
 			
 		} else {
 				
-			next=NULL;
-			
-			for(int j=0;j<current->data.children.size();j++) {
-			
-				Node *child = current->data.children[j];
+			next=current->_get_child_by_name(name);
 
-				if ( child->data.name == name ) {
-				
-					next = child;
-					break;
-				}			
-			}
 			if (next == NULL) {
 				return NULL;
 			};
@@ -770,11 +838,21 @@ Node *Node::_get_node(const NodePath& p_path) const {
 Node *Node::get_node(const NodePath& p_path) const {
 
 	Node *node = _get_node(p_path);
-	ERR_EXPLAIN("Node not found: "+p_path);
-	ERR_FAIL_COND_V(!node,NULL);
+	if (!node) {
+		ERR_EXPLAIN("Node not found: "+p_path);
+		ERR_FAIL_V(NULL);
+	}
 	return node;
 }
 
+Ref<NodeRef> Node::get_node_ref(const NodePath& p_path) const {
+
+	Ref<NodeRef> ref = memnew( NodeRef );
+	ref->set_base(const_cast<Node*>(this));
+	ref->set_path(p_path);
+	return ref;
+}
+
 bool Node::has_node(const NodePath& p_path) const {
 
 	return _get_node(p_path)!=NULL;
@@ -803,6 +881,12 @@ bool Node::is_a_parent_of(const Node *p_node) const {
 bool Node::is_greater_than(const Node *p_node) const {
 
 	ERR_FAIL_NULL_V(p_node,false);
+
+	if (data.order && p_node->data.order && data.scene==p_node->data.scene) {
+		//both inside the same scene, compare the order keys
+		return data.order > p_node->data.order;
+	}
+
 	ERR_FAIL_COND_V( !data.inside_scene, false );
 	ERR_FAIL_COND_V( !p_node->data.inside_scene, false );
 	
@@ -1568,6 +1652,7 @@ void Node::_set_scene(SceneMainLoop *p_scene) {
 
 	if (data.scene) {
 
+		data.scene->_assign_tree_order(this);
 
 		_propagate_enter_scene();
 		_propagate_ready(); //reverse_notification(NOTIFICATION_READY);
@@ -1650,6 +1735,7 @@ void Node::_bind_methods() {
 	ObjectTypeDB::bind_method(_MD("get_child:Node","idx"),&Node::get_child);
 	ObjectTypeDB::bind_method(_MD("has_node","path"),&Node::has_node);
 	ObjectTypeDB::bind_method(_MD("get_node:Node","path"),&Node::get_node);
+	ObjectTypeDB::bind_method(_MD("get_node_ref:NodeRef","path"),&Node::get_node_ref);
 	ObjectTypeDB::bind_method(_MD("get_parent:Parent"),&Node::get_parent);
 	ObjectTypeDB::bind_method(_MD("has_node_and_resource","path"),&Node::has_node_and_resource);
 	ObjectTypeDB::bind_method(_MD("get_node_and_resource","path"),&Node::_get_node_and_resource);
@@ -1739,7 +1825,9 @@ void Node::_bind_methods() {
 Node::Node() {
 	
 	data.pos=-1;
+	data.child_index=NULL;
 	data.depth=-1;
+	data.order=0;
 	data.blocked=0;
 	data.parent=NULL;
 	data.scene=NULL;
@@ -1753,6 +1841,7 @@ Node::Node() {
 	data.unhandled_input=false;
 	data.pause_mode=PAUSE_MODE_INHERIT;
 	data.pause_owner=NULL;
+	data.process_paused=false;
 	data.parent_owned=false;
 	data.in_constructor=true;
 }
@@ -1763,6 +1852,8 @@ Node::~Node() {
 	data.grouped.clear();
 	data.owned.clear();
 	data.children.clear();
+	if (data.child_index)
+		memdelete(data.child_index);
 	
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
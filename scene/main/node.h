@@ -37,6 +37,8 @@
 #include "scene/main/scene_main_loop.h"
 
 
+class NodeRef;
+
 class Node : public Object {
 
 	OBJ_TYPE( Node, Object );
@@ -64,6 +66,12 @@ private:
 		bool persistent;	
 		GroupData() { persistent=false; }
 	};
+
+	enum {
+		CHILD_INDEX_MIN=32 // children are looked up through a name index from this many on
+	};
+
+	typedef HashMap<StringName,Node*,StringNameHasher> ChildIndex;
 		
 	struct Data {
 	
@@ -75,8 +83,10 @@ private:
 		Node *parent;
 		Node *owner;
 		Vector<Node*> children;	// list of children
+		mutable ChildIndex *child_index; // built lazily by lookups on nodes with many children
 		int pos;
 		int depth;
+		uint64_t order; // tree order key, increasing in pre-order, 0 when outside the scene
 		int blocked; // safeguard that throws an error when attempting to modify the tree in a harmful way while being traversed.
 		StringName name;
 		SceneMainLoop *scene;
@@ -89,6 +99,7 @@ private:
 		
 		PauseMode pause_mode;
 		Node *pause_owner;
+		bool process_paused; // cached can_process() result for when the scene is paused
 		// variables used to properly sort the node when processing, ignored otherwise
 		bool fixed_process;
 		bool idle_process;
@@ -108,6 +119,9 @@ private:
 
 
 	void _validate_child_name(Node *p_name);
+	Node *_get_child_by_name(const StringName& p_name) const;
+	void _index_child(Node *p_child);
+	void _unindex_child(Node *p_child,const StringName& p_name);
 
 	void _propagate_reverse_notification(int p_notification);	
 	void _propagate_deferred_notification(int p_notification, bool p_reverse);
@@ -117,12 +131,14 @@ private:
 	void _propagate_validate_owner();
 	void _print_stray_nodes();
 	void _propagate_pause_owner(Node*p_owner);
+	void _update_process_paused();
 	Array _get_node_and_resource(const NodePath& p_path);
 
 	void _duplicate_and_reown(Node* p_new_parent, const Map<Node*,Node*>& p_reown_map) const;
 	Array _get_children() const;
 
 friend class SceneMainLoop;
+friend class NodeRef;
 
 	void _set_scene(SceneMainLoop *p_scene);
 protected:
@@ -175,6 +191,7 @@ public:
 	Node *get_child(int p_index) const;
 	bool has_node(const NodePath& p_path) const;
 	Node *get_node(const NodePath& p_path) const;
+	Ref<NodeRef> get_node_ref(const NodePath& p_path) const;
 	bool has_node_and_resource(const NodePath& p_path) const;
 	Node *get_node_and_resource(const NodePath& p_path,RES& r_res) const;
 	
@@ -0,0 +1,89 @@
+/*************************************************************************/
+/*  node_ref.cpp                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "node_ref.h"
+#include "scene/main/node.h"
+#include "scene/main/scene_main_loop.h"
+
+void NodeRef::set_base(Node *p_base) {
+
+	base=p_base?p_base->get_instance_ID():0;
+	node=NULL;
+}
+
+Node *NodeRef::get_base() const {
+
+	Object *obj = ObjectDB::get_instance(base);
+	return obj?obj->cast_to<Node>():NULL;
+}
+
+void NodeRef::set_path(const NodePath& p_path) {
+
+	path=p_path;
+	node=NULL;
+}
+
+NodePath NodeRef::get_path() const {
+
+	return path;
+}
+
+Node *NodeRef::get_node() const {
+
+	if (node && version==SceneMainLoop::get_tree_version())
+		return node;
+
+	node=NULL;
+	Node *from = get_base();
+	ERR_FAIL_COND_V(!from,NULL);
+
+	Node *found = from->_get_node(path);
+	if (found && from->is_inside_scene()) {
+		//only valid while nothing in the tree moves, renames or exits
+		node=found;
+		version=SceneMainLoop::get_tree_version();
+	}
+
+	return found;
+}
+
+void NodeRef::_bind_methods() {
+
+	ObjectTypeDB::bind_method(_MD("set_base","node:Node"),&NodeRef::set_base);
+	ObjectTypeDB::bind_method(_MD("get_base:Node"),&NodeRef::get_base);
+	ObjectTypeDB::bind_method(_MD("set_path","path"),&NodeRef::set_path);
+	ObjectTypeDB::bind_method(_MD("get_path"),&NodeRef::get_path);
+	ObjectTypeDB::bind_method(_MD("get_node:Node"),&NodeRef::get_node);
+}
+
+NodeRef::NodeRef() {
+
+	base=0;
+	node=NULL;
+	version=0;
+}
@@ -0,0 +1,64 @@
+/*************************************************************************/
+/*  node_ref.h                                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef NODE_REF_H
+#define NODE_REF_H
+
+#include "reference.h"
+#include "path_db.h"
+
+class Node;
+
+/* Keeps a path resolved against a base node, re-resolving only when the scene tree changed */
+
+class NodeRef : public Reference {
+
+	OBJ_TYPE(NodeRef,Reference);
+
+	ObjectID base;
+	NodePath path;
+	mutable Node *node;
+	mutable uint64_t version;
+
+protected:
+
+	static void _bind_methods();
+public:
+
+	void set_base(Node *p_base);
+	Node *get_base() const;
+
+	void set_path(const NodePath& p_path);
+	NodePath get_path() const;
+
+	Node *get_node() const;
+
+	NodeRef();
+};
+
+#endif // NODE_REF_H
@@ -43,6 +43,8 @@
 #include "viewport.h"
 
 
+uint64_t SceneMainLoop::tree_version=1;
+
 void SceneMainLoop::tree_changed() {
 
 	tree_version++;
@@ -59,19 +61,214 @@ void SceneMainLoop::node_removed(Node *p_node) {
 }
 
 
+/* Every node inside the scene has an order key that increases in pre-order, so comparing
+ * two nodes is a single compare. Keys are handed out with gaps between them, a new subtree
+ * takes keys between its neighbours and only when a gap runs out the whole tree is relabeled. */
+
+#define TREE_ORDER_STEP (uint64_t(1)<<32)
+
+int SceneMainLoop::_count_tree_order(Node *p_node,Node *p_pending,bool p_all) const {
+
+	int count=1;
+	for(int i=0;i<p_node->data.children.size();i++) {
+
+		Node *c=p_node->data.children[i];
+		if (p_all || c==p_pending || c->data.order)
+			count+=_count_tree_order(c,p_pending,p_all || c==p_pending);
+	}
+
+	return count;
+}
+
+void SceneMainLoop::_set_tree_order(Node *p_node,Node *p_pending,bool p_all,uint64_t& r_key,uint64_t p_step) {
+
+	r_key+=p_step;
+	p_node->data.order=r_key;
+
+	for(int i=0;i<p_node->data.children.size();i++) {
+
+		Node *c=p_node->data.children[i];
+		if (p_all || c==p_pending || c->data.order)
+			_set_tree_order(c,p_pending,p_all || c==p_pending,r_key,p_step);
+	}
+}
+
+void SceneMainLoop::_clear_tree_order(Node *p_node) {
+
+	p_node->data.order=0;
+	for(int i=0;i<p_node->data.children.size();i++) {
+
+		if (p_node->data.children[i]->data.order)
+			_clear_tree_order(p_node->data.children[i]);
+	}
+}
+
+void SceneMainLoop::_assign_tree_order(Node *p_node) {
+
+	//p_node and its children have no keys yet, find the keys around them
+
+	uint64_t from=0;
+	uint64_t to=~uint64_t(0);
+
+	Node *parent=p_node->data.parent;
+	if (parent) {
+
+		Node *prev=NULL;
+		for(int i=p_node->data.pos-1;i>=0 && !prev;i--) {
+
+			if (parent->data.children[i]->data.order)
+				prev=parent->data.children[i];
+		}
+
+		if (prev) {
+			//last node under the previous sibling
+			while(true) {
+
+				Node *last=NULL;
+				for(int i=prev->data.children.size()-1;i>=0 && !last;i--) {
+
+					if (prev->data.children[i]->data.order)
+						last=prev->data.children[i];
+				}
+
+				if (!last)
+					break;
+				prev=last;
+			}
+
+			from=prev->data.order;
+		} else {
+
+			from=parent->data.order;
+		}
+
+		bool found=false;
+		for(Node *n=p_node;n->data.parent && !found;n=n->data.parent) {
+
+			Node *p=n->data.parent;
+			for(int i=n->data.pos+1;i<p->data.children.size();i++) {
+
+				if (p->data.children[i]->data.order) {
+					to=p->data.children[i]->data.order;
+					found=true;
+					break;
+				}
+			}
+		}
+	}
+
+	int count=_count_tree_order(p_node,p_node,true);
+	uint64_t step=(to-from)/uint64_t(count+1);
+	if (step>TREE_ORDER_STEP)
+		step=TREE_ORDER_STEP;
+
+	if (step>0) {
+
+		_set_tree_order(p_node,p_node,true,from,step);
+		return;
+	}
+
+	//no room left between the neighbours, relabel everything
+
+	Node *top=p_node;
+	while(top->data.parent)
+		top=top->data.parent;
+
+	int total=_count_tree_order(top,p_node,top==p_node);
+	uint64_t key=0;
+	//use a quarter of the range, leaves plenty of room for appending
+	_set_tree_order(top,p_node,top==p_node,key,~uint64_t(0)/(uint64_t(total+1)*4));
+}
+
+void SceneMainLoop::_move_tree_order(Node *p_node) {
+
+	_clear_tree_order(p_node);
+	_assign_tree_order(p_node);
+	order_version++; //existing group members changed order
+}
+
+int SceneMainLoop::_find_in_group(const Group& g,Node *p_node) const {
+
+	if (g.order_version!=order_version || !p_node->data.order)
+		return g.nodes.find(p_node);
+
+	//sorted part can be searched by key, skipping the holes left by removed nodes
+	Node * const *nodes=g.nodes.ptr();
+	uint64_t key=p_node->data.order;
+	int lo=0;
+	int hi=g.sorted;
+	while(lo<hi) {
+
+		int mid=(lo+hi)>>1;
+		int idx=mid;
+		while(idx<hi && !nodes[idx])
+			idx++;
+
+		if (idx==hi)
+			hi=mid;
+		else if (nodes[idx]->data.order<key)
+			lo=idx+1;
+		else
+			hi=idx;
+	}
+
+	while(lo<g.sorted && !nodes[lo])
+		lo++;
+
+	if (lo<g.sorted && nodes[lo]==p_node)
+		return lo;
+
+	for(int i=g.sorted;i<g.nodes.size();i++) {
+
+		if (nodes[i]==p_node)
+			return i;
+	}
+
+	return -1;
+}
+
+bool SceneMainLoop::_group_add_node(Group& g,Node *p_node) {
+
+	int count=g.nodes.size();
+
+	if (g.order_version==order_version && g.sorted==count && p_node->data.order && (count==0 || (g.nodes[count-1] && g.nodes[count-1]->data.order < p_node->data.order))) {
+		//comes after everything else, group stays sorted
+		g.nodes.push_back(p_node);
+		g.sorted++;
+		return true;
+	}
+
+	if (_find_in_group(g,p_node)!=-1)
+		return false;
+
+	g.nodes.push_back(p_node);
+	return true;
+}
+
+bool SceneMainLoop::_group_remove_node(Group& g,Node *p_node) {
+
+	int idx=_find_in_group(g,p_node);
+	if (idx==-1)
+		return false;
+
+	//compacted on the next update, removing many nodes stays linear
+	g.nodes[idx]=NULL;
+	g.removed++;
+	return true;
+}
+
 void SceneMainLoop::add_to_group(const StringName& p_group, Node *p_node) {
 
 	Map<StringName,Group>::Element *E=group_map.find(p_group);
 	if (!E) {
 		E=group_map.insert(p_group,Group());
+		E->get().order_version=order_version;
 	}
 
-	if (E->get().nodes.find(p_node)!=-1) {
+	if (!_group_add_node(E->get(),p_node)) {
 		ERR_EXPLAIN("Already in group: "+p_group);
 		ERR_FAIL();
 	}
-	E->get().nodes.push_back(p_node);
-	E->get().last_tree_version=0;
 }
 
 void SceneMainLoop::remove_from_group(const StringName& p_group, Node *p_node) {
@@ -79,14 +276,73 @@ void SceneMainLoop::remove_from_group(const StringName& p_group, Node *p_node) {
 	Map<StringName,Group>::Element *E=group_map.find(p_group);
 	ERR_FAIL_COND(!E);
 
-
-	E->get().nodes.erase(p_node);
-	if (E->get().nodes.empty())
+	ERR_FAIL_COND(!_group_remove_node(E->get(),p_node));
+	if (E->get().removed==E->get().nodes.size())
 		group_map.erase(E);
 }
 
+void SceneMainLoop::add_to_process(ProcessList p_list, Node *p_node) {
+
+	ERR_FAIL_INDEX(p_list,PROCESS_MAX);
+	ERR_FAIL_COND(!_group_add_node(process_list[p_list],p_node));
+}
+
+void SceneMainLoop::remove_from_process(ProcessList p_list, Node *p_node) {
+
+	ERR_FAIL_INDEX(p_list,PROCESS_MAX);
+	ERR_FAIL_COND(!_group_remove_node(process_list[p_list],p_node));
+}
+
+struct _XFormChangeSort {
+
+	bool operator()(const SelfList<Node>* p_a, const SelfList<Node>* p_b) const { return p_b->self()->is_greater_than(p_a->self()); }
+};
+
+void SceneMainLoop::_add_xform_change(SelfList<Node> *p_xform_change) {
+
+	//add() prepends, so the list stays in tree order as long as nodes come last to first
+	SelfList<Node> *first=xform_change_list.first();
+	if (first && first->self()->data.order < p_xform_change->self()->data.order)
+		xform_change_unsorted=true;
+
+	xform_change_list.add(p_xform_change);
+}
+
+void SceneMainLoop::_sort_transform_notifications() {
+
+	if (!xform_change_unsorted)
+		return;
+
+	xform_change_unsorted=false;
+
+	int count=0;
+	for(SelfList<Node>* n=xform_change_list.first();n;n=n->next())
+		count++;
+
+	if (count<2)
+		return;
+
+	Vector<SelfList<Node>*> changed;
+	changed.resize(count);
+	SelfList<Node>** elems=&changed[0];
+
+	for(int i=0;i<count;i++) {
+		elems[i]=xform_change_list.first();
+		xform_change_list.remove(elems[i]);
+	}
+
+	SortArray<SelfList<Node>*,_XFormChangeSort> sorter;
+	sorter.sort(elems,count);
+
+	for(int i=count-1;i>=0;i--)
+		xform_change_list.add(elems[i]);
+}
+
 void SceneMainLoop::_flush_transform_notifications() {
 
+	//parents are notified before their children
+	_sort_transform_notifications();
+
 	SelfList<Node>* n = xform_change_list.first();
 	while(n) {
 
@@ -120,17 +376,70 @@ void SceneMainLoop::_flush_ugc() {
 
 void SceneMainLoop::_update_group_order(Group& g) {
 
-	if (g.last_tree_version==tree_version)
-		return;
-	if (g.nodes.empty())
+	if (g.removed) {
+
+		Node **nodes = &g.nodes[0];
+		int count=g.nodes.size();
+		int to=0;
+		int sorted=0;
+		for(int i=0;i<count;i++) {
+
+			if (!nodes[i])
+				continue;
+			if (i<g.sorted)
+				sorted++;
+			nodes[to++]=nodes[i];
+		}
+
+		g.nodes.resize(to);
+		g.sorted=sorted;
+		g.removed=0;
+	}
+
+	int count=g.nodes.size();
+
+	if (g.order_version!=order_version) {
+		//nodes were moved around, see how much is still in order
+		const Vector<Node*>& group_nodes=g.nodes;
+		const Node * const *nodes=group_nodes.ptr();
+		int sorted=MIN(count,1);
+		while(sorted<count && nodes[sorted-1]->data.order < nodes[sorted]->data.order)
+			sorted++;
+		g.sorted=sorted;
+		g.order_version=order_version;
+	}
+
+	if (g.sorted==count)
 		return;
 
+	//sort what was added since last time and merge it with the sorted part
+
 	Node **nodes = &g.nodes[0];
-	int node_count=g.nodes.size();
+	int sorted=g.sorted;
 
 	SortArray<Node*,Node::Comparator> node_sort;
-	node_sort.sort(nodes,node_count);
-	g.last_tree_version=tree_version;
+	node_sort.sort(&nodes[sorted],count-sorted);
+
+	if (sorted>0 && nodes[sorted]->data.order < nodes[sorted-1]->data.order) {
+
+		Vector<Node*> added;
+		added.resize(count-sorted);
+		for(int i=0;i<added.size();i++)
+			added[i]=nodes[sorted+i];
+
+		Node * const *src=added.ptr();
+		int from=sorted-1;
+		int to=count-1;
+		for(int i=added.size()-1;i>=0;) {
+
+			if (from>=0 && nodes[from]->data.order > src[i]->data.order)
+				nodes[to--]=nodes[from--];
+			else
+				nodes[to--]=src[i--];
+		}
+	}
+
+	g.sorted=count;
 }
 
 
@@ -476,7 +785,7 @@ bool SceneMainLoop::iteration(float p_time) {
 	MainLoop::iteration(p_time);
 
 	fixed_process_time=p_time;
-	_notify_group_pause("fixed_process",Node::NOTIFICATION_FIXED_PROCESS);
+	_notify_process(PROCESS_FIXED,Node::NOTIFICATION_FIXED_PROCESS);
 	_flush_ugc();
 	_flush_transform_notifications();
 	call_group(GROUP_CALL_REALTIME,"_viewports","update_worlds");
@@ -502,7 +811,7 @@ bool SceneMainLoop::idle(float p_time){
 
 	_flush_transform_notifications();
 
-	_notify_group_pause("idle_process",Node::NOTIFICATION_PROCESS);
+	_notify_process(PROCESS_IDLE,Node::NOTIFICATION_PROCESS);
 
 	Size2 win_size=Size2( OS::get_singleton()->get_video_mode().width, OS::get_singleton()->get_video_mode().height );
 	if(win_size!=last_screen_size) {
@@ -665,43 +974,29 @@ void SceneMainLoop::_call_input_pause(const StringName& p_group,const StringName
 		call_skip.clear();
 }
 
-void SceneMainLoop::_notify_group_pause(const StringName& p_group,int p_notification) {
-
-	Map<StringName,Group>::Element *E=group_map.find(p_group);
-	if (!E)
-		return;
-	Group &g=E->get();
-	if (g.nodes.empty())
-		return;
+void SceneMainLoop::_notify_process(ProcessList p_list,int p_notification) {
 
+	process_pass++;
 
+	Group &g=process_list[p_list];
 	_update_group_order(g);
 
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node*> nodes_copy = g.nodes;
-
-	int node_count=nodes_copy.size();
-	Node **nodes = &nodes_copy[0];
-
-	call_lock++;
+	//walked in place, nodes removed meanwhile leave a NULL behind and
+	//nodes added meanwhile go past the end, so neither is processed this time.
+	const Vector<Node*> &nodes=g.nodes;
+	int node_count=nodes.size();
 
 	for(int i=0;i<node_count;i++) {
 
 		Node *n = nodes[i];
-		if (call_lock && call_skip.has(n))
+		if (!n)
 			continue;
 
-		if (!n->can_process())
+		if (pause && !n->data.process_paused)
 			continue;
 
 		n->notification(p_notification);
-		//ERR_FAIL_COND(node_count != g.nodes.size());
 	}
-
-	call_lock--;
-	if (call_lock==0)
-		call_skip.clear();
 }
 
 /*
@@ -898,15 +1193,19 @@ SceneMainLoop::SceneMainLoop() {
 
 	_quit=false;
 	initialized=false;
-	tree_version=1;
+	order_version=1;
+	for(int i=0;i<PROCESS_MAX;i++)
+		process_list[i].order_version=order_version;
 	fixed_process_time=1;
 	idle_process_time=1;
 	last_id=0;
 	root=NULL;
 	current_frame=0;
+	process_pass=0;
 	tree_changed_name="tree_changed";
 	node_removed_name="node_removed";
 	ugc_locked=false;
+	xform_change_unsorted=false;
 	call_lock=0;
 	root_lock=0;
 	node_count=0;
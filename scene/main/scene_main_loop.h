@@ -54,13 +54,24 @@ class SceneMainLoop : public MainLoop {
 	struct Group {
 
 		Vector<Node*> nodes;
-		uint64_t last_tree_version;		
-		Group() { last_tree_version=0; };
+		int sorted; // nodes before this index are known to be in tree order
+		int removed; // removed nodes leave a NULL behind until the next update
+		uint64_t order_version;
+		Group() { sorted=0; removed=0; order_version=0; };
 	};
 
 	Viewport *root;
 
-	uint64_t tree_version;
+	uint64_t order_version; // changes when nodes already in the tree are reordered
+
+	enum ProcessList {
+		PROCESS_FIXED,
+		PROCESS_IDLE,
+		PROCESS_MAX
+	};
+
+	Group process_list[PROCESS_MAX]; // kept out of group_map, walked in place every frame
+	uint64_t process_pass; // serial of the last process walk, lets nodes batch work once per walk
 	float fixed_process_time;
 	float idle_process_time;
 	bool accept_quit;
@@ -101,8 +112,18 @@ class SceneMainLoop : public MainLoop {
 	bool ugc_locked;
 	void _flush_ugc();
 	void _flush_transform_notifications();
+	void _sort_transform_notifications();
 
 	void _update_group_order(Group& g);
+	int _find_in_group(const Group& g,Node *p_node) const;
+	bool _group_add_node(Group& g,Node *p_node);
+	bool _group_remove_node(Group& g,Node *p_node);
+
+	int _count_tree_order(Node *p_node,Node *p_pending,bool p_all) const;
+	void _set_tree_order(Node *p_node,Node *p_pending,bool p_all,uint64_t& r_key,uint64_t p_step);
+	void _clear_tree_order(Node *p_node);
+	void _assign_tree_order(Node *p_node);
+	void _move_tree_order(Node *p_node);
 	void _update_listener();
 
 	Array _get_nodes_in_group(const StringName& p_group);
@@ -119,7 +140,10 @@ friend class Node;
 	void add_to_group(const StringName& p_group, Node *p_node);
 	void remove_from_group(const StringName& p_group, Node *p_node);
 
-	void _notify_group_pause(const StringName& p_group,int p_notification);
+	void add_to_process(ProcessList p_list, Node *p_node);
+	void remove_from_process(ProcessList p_list, Node *p_node);
+
+	void _notify_process(ProcessList p_list,int p_notification);
 	void _call_input_pause(const StringName& p_group,const StringName& p_method,const InputEvent& p_input);
 	Variant _call_group(const Variant** p_args, int p_argcount, Variant::CallError& r_error);
 
@@ -130,6 +154,10 @@ friend class Node;
 friend class CanvasItem;
 friend class Spatial;
 	SelfList<Node>::List xform_change_list;
+	bool xform_change_unsorted; // something was added out of tree order since the last flush
+	void _add_xform_change(SelfList<Node> *p_xform_change);
+
+	static uint64_t tree_version; // bumped on every tree change, shared so versions never repeat across scenes
 
 protected:
 
@@ -152,6 +180,7 @@ public:
 
 
 	_FORCE_INLINE_ Viewport *get_root() const { return root; }
+	_FORCE_INLINE_ static uint64_t get_tree_version() { return tree_version; }
 
 	uint32_t get_last_event_id() const;
 
@@ -176,6 +205,7 @@ public:
 	void set_input_as_handled();
 	_FORCE_INLINE_ float get_fixed_process_time() const { return fixed_process_time; }
 	_FORCE_INLINE_ float get_idle_process_time() const { return idle_process_time; }
+	_FORCE_INLINE_ uint64_t get_process_pass() const { return process_pass; }
 
 	void set_editor_hint(bool p_enabled);
 	bool is_editor_hint() const;
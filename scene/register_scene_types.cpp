@@ -107,7 +107,9 @@
 
 #include "scene/animation/animation_player.h"
 #include "scene/animation/animation_tree_player.h"
+#include "scene/animation/animation_batch.h"
 #include "scene/main/scene_main_loop.h"
+#include "scene/main/node_ref.h"
 #include "scene/main/resource_preloader.h"
 #include "scene/resources/packed_scene.h"
 
@@ -252,6 +254,7 @@ void register_scene_types() {
 
 	resource_loader_shader = memnew( ResourceFormatLoaderShader );
 	ResourceLoader::add_resource_format_loader( resource_loader_shader );
+
 #ifdef OLD_SCENE_FORMAT_ENABLED
 	scene_saver_object=memnew( SceneFormatSaverObject );
 	SceneSaver::add_scene_format_saver(scene_saver_object);
@@ -270,6 +273,7 @@ void register_scene_types() {
 	ObjectTypeDB::register_type<Object>();
 
 	ObjectTypeDB::register_type<Node>();
+	ObjectTypeDB::register_type<NodeRef>();
 
 	ObjectTypeDB::register_type<Viewport>();
 	ObjectTypeDB::register_virtual_type<RenderTargetTexture>();
@@ -570,6 +574,7 @@ void register_scene_types() {
 
 void unregister_scene_types() {
 	
+	AnimationBatch::finish();
 	clear_default_theme();
 	
 	memdelete( resource_loader_image );
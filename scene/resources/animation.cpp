@@ -28,6 +28,8 @@
 /*************************************************************************/
 #include "animation.h"
 #include "geometry.h"
+#include "io/marshalls.h"
+#include "math/simd4.h"
 
 
 bool Animation::_set(const StringName& p_name, const Variant& p_value) {
@@ -77,6 +79,62 @@ bool Animation::_set(const StringName& p_name, const Variant& p_value) {
 			if (track_get_type(track)==TYPE_TRANSFORM) {
 
 				TransformTrack *tt = static_cast<TransformTrack*>(tracks[track]);
+
+				if (p_value.get_type()==Variant::DICTIONARY) {
+					//compressed keys
+					Dictionary d=p_value;
+					ERR_FAIL_COND_V(!d.has("channels") || !d.has("constant") || !d.has("ranges") || !d.has("times") || !d.has("data"),false);
+
+					CompressedTransforms packed;
+					packed.channels=int(d["channels"])&(CHANNEL_LOC|CHANNEL_ROT|CHANNEL_SCALE);
+					packed.stride=((packed.channels&CHANNEL_LOC)?3:0)+((packed.channels&CHANNEL_ROT)?4:0)+((packed.channels&CHANNEL_SCALE)?3:0);
+
+					DVector<float> constant=d["constant"];
+					DVector<float> ranges=d["ranges"];
+					ERR_FAIL_COND_V(constant.size()!=10 || ranges.size()!=12,false);
+					DVector<float>::Read rc=constant.read();
+					packed.constant.loc=Vector3(rc[0],rc[1],rc[2]);
+					packed.constant.rot=Quat(rc[3],rc[4],rc[5],rc[6]);
+					packed.constant.scale=Vector3(rc[7],rc[8],rc[9]);
+					DVector<float>::Read rr=ranges.read();
+					packed.loc_base=Vector3(rr[0],rr[1],rr[2]);
+					packed.loc_step=Vector3(rr[3],rr[4],rr[5]);
+					packed.scale_base=Vector3(rr[6],rr[7],rr[8]);
+					packed.scale_step=Vector3(rr[9],rr[10],rr[11]);
+
+					DVector<float> times=d["times"];
+					int count=times.size();
+					DVector<float>::Read rt=times.read();
+					packed.times.resize(count);
+					for(int i=0;i<count;i++)
+						packed.times[i].time=rt[i];
+
+					if (d.has("transitions")) {
+
+						DVector<float> transitions=d["transitions"];
+						ERR_FAIL_COND_V(transitions.size() && transitions.size()!=count,false);
+						DVector<float>::Read rtr=transitions.read();
+						packed.transitions.resize(transitions.size());
+						for(int i=0;i<transitions.size();i++)
+							packed.transitions[i]=rtr[i];
+					}
+
+					DVector<uint8_t> data=d["data"];
+					ERR_FAIL_COND_V(data.size()!=count*packed.stride*2,false);
+					DVector<uint8_t>::Read rd=data.read();
+					packed.data.resize(count*packed.stride);
+					for(int i=0;i<packed.data.size();i++)
+						packed.data[i]=decode_uint16(&rd[i*2]);
+
+					tt->transforms.clear();
+					tt->packed=packed;
+					tt->compressed=true;
+					return true;
+				}
+
+				tt->compressed=false;
+				tt->packed=CompressedTransforms();
+
 				DVector<float> values=p_value;
 				int vcount=values.size();
 
@@ -278,7 +336,62 @@ bool Animation::_get(const StringName& p_name,Variant &r_ret) const {
 			r_ret = track_get_interpolation_type(track);
 		else if (what=="keys") {
 
-			if (track_get_type(track)==TYPE_TRANSFORM) {
+			if (track_get_type(track)==TYPE_TRANSFORM && static_cast<const TransformTrack*>(tracks[track])->compressed) {
+
+				const CompressedTransforms &packed = static_cast<const TransformTrack*>(tracks[track])->packed;
+				Dictionary d;
+
+				DVector<float> constant;
+				constant.resize(10);
+				DVector<float>::Write wc=constant.write();
+				wc[0]=packed.constant.loc.x; wc[1]=packed.constant.loc.y; wc[2]=packed.constant.loc.z;
+				wc[3]=packed.constant.rot.x; wc[4]=packed.constant.rot.y; wc[5]=packed.constant.rot.z; wc[6]=packed.constant.rot.w;
+				wc[7]=packed.constant.scale.x; wc[8]=packed.constant.scale.y; wc[9]=packed.constant.scale.z;
+				wc=DVector<float>::Write();
+
+				DVector<float> ranges;
+				ranges.resize(12);
+				DVector<float>::Write wr=ranges.write();
+				const Vector3 *range[4]={&packed.loc_base,&packed.loc_step,&packed.scale_base,&packed.scale_step};
+				for(int i=0;i<4;i++) {
+					wr[i*3+0]=range[i]->x;
+					wr[i*3+1]=range[i]->y;
+					wr[i*3+2]=range[i]->z;
+				}
+				wr=DVector<float>::Write();
+
+				DVector<float> times;
+				times.resize(packed.times.size());
+				DVector<float>::Write wt=times.write();
+				for(int i=0;i<packed.times.size();i++)
+					wt[i]=packed.times[i].time;
+				wt=DVector<float>::Write();
+
+				DVector<float> transitions;
+				transitions.resize(packed.transitions.size());
+				DVector<float>::Write wtr=transitions.write();
+				for(int i=0;i<packed.transitions.size();i++)
+					wtr[i]=packed.transitions[i];
+				wtr=DVector<float>::Write();
+
+				DVector<uint8_t> data;
+				data.resize(packed.data.size()*2);
+				DVector<uint8_t>::Write wd=data.write();
+				for(int i=0;i<packed.data.size();i++)
+					encode_uint16(packed.data[i],&wd[i*2]);
+				wd=DVector<uint8_t>::Write();
+
+				d["channels"]=int(packed.channels);
+				d["constant"]=constant;
+				d["ranges"]=ranges;
+				d["times"]=times;
+				d["transitions"]=transitions;
+				d["data"]=data;
+
+				r_ret=d;
+				return true;
+
+			} else if (track_get_type(track)==TYPE_TRANSFORM) {
 
 				DVector<real_t> keys;
 				int kk=track_get_key_count(track);				
@@ -601,6 +714,65 @@ void Animation::_clear(T& p_keys) {
 	p_keys.clear();
 }
 
+void Animation::_transform_key_decode(const CompressedTransforms& p_packed, int p_key, TransformKey& r_key) const {
+
+	r_key=p_packed.constant;
+	const uint16_t *q=&p_packed.data.ptr()[p_key*p_packed.stride];
+
+	if (p_packed.channels&CHANNEL_LOC) {
+
+		r_key.loc.x=p_packed.loc_base.x+q[0]*p_packed.loc_step.x;
+		r_key.loc.y=p_packed.loc_base.y+q[1]*p_packed.loc_step.y;
+		r_key.loc.z=p_packed.loc_base.z+q[2]*p_packed.loc_step.z;
+		q+=3;
+	}
+
+	if (p_packed.channels&CHANNEL_ROT) {
+
+		// within 1/32767 of unit length, close enough to skip normalizing
+		const int16_t *r=(const int16_t*)q;
+		const real_t unit=1.0/32767.0;
+		r_key.rot=Quat(r[0]*unit,r[1]*unit,r[2]*unit,r[3]*unit);
+		q+=4;
+	}
+
+	if (p_packed.channels&CHANNEL_SCALE) {
+
+		r_key.scale.x=p_packed.scale_base.x+q[0]*p_packed.scale_step.x;
+		r_key.scale.y=p_packed.scale_base.y+q[1]*p_packed.scale_step.y;
+		r_key.scale.z=p_packed.scale_base.z+q[2]*p_packed.scale_step.z;
+	}
+}
+
+void Animation::_transform_key_get(const TransformTrack *p_track, int p_key, TransformKey& r_key) const {
+
+	if (p_track->compressed)
+		_transform_key_decode(p_track->packed,p_key,r_key);
+	else
+		r_key=p_track->transforms[p_key].value;
+}
+
+void Animation::_transform_track_decompress(TransformTrack *p_track) {
+
+	if (!p_track->compressed)
+		return;
+
+	const CompressedTransforms &packed=p_track->packed;
+	int count=packed.times.size();
+	p_track->transforms.resize(count);
+
+	for(int i=0;i<count;i++) {
+
+		TKey<TransformKey> &tk=p_track->transforms[i];
+		tk.time=packed.times[i].time;
+		tk.transition=packed.transitions.size()?packed.transitions[i]:1.0;
+		_transform_key_decode(packed,i,tk.value);
+	}
+
+	p_track->packed=CompressedTransforms();
+	p_track->compressed=false;
+}
+
 Error Animation::transform_track_get_key(int p_track, int p_key, Vector3* r_loc, Quat* r_rot, Vector3* r_scale) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(),ERR_INVALID_PARAMETER);
@@ -608,14 +780,17 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3* r_loc,
 
 	TransformTrack * tt = static_cast<TransformTrack*>(t);
 	ERR_FAIL_COND_V(t->type!=TYPE_TRANSFORM,ERR_INVALID_PARAMETER);
-	ERR_FAIL_INDEX_V(p_key,tt->transforms.size(),ERR_INVALID_PARAMETER);
+	ERR_FAIL_INDEX_V(p_key,_transform_key_count(tt),ERR_INVALID_PARAMETER);
+
+	TransformKey tk;
+	_transform_key_get(tt,p_key,tk);
 
 	if (r_loc)
-		*r_loc=tt->transforms[p_key].value.loc;
+		*r_loc=tk.loc;
 	if (r_rot)
-		*r_rot=tt->transforms[p_key].value.rot;
+		*r_rot=tk.rot;
 	if (r_scale)
-		*r_scale=tt->transforms[p_key].value.scale;
+		*r_scale=tk.scale;
 
 	return OK;
 }
@@ -627,6 +802,7 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	ERR_FAIL_COND_V(t->type!=TYPE_TRANSFORM,-1);
 
 	TransformTrack * tt = static_cast<TransformTrack*>(t);
+	_transform_track_decompress(tt);
 
 	TKey<TransformKey> tkey;
 	tkey.time=p_time;
@@ -655,6 +831,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack * tt = static_cast<TransformTrack*>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_idx,tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -687,6 +864,17 @@ int Animation::track_find_key(int p_track, float p_time, bool p_exact) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack * tt = static_cast<TransformTrack*>(t);
+			if (tt->compressed) {
+
+				const Vector<PackedTime> &times=tt->packed.times;
+				int k = _find(times,p_time);
+				if (k<0 || k>=times.size())
+					return -1;
+				if (times[k].time!=p_time  && p_exact)
+					return -1;
+				return k;
+			}
+
 			int k = _find(tt->transforms,p_time);
 			if (k<0 || k>=tt->transforms.size())
 				return -1;
@@ -796,7 +984,7 @@ int Animation::track_get_key_count(int p_track) const {
 		case TYPE_TRANSFORM: {
 		
 			TransformTrack * tt = static_cast<TransformTrack*>(t);
-			return tt->transforms.size();
+			return _transform_key_count(tt);
 		} break;
 		case TYPE_VALUE: {
 					
@@ -824,12 +1012,15 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 		
 			TransformTrack * tt = static_cast<TransformTrack*>(t);
-			ERR_FAIL_INDEX_V( p_key_idx, tt->transforms.size(), Variant() );
+			ERR_FAIL_INDEX_V( p_key_idx, _transform_key_count(tt), Variant() );
+
+			TransformKey tk;
+			_transform_key_get(tt,p_key_idx,tk);
 
 			Dictionary d;
-			d["loc"]=tt->transforms[p_key_idx].value.loc;
-			d["rot"]=tt->transforms[p_key_idx].value.rot;
-			d["scale"]=tt->transforms[p_key_idx].value.scale;
+			d["loc"]=tk.loc;
+			d["rot"]=tk.rot;
+			d["scale"]=tk.scale;
 
 			return d;
 		} break;
@@ -866,7 +1057,9 @@ float Animation::track_get_key_time(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 		
 			TransformTrack * tt = static_cast<TransformTrack*>(t);
-			ERR_FAIL_INDEX_V( p_key_idx, tt->transforms.size(), -1 );
+			ERR_FAIL_INDEX_V( p_key_idx, _transform_key_count(tt), -1 );
+			if (tt->compressed)
+				return tt->packed.times[p_key_idx].time;
 			return tt->transforms[p_key_idx].time;
 		} break;
 		case TYPE_VALUE: {
@@ -901,7 +1094,9 @@ float Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack * tt = static_cast<TransformTrack*>(t);
-			ERR_FAIL_INDEX_V( p_key_idx, tt->transforms.size(), -1 );
+			ERR_FAIL_INDEX_V( p_key_idx, _transform_key_count(tt), -1 );
+			if (tt->compressed)
+				return tt->packed.transitions.size()?tt->packed.transitions[p_key_idx]:1.0;
 			return tt->transforms[p_key_idx].transition;
 		} break;
 		case TYPE_VALUE: {
@@ -936,6 +1131,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx,const Variant& p_
 		case TYPE_TRANSFORM: {
 
 			TransformTrack * tt = static_cast<TransformTrack*>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX( p_key_idx, tt->transforms.size());
 			Dictionary d = p_value;
 			if (d.has("loc"))
@@ -977,6 +1173,7 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx,float p_tran
 		case TYPE_TRANSFORM: {
 
 			TransformTrack * tt = static_cast<TransformTrack*>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX( p_key_idx, tt->transforms.size());
 			tt->transforms[p_key_idx].transition=p_transition;
 		} break;
@@ -1192,106 +1389,152 @@ float Animation::_cubic_interpolate( const float& p_pre_a,const float& p_a, cons
 	return _interpolate(p_a,p_b,p_c);
 }
 
-template<class T>
-T Animation::_interpolate( const Vector< TKey<T> >& p_keys, float p_time,  InterpolationType p_interp, bool *p_ok) const {
+template<class K>
+int Animation::_find_hinted( const Vector<K>& p_keys, float p_time, int p_hint) const {
 
-	int len=_find( p_keys, length )+1; // try to find last key (there may be more past the end)
+	int len=p_keys.size();
 
-	if (len<=0) { 
-		// (-1 or -2 returned originally) (plus one above)
-		// meaning no keys, or only key time is larger than length
-		if (p_ok)
-			*p_ok=false;
-		return T();
-	} else if (len==1) { // one key found (0+1), return it
-	
-		if (p_ok)
-			*p_ok=true;
-		return p_keys[0].value;
+	if (p_hint>=0 && p_hint<len) {
+		//playback mostly stays on the hinted key or moves to the next one
+		const K* keys=p_keys.ptr();
+		for(int i=p_hint;i<len && i<=p_hint+1;i++) {
+
+			if (keys[i].time<=p_time && (i+1==len || keys[i+1].time>p_time))
+				return i;
+		}
 	}
-	
-	int idx=_find(p_keys, p_time);
-	
-	ERR_FAIL_COND_V( idx==-2, T());
-	
-	if (p_ok)
-		*p_ok=true;
-	
+
+	return _find(p_keys,p_time);
+}
+
+template<class K>
+bool Animation::_find_interval( const Vector<K>& p_keys, float p_time, int *p_hint, int &r_len, int &r_idx, int &r_next, float &r_c) const {
+
+	int size=p_keys.size();
+	if (size==0)
+		return false;
+
+	const K* keys=p_keys.ptr();
+
+	// try to find last key (there may be more past the end)
+	int len=keys[size-1].time<=length ? size : _find( p_keys, length )+1;
+
+	if (len<=0) {
+		// (-1 returned originally) (plus one above)
+		// meaning only key time is larger than length
+		return false;
+	}
+
+	r_len=len;
+	r_c=0;
+
+	if (len==1) { // one key found (0+1), use it
+
+		r_idx=r_next=0;
+		return true;
+	}
+
+	int idx=p_hint ? _find_hinted(p_keys, p_time, *p_hint) : _find(p_keys, p_time);
+	if (p_hint)
+		*p_hint=idx;
+
 	int next;
-	float c=0;	
+	float c=0;
 	// prepare for all cases of interpolation
-	
+
 	if (loop) {
 	// loop
 		if (idx>=0) {
-		
+
 			if ((idx+1) < len) {
-			
+
 				next=idx+1;
-				float delta=p_keys[next].time - p_keys[idx].time;
-				float from=p_time-p_keys[idx].time;
+				float delta=keys[next].time - keys[idx].time;
+				float from=p_time-keys[idx].time;
 
 				if (Math::absf(delta)>CMP_EPSILON)
 					c=from/delta;
-				else 
+				else
 					c=0;
-			
+
 			} else {
-			
+
 				next=0;
-				float delta=(length - p_keys[idx].time) + p_keys[next].time;
-				float from=p_time-p_keys[idx].time;
-				
+				float delta=(length - keys[idx].time) + keys[next].time;
+				float from=p_time-keys[idx].time;
+
 				if (Math::absf(delta)>CMP_EPSILON)
-					c=from/delta;			
-				else 
+					c=from/delta;
+				else
 					c=0;
-				
+
 			}
-			
+
 		} else {
 			// on loop, behind first key
 			idx=len-1;
 			next=0;
-			float endtime=(length - p_keys[idx].time);
+			float endtime=(length - keys[idx].time);
 			if (endtime<0) // may be keys past the end
 				endtime=0;
-			float delta=endtime + p_keys[next].time;
+			float delta=endtime + keys[next].time;
 			float from=endtime+p_time;
-			
+
 			if (Math::absf(delta)>CMP_EPSILON)
-				c=from/delta;			
-			else 
+				c=from/delta;
+			else
 				c=0;
-		} 		
-	
-	} else { // no loop 
-	
+		}
+
+	} else { // no loop
+
 		if (idx>=0) {
-		
+
 			if ((idx+1) < len) {
-			
+
 				next=idx+1;
-				float delta=p_keys[next].time - p_keys[idx].time;
-				float from=p_time - p_keys[idx].time;
-				
+				float delta=keys[next].time - keys[idx].time;
+				float from=p_time - keys[idx].time;
+
 				if (Math::absf(delta)>CMP_EPSILON)
 					c=from/delta;
 				else
 					c=0;
-			
+
 			} else {
-			
+
 				next=idx;
 			}
-			
+
 		} else if (idx<0) {
-		
+
 			idx=next=0;
-		} 		
-	
+		}
+
 	}
-	
+
+	r_idx=idx;
+	r_next=next;
+	r_c=c;
+	return true;
+}
+
+template<class T>
+T Animation::_interpolate( const Vector< TKey<T> >& p_keys, float p_time,  InterpolationType p_interp, bool *p_ok, int *p_hint) const {
+
+	int len,idx,next;
+	float c;
+
+	if (!_find_interval(p_keys,p_time,p_hint,len,idx,next,c)) {
+		// no keys, or only key time is larger than length
+		if (p_ok)
+			*p_ok=false;
+		return T();
+	}
+
+	if (p_ok)
+		*p_ok=true;
+
 	float tr = p_keys[idx].transition;
 
 	if (tr==0 || idx==next) {
@@ -1335,7 +1578,61 @@ T Animation::_interpolate( const Vector< TKey<T> >& p_keys, float p_time,  Inter
 }
 
 
-Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 * r_loc, Quat *r_rot, Vector3 *r_scale) const {
+bool Animation::_transform_track_span(const TransformTrack *p_track, float p_time, int *p_hint, TransformKey& r_from, TransformKey& r_to, float &r_c) const {
+
+	int len,idx,next;
+	float tr;
+
+	if (p_track->compressed) {
+
+		if (!_find_interval(p_track->packed.times,p_time,p_hint,len,idx,next,r_c))
+			return false;
+		tr = p_track->packed.transitions.size()?p_track->packed.transitions[idx]:1.0;
+	} else {
+
+		if (!_find_interval(p_track->transforms,p_time,p_hint,len,idx,next,r_c))
+			return false;
+		tr = p_track->transforms[idx].transition;
+	}
+
+	_transform_key_get(p_track,idx,r_from);
+
+	if (tr==0 || idx==next || p_track->interpolation==INTERPOLATION_NEAREST) {
+		// don't interpolate if not needed
+		r_to=r_from;
+		r_c=0;
+		return true;
+	}
+
+	if (tr!=1.0) {
+
+		r_c = Math::ease(r_c,tr);
+	}
+
+	_transform_key_get(p_track,next,r_to);
+
+	if (p_track->interpolation==INTERPOLATION_CUBIC) {
+
+		int pre = idx-1;
+		if (pre<0)
+			pre=0;
+		int post = next+1;
+		if (post>=len)
+			post=next;
+
+		TransformKey pre_key,post_key;
+		_transform_key_get(p_track,pre,pre_key);
+		_transform_key_get(p_track,post,post_key);
+
+		r_from=_cubic_interpolate(pre_key,r_from,r_to,post_key,r_c);
+		r_to=r_from;
+		r_c=0;
+	}
+
+	return true;
+}
+
+Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 * r_loc, Quat *r_rot, Vector3 *r_scale, int *p_key_hint) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(),ERR_INVALID_PARAMETER);
 	Track *t=tracks[p_track];
@@ -1343,13 +1640,14 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 	
 	TransformTrack * tt = static_cast<TransformTrack*>(t);
 
-	bool ok;
-
-	TransformKey tk = _interpolate( tt->transforms, p_time, tt->interpolation, &ok );
+	TransformKey from,to;
+	float c;
 
-	if (!ok) // ??
+	if (!_transform_track_span(tt,p_time,p_key_hint,from,to,c)) // ??
 		return ERR_UNAVAILABLE;
 
+	TransformKey tk = c==0 ? from : _interpolate(from,to,c);
+
 	if (r_loc)
 		*r_loc=tk.loc;
 
@@ -1363,6 +1661,136 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 
 }
 
+// acos for 0<=x<=1 (Abramowitz & Stegun 4.4.46)
+static _FORCE_INLINE_ Simd4 _simd_acos_unit(const Simd4& p_x) {
+
+	Simd4 p(-0.0012624911);
+	p=p*p_x+Simd4(0.0066700901);
+	p=p*p_x+Simd4(-0.0170881256);
+	p=p*p_x+Simd4(0.0308918810);
+	p=p*p_x+Simd4(-0.0501743046);
+	p=p*p_x+Simd4(0.0889789874);
+	p=p*p_x+Simd4(-0.2145988016);
+	p=p*p_x+Simd4(1.5707963050);
+	return (Simd4(1.0)-p_x).max(Simd4(0.0)).sqrt()*p;
+}
+
+// sin for 0<=x<=pi/2
+static _FORCE_INLINE_ Simd4 _simd_sin_quadrant(const Simd4& p_x) {
+
+	Simd4 x2=p_x*p_x;
+	Simd4 p(-1.0/39916800.0);
+	p=p*x2+Simd4(1.0/362880.0);
+	p=p*x2+Simd4(-1.0/5040.0);
+	p=p*x2+Simd4(1.0/120.0);
+	p=p*x2+Simd4(-1.0/6.0);
+	p=p*x2+Simd4(1.0);
+	return p*p_x;
+}
+
+void Animation::transform_tracks_interpolate(const int *p_tracks, int p_count, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, bool *r_ok, int *p_key_hints) const {
+
+	enum {
+		LOC_X, LOC_Y, LOC_Z,
+		ROT_X, ROT_Y, ROT_Z, ROT_W,
+		SCALE_X, SCALE_Y, SCALE_Z,
+		COMPONENTS
+	};
+
+	// four tracks at a time: find and decode their spans, then lerp and slerp them lane by lane
+	for(int from=0;from<p_count;from+=4) {
+
+		real_t a[COMPONENTS][4];
+		real_t b[COMPONENTS][4];
+		real_t c[4];
+		int lanes=MIN(4,p_count-from);
+
+		for(int i=0;i<4;i++) {
+
+			TransformKey ka,kb;
+			float kc=0;
+			bool ok=false;
+
+			if (i<lanes) {
+
+				int track=p_tracks[from+i];
+				ok = track>=0 && track<tracks.size() && tracks[track]->type==TYPE_TRANSFORM;
+				ok = ok && _transform_track_span(static_cast<const TransformTrack*>(tracks[track]),p_time,p_key_hints?&p_key_hints[from+i]:NULL,ka,kb,kc);
+				r_ok[from+i]=ok;
+			}
+
+			if (!ok) {
+				ka=kb=TransformKey();
+				kc=0;
+			}
+
+			a[LOC_X][i]=ka.loc.x; a[LOC_Y][i]=ka.loc.y; a[LOC_Z][i]=ka.loc.z;
+			a[ROT_X][i]=ka.rot.x; a[ROT_Y][i]=ka.rot.y; a[ROT_Z][i]=ka.rot.z; a[ROT_W][i]=ka.rot.w;
+			a[SCALE_X][i]=ka.scale.x; a[SCALE_Y][i]=ka.scale.y; a[SCALE_Z][i]=ka.scale.z;
+			b[LOC_X][i]=kb.loc.x; b[LOC_Y][i]=kb.loc.y; b[LOC_Z][i]=kb.loc.z;
+			b[ROT_X][i]=kb.rot.x; b[ROT_Y][i]=kb.rot.y; b[ROT_Z][i]=kb.rot.z; b[ROT_W][i]=kb.rot.w;
+			b[SCALE_X][i]=kb.scale.x; b[SCALE_Y][i]=kb.scale.y; b[SCALE_Z][i]=kb.scale.z;
+			c[i]=kc;
+		}
+
+		Simd4 t=Simd4::load(c);
+		real_t res[COMPONENTS][4];
+
+		{ //loc and scale, lerp
+
+			static const int lerped[6]={LOC_X,LOC_Y,LOC_Z,SCALE_X,SCALE_Y,SCALE_Z};
+			for(int i=0;i<6;i++) {
+
+				Simd4 va=Simd4::load(a[lerped[i]]);
+				Simd4 vb=Simd4::load(b[lerped[i]]);
+				(va+(vb-va)*t).store(res[lerped[i]]);
+			}
+		}
+
+		{ //rot, slerp as Quat::slerp does it
+
+			Simd4 ax=Simd4::load(a[ROT_X]), ay=Simd4::load(a[ROT_Y]), az=Simd4::load(a[ROT_Z]), aw=Simd4::load(a[ROT_W]);
+			Simd4 bx=Simd4::load(b[ROT_X]), by=Simd4::load(b[ROT_Y]), bz=Simd4::load(b[ROT_Z]), bw=Simd4::load(b[ROT_W]);
+
+			Simd4 cosom=ax*bx+ay*by+az*bz+aw*bw;
+			// adjust signs (if necessary)
+			Simd4 flip=cosom.less(Simd4(0.0));
+			bx=Simd4::select(flip,-bx,bx);
+			by=Simd4::select(flip,-by,by);
+			bz=Simd4::select(flip,-bz,bz);
+			bw=Simd4::select(flip,-bw,bw);
+			cosom=cosom.abs().min(Simd4(1.0));
+
+			Simd4 one(1.0);
+			Simd4 omega=_simd_acos_unit(cosom);
+			Simd4 sinom=_simd_sin_quadrant(omega);
+			Simd4 scale0=_simd_sin_quadrant((one-t)*omega)/sinom;
+			Simd4 scale1=_simd_sin_quadrant(t*omega)/sinom;
+
+			// "from" and "to" quaternions are very close, lerp
+			Simd4 standard=(one-cosom).greater(Simd4(CMP_EPSILON));
+			scale0=Simd4::select(standard,scale0,one-t);
+			scale1=Simd4::select(standard,scale1,t);
+
+			(ax*scale0+bx*scale1).store(res[ROT_X]);
+			(ay*scale0+by*scale1).store(res[ROT_Y]);
+			(az*scale0+bz*scale1).store(res[ROT_Z]);
+			(aw*scale0+bw*scale1).store(res[ROT_W]);
+		}
+
+		for(int i=0;i<lanes;i++) {
+
+			int idx=from+i;
+			if (r_loc)
+				r_loc[idx]=Vector3(res[LOC_X][i],res[LOC_Y][i],res[LOC_Z][i]);
+			if (r_rot)
+				r_rot[idx]=Quat(res[ROT_X][i],res[ROT_Y][i],res[ROT_Z][i],res[ROT_W][i]);
+			if (r_scale)
+				r_scale[idx]=Vector3(res[SCALE_X][i],res[SCALE_Y][i],res[SCALE_Z][i]);
+		}
+	}
+}
+
 Variant Animation::value_track_interpolate(int p_track, float p_time) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(),0);
@@ -1676,6 +2104,8 @@ void Animation::_bind_methods() {
 
 
 	ObjectTypeDB::bind_method(_MD("transform_track_interpolate","idx","time_sec"),&Animation::_transform_track_interpolate);
+	ObjectTypeDB::bind_method(_MD("transform_track_compress","idx","max_error"),&Animation::transform_track_compress,DEFVAL(0.001));
+	ObjectTypeDB::bind_method(_MD("transform_track_is_compressed","idx"),&Animation::transform_track_is_compressed);
 	ObjectTypeDB::bind_method(_MD("value_track_set_continuous","idx","continuous"),&Animation::value_track_set_continuous);
 	ObjectTypeDB::bind_method(_MD("value_track_is_continuous","idx"),&Animation::value_track_is_continuous);
 	
@@ -1695,6 +2125,7 @@ void Animation::_bind_methods() {
 	ObjectTypeDB::bind_method(_MD("get_step"),&Animation::get_step);
 
 	ObjectTypeDB::bind_method(_MD("clear"),&Animation::clear);
+	ObjectTypeDB::bind_method(_MD("compress","max_error"),&Animation::compress,DEFVAL(0.001));
 
 	BIND_CONSTANT( TYPE_VALUE );
 	BIND_CONSTANT( TYPE_TRANSFORM );
@@ -1721,6 +2152,9 @@ void Animation::_transform_track_optimize(int p_idx,float p_allowed_err) {
 	ERR_FAIL_INDEX(p_idx,tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type!=TYPE_TRANSFORM);
 	TransformTrack *tt= static_cast<TransformTrack*>(tracks[p_idx]);
+	if (tt->compressed)
+		return; //already fitted when compressed
+
 	for(int i=1;i<tt->transforms.size()-1;i++) {
 
 		TKey<TransformKey> &t0 = tt->transforms[i-1];
@@ -1905,6 +2339,215 @@ void Animation::_transform_track_optimize(int p_idx,float p_allowed_err) {
 
 }
 
+static _FORCE_INLINE_ real_t _rot_error(const Quat& p_a, const Quat& p_b) {
+
+	// angle between the rotations, from the chord (acos of the dot loses too much precision near 1)
+	Quat d = p_a.dot(p_b)<0 ? p_a+p_b : p_a-p_b;
+	real_t chord = MIN(Math::sqrt(d.dot(d))*0.5,1.0);
+	return 4.0*Math::asin(chord);
+}
+
+static _FORCE_INLINE_ uint16_t _quantize(real_t p_value, real_t p_base, real_t p_step) {
+
+	if (p_step<=0)
+		return 0;
+	int q=int((p_value-p_base)/p_step+0.5);
+	return CLAMP(q,0,65535);
+}
+
+static _FORCE_INLINE_ int16_t _quantize_unit(real_t p_value) {
+
+	int q=int(Math::floor(p_value*32767.0+0.5));
+	return CLAMP(q,-32767,32767);
+}
+
+bool Animation::transform_track_compress(int p_track, float p_max_error) {
+
+	ERR_FAIL_INDEX_V(p_track,tracks.size(),false);
+	ERR_FAIL_COND_V(tracks[p_track]->type!=TYPE_TRANSFORM,false);
+
+	TransformTrack *tt=static_cast<TransformTrack*>(tracks[p_track]);
+	if (tt->compressed)
+		return true;
+
+	const Vector< TKey<TransformKey> > &keys=tt->transforms;
+	int count=keys.size();
+	if (count==0)
+		return false;
+
+	const TKey<TransformKey> *k=keys.ptr();
+
+	// channels that stay within the error of the first key are stored once
+
+	uint32_t channels=0;
+	AABB loc_range(k[0].value.loc,Vector3());
+	AABB scale_range(k[0].value.scale,Vector3());
+	bool transitions=false;
+
+	for(int i=0;i<count;i++) {
+
+		const TransformKey &tk=k[i].value;
+		if (Math::abs(tk.rot.length()-1.0)>p_max_error)
+			return false; //decoding normalizes, can't keep these
+
+		if (tk.loc.distance_to(k[0].value.loc)>p_max_error)
+			channels|=CHANNEL_LOC;
+		if (_rot_error(tk.rot,k[0].value.rot)>p_max_error)
+			channels|=CHANNEL_ROT;
+		if (tk.scale.distance_to(k[0].value.scale)>p_max_error)
+			channels|=CHANNEL_SCALE;
+
+		loc_range.expand_to(tk.loc);
+		scale_range.expand_to(tk.scale);
+		if (k[i].transition!=1.0)
+			transitions=true;
+	}
+
+	// quantization has to leave room in the error for fitting the keys
+
+	Vector3 loc_step = (channels&CHANNEL_LOC) ? loc_range.size/65535.0 : Vector3();
+	Vector3 scale_step = (channels&CHANNEL_SCALE) ? scale_range.size/65535.0 : Vector3();
+	real_t loc_err = p_max_error - loc_step.length()*0.5;
+	real_t rot_err = p_max_error - ((channels&CHANNEL_ROT) ? 2.0/32767.0 : 0);
+	real_t scale_err = p_max_error - scale_step.length()*0.5;
+
+	if (loc_err<=0 || rot_err<=0 || scale_err<=0)
+		return false; //range too large for the error asked
+
+	// fit the keys: keep first and last, drop the ones interpolating their kept neighbours reproduces
+
+	int last=count-1;
+	while(last>0 && k[last].time>length)
+		last--; // keys past the end are kept as they are
+
+	Vector<int> kept;
+	kept.push_back(0);
+
+	if (tt->interpolation==INTERPOLATION_NEAREST) {
+
+		int prev=0;
+		for(int i=1;i<=last;i++) {
+
+			const TransformKey &a=k[prev].value;
+			const TransformKey &b=k[i].value;
+			if (i==last || a.loc.distance_to(b.loc)>loc_err || _rot_error(a.rot,b.rot)>rot_err || a.scale.distance_to(b.scale)>scale_err) {
+				kept.push_back(i);
+				prev=i;
+			}
+		}
+
+	} else if (tt->interpolation==INTERPOLATION_LINEAR && !transitions) {
+
+		int from=0;
+		while(from<last) {
+
+			int to=from+1;
+
+			while(to<last) {
+
+				// can from reach to+1 with every key in between within the error?
+				int end=to+1;
+				float span=k[end].time-k[from].time;
+				bool fits=span>CMP_EPSILON;
+
+				for(int i=from+1;fits && i<end;i++) {
+
+					float c=(k[i].time-k[from].time)/span;
+					TransformKey v=_interpolate(k[from].value,k[end].value,c);
+					const TransformKey &kv=k[i].value;
+
+					if ((channels&CHANNEL_LOC) && v.loc.distance_to(kv.loc)>loc_err)
+						fits=false;
+					else if ((channels&CHANNEL_ROT) && _rot_error(v.rot.normalized(),kv.rot)>rot_err)
+						fits=false;
+					else if ((channels&CHANNEL_SCALE) && v.scale.distance_to(kv.scale)>scale_err)
+						fits=false;
+				}
+
+				if (!fits)
+					break;
+				to=end;
+			}
+
+			kept.push_back(to);
+			from=to;
+		}
+
+	} else {
+		//cubic curves (and eased linear ones) don't interpolate linearly, keep every key
+		for(int i=1;i<=last;i++)
+			kept.push_back(i);
+	}
+
+	for(int i=last+1;i<count;i++)
+		kept.push_back(i);
+
+	// pack
+
+	CompressedTransforms packed;
+	packed.channels=channels;
+	packed.stride=((channels&CHANNEL_LOC)?3:0)+((channels&CHANNEL_ROT)?4:0)+((channels&CHANNEL_SCALE)?3:0);
+	packed.constant=k[0].value;
+	packed.loc_base=loc_range.pos;
+	packed.loc_step=loc_step;
+	packed.scale_base=scale_range.pos;
+	packed.scale_step=scale_step;
+
+	int kc=kept.size();
+	packed.times.resize(kc);
+	packed.data.resize(kc*packed.stride);
+	if (transitions)
+		packed.transitions.resize(kc);
+
+	uint16_t *w=packed.data.ptr();
+
+	for(int i=0;i<kc;i++) {
+
+		const TKey<TransformKey> &key=k[kept[i]];
+		packed.times[i].time=key.time;
+		if (transitions)
+			packed.transitions[i]=key.transition;
+
+		if (channels&CHANNEL_LOC) {
+
+			*w++=_quantize(key.value.loc.x,loc_range.pos.x,loc_step.x);
+			*w++=_quantize(key.value.loc.y,loc_range.pos.y,loc_step.y);
+			*w++=_quantize(key.value.loc.z,loc_range.pos.z,loc_step.z);
+		}
+
+		if (channels&CHANNEL_ROT) {
+
+			Quat rot=key.value.rot.normalized();
+			*w++=uint16_t(_quantize_unit(rot.x));
+			*w++=uint16_t(_quantize_unit(rot.y));
+			*w++=uint16_t(_quantize_unit(rot.z));
+			*w++=uint16_t(_quantize_unit(rot.w));
+		}
+
+		if (channels&CHANNEL_SCALE) {
+
+			*w++=_quantize(key.value.scale.x,scale_range.pos.x,scale_step.x);
+			*w++=_quantize(key.value.scale.y,scale_range.pos.y,scale_step.y);
+			*w++=_quantize(key.value.scale.z,scale_range.pos.z,scale_step.z);
+		}
+	}
+
+	tt->packed=packed;
+	tt->compressed=true;
+	tt->transforms.clear();
+
+	emit_changed();
+	return true;
+}
+
+bool Animation::transform_track_is_compressed(int p_track) const {
+
+	ERR_FAIL_INDEX_V(p_track,tracks.size(),false);
+	ERR_FAIL_COND_V(tracks[p_track]->type!=TYPE_TRANSFORM,false);
+
+	return static_cast<const TransformTrack*>(tracks[p_track])->compressed;
+}
+
 void Animation::optimize(float p_allowed_err) {
 
 
@@ -1920,6 +2563,15 @@ void Animation::optimize(float p_allowed_err) {
 }
 
 
+void Animation::compress(float p_max_error) {
+
+	for(int i=0;i<tracks.size();i++) {
+
+		if (tracks[i]->type==TYPE_TRANSFORM)
+			transform_track_compress(i,p_max_error);
+	}
+}
+
 Animation::Animation() {
 
 	step=0.1;
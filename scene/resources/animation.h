@@ -92,13 +92,44 @@ private:
 		Vector3 scale;
 	};
 
+	/* COMPRESSED TRANSFORM KEYS */
+
+	enum {
+		CHANNEL_LOC=1,
+		CHANNEL_ROT=2,
+		CHANNEL_SCALE=4
+	};
+
+	struct PackedTime {
+
+		float time;
+	};
+
+	// channels that change are stored per key, quantized to 16 bits per component.
+	// the others are kept once in "constant".
+	struct CompressedTransforms {
+
+		uint32_t channels;
+		int stride; // uint16_t per key
+		TransformKey constant;
+		Vector3 loc_base,loc_step; // loc = loc_base + q * loc_step
+		Vector3 scale_base,scale_step;
+		Vector<PackedTime> times;
+		Vector<float> transitions; // empty when all are 1
+		Vector<uint16_t> data;
+
+		CompressedTransforms() { channels=0; stride=0; }
+	};
+
 	/* TRANSFORM TRACK */
 	
 	struct TransformTrack : public Track {
 
 		Vector< TKey<TransformKey> > transforms;
+		bool compressed; // keys live in "packed" instead of "transforms"
+		CompressedTransforms packed;
 		
-		TransformTrack() { type=TYPE_TRANSFORM; }
+		TransformTrack() { type=TYPE_TRANSFORM; compressed=false; }
 	};
 	
 	/* PROPERTY VALUE TRACK */
@@ -140,6 +171,10 @@ private:
 
 	template<class K>
 	inline int _find( const Vector<K>& p_keys, float p_time) const;
+	template<class K>
+	_FORCE_INLINE_ int _find_hinted( const Vector<K>& p_keys, float p_time, int p_hint) const;
+	template<class K>
+	_FORCE_INLINE_ bool _find_interval( const Vector<K>& p_keys, float p_time, int *p_hint, int &r_len, int &r_idx, int &r_next, float &r_c) const;
 	
 	_FORCE_INLINE_ Animation::TransformKey _interpolate( const Animation::TransformKey& p_a, const Animation::TransformKey& p_b, float p_c) const;
 
@@ -155,7 +190,13 @@ private:
 	_FORCE_INLINE_ float _cubic_interpolate( const float& p_pre_a,const float& p_a, const float& p_b, const float& p_post_b, float p_c) const;
 
 	template<class T>
-	_FORCE_INLINE_ T _interpolate( const Vector< TKey<T> >& p_keys, float p_time, InterpolationType p_interp,bool *p_ok) const;
+	_FORCE_INLINE_ T _interpolate( const Vector< TKey<T> >& p_keys, float p_time, InterpolationType p_interp,bool *p_ok,int *p_hint=NULL) const;
+
+	_FORCE_INLINE_ int _transform_key_count(const TransformTrack *p_track) const { return p_track->compressed?p_track->packed.times.size():p_track->transforms.size(); }
+	_FORCE_INLINE_ void _transform_key_decode(const CompressedTransforms& p_packed, int p_key, TransformKey& r_key) const;
+	_FORCE_INLINE_ void _transform_key_get(const TransformTrack *p_track, int p_key, TransformKey& r_key) const;
+	_FORCE_INLINE_ bool _transform_track_span(const TransformTrack *p_track, float p_time, int *p_hint, TransformKey& r_from, TransformKey& r_to, float &r_c) const;
+	void _transform_track_decompress(TransformTrack *p_track);
 
 	_FORCE_INLINE_ void _value_track_get_key_indices_in_range(const ValueTrack * vt, float from_time, float to_time,List<int> *p_indices) const;
 	_FORCE_INLINE_ void _method_track_get_key_indices_in_range(const MethodTrack * mt, float from_time, float to_time,List<int> *p_indices) const;
@@ -248,7 +289,11 @@ public:
 	InterpolationType track_get_interpolation_type(int p_track) const;
 
 	
-	Error transform_track_interpolate(int p_track, float p_time, Vector3 * r_loc, Quat *r_rot, Vector3 *r_scale) const;
+	Error transform_track_interpolate(int p_track, float p_time, Vector3 * r_loc, Quat *r_rot, Vector3 *r_scale, int *p_key_hint=NULL) const;
+	void transform_tracks_interpolate(const int *p_tracks, int p_count, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, bool *r_ok, int *p_key_hints=NULL) const;
+
+	bool transform_track_compress(int p_track, float p_max_error=0.001);
+	bool transform_track_is_compressed(int p_track) const;
 	
 	Variant value_track_interpolate(int p_track, float p_time) const;
 	void value_track_get_key_indices(int p_track, float p_time, float p_delta,List<int> *p_indices) const;
@@ -272,6 +317,7 @@ public:
 	void clear();
 
 	void optimize(float p_allowed_err=0.05);
+	void compress(float p_max_error=0.001);
 
 	Animation();	
 	~Animation();
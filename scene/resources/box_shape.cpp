@@ -32,7 +32,7 @@
 
 void BoxShape::_update_shape() {
 
-	PhysicsServer::get_singleton()->shape_set_data(get_shape(),extents);
+	_set_shape_data(extents);
 }
 
 void BoxShape::set_extents(const Vector3& p_extents) {
@@ -58,7 +58,7 @@ void BoxShape::_bind_methods() {
 
 }
 
-BoxShape::BoxShape() : Shape( PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_BOX)) {
+BoxShape::BoxShape() : Shape(PhysicsServer::SHAPE_BOX) {
 
 	set_extents(Vector3(1,1,1));
 }
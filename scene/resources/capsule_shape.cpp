@@ -36,7 +36,7 @@ void CapsuleShape::_update_shape() {
 	Dictionary d;
 	d["radius"]=radius;
 	d["height"]=height;
-	PhysicsServer::get_singleton()->shape_set_data(get_shape(),d);
+	_set_shape_data(d);
 }
 
 void CapsuleShape::set_radius(float p_radius) {
@@ -78,7 +78,7 @@ void CapsuleShape::_bind_methods() {
 
 }
 
-CapsuleShape::CapsuleShape() : Shape( PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_CAPSULE)) {
+CapsuleShape::CapsuleShape() : Shape(PhysicsServer::SHAPE_CAPSULE) {
 
 	radius=1.0;
 	height=1.0;
@@ -33,7 +33,7 @@
 bool ConcavePolygonShape::_set(const StringName& p_name, const Variant& p_value) {
 
 	if (p_name=="data")
-		PhysicsServer::get_singleton()->shape_set_data(get_shape(),p_value);
+		_set_shape_data(p_value);
 	else
 		return false;
 
@@ -44,7 +44,7 @@ bool ConcavePolygonShape::_set(const StringName& p_name, const Variant& p_value)
 bool ConcavePolygonShape::_get(const StringName& p_name,Variant &r_ret) const {
 
 	if (p_name=="data")
-		r_ret=PhysicsServer::get_singleton()->shape_get_data(get_shape());
+		r_ret=_get_shape_data();
 	else
 		return false;
 	return true;
@@ -62,13 +62,13 @@ void ConcavePolygonShape::_update_shape() {
 
 void ConcavePolygonShape::set_faces(const DVector<Vector3>& p_faces) {
 
-	PhysicsServer::get_singleton()->shape_set_data(get_shape(),p_faces);
+	_set_shape_data(p_faces);
 	notify_change_to_owners();
 }
 
 DVector<Vector3> ConcavePolygonShape::get_faces() const {
 
-	return PhysicsServer::get_singleton()->shape_get_data(get_shape());
+	return _get_shape_data();
 
 }
 
@@ -80,7 +80,7 @@ void ConcavePolygonShape::_bind_methods() {
 	ObjectTypeDB::bind_method(_MD("get_faces"),&ConcavePolygonShape::get_faces);
 }
 
-ConcavePolygonShape::ConcavePolygonShape() : Shape( PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_CONCAVE_POLYGON)) {
+ConcavePolygonShape::ConcavePolygonShape() : Shape(PhysicsServer::SHAPE_CONCAVE_POLYGON) {
 
 	//set_planes(Vector3(1,1,1));
 }
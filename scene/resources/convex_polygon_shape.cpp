@@ -33,7 +33,7 @@
 
 void ConvexPolygonShape::_update_shape() {
 
-	PhysicsServer::get_singleton()->shape_set_data(get_shape(),points);
+	_set_shape_data(points);
 	emit_changed();
 }
 
@@ -59,7 +59,7 @@ void ConvexPolygonShape::_bind_methods() {
 
 }
 
-ConvexPolygonShape::ConvexPolygonShape() : Shape( PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_CONVEX_POLYGON)) {
+ConvexPolygonShape::ConvexPolygonShape() : Shape(PhysicsServer::SHAPE_CONVEX_POLYGON) {
 
 	//set_points(Vector3(1,1,1));
 }
@@ -40,6 +40,13 @@ Node *PackedScene::instance(bool p_gen_edit_state) const {
 	int nc = nodes.size();
 	ERR_FAIL_COND_V(nc==0,NULL);
 
+	if (!p_gen_edit_state && pool.size()) {
+
+		Node *pooled = pool[pool.size()-1];
+		pool.resize(pool.size()-1);
+		return pooled;
+	}
+
 	const StringName*snames=NULL;
 	int sname_count=names.size();
 	if (sname_count)
@@ -50,9 +57,11 @@ Node *PackedScene::instance(bool p_gen_edit_state) const {
 	if (prop_count)
 		props=&variants[0];
 
-	Vector<Variant> properties;
-
 	const NodeData *nd = &nodes[0];
+	const Property *pdata = properties.ptr();
+	const int *gdata = groups.ptr();
+	const ObjectTypeDB::CreationFunc *creators = node_creators.ptr();
+	MethodBind * const *setters = property_setters.ptr();
 
 	Node **ret_nodes=(Node**)alloca( sizeof(Node*)*nc );
 
@@ -61,7 +70,7 @@ Node *PackedScene::instance(bool p_gen_edit_state) const {
 
 		const NodeData &n=nd[i];
 
-		if (!ObjectTypeDB::is_type_enabled(snames[n.type])) {
+		if (!creators[i]) {
 			ret_nodes[i]=NULL;
 			continue;
 		}
@@ -79,7 +88,7 @@ Node *PackedScene::instance(bool p_gen_edit_state) const {
 
 		} else {
 			//create anew
-			Object * obj = ObjectTypeDB::instance(snames[ n.type ]);
+			Object * obj = creators[i]();
 			ERR_FAIL_COND_V(!obj,NULL);
 			node = obj->cast_to<Node>();
 			ERR_FAIL_COND_V(!node,NULL);
@@ -88,10 +97,10 @@ Node *PackedScene::instance(bool p_gen_edit_state) const {
 
 
 		//properties
-		int nprop_count=n.properties.size();
+		int nprop_count=n.property_count;
 		if (nprop_count) {
 
-			const NodeData::Property* nprops=&n.properties[0];
+			const Property* nprops=&pdata[n.property_ofs];
 
 			for(int j=0;j<nprop_count;j++) {
 
@@ -99,17 +108,25 @@ Node *PackedScene::instance(bool p_gen_edit_state) const {
 				ERR_FAIL_INDEX_V( nprops[j].name, sname_count, NULL );
 				ERR_FAIL_INDEX_V( nprops[j].value, prop_count, NULL );
 
-				node->set(snames[ nprops[j].name ],props[ nprops[j].value ],&valid);
+				MethodBind *setter = setters[n.property_ofs+j];
+				if (setter && !node->get_script_instance()) {
+					const Variant* arg[1]={&props[ nprops[j].value ]};
+					Variant::CallError ce;
+					setter->call(node,arg,1,ce);
+				} else {
+					node->set(snames[ nprops[j].name ],props[ nprops[j].value ],&valid);
+				}
 			}
 		}
 
 		//name
 
 		//groups
-		for(int j=0;j<n.groups.size();j++) {
+		for(int j=0;j<n.group_count;j++) {
 
-			ERR_FAIL_INDEX_V( n.groups[j], sname_count, NULL );
-			node->add_to_group( snames[ n.groups[j] ], true );
+			int g = gdata[n.group_ofs+j];
+			ERR_FAIL_INDEX_V( g, sname_count, NULL );
+			node->add_to_group( snames[ g ], true );
 		}
 
 
@@ -137,6 +154,7 @@ Node *PackedScene::instance(bool p_gen_edit_state) const {
 
 	int cc = connections.size();
 	const ConnectionData *cdata = connections.ptr();
+	const int *bdata = binds.ptr();
 
 	for(int i=0;i<cc;i++) {
 
@@ -144,16 +162,16 @@ Node *PackedScene::instance(bool p_gen_edit_state) const {
 		ERR_FAIL_INDEX_V( c.from, nc, NULL );
 		ERR_FAIL_INDEX_V( c.to, nc, NULL );
 
-		Vector<Variant> binds;
-		if (c.binds.size()) {
-			binds.resize(c.binds.size());
-			for(int j=0;j<c.binds.size();j++)
-				binds[j]=props[ c.binds[j] ];
+		Vector<Variant> cbinds;
+		if (c.bind_count) {
+			cbinds.resize(c.bind_count);
+			for(int j=0;j<c.bind_count;j++)
+				cbinds[j]=props[ bdata[c.bind_ofs+j] ];
 		}
 
 		if (!ret_nodes[c.from] || !ret_nodes[c.to])
 			continue;
-		ret_nodes[c.from]->connect( snames[ c.signal], ret_nodes[ c.to ], snames[ c.method], binds,CONNECT_PERSIST|c.flags );
+		ret_nodes[c.from]->connect( snames[ c.signal], ret_nodes[ c.to ], snames[ c.method], cbinds,CONNECT_PERSIST|c.flags );
 	}
 
 	Node *s = ret_nodes[0];
@@ -221,6 +239,8 @@ Error PackedScene::_parse_node(Node *p_owner,Node *p_node,int p_parent_idx, Map<
 
 	//instance state makes sure that only changes to instance are saved
 
+	nd.property_ofs=properties.size();
+
 	List<PropertyInfo> plist;
 	p_node->get_property_list(&plist);
 	for (List<PropertyInfo>::Element *E=plist.front();E;E=E->next()) {
@@ -244,17 +264,20 @@ Error PackedScene::_parse_node(Node *p_owner,Node *p_node,int p_parent_idx, Map<
 
 		}
 
-		NodeData::Property prop;
+		Property prop;
 		prop.name=_nm_get_string( name,name_map);
 		prop.value=_vm_get_variant( value, variant_map);
-		nd.properties.push_back(prop);
+		properties.push_back(prop);
 
 	}
 
+	nd.property_count=properties.size()-nd.property_ofs;
+	nd.group_ofs=groups.size();
+
 
-	List<Node::GroupInfo> groups;
-	p_node->get_groups(&groups);
-	for(List<Node::GroupInfo>::Element *E=groups.front();E;E=E->next()) {
+	List<Node::GroupInfo> node_groups;
+	p_node->get_groups(&node_groups);
+	for(List<Node::GroupInfo>::Element *E=node_groups.front();E;E=E->next()) {
 		Node::GroupInfo &gi=E->get();
 
 		if (!gi.persistent)
@@ -262,9 +285,11 @@ Error PackedScene::_parse_node(Node *p_owner,Node *p_node,int p_parent_idx, Map<
 		if (nd.instance>=0 && instance_groups.has(gi.name))
 			continue; //group was instanced, don't add here
 
-		nd.groups.push_back(_nm_get_string(gi.name,name_map));
+		groups.push_back(_nm_get_string(gi.name,name_map));
 	}
 
+	nd.group_count=groups.size()-nd.group_ofs;
+
 	if (node_map.has(p_node->get_owner()))
 		nd.owner=node_map[p_node->get_owner()];
 	else
@@ -297,7 +322,7 @@ Error PackedScene::_parse_connections(Node *p_owner,Node *p_node, Map<StringName
 	p_node->get_signal_list(&signals);
 
 	ERR_FAIL_COND_V( !node_map.has(p_node), ERR_BUG);
-	NodeData &nd = nodes[node_map[p_node]];
+	const NodeData &nd = nodes[node_map[p_node]];
 	Set<Connection> instance_connections;
 
 	if (nd.instance>=0) {
@@ -338,9 +363,11 @@ Error PackedScene::_parse_connections(Node *p_owner,Node *p_node, Map<StringName
 			cd.method=_nm_get_string(c.method,name_map);
 			cd.signal=_nm_get_string(c.signal,name_map);
 			cd.flags=c.flags;
+			cd.bind_ofs=binds.size();
+			cd.bind_count=c.binds.size();
 			for(int i=0;i<c.binds.size();i++) {
 
-				cd.binds.push_back( _vm_get_variant(c.binds[i],variant_map));
+				binds.push_back( _vm_get_variant(c.binds[i],variant_map));
 			}
 			connections.push_back(cd);
 		}
@@ -397,6 +424,8 @@ Error PackedScene::pack(Node *p_scene) {
 		variants[idx]=*K;
 	}
 
+	_resolve_cache();
+
 	return OK;
 }
 
@@ -405,7 +434,13 @@ void PackedScene::clear() {
 	names.clear();
 	variants.clear();
 	nodes.clear();
+	properties.clear();
+	groups.clear();
 	connections.clear();
+	binds.clear();
+	node_creators.clear();
+	property_setters.clear();
+	clear_pool();
 
 }
 
@@ -414,12 +449,10 @@ void PackedScene::_set_bundled_scene(const Dictionary& d) {
 
 	ERR_FAIL_COND( !d.has("names"));
 	ERR_FAIL_COND( !d.has("variants"));
-	ERR_FAIL_COND( !d.has("node_count"));
-	ERR_FAIL_COND( !d.has("nodes"));
-	ERR_FAIL_COND( !d.has("conn_count"));
-	ERR_FAIL_COND( !d.has("conns"));
 //	ERR_FAIL_COND( !d.has("path"));
 
+	clear();
+
 	DVector<String> snames = d["names"];
 	if (snames.size()) {
 
@@ -444,6 +477,87 @@ void PackedScene::_set_bundled_scene(const Dictionary& d) {
 		variants.clear();
 	}
 
+	int version = d.has("version") ? int(d["version"]) : 1;
+
+	if (version>=BUNDLE_VERSION) {
+
+		ERR_FAIL_COND( !d.has("data"));
+		DVector<int> sdata = d["data"];
+		ERR_FAIL_COND( sdata.size()<BUNDLE_HEADER_SIZE );
+		DVector<int>::Read r = sdata.read();
+		const int *src=r.ptr();
+
+		int nc=src[0];
+		int pc=src[1];
+		int gc=src[2];
+		int cc=src[3];
+		int bc=src[4];
+		ERR_FAIL_COND( nc<0 || pc<0 || gc<0 || cc<0 || bc<0 );
+
+		const int node_size=sizeof(NodeData)/sizeof(int);
+		const int prop_size=sizeof(Property)/sizeof(int);
+		const int conn_size=sizeof(ConnectionData)/sizeof(int);
+		int64_t total = BUNDLE_HEADER_SIZE+int64_t(nc)*node_size+int64_t(pc)*prop_size+gc+int64_t(cc)*conn_size+bc;
+		ERR_FAIL_COND( total!=sdata.size() );
+		src+=BUNDLE_HEADER_SIZE;
+
+		nodes.resize(nc);
+		properties.resize(pc);
+		groups.resize(gc);
+		connections.resize(cc);
+		binds.resize(bc);
+
+		if (nc)
+			copymem(nodes.ptr(),src,nc*sizeof(NodeData));
+		src+=nc*node_size;
+		if (pc)
+			copymem(properties.ptr(),src,pc*sizeof(Property));
+		src+=pc*prop_size;
+		if (gc)
+			copymem(groups.ptr(),src,gc*sizeof(int));
+		src+=gc;
+		if (cc)
+			copymem(connections.ptr(),src,cc*sizeof(ConnectionData));
+		src+=cc*conn_size;
+		if (bc)
+			copymem(binds.ptr(),src,bc*sizeof(int));
+
+		//instance() trusts the ranges, and each property slot must belong to a single node
+		int next_prop=0;
+		int next_group=0;
+		for(int i=0;i<nc;i++) {
+
+			const NodeData &nd=nodes[i];
+			if (nd.property_ofs!=next_prop || nd.property_count<0 || nd.property_ofs>pc-nd.property_count ||
+			    nd.group_ofs!=next_group || nd.group_count<0 || nd.group_ofs>gc-nd.group_count) {
+				clear();
+				ERR_EXPLAIN("Corrupt node table in scene bundle");
+				ERR_FAIL();
+			}
+			next_prop+=nd.property_count;
+			next_group+=nd.group_count;
+		}
+		for(int i=0;i<cc;i++) {
+
+			const ConnectionData &cd=connections[i];
+			if (cd.bind_ofs<0 || cd.bind_count<0 || cd.bind_ofs>bc-cd.bind_count) {
+				clear();
+				ERR_EXPLAIN("Corrupt connection table in scene bundle");
+				ERR_FAIL();
+			}
+		}
+
+		_resolve_cache();
+		return;
+	}
+
+	//version 1, variable sized records
+
+	ERR_FAIL_COND( !d.has("node_count"));
+	ERR_FAIL_COND( !d.has("nodes"));
+	ERR_FAIL_COND( !d.has("conn_count"));
+	ERR_FAIL_COND( !d.has("conns"));
+
 	nodes.resize(d["node_count"]);
 	int nc=nodes.size();
 	if (nc) {
@@ -457,16 +571,20 @@ void PackedScene::_set_bundled_scene(const Dictionary& d) {
 			nd.type=r[idx++];
 			nd.name=r[idx++];
 			nd.instance=r[idx++];
-			nd.properties.resize(r[idx++]);
-			for(int j=0;j<nd.properties.size();j++) {
-
-				nd.properties[j].name=r[idx++];
-				nd.properties[j].value=r[idx++];
+			nd.property_ofs=properties.size();
+			nd.property_count=r[idx++];
+			for(int j=0;j<nd.property_count;j++) {
+
+				Property prop;
+				prop.name=r[idx++];
+				prop.value=r[idx++];
+				properties.push_back(prop);
 			}
-			nd.groups.resize(r[idx++]);
-			for(int j=0;j<nd.groups.size();j++) {
+			nd.group_ofs=groups.size();
+			nd.group_count=r[idx++];
+			for(int j=0;j<nd.group_count;j++) {
 
-				nd.groups[j]=r[idx++];
+				groups.push_back(r[idx++]);
 			}
 		}
 
@@ -487,16 +605,19 @@ void PackedScene::_set_bundled_scene(const Dictionary& d) {
 			cd.signal=r[idx++];
 			cd.method=r[idx++];
 			cd.flags=r[idx++];
-			cd.binds.resize(r[idx++]);
+			cd.bind_ofs=binds.size();
+			cd.bind_count=r[idx++];
 
-			for(int j=0;j<cd.binds.size();j++) {
+			for(int j=0;j<cd.bind_count;j++) {
 
-				cd.binds[j]=r[idx++];
+				binds.push_back(r[idx++]);
 			}
 		}
 
 	}
 
+	_resolve_cache();
+
 //	path=d["path"];
 
 }
@@ -518,57 +639,91 @@ Dictionary PackedScene::_get_bundled_scene() const {
 	d["names"]=rnames;
 	d["variants"]=variants;
 
-	Vector<int> rnodes;
-	d["node_count"]=nodes.size();
+	DVector<int> rdata;
+	rdata.resize(BUNDLE_HEADER_SIZE+(nodes.size()*sizeof(NodeData)+properties.size()*sizeof(Property)+groups.size()*sizeof(int)+connections.size()*sizeof(ConnectionData)+binds.size()*sizeof(int))/sizeof(int));
+	{
+		DVector<int>::Write w=rdata.write();
+		int *dst=w.ptr();
+		dst[0]=nodes.size();
+		dst[1]=properties.size();
+		dst[2]=groups.size();
+		dst[3]=connections.size();
+		dst[4]=binds.size();
+		dst+=BUNDLE_HEADER_SIZE;
+
+		copymem(dst,nodes.ptr(),nodes.size()*sizeof(NodeData));
+		dst+=nodes.size()*sizeof(NodeData)/sizeof(int);
+		copymem(dst,properties.ptr(),properties.size()*sizeof(Property));
+		dst+=properties.size()*sizeof(Property)/sizeof(int);
+		copymem(dst,groups.ptr(),groups.size()*sizeof(int));
+		dst+=groups.size();
+		copymem(dst,connections.ptr(),connections.size()*sizeof(ConnectionData));
+		dst+=connections.size()*sizeof(ConnectionData)/sizeof(int);
+		copymem(dst,binds.ptr(),binds.size()*sizeof(int));
+	}
+
+	d["data"]=rdata;
+	d["version"]=BUNDLE_VERSION;
+
+//	d["path"]=path;
+
+	return d;
+
+
+}
+
+void PackedScene::_resolve_cache() {
+
+	node_creators.resize(nodes.size());
+	property_setters.resize(properties.size());
 
 	for(int i=0;i<nodes.size();i++) {
 
-		const NodeData &nd=nodes[i];
-		rnodes.push_back(nd.parent);
-		rnodes.push_back(nd.owner);
-		rnodes.push_back(nd.type);
-		rnodes.push_back(nd.name);
-		rnodes.push_back(nd.instance);
-		rnodes.push_back(nd.properties.size());
-		for(int j=0;j<nd.properties.size();j++) {
-
-			rnodes.push_back(nd.properties[j].name);
-			rnodes.push_back(nd.properties[j].value);
-		}
-		rnodes.push_back(nd.groups.size());
-		for(int j=0;j<nd.groups.size();j++) {
+		const NodeData &n=nodes[i];
+		ObjectTypeDB::CreationFunc creator=NULL;
+		if (n.type>=0 && n.type<names.size())
+			creator=ObjectTypeDB::get_creation_func(names[n.type]);
+		node_creators[i]=creator;
+
+		for(int j=0;j<n.property_count;j++) {
 
-			rnodes.push_back(nd.groups[j]);
+			const Property &p=properties[n.property_ofs+j];
+			MethodBind *setter=NULL;
+			//setters can only be called directly on objects created here, instances may be of other types
+			if (creator && n.instance<0 && p.name>=0 && p.name<names.size())
+				setter=ObjectTypeDB::get_property_setter(names[n.type],names[p.name]);
+			property_setters[n.property_ofs+j]=setter;
 		}
 	}
+}
 
-	d["nodes"]=rnodes;
-
-	Vector<int> rconns;
-	d["conn_count"]=connections.size();
+void PackedScene::fill_pool(int p_count) {
 
-	for(int i=0;i<connections.size();i++) {
+	//instance() must not pop from the pool while it is being filled
+	Vector<Node*> filled = pool;
+	pool.clear();
 
-		const ConnectionData &cd=connections[i];
-		rconns.push_back(cd.from);
-		rconns.push_back(cd.to);
-		rconns.push_back(cd.signal);
-		rconns.push_back(cd.method);
-		rconns.push_back(cd.flags);
-		rconns.push_back(cd.binds.size());
-		for(int j=0;j<cd.binds.size();j++)
-			rconns.push_back(cd.binds[j]);
+	for(int i=0;i<p_count;i++) {
 
+		Node *n = instance();
+		if (!n)
+			break;
+		filled.push_back(n);
 	}
 
-	d["conns"]=rconns;
-	d["version"]=1;
+	pool=filled;
+}
 
-//	d["path"]=path;
+void PackedScene::clear_pool() {
 
-	return d;
+	for(int i=0;i<pool.size();i++)
+		memdelete(pool[i]);
+	pool.clear();
+}
 
+int PackedScene::get_pool_size() const {
 
+	return pool.size();
 }
 
 void PackedScene::_bind_methods() {
@@ -576,6 +731,9 @@ void PackedScene::_bind_methods() {
 	ObjectTypeDB::bind_method(_MD("pack","path:Node"),&PackedScene::pack);
 	ObjectTypeDB::bind_method(_MD("instance:Node"),&PackedScene::instance,DEFVAL(false));
 	ObjectTypeDB::bind_method(_MD("can_instance"),&PackedScene::can_instance);
+	ObjectTypeDB::bind_method(_MD("fill_pool","count"),&PackedScene::fill_pool);
+	ObjectTypeDB::bind_method(_MD("clear_pool"),&PackedScene::clear_pool);
+	ObjectTypeDB::bind_method(_MD("get_pool_size"),&PackedScene::get_pool_size);
 	ObjectTypeDB::bind_method(_MD("_set_bundled_scene"),&PackedScene::_set_bundled_scene);
 	ObjectTypeDB::bind_method(_MD("_get_bundled_scene"),&PackedScene::_get_bundled_scene);
 
@@ -587,3 +745,8 @@ PackedScene::PackedScene() {
 
 
 }
+
+PackedScene::~PackedScene() {
+
+	clear_pool();
+}
@@ -44,6 +44,8 @@ class PackedScene : public Resource {
 	//missing - owner
 	//missing - override names and values
 
+	//all tables are flat arrays of ints, so they are saved and loaded as a single block
+
 	struct NodeData {
 
 		int parent;
@@ -51,19 +53,21 @@ class PackedScene : public Resource {
 		int type;
 		int name;
 		int instance;
+		int property_ofs;
+		int property_count;
+		int group_ofs;
+		int group_count;
+	};
 
-		struct Property {
-
-			int name;
-			int value;
-		};
+	struct Property {
 
-		Vector<Property> properties;
-		Vector<int> groups;
+		int name;
+		int value;
 	};
 
-
 	Vector<NodeData> nodes;
+	Vector<Property> properties;
+	Vector<int> groups;
 
 	struct ConnectionData {
 
@@ -72,15 +76,30 @@ class PackedScene : public Resource {
 		int signal;
 		int method;
 		int flags;
-		Vector<int> binds;
+		int bind_ofs;
+		int bind_count;
 	};
 
 	Vector<ConnectionData> connections;
+	Vector<int> binds;
+
+	enum {
+		BUNDLE_VERSION=2,
+		BUNDLE_HEADER_SIZE=5
+	};
 
 	Error _parse_node(Node *p_owner,Node *p_node,int p_parent_idx, Map<StringName,int> &name_map,HashMap<Variant,int,VariantHasher> &variant_map,Map<Node*,int> &node_map);
 	Error _parse_connections(Node *p_owner,Node *p_node, Map<StringName,int> &name_map,HashMap<Variant,int,VariantHasher> &variant_map,Map<Node*,int> &node_map);
 
 
+	//resolved once, so instancing does not look up types or setters by name
+	Vector<ObjectTypeDB::CreationFunc> node_creators;
+	Vector<MethodBind*> property_setters; //NULL means going through Object::set
+
+	mutable Vector<Node*> pool;
+
+	void _resolve_cache();
+
 	void _set_bundled_scene(const Dictionary& p_scene);
 	Dictionary _get_bundled_scene() const;
 
@@ -98,7 +117,12 @@ public:
 	bool can_instance() const;
 	Node *instance(bool p_gen_edit_state=false) const;
 
+	void fill_pool(int p_count);
+	void clear_pool();
+	int get_pool_size() const;
+
 	PackedScene();
+	~PackedScene();
 };
 
 #endif // SCENE_PRELOADER_H
@@ -34,7 +34,7 @@
 
 void PlaneShape::_update_shape() {
 
-	PhysicsServer::get_singleton()->shape_set_data(get_shape(),plane);
+	_set_shape_data(plane);
 }
 
 void PlaneShape::set_plane(Plane p_plane) {
@@ -60,7 +60,7 @@ void PlaneShape::_bind_methods() {
 
 }
 
-PlaneShape::PlaneShape() : Shape( PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_PLANE)) {
+PlaneShape::PlaneShape() : Shape(PhysicsServer::SHAPE_PLANE) {
 
 	set_plane(Plane(0,1,0,0));
 }
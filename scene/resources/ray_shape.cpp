@@ -34,7 +34,7 @@
 
 void RayShape::_update_shape() {
 
-	PhysicsServer::get_singleton()->shape_set_data(get_shape(),length);
+	_set_shape_data(length);
 	emit_changed();
 }
 
@@ -60,7 +60,7 @@ void RayShape::_bind_methods() {
 
 }
 
-RayShape::RayShape() : Shape( PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_RAY)) {
+RayShape::RayShape() : Shape(PhysicsServer::SHAPE_RAY) {
 
 	set_length(1.0);
 }
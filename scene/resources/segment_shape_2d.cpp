@@ -35,7 +35,7 @@ void SegmentShape2D::_update_shape() {
 	Rect2 r;
 	r.pos=a;
 	r.size=b;
-	Physics2DServer::get_singleton()->shape_set_data(get_rid(),r);
+	_set_shape_data(r);
 	emit_changed();
 
 }
@@ -76,7 +76,7 @@ void SegmentShape2D::_bind_methods() {
 
 }
 
-SegmentShape2D::SegmentShape2D() : Shape2D( Physics2DServer::get_singleton()->shape_create(Physics2DServer::SHAPE_SEGMENT)) {
+SegmentShape2D::SegmentShape2D() : Shape2D(Physics2DServer::SHAPE_SEGMENT) {
 
 	a=Vector2();
 	b=Vector2(0,10);
@@ -89,7 +89,7 @@ SegmentShape2D::SegmentShape2D() : Shape2D( Physics2DServer::get_singleton()->sh
 
 void RayShape2D::_update_shape() {
 
-	Physics2DServer::get_singleton()->shape_set_data(get_rid(),length);
+	_set_shape_data(length);
 	emit_changed();
 
 }
@@ -115,7 +115,7 @@ real_t RayShape2D::get_length() const {
 
 }
 
-RayShape2D::RayShape2D()  : Shape2D( Physics2DServer::get_singleton()->shape_create(Physics2DServer::SHAPE_RAY)) {
+RayShape2D::RayShape2D()  : Shape2D(Physics2DServer::SHAPE_RAY) {
 
 	length=20;
 	_update_shape();
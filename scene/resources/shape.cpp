@@ -29,9 +29,55 @@
 #include "shape.h"
 
 #include "servers/physics_server.h"
+#include "io/resource_loader.h"
 
+//the physics server is not thread safe, shapes parsed by a load thread set it up from the main thread
 
+struct _ShapeServerCall {
 
+	enum Op {
+		OP_CREATE,
+		OP_SET_DATA,
+		OP_GET_DATA,
+		OP_FREE
+	};
+
+	Op op;
+	PhysicsServer::ShapeType type;
+	RID shape;
+	Variant data;
+};
+
+static void _shape_server_call(void *p_ud) {
+
+	_ShapeServerCall *call=(_ShapeServerCall*)p_ud;
+	PhysicsServer *ps=PhysicsServer::get_singleton();
+
+	switch(call->op) {
+		case _ShapeServerCall::OP_CREATE: call->shape=ps->shape_create(call->type); break;
+		case _ShapeServerCall::OP_SET_DATA: ps->shape_set_data(call->shape,call->data); break;
+		case _ShapeServerCall::OP_GET_DATA: call->data=ps->shape_get_data(call->shape); break;
+		case _ShapeServerCall::OP_FREE: ps->free(call->shape); break;
+	}
+}
+
+void Shape::_set_shape_data(const Variant& p_data) {
+
+	_ShapeServerCall call;
+	call.op=_ShapeServerCall::OP_SET_DATA;
+	call.shape=shape;
+	call.data=p_data;
+	ResourceLoader::call_on_main_thread(_shape_server_call,&call);
+}
+
+Variant Shape::_get_shape_data() const {
+
+	_ShapeServerCall call;
+	call.op=_ShapeServerCall::OP_GET_DATA;
+	call.shape=shape;
+	ResourceLoader::call_on_main_thread(_shape_server_call,&call);
+	return call.data;
+}
 
 Shape::Shape() {
 
@@ -40,12 +86,19 @@ Shape::Shape() {
 }
 
 
-Shape::Shape(RID p_shape) {
+Shape::Shape(PhysicsServer::ShapeType p_type) {
 
-	shape=p_shape;
+	_ShapeServerCall call;
+	call.op=_ShapeServerCall::OP_CREATE;
+	call.type=p_type;
+	ResourceLoader::call_on_main_thread(_shape_server_call,&call);
+	shape=call.shape;
 }
 
 Shape::~Shape() {
 
-	PhysicsServer::get_singleton()->free(shape);
+	_ShapeServerCall call;
+	call.op=_ShapeServerCall::OP_FREE;
+	call.shape=shape;
+	ResourceLoader::call_on_main_thread(_shape_server_call,&call);
 }
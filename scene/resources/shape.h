@@ -30,6 +30,7 @@
 #define SHAPE_H
 
 #include "resource.h"
+#include "servers/physics_server.h"
 
 class Shape : public Resource {
 
@@ -41,7 +42,9 @@ class Shape : public Resource {
 protected:
 
 	_FORCE_INLINE_ RID get_shape() const { return shape; }
-	Shape(RID p_shape);
+	void _set_shape_data(const Variant& p_data);
+	Variant _get_shape_data() const;
+	Shape(PhysicsServer::ShapeType p_type);
 public:
 
 	virtual RID get_rid() const { return shape; }
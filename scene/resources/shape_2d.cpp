@@ -28,6 +28,58 @@
 /*************************************************************************/
 #include "shape_2d.h"
 #include "servers/physics_2d_server.h"
+#include "io/resource_loader.h"
+
+//the physics server is not thread safe, shapes parsed by a load thread set it up from the main thread
+
+struct _Shape2DServerCall {
+
+	enum Op {
+		OP_CREATE,
+		OP_SET_DATA,
+		OP_GET_DATA,
+		OP_SET_BIAS,
+		OP_FREE
+	};
+
+	Op op;
+	Physics2DServer::ShapeType type;
+	RID shape;
+	Variant data;
+};
+
+static void _shape_2d_server_call(void *p_ud) {
+
+	_Shape2DServerCall *call=(_Shape2DServerCall*)p_ud;
+	Physics2DServer *ps=Physics2DServer::get_singleton();
+
+	switch(call->op) {
+		case _Shape2DServerCall::OP_CREATE: call->shape=ps->shape_create(call->type); break;
+		case _Shape2DServerCall::OP_SET_DATA: ps->shape_set_data(call->shape,call->data); break;
+		case _Shape2DServerCall::OP_GET_DATA: call->data=ps->shape_get_data(call->shape); break;
+		case _Shape2DServerCall::OP_SET_BIAS: ps->shape_set_custom_solver_bias(call->shape,call->data); break;
+		case _Shape2DServerCall::OP_FREE: ps->free(call->shape); break;
+	}
+}
+
+void Shape2D::_set_shape_data(const Variant& p_data) {
+
+	_Shape2DServerCall call;
+	call.op=_Shape2DServerCall::OP_SET_DATA;
+	call.shape=shape;
+	call.data=p_data;
+	ResourceLoader::call_on_main_thread(_shape_2d_server_call,&call);
+}
+
+Variant Shape2D::_get_shape_data() const {
+
+	_Shape2DServerCall call;
+	call.op=_Shape2DServerCall::OP_GET_DATA;
+	call.shape=shape;
+	ResourceLoader::call_on_main_thread(_shape_2d_server_call,&call);
+	return call.data;
+}
+
 RID Shape2D::get_rid() const {
 
 	return shape;
@@ -37,7 +89,12 @@ RID Shape2D::get_rid() const {
 void Shape2D::set_custom_solver_bias(real_t p_bias) {
 
 	custom_bias=p_bias;
-	Physics2DServer::get_singleton()->shape_set_custom_solver_bias(shape,custom_bias);
+
+	_Shape2DServerCall call;
+	call.op=_Shape2DServerCall::OP_SET_BIAS;
+	call.shape=shape;
+	call.data=custom_bias;
+	ResourceLoader::call_on_main_thread(_shape_2d_server_call,&call);
 }
 
 real_t Shape2D::get_custom_solver_bias() const{
@@ -116,8 +173,13 @@ void Shape2D::_bind_methods() {
 
 
 
-Shape2D::Shape2D(const RID& p_rid) {
-	shape=p_rid;
+Shape2D::Shape2D(Physics2DServer::ShapeType p_type) {
+
+	_Shape2DServerCall call;
+	call.op=_Shape2DServerCall::OP_CREATE;
+	call.type=p_type;
+	ResourceLoader::call_on_main_thread(_shape_2d_server_call,&call);
+	shape=call.shape;
 	custom_bias=0;
 }
 
@@ -125,5 +187,8 @@ Shape2D::Shape2D(const RID& p_rid) {
 
 Shape2D::~Shape2D() {
 
-	Physics2DServer::get_singleton()->free(shape);
+	_Shape2DServerCall call;
+	call.op=_Shape2DServerCall::OP_FREE;
+	call.shape=shape;
+	ResourceLoader::call_on_main_thread(_shape_2d_server_call,&call);
 }
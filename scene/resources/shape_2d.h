@@ -30,6 +30,7 @@
 #define SHAPE_2D_H
 
 #include "resource.h"
+#include "servers/physics_2d_server.h"
 
 class Shape2D : public Resource {
 	OBJ_TYPE( Shape2D, Resource );
@@ -41,7 +42,9 @@ protected:
 
 
 	static void _bind_methods();
-	Shape2D(const RID& p_rid);
+	void _set_shape_data(const Variant& p_data);
+	Variant _get_shape_data() const;
+	Shape2D(Physics2DServer::ShapeType p_type);
 public:
 
 	void set_custom_solver_bias(real_t p_bias);
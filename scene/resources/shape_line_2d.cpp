@@ -34,7 +34,7 @@ void LineShape2D::_update_shape() {
 	Array arr;
 	arr.push_back(normal);
 	arr.push_back(d);
-	Physics2DServer::get_singleton()->shape_set_data(get_rid(),arr);
+	_set_shape_data(arr);
 
 }
 
@@ -74,7 +74,7 @@ void LineShape2D::_bind_methods() {
 
 }
 
-LineShape2D::LineShape2D() : Shape2D( Physics2DServer::get_singleton()->shape_create(Physics2DServer::SHAPE_LINE)) {
+LineShape2D::LineShape2D() : Shape2D(Physics2DServer::SHAPE_LINE) {
 
 	normal=Vector2(0,-1);
 	d=0;
@@ -32,7 +32,7 @@
 
 void SphereShape::_update_shape() {
 
-	PhysicsServer::get_singleton()->shape_set_data(get_shape(),radius);
+	_set_shape_data(radius);
 }
 
 void SphereShape::set_radius(float p_radius) {
@@ -58,7 +58,7 @@ void SphereShape::_bind_methods() {
 
 }
 
-SphereShape::SphereShape() : Shape( PhysicsServer::get_singleton()->shape_create(PhysicsServer::SHAPE_SPHERE)) {
+SphereShape::SphereShape() : Shape(PhysicsServer::SHAPE_SPHERE) {
 
 	set_radius(1.0);
 }
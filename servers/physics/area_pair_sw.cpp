@@ -34,29 +34,33 @@ bool AreaPairSW::setup(float p_step) {
 
 	bool result = CollisionSolverSW::solve_static(body->get_shape(body_shape),body->get_transform() * body->get_shape_transform(body_shape),area->get_shape(area_shape),area->get_transform() * area->get_shape_transform(area_shape),NULL,this);
 
-	if (result!=colliding) {
+	set_colliding(result);
 
-		if (result) {
+	return false; //never do any post solving
+}
+
+void AreaPairSW::set_colliding(bool p_colliding) {
 
-			if (area->get_space_override_mode()!=PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED)
-				body->add_area(area);
-			if (area->has_monitor_callback())
-				area->add_body_to_query(body,body_shape,area_shape);
+	if (p_colliding==colliding)
+		return;
 
-		} else {
+	if (p_colliding) {
 
-			if (area->get_space_override_mode()!=PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED)
-				body->remove_area(area);
-			if (area->has_monitor_callback())
-				area->remove_body_from_query(body,body_shape,area_shape);
+		if (area->get_space_override_mode()!=PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED)
+			body->add_area(area);
+		if (area->has_monitor_callback())
+			area->add_body_to_query(body,body_shape,area_shape);
 
-		}
+	} else {
 
-		colliding=result;
+		if (area->get_space_override_mode()!=PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED)
+			body->remove_area(area);
+		if (area->has_monitor_callback())
+			area->remove_body_from_query(body,body_shape,area_shape);
 
 	}
 
-	return false; //never do any post solving
+	colliding=p_colliding;
 }
 
 void AreaPairSW::solve(float p_step) {
@@ -73,6 +77,8 @@ AreaPairSW::AreaPairSW(BodySW *p_body,int p_body_shape, AreaSW *p_area,int p_are
 	body_shape=p_body_shape;
 	area_shape=p_area_shape;
 	colliding=false;
+	_set_type(TYPE_AREA_PAIR);
+	_set_sort_key((uint64_t(area->get_self().get_id())<<32)|body->get_self().get_id(),(uint64_t(uint32_t(area_shape))<<32)|uint32_t(body_shape));
 	body->add_constraint(this,0);
 	area->add_constraint(this);
 
@@ -42,6 +42,9 @@ class AreaPairSW : public ConstraintSW {
 	bool colliding;
 public:
 
+	_FORCE_INLINE_ bool is_colliding() const { return colliding; }
+	void set_colliding(bool p_colliding);
+
 	bool setup(float p_step);
 	void solve(float p_step);
 
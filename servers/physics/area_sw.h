@@ -93,7 +93,7 @@ class AreaSW : public CollisionObjectSW{
 	//virtual void shape_changed_notify(ShapeSW *p_shape);
 	//virtual void shape_deleted_notify(ShapeSW *p_shape);
 
-	Set<ConstraintSW*> constraints;
+	Set<ConstraintSW*,ConstraintCMP> constraints;
 
 
 	virtual void _shapes_changed();
@@ -136,7 +136,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint( ConstraintSW* p_constraint) { constraints.insert(p_constraint); }
 	_FORCE_INLINE_ void remove_constraint( ConstraintSW* p_constraint) { constraints.erase(p_constraint); }
-	_FORCE_INLINE_ const Set<ConstraintSW*>& get_constraints() const { return constraints; }
+	_FORCE_INLINE_ const Set<ConstraintSW*,ConstraintCMP>& get_constraints() const { return constraints; }
 
 	void set_transform(const Transform& p_transform);
 
@@ -30,6 +30,8 @@
 #include "collision_solver_sw.h"
 #include "space_sw.h"
 
+#include <string.h>
+
 
 /*
 #define NO_ACCUMULATE_IMPULSES
@@ -419,6 +421,48 @@ void BodyPairSW::solve(float p_step) {
 
 
 
+int BodyPairSW::get_state_size() const {
+
+	return sizeof(State)+sizeof(Contact)*contact_count;
+}
+
+int BodyPairSW::save_state(uint8_t *r_buffer) const {
+
+	State state;
+	state.offset_B=offset_B;
+	state.sep_axis=sep_axis;
+	state.contact_count=contact_count;
+	state.collided=collided;
+	memcpy(r_buffer,&state,sizeof(State));
+	memcpy(r_buffer+sizeof(State),contacts,sizeof(Contact)*contact_count);
+
+	return get_state_size();
+}
+
+int BodyPairSW::load_state(const uint8_t *p_buffer,int p_size) {
+
+	ERR_FAIL_COND_V(p_size<(int)sizeof(State),0);
+	State state;
+	memcpy(&state,p_buffer,sizeof(State));
+	ERR_FAIL_COND_V(state.contact_count<0 || state.contact_count>MAX_CONTACTS,0);
+	ERR_FAIL_COND_V(p_size<int(sizeof(State)+sizeof(Contact)*state.contact_count),0);
+
+	offset_B=state.offset_B;
+	sep_axis=state.sep_axis;
+	contact_count=state.contact_count;
+	collided=state.collided;
+	memcpy(contacts,p_buffer+sizeof(State),sizeof(Contact)*contact_count);
+
+	return get_state_size();
+}
+
+void BodyPairSW::clear_state() {
+
+	sep_axis=Vector3();
+	contact_count=0;
+	collided=false;
+}
+
 BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A,BodySW *p_B, int p_shape_B) : ConstraintSW(_arr,2) {
 
 	A=p_A;
@@ -426,6 +470,8 @@ BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A,BodySW *p_B, int p_shape_B) :
 	shape_A=p_shape_A;
 	shape_B=p_shape_B;
 	space=A->get_space();
+	_set_type(TYPE_BODY_PAIR);
+	_set_sort_key((uint64_t(A->get_self().get_id())<<32)|B->get_self().get_id(),(uint64_t(uint32_t(shape_A))<<32)|uint32_t(shape_B));
 	A->add_constraint(this,0);
 	B->add_constraint(this,1);
 	contact_count=0;
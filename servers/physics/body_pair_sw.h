@@ -84,8 +84,22 @@ class BodyPairSW : public ConstraintSW {
 
 	SpaceSW *space;
 
+	struct State {
+
+		Vector3 offset_B;
+		Vector3 sep_axis;
+		int contact_count;
+		bool collided;
+	};
+
 public:
 
+	//contact cache as raw bytes, only the contacts in use are stored
+	int get_state_size() const;
+	int save_state(uint8_t *r_buffer) const;
+	int load_state(const uint8_t *p_buffer,int p_size);
+	void clear_state();
+
 	bool setup(float p_step);
 	void solve(float p_step);
 
@@ -441,9 +441,12 @@ void BodySW::integrate_velocities(real_t p_step) {
 	}
 
 	Vector3 total_linear_velocity=linear_velocity+biased_linear_velocity;
+	Vector3 motion=total_linear_velocity * p_step;
 
+	if (continuous_cd) //stop at the first time of impact instead of tunnelling
+		motion*=get_space()->body_cast_motion(this,motion);
 
-	transform.origin+=total_linear_velocity * p_step;
+	transform.origin+=motion;
 
 	_set_transform(transform);
 	_set_inv_transform(get_transform().inverse());
@@ -458,6 +461,39 @@ void BodySW::integrate_velocities(real_t p_step) {
 }
 
 
+void BodySW::save_state(State& r_state) const {
+
+	r_state.transform=get_transform();
+	r_state.inv_transform=get_inv_transform();
+	r_state.inv_inertia_tensor=_inv_inertia_tensor;
+	r_state.linear_velocity=linear_velocity;
+	r_state.angular_velocity=angular_velocity;
+	r_state.biased_linear_velocity=biased_linear_velocity;
+	r_state.biased_angular_velocity=biased_angular_velocity;
+	r_state.applied_force=applied_force;
+	r_state.applied_torque=applied_torque;
+	r_state.still_time=still_time;
+}
+
+void BodySW::load_state(const State& p_state) {
+
+	//shapes are not updated here, the space restores their exact broadphase aabbs
+	_set_transform(p_state.transform,false);
+	_set_inv_transform(p_state.inv_transform);
+
+	_inv_inertia_tensor=p_state.inv_inertia_tensor;
+	linear_velocity=p_state.linear_velocity;
+	angular_velocity=p_state.angular_velocity;
+	biased_linear_velocity=p_state.biased_linear_velocity;
+	biased_angular_velocity=p_state.biased_angular_velocity;
+	applied_force=p_state.applied_force;
+	applied_torque=p_state.applied_torque;
+	still_time=p_state.still_time;
+
+	if (fi_callback && get_space() && !direct_state_query_list.in_list())
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+}
+
 void BodySW::simulate_motion(const Transform& p_xform,real_t p_step) {
 
 	Transform inv_xform = p_xform.affine_inverse();
@@ -492,7 +528,7 @@ void BodySW::simulate_motion(const Transform& p_xform,real_t p_step) {
 
 void BodySW::wakeup_neighbours() {
 
-	for(Map<ConstraintSW*,int>::Element *E=constraint_map.front();E;E=E->next()) {
+	for(Map<ConstraintSW*,int,ConstraintCMP>::Element *E=constraint_map.front();E;E=E->next()) {
 
 		const ConstraintSW *c=E->key();
 		BodySW **n = c->get_body_ptr();
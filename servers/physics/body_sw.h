@@ -75,7 +75,7 @@ class BodySW : public CollisionObjectSW {
 	void _update_inertia();
 	virtual void _shapes_changed();
 
-	Map<ConstraintSW*,int> constraint_map;
+	Map<ConstraintSW*,int,ConstraintCMP> constraint_map;
 
 	struct AreaCMP {
 
@@ -127,6 +127,22 @@ friend class PhysicsDirectBodyStateSW; // i give up, too many functions to expos
 
 public:
 
+	struct State {
+
+		Transform transform;
+		Transform inv_transform;
+		Matrix3 inv_inertia_tensor;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 biased_linear_velocity;
+		Vector3 biased_angular_velocity;
+		Vector3 applied_force;
+		Vector3 applied_torque;
+		real_t still_time;
+	};
+
+	void save_state(State& r_state) const;
+	void load_state(const State& p_state);
 
 	void set_force_integration_callback(ObjectID p_id,const StringName& p_method,const Variant& p_udata=Variant());
 
@@ -157,7 +173,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(ConstraintSW* p_constraint, int p_pos) { constraint_map[p_constraint]=p_pos; }
 	_FORCE_INLINE_ void remove_constraint(ConstraintSW* p_constraint) { constraint_map.erase(p_constraint); }
-	const Map<ConstraintSW*,int>& get_constraint_map() const { return constraint_map; }
+	const Map<ConstraintSW*,int,ConstraintCMP>& get_constraint_map() const { return constraint_map; }
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration=p_omit_force_integration; }
 	_FORCE_INLINE_ bool get_omit_force_integration() const { return omit_force_integration; }
@@ -0,0 +1,531 @@
+/*************************************************************************/
+/*  broad_phase_sap.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "broad_phase_sap.h"
+#include "sort.h"
+
+void BroadPhaseSAP::_add_pair(ID p_a, ID p_b) {
+
+	const Element *el=elements.ptr();
+	const Element &A=el[p_a];
+	const Element &B=el[p_b];
+
+	if (!A.has_aabb || !B.has_aabb || A.owner==B.owner || (A._static && B._static))
+		return;
+	if (!A.aabb.intersects(B.aabb))
+		return;
+
+	PairKey key(p_a,p_b);
+	if (pair_map.has(key.key))
+		return;
+
+	void *data=NULL;
+	if (pair_callback)
+		data=pair_callback(el[key.a].owner,el[key.a].subindex,el[key.b].owner,el[key.b].subindex,pair_userdata);
+	pair_map.set(key.key,data);
+}
+
+void BroadPhaseSAP::_remove_pair(ID p_a, ID p_b,bool p_force) {
+
+	const Element *el=elements.ptr();
+	const Element &A=el[p_a];
+	const Element &B=el[p_b];
+
+	if (!p_force && A.has_aabb && B.has_aabb && !(A._static && B._static) && A.aabb.intersects(B.aabb))
+		return; // still overlapping on the other axes
+
+	PairKey key(p_a,p_b);
+	void **data=pair_map.getptr(key.key);
+	if (!data)
+		return;
+
+	if (unpair_callback)
+		unpair_callback(el[key.a].owner,el[key.a].subindex,el[key.b].owner,el[key.b].subindex,*data,unpair_userdata);
+	pair_map.erase(key.key);
+}
+
+void BroadPhaseSAP::_update_overlapping(ID p_id,bool p_add,bool p_force_remove) {
+
+	const AABB aabb=elements[p_id].aabb;
+	const Endpoint *ep=axis[0].ptr();
+	int count=axis[0].size();
+	real_t to=aabb.pos.x+aabb.size.x;
+
+	for(int i=_find_first(aabb.pos.x-max_extent);i<count && ep[i].value<=to;i++) {
+
+		if (ep[i].is_max())
+			continue;
+		ID other=ep[i].get_id();
+		if (other==p_id)
+			continue;
+
+		if (p_add)
+			_add_pair(p_id,other);
+		else
+			_remove_pair(p_id,other,p_force_remove);
+	}
+}
+
+void BroadPhaseSAP::_sort_down(int p_axis,uint32_t p_index) {
+
+	Endpoint *ep=axis[p_axis].ptr();
+	Element *el=elements.ptr();
+	Endpoint moving=ep[p_index];
+	ID id=moving.get_id();
+	uint32_t i=p_index;
+
+	while(i>0 && moving<ep[i-1]) {
+
+		Endpoint prev=ep[i-1];
+		ID other=prev.get_id();
+
+		if (moving.is_max()!=prev.is_max()) {
+
+			if (prev.is_max())
+				_add_pair(id,other); // min went below the other's max
+			else
+				_remove_pair(id,other); // max went below the other's min
+		}
+
+		ep[i]=prev;
+		if (prev.is_max())
+			el[other].max[p_axis]=i;
+		else
+			el[other].min[p_axis]=i;
+		i--;
+	}
+
+	ep[i]=moving;
+	if (moving.is_max())
+		el[id].max[p_axis]=i;
+	else
+		el[id].min[p_axis]=i;
+}
+
+void BroadPhaseSAP::_sort_up(int p_axis,uint32_t p_index) {
+
+	Endpoint *ep=axis[p_axis].ptr();
+	Element *el=elements.ptr();
+	uint32_t count=axis[p_axis].size();
+	Endpoint moving=ep[p_index];
+	ID id=moving.get_id();
+	uint32_t i=p_index;
+
+	while(i+1<count && ep[i+1]<moving) {
+
+		Endpoint next=ep[i+1];
+		ID other=next.get_id();
+
+		if (moving.is_max()!=next.is_max()) {
+
+			if (moving.is_max())
+				_add_pair(id,other); // max went above the other's min
+			else
+				_remove_pair(id,other); // min went above the other's max
+		}
+
+		ep[i]=next;
+		if (next.is_max())
+			el[other].max[p_axis]=i;
+		else
+			el[other].min[p_axis]=i;
+		i++;
+	}
+
+	ep[i]=moving;
+	if (moving.is_max())
+		el[id].max[p_axis]=i;
+	else
+		el[id].min[p_axis]=i;
+}
+
+void BroadPhaseSAP::_merge_pending() {
+
+	int count=pending.size();
+	if (!count && !dead_ids.size())
+		return;
+
+	Element *el=elements.ptr();
+	merge_endpoints.resize(count*2);
+	Endpoint *mep=merge_endpoints.ptr();
+
+	for(int i=0;i<3;i++) {
+
+		Endpoint *ep=axis[i].ptr();
+		int alive=axis[i].size();
+
+		if (dead_ids.size()) {
+
+			alive=0;
+			for(int j=0;j<axis[i].size();j++) {
+				if (el[ep[j].get_id()].owner)
+					ep[alive++]=ep[j];
+			}
+		}
+
+		for(int j=0;j<count;j++) {
+
+			const Element &e=el[pending[j]];
+			mep[j*2].value=e.aabb.pos[i];
+			mep[j*2].data=pending[j]<<1;
+			mep[j*2+1].value=e.aabb.pos[i]+e.aabb.size[i];
+			mep[j*2+1].data=(pending[j]<<1)|1;
+		}
+
+		SortArray<Endpoint> sort;
+		sort.sort(mep,count*2);
+
+		// merge from the back, so it can be done in place
+		axis[i].resize(alive+count*2);
+		ep=axis[i].ptr();
+		int src=alive-1;
+		int m=count*2-1;
+		for(int dst=alive+count*2-1;m>=0;dst--) {
+
+			if (src>=0 && mep[m]<ep[src])
+				ep[dst]=ep[src--];
+			else
+				ep[dst]=mep[m--];
+		}
+
+		for(int j=0;j<axis[i].size();j++) {
+
+			if (ep[j].is_max())
+				el[ep[j].get_id()].max[i]=j;
+			else
+				el[ep[j].get_id()].min[i]=j;
+		}
+	}
+
+	for(int i=0;i<dead_ids.size();i++) {
+
+		el[dead_ids[i]].in_axes=false;
+		free_ids.push_back(dead_ids[i]);
+	}
+	dead_ids.resize(0);
+
+	for(int i=0;i<count;i++) {
+
+		el[pending[i]].in_axes=true;
+		el[pending[i]].pending=-1;
+	}
+
+	for(int i=0;i<count;i++)
+		_update_overlapping(pending[i],true);
+
+	pending.resize(0);
+}
+
+int BroadPhaseSAP::_find_first(real_t p_value) const {
+
+	const Endpoint *ep=axis[0].ptr();
+	int lo=0;
+	int hi=axis[0].size();
+
+	while(lo<hi) {
+
+		int mid=(lo+hi)>>1;
+		if (ep[mid].value<p_value)
+			lo=mid+1;
+		else
+			hi=mid;
+	}
+
+	return lo;
+}
+
+BroadPhaseSW::ID BroadPhaseSAP::create(CollisionObjectSW *p_object_, int p_subindex) {
+
+	ERR_FAIL_COND_V(p_object_==NULL,0);
+
+	ID id;
+	if (free_ids.size()) {
+		id=free_ids[free_ids.size()-1];
+		free_ids.resize(free_ids.size()-1);
+	} else {
+		id=elements.size();
+		elements.resize(id+1);
+	}
+
+	Element &e=elements[id];
+	e.owner=p_object_;
+	e._static=false;
+	e.has_aabb=false;
+	e.in_axes=false;
+	e.pending=-1;
+	e.subindex=p_subindex;
+
+	return id;
+}
+
+void BroadPhaseSAP::move(ID p_id, const AABB& p_aabb) {
+
+	ERR_FAIL_COND(!_exists(p_id));
+
+	Element &e=elements[p_id];
+	if (e.has_aabb && e.aabb.size.x==max_extent && p_aabb.size.x<max_extent)
+		max_extent_dirty=true;
+	if (p_aabb.size.x>max_extent)
+		max_extent=p_aabb.size.x;
+
+	e.aabb=p_aabb;
+
+	if (!e.has_aabb) {
+		// first placement, sorted in on update()
+		e.has_aabb=true;
+		e.pending=pending.size();
+		pending.push_back(p_id);
+		return;
+	}
+
+	if (!e.in_axes)
+		return;
+
+	for(int i=0;i<3;i++) {
+
+		uint32_t min_idx=e.min[i];
+		uint32_t max_idx=e.max[i];
+		real_t new_min=p_aabb.pos[i];
+		real_t new_max=p_aabb.pos[i]+p_aabb.size[i];
+
+		Endpoint *ep=axis[i].ptr();
+		real_t old_min=ep[min_idx].value;
+		real_t old_max=ep[max_idx].value;
+		ep[min_idx].value=new_min;
+		ep[max_idx].value=new_max;
+
+		// sort the leading endpoint first so min never has to pass its own max
+		if (new_max>old_max) {
+
+			_sort_up(i,max_idx);
+			if (new_min>old_min)
+				_sort_up(i,min_idx);
+			else if (new_min<old_min)
+				_sort_down(i,min_idx);
+		} else {
+
+			if (new_min<old_min)
+				_sort_down(i,min_idx);
+			else if (new_min>old_min)
+				_sort_up(i,min_idx);
+			if (new_max<old_max)
+				_sort_down(i,elements[p_id].max[i]);
+		}
+	}
+}
+
+void BroadPhaseSAP::set_static(ID p_id, bool p_static) {
+
+	ERR_FAIL_COND(!_exists(p_id));
+
+	Element &e=elements[p_id];
+	if (e._static==p_static)
+		return;
+	e._static=p_static;
+
+	// pairs with overlapping statics appear or disappear
+	if (e.in_axes)
+		_update_overlapping(p_id,!p_static);
+}
+
+void BroadPhaseSAP::remove(ID p_id) {
+
+	ERR_FAIL_COND(!_exists(p_id));
+
+	Element &e=elements[p_id];
+	if (e.has_aabb && e.aabb.size.x==max_extent)
+		max_extent_dirty=true;
+
+	if (e.pending>=0) {
+
+		ID last=pending[pending.size()-1];
+		pending[e.pending]=last;
+		elements[last].pending=e.pending;
+		pending.resize(pending.size()-1);
+		e.pending=-1;
+	}
+
+	if (e.in_axes) {
+
+		//unpair must be done immediately on removal to avoid potential invalid pointers
+		_update_overlapping(p_id,false,true);
+		// endpoints stay until update(), the id can't be reused before that
+		dead_ids.push_back(p_id);
+	} else {
+
+		free_ids.push_back(p_id);
+	}
+
+	e.owner=NULL;
+	e.has_aabb=false;
+}
+
+CollisionObjectSW *BroadPhaseSAP::get_object(ID p_id) const {
+
+	ERR_FAIL_COND_V(!_exists(p_id),NULL);
+	return elements[p_id].owner;
+}
+
+bool BroadPhaseSAP::is_static(ID p_id) const {
+
+	ERR_FAIL_COND_V(!_exists(p_id),false);
+	return elements[p_id]._static;
+}
+
+int BroadPhaseSAP::get_subindex(ID p_id) const {
+
+	ERR_FAIL_COND_V(!_exists(p_id),-1);
+	return elements[p_id].subindex;
+}
+
+struct _SAPCullAABB {
+
+	AABB aabb;
+	_FORCE_INLINE_ bool operator()(const AABB& p_aabb) const { return aabb.intersects(p_aabb); }
+};
+
+struct _SAPCullSegment {
+
+	Vector3 from;
+	Vector3 to;
+	_FORCE_INLINE_ bool operator()(const AABB& p_aabb) const { return p_aabb.intersects_segment(from,to); }
+};
+
+template<class T>
+int BroadPhaseSAP::_cull(const AABB& p_aabb,const T& p_test,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices) {
+
+	if (p_max_results<=0)
+		return 0;
+
+	const Endpoint *ep=axis[0].ptr();
+	const Element *el=elements.ptr();
+	int count=axis[0].size();
+	real_t to=p_aabb.pos.x+p_aabb.size.x;
+	int rc=0;
+
+	// anything overlapping starts at most max_extent before the query
+	for(int i=_find_first(p_aabb.pos.x-max_extent);i<count && ep[i].value<=to;i++) {
+
+		if (ep[i].is_max())
+			continue;
+
+		const Element &e=el[ep[i].get_id()];
+		if (!e.has_aabb || !p_test(e.aabb))
+			continue;
+
+		p_results[rc]=e.owner;
+		if (p_result_indices)
+			p_result_indices[rc]=e.subindex;
+		rc++;
+		if (rc>=p_max_results)
+			return rc;
+	}
+
+	for(int i=0;i<pending.size();i++) {
+
+		const Element &e=el[pending[i]];
+		if (!p_test(e.aabb))
+			continue;
+
+		p_results[rc]=e.owner;
+		if (p_result_indices)
+			p_result_indices[rc]=e.subindex;
+		rc++;
+		if (rc>=p_max_results)
+			break;
+	}
+
+	return rc;
+}
+
+int BroadPhaseSAP::cull_segment(const Vector3& p_from, const Vector3& p_to,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices) {
+
+	_SAPCullSegment test;
+	test.from=p_from;
+	test.to=p_to;
+
+	AABB aabb(p_from,Vector3());
+	aabb.expand_to(p_to);
+
+	return _cull(aabb,test,p_results,p_max_results,p_result_indices);
+}
+
+int BroadPhaseSAP::cull_aabb(const AABB& p_aabb,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices) {
+
+	_SAPCullAABB test;
+	test.aabb=p_aabb;
+
+	return _cull(p_aabb,test,p_results,p_max_results,p_result_indices);
+}
+
+void BroadPhaseSAP::set_pair_callback(PairCallback p_pair_callback,void *p_userdata) {
+
+	pair_userdata=p_userdata;
+	pair_callback=p_pair_callback;
+}
+
+void BroadPhaseSAP::set_unpair_callback(UnpairCallback p_unpair_callback,void *p_userdata) {
+
+	unpair_userdata=p_userdata;
+	unpair_callback=p_unpair_callback;
+}
+
+void BroadPhaseSAP::update() {
+
+	if (max_extent_dirty) {
+
+		max_extent=0;
+		const Element *el=elements.ptr();
+		for(int i=1;i<elements.size();i++) {
+
+			if (el[i].owner && el[i].has_aabb && el[i].aabb.size.x>max_extent)
+				max_extent=el[i].aabb.size.x;
+		}
+		max_extent_dirty=false;
+	}
+
+	// moved pairs were already reported by move(), only new elements need pairing
+	_merge_pending();
+}
+
+BroadPhaseSW *BroadPhaseSAP::_create() {
+
+	return memnew( BroadPhaseSAP );
+}
+
+BroadPhaseSAP::BroadPhaseSAP() {
+
+	elements.resize(1); // 0 is an invalid ID
+	elements[0].owner=NULL;
+	max_extent=0;
+	max_extent_dirty=false;
+	unpair_callback=NULL;
+	unpair_userdata=NULL;
+	pair_callback=NULL;
+	pair_userdata=NULL;
+}
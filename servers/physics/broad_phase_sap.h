@@ -0,0 +1,138 @@
+/*************************************************************************/
+/*  broad_phase_sap.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                    http://www.godotengine.org                         */
+/*************************************************************************/
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef BROAD_PHASE_SAP_H
+#define BROAD_PHASE_SAP_H
+
+#include "broad_phase_sw.h"
+#include "hash_map.h"
+#include "vector.h"
+
+/* Incremental sweep and prune. Endpoints are kept sorted on the three axes and
+   re-sorted with insertion sort on every move, so objects that move a little
+   per frame only swap with their immediate neighbours. Pairs are created and
+   destroyed when endpoints cross. Newly placed elements are merged in and
+   removed ones compacted out in batch on update(). */
+
+class BroadPhaseSAP : public BroadPhaseSW {
+
+	struct Endpoint {
+
+		real_t value;
+		uint32_t data; // element id << 1 | is max
+
+		_FORCE_INLINE_ ID get_id() const { return data>>1; }
+		_FORCE_INLINE_ bool is_max() const { return data&1; }
+
+		// mins sort before maxes at the same position, so touching boxes overlap
+		_FORCE_INLINE_ bool operator<(const Endpoint& p_ep) const {
+			return value==p_ep.value ? (data&1)<(p_ep.data&1) : value<p_ep.value;
+		}
+	};
+
+	struct Element {
+
+		CollisionObjectSW *owner;
+		bool _static;
+		bool has_aabb;
+		bool in_axes;
+		AABB aabb;
+		int pending; // index in pending list, -1 if not waiting for update()
+		int subindex;
+		uint32_t min[3];
+		uint32_t max[3];
+	};
+
+	struct PairKey {
+
+		union {
+			struct {
+				ID a;
+				ID b;
+			};
+			uint64_t key;
+		};
+
+		PairKey() { key=0; }
+		PairKey(ID p_a, ID p_b) { if (p_a>p_b) { a=p_b; b=p_a; } else { a=p_a; b=p_b; }}
+	};
+
+	Vector<Element> elements; // indexed by ID, 0 is unused
+	Vector<ID> free_ids;
+	Vector<ID> dead_ids; // removed but still have endpoints in the axes
+	Vector<ID> pending; // moved for the first time, not in the axes yet
+	Vector<Endpoint> axis[3];
+	Vector<Endpoint> merge_endpoints;
+
+	HashMap<uint64_t,void*> pair_map;
+
+	real_t max_extent; // largest element size on x, used to bound culling
+	bool max_extent_dirty;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+	_FORCE_INLINE_ bool _exists(ID p_id) const { return p_id>0 && p_id<(ID)elements.size() && elements[p_id].owner; }
+
+	void _add_pair(ID p_a, ID p_b);
+	void _remove_pair(ID p_a, ID p_b,bool p_force=false);
+	void _update_overlapping(ID p_id,bool p_add,bool p_force_remove=false);
+	void _sort_down(int p_axis,uint32_t p_index);
+	void _sort_up(int p_axis,uint32_t p_index);
+	void _merge_pending();
+	int _find_first(real_t p_value) const;
+	template<class T>
+	int _cull(const AABB& p_aabb,const T& p_test,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices);
+
+public:
+
+	// 0 is an invalid ID
+	virtual ID create(CollisionObjectSW *p_object_, int p_subindex=0);
+	virtual void move(ID p_id, const AABB& p_aabb);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObjectSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_segment(const Vector3& p_from, const Vector3& p_to,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices=NULL);
+	virtual int cull_aabb(const AABB& p_aabb,CollisionObjectSW** p_results,int p_max_results,int *p_result_indices=NULL);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback,void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback,void *p_userdata);
+
+	virtual void update();
+
+	static BroadPhaseSW *_create();
+	BroadPhaseSAP();
+};
+
+#endif // BROAD_PHASE_SAP_H
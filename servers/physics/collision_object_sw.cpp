@@ -29,6 +29,15 @@
 #include "collision_object_sw.h"
 #include "space_sw.h"
 
+bool ConstraintCMP::operator()(const ConstraintSW* p_a,const ConstraintSW* p_b) const {
+
+	if (p_a->get_sort_key()!=p_b->get_sort_key())
+		return p_a->get_sort_key() < p_b->get_sort_key();
+	if (p_a->get_sort_subkey()!=p_b->get_sort_subkey())
+		return p_a->get_sort_subkey() < p_b->get_sort_subkey();
+	return p_a < p_b;
+}
+
 void CollisionObjectSW::add_shape(ShapeSW *p_shape,const Transform& p_transform) {
 
 	Shape s;
@@ -177,6 +186,26 @@ void CollisionObjectSW::_update_shapes_with_motion(const Vector3& p_motion) {
 
 }
 
+void CollisionObjectSW::_set_shape_aabb(int p_index,const AABB& p_aabb) {
+
+	ERR_FAIL_INDEX(p_index,shapes.size());
+	Shape &s=shapes[p_index];
+	if (s.bpid!=0 && s.aabb_cache==p_aabb)
+		return; //broadphase already has it
+
+	s.aabb_cache=p_aabb;
+
+	if (!space)
+		return;
+
+	if (s.bpid==0) {
+		s.bpid=space->get_broadphase()->create(this,p_index);
+		space->get_broadphase()->set_static(s.bpid,_static);
+	}
+
+	space->get_broadphase()->move(s.bpid,s.aabb_cache);
+}
+
 void CollisionObjectSW::_set_space(SpaceSW *p_space) {
 
 	if (space) {
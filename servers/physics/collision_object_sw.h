@@ -35,6 +35,12 @@
 #include "broad_phase_sw.h"
 
 class SpaceSW;
+class ConstraintSW;
+
+struct ConstraintCMP {
+
+	bool operator()(const ConstraintSW* p_a,const ConstraintSW* p_b) const;
+};
 
 class CollisionObjectSW : public ShapeOwnerSW {
 public:
@@ -71,7 +77,7 @@ protected:
 	void _update_shapes_with_motion(const Vector3& p_motion);
 	void _unregister_shapes();
 
-	_FORCE_INLINE_ void _set_transform(const Transform& p_transform) { transform=p_transform; _update_shapes(); }
+	_FORCE_INLINE_ void _set_transform(const Transform& p_transform, bool p_update_shapes=true) { transform=p_transform; if (p_update_shapes) {_update_shapes();} }
 	_FORCE_INLINE_ void _set_inv_transform(const Transform& p_transform) { inv_transform=p_transform; }
 	void _set_static(bool p_static);
 
@@ -88,6 +94,7 @@ public:
 	_FORCE_INLINE_ ObjectID get_instance_id() const { return instance_id; }
 
 	void _shape_changed();
+	void _set_shape_aabb(int p_index,const AABB& p_aabb);
 
 	_FORCE_INLINE_ Type get_type() const { return type; }
 	void add_shape(ShapeSW *p_shape,const Transform& p_transform=Transform());
@@ -31,6 +31,18 @@
 
 #define _EDGE_IS_VALID_SUPPORT_TRESHOLD 0.02
 
+static bool sat_simd_enabled=true;
+
+void sat_set_simd_enabled(bool p_enabled) {
+
+	sat_simd_enabled=p_enabled;
+}
+
+bool sat_is_simd_enabled() {
+
+	return sat_simd_enabled;
+}
+
 struct _CollectorCallback {
 
 	CollisionSolverSW::CallbackResult callback;
@@ -314,6 +326,35 @@ class SeparatorAxisTest {
 
 	Vector3 separator_axis;
 
+	Vector3 queued_axes[4];
+	int queued_count;
+
+	_FORCE_INLINE_ bool _process_depth(const Vector3& p_axis,real_t dmin,real_t dmax) {
+
+		if (dmin > 0.0 || dmax < 0.0) {
+			separator_axis=p_axis;
+			return false; // doesn't contain 0
+		}
+
+		//use the smallest depth
+
+		dmin = Math::abs(dmin);
+
+		if ( dmax < dmin ) {
+			if ( dmax < best_depth ) {
+				best_depth=dmax;
+				best_axis=p_axis;
+			}
+		} else {
+			if ( dmin < best_depth ) {
+				best_depth=dmin;
+				best_axis=-p_axis; // keep it as A axis
+			}
+		}
+
+		return true;
+	}
+
 public:
 
 	_FORCE_INLINE_ bool test_previous_axis() {
@@ -346,25 +387,68 @@ public:
 		real_t dmin = min_B - ( min_A + max_A ) * 0.5;
 		real_t dmax = max_B - ( min_A + max_A ) * 0.5;
 
-		if (dmin > 0.0 || dmax < 0.0) {
-			separator_axis=axis;
-			return false; // doesn't contain 0
+		return _process_depth(axis,dmin,dmax);
+	}
+
+	// same as test_axis, but axes are projected four at a time. Results are
+	// processed in the order the axes were queued, so the best axis matches.
+	_FORCE_INLINE_ bool queue_axis(const Vector3& p_axis) {
+
+		if (!sat_simd_enabled)
+			return test_axis(p_axis);
+
+		Vector3 axis=p_axis;
+
+		if (	Math::abs(axis.x)<CMP_EPSILON &&
+			Math::abs(axis.y)<CMP_EPSILON &&
+			Math::abs(axis.z)<CMP_EPSILON ) {
+			// strange case, try an upwards separator
+			axis=Vector3(0.0,1.0,0.0);
 		}
 
-		//use the smallest depth
+		queued_axes[queued_count++]=axis;
+		if (queued_count<4)
+			return true;
 
-		dmin = Math::abs(dmin);
+		return flush_axes();
+	}
 
-		if ( dmax < dmin ) {
-			if ( dmax < best_depth ) {
-				best_depth=dmax;
-				best_axis=axis;
-			}
-		} else {
-			if ( dmin < best_depth ) {
-				best_depth=dmin;
-				best_axis=-axis; // keep it as A axis
-			}
+	bool flush_axes() {
+
+		if (queued_count==0)
+			return true;
+
+		int count=queued_count;
+		queued_count=0;
+
+		// unused lanes repeat the first axis
+		Simd4 axes[3];
+		for(int i=0;i<3;i++) {
+			axes[i]=Simd4(
+				queued_axes[0][i],
+				queued_axes[count>1?1:0][i],
+				queued_axes[count>2?2:0][i],
+				queued_axes[count>3?3:0][i]);
+		}
+
+		Simd4 min_A,max_A,min_B,max_B;
+
+		shape_A->project_range4(axes,*transform_A,min_A,max_A);
+		shape_B->project_range4(axes,*transform_B,min_B,max_B);
+
+		Simd4 half(0.5);
+		Simd4 half_A = ( max_A - min_A ) * half;
+		Simd4 center_A = ( min_A + max_A ) * half;
+
+		real_t dmin[4];
+		real_t dmax[4];
+		(min_B - half_A - center_A).store(dmin);
+		(max_B + half_A - center_A).store(dmax);
+
+		for(int i=0;i<count;i++) {
+
+			if (!_process_depth(queued_axes[i],dmin[i],dmax[i]))
+				return false;
 		}
 
 		return true;
@@ -425,6 +509,7 @@ public:
 
 	_FORCE_INLINE_ SeparatorAxisTest(const ShapeA *p_shape_A,const Transform& p_transform_A, const ShapeB *p_shape_B,const Transform& p_transform_B,_CollectorCallback *p_callback) {
 		best_depth=1e15;
+		queued_count=0;
 		shape_A=p_shape_A;
 		shape_B=p_shape_B;
 		transform_A=&p_transform_A;
@@ -689,7 +774,7 @@ static void _collision_box_box(const ShapeSW *p_a,const Transform &p_transform_a
 
 		Vector3 axis = p_transform_a.basis.get_axis(i).normalized();
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 
 	}
@@ -700,7 +785,7 @@ static void _collision_box_box(const ShapeSW *p_a,const Transform &p_transform_a
 
 		Vector3 axis = p_transform_b.basis.get_axis(i).normalized();
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 
 	}
@@ -717,12 +802,15 @@ static void _collision_box_box(const ShapeSW *p_a,const Transform &p_transform_a
 			axis.normalize();
 
 
-			if (!separator.test_axis( axis  )) {
+			if (!separator.queue_axis( axis  )) {
 				return;
 			}
 		}
 	}
 
+	if (!separator.flush_axes())
+		return;
+
 	separator.generate_contacts();
 
 
@@ -744,7 +832,7 @@ static void _collision_box_capsule(const ShapeSW *p_a,const Transform &p_transfo
 
 		Vector3 axis = p_transform_a.basis.get_axis(i);
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 	}
 
@@ -761,7 +849,7 @@ static void _collision_box_capsule(const ShapeSW *p_a,const Transform &p_transfo
 		if (axis.length_squared() < CMP_EPSILON)
 			continue;
 
-		if (!separator.test_axis( axis.normalized() ))
+		if (!separator.queue_axis( axis.normalized() ))
 			return;
 	}
 
@@ -782,7 +870,7 @@ static void _collision_box_capsule(const ShapeSW *p_a,const Transform &p_transfo
 				//Vector3 axis = (point - cyl_axis * cyl_axis.dot(point)).normalized();
 				Vector3 axis = Plane(cyl_axis,0).project(point).normalized();
 
-				if (!separator.test_axis( axis ))
+				if (!separator.queue_axis( axis ))
 					return;
 			}
 		}
@@ -810,7 +898,7 @@ static void _collision_box_capsule(const ShapeSW *p_a,const Transform &p_transfo
 		// use point to test axis
 		Vector3 point_axis = (sphere_pos - cpoint).normalized();
 
-		if (!separator.test_axis( point_axis  ))
+		if (!separator.queue_axis( point_axis  ))
 			return;
 
 		// test edges of A
@@ -819,12 +907,15 @@ static void _collision_box_capsule(const ShapeSW *p_a,const Transform &p_transfo
 
 			Vector3 axis = point_axis.cross( p_transform_a.basis.get_axis(i) ).cross( p_transform_a.basis.get_axis(i) ).normalized();
 
-			if (!separator.test_axis( axis  ))
+			if (!separator.queue_axis( axis  ))
 				return;
 		}
 	}
 
 
+	if (!separator.flush_axes())
+		return;
+
 	separator.generate_contacts();
 }
 
@@ -856,7 +947,7 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a,const Transform &p_
 
 		Vector3 axis = p_transform_a.basis.get_axis(i).normalized();
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 	}
 
@@ -865,7 +956,7 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a,const Transform &p_
 
 		Vector3 axis = p_transform_b.xform( faces[i].plane ).normal;
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 	}
 
@@ -880,12 +971,15 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a,const Transform &p_
 
 			Vector3 axis=e1.cross( e2 ).normalized();
 
-			if (!separator.test_axis( axis ))
+			if (!separator.queue_axis( axis ))
 				return;
 
 		}
 	}
 
+	if (!separator.flush_axes())
+		return;
+
 	separator.generate_contacts();
 
 
@@ -958,37 +1052,40 @@ static void _collision_capsule_capsule(const ShapeSW *p_a,const Transform &p_tra
 
 	//balls-balls
 
-	if (!separator.test_axis( (capsule_A_ball_1 - capsule_B_ball_1 ).normalized() ) )
+	if (!separator.queue_axis( (capsule_A_ball_1 - capsule_B_ball_1 ).normalized() ) )
 		return;
-	if (!separator.test_axis( (capsule_A_ball_1 - capsule_B_ball_2 ).normalized() ) )
+	if (!separator.queue_axis( (capsule_A_ball_1 - capsule_B_ball_2 ).normalized() ) )
 		return;
 
-	if (!separator.test_axis( (capsule_A_ball_2 - capsule_B_ball_1 ).normalized() ) )
+	if (!separator.queue_axis( (capsule_A_ball_2 - capsule_B_ball_1 ).normalized() ) )
 		return;
-	if (!separator.test_axis( (capsule_A_ball_2 - capsule_B_ball_2 ).normalized() ) )
+	if (!separator.queue_axis( (capsule_A_ball_2 - capsule_B_ball_2 ).normalized() ) )
 		return;
 
 
 	// edges-balls
 
-	if (!separator.test_axis( (capsule_A_ball_1 - capsule_B_ball_1 ).cross(capsule_A_axis).cross(capsule_A_axis).normalized() ) )
+	if (!separator.queue_axis( (capsule_A_ball_1 - capsule_B_ball_1 ).cross(capsule_A_axis).cross(capsule_A_axis).normalized() ) )
 		return;
 
-	if (!separator.test_axis( (capsule_A_ball_1 - capsule_B_ball_2 ).cross(capsule_A_axis).cross(capsule_A_axis).normalized() ) )
+	if (!separator.queue_axis( (capsule_A_ball_1 - capsule_B_ball_2 ).cross(capsule_A_axis).cross(capsule_A_axis).normalized() ) )
 		return;
 
-	if (!separator.test_axis( (capsule_B_ball_1 - capsule_A_ball_1 ).cross(capsule_B_axis).cross(capsule_B_axis).normalized() ) )
+	if (!separator.queue_axis( (capsule_B_ball_1 - capsule_A_ball_1 ).cross(capsule_B_axis).cross(capsule_B_axis).normalized() ) )
 		return;
 
-	if (!separator.test_axis( (capsule_B_ball_1 - capsule_A_ball_2 ).cross(capsule_B_axis).cross(capsule_B_axis).normalized() ) )
+	if (!separator.queue_axis( (capsule_B_ball_1 - capsule_A_ball_2 ).cross(capsule_B_axis).cross(capsule_B_axis).normalized() ) )
 		return;
 
 	// edges
 
-	if (!separator.test_axis( capsule_A_axis.cross(capsule_B_axis).normalized() ) )
+	if (!separator.queue_axis( capsule_A_axis.cross(capsule_B_axis).normalized() ) )
 		return;
 
 
+	if (!separator.flush_axes())
+		return;
+
 	separator.generate_contacts();
 
 }
@@ -1018,7 +1115,7 @@ static void _collision_capsule_convex_polygon(const ShapeSW *p_a,const Transform
 
 		Vector3 axis = p_transform_b.xform( faces[i].plane ).normal;
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 	}
 
@@ -1031,7 +1128,7 @@ static void _collision_capsule_convex_polygon(const ShapeSW *p_a,const Transform
 		Vector3 axis = edge_axis.cross( p_transform_a.basis.get_axis(2) ).normalized();
 
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 	}
 
@@ -1053,12 +1150,15 @@ static void _collision_capsule_convex_polygon(const ShapeSW *p_a,const Transform
 
 			Vector3 axis = n1.cross(n2).cross(n2).normalized();
 
-			if (!separator.test_axis( axis ))
+			if (!separator.queue_axis( axis ))
 				return;
 		}
 	}
 
 
+	if (!separator.flush_axes())
+		return;
+
 	separator.generate_contacts();
 
 }
@@ -1160,7 +1260,7 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a,const Tr
 		Vector3 axis = p_transform_a.xform( faces_A[i].plane ).normal;
 //		Vector3 axis = p_transform_a.basis.xform( faces_A[i].plane.normal ).normalized();
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 	}
 
@@ -1171,7 +1271,7 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a,const Tr
 //		Vector3 axis = p_transform_b.basis.xform( faces_B[i].plane.normal ).normalized();
 
 
-		if (!separator.test_axis( axis ))
+		if (!separator.queue_axis( axis ))
 			return;
 	}
 
@@ -1186,12 +1286,15 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a,const Tr
 
 			Vector3 axis=e1.cross( e2 ).normalized();
 
-			if (!separator.test_axis( axis ))
+			if (!separator.queue_axis( axis ))
 				return;
 
 		}
 	}
 
+	if (!separator.flush_axes())
+		return;
+
 	separator.generate_contacts();
 
 }
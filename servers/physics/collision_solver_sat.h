@@ -32,6 +32,10 @@
 #include "collision_solver_sw.h"
 
 
+// axis tests run four at a time when enabled (default), the scalar path is kept for reference
+void sat_set_simd_enabled(bool p_enabled);
+bool sat_is_simd_enabled();
+
 bool sat_calculate_penetration(const ShapeSW *p_shape_A, const Transform& p_transform_A, const ShapeSW *p_shape_B, const Transform& p_transform_B, CollisionSolverSW::CallbackResult p_result_callback,void *p_userdata, bool p_swap=false,Vector3* r_prev_axis=NULL);
 
 #endif // COLLISION_SOLVER_SAT_H
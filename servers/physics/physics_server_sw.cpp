@@ -29,6 +29,8 @@
 #include "physics_server_sw.h"
 #include "broad_phase_basic.h"
 #include "broad_phase_octree.h"
+#include "broad_phase_sap.h"
+#include "globals.h"
 
 RID PhysicsServerSW::shape_create(ShapeType p_shape) {
 
@@ -191,6 +193,27 @@ PhysicsDirectSpaceState* PhysicsServerSW::space_get_direct_state(RID p_space) {
 	return space->get_direct_state();
 }
 
+int PhysicsServerSW::space_get_snapshot_size(RID p_space) const {
+
+	const SpaceSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space,0);
+	return space->get_snapshot_size();
+}
+
+int PhysicsServerSW::space_snapshot(RID p_space,uint8_t *r_buffer,int p_size) const {
+
+	const SpaceSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space,0);
+	return space->snapshot(r_buffer,p_size);
+}
+
+Error PhysicsServerSW::space_restore_snapshot(RID p_space,const uint8_t *p_buffer,int p_size) {
+
+	SpaceSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space,ERR_INVALID_PARAMETER);
+	return space->restore_snapshot(p_buffer,p_size);
+}
+
 RID PhysicsServerSW::area_create() {
 
 	AreaSW *area = memnew( AreaSW );
@@ -987,6 +1010,15 @@ void PhysicsServerSW::init() {
 	iterations=8;// 8?
 	stepper = memnew( StepSW );
 	direct_state = memnew( PhysicsDirectBodyStateSW );
+
+	String broad_phase = GLOBAL_DEF("physics/broad_phase","octree");
+	Globals::get_singleton()->set_custom_property_info("physics/broad_phase",PropertyInfo(Variant::STRING,"physics/broad_phase",PROPERTY_HINT_ENUM,"octree,sap,basic"));
+	if (broad_phase=="sap")
+		BroadPhaseSW::create_func=BroadPhaseSAP::_create;
+	else if (broad_phase=="basic")
+		BroadPhaseSW::create_func=BroadPhaseBasic::_create;
+	else
+		BroadPhaseSW::create_func=BroadPhaseOctree::_create;
 };
 
 
@@ -308,6 +308,18 @@ void BoxShapeSW::project_range(const Vector3& p_normal, const Transform& p_trans
 
 }
 
+void BoxShapeSW::project_range4(const Simd4 *p_axes, const Transform& p_transform, Simd4 &r_min, Simd4 &r_max) const {
+
+	Simd4 local[3];
+	Simd4 distance;
+	_axes4_to_local(p_axes,p_transform,local,distance);
+
+	Simd4 length = local[0].abs()*Simd4(half_extents.x) + local[1].abs()*Simd4(half_extents.y) + local[2].abs()*Simd4(half_extents.z);
+
+	r_min = distance - length;
+	r_max = distance + length;
+}
+
 Vector3 BoxShapeSW::get_support(const Vector3& p_normal) const {
 
 
@@ -480,6 +492,20 @@ void CapsuleShapeSW::project_range(const Vector3& p_normal, const Transform& p_t
 
 }
 
+void CapsuleShapeSW::project_range4(const Simd4 *p_axes, const Transform& p_transform, Simd4 &r_min, Simd4 &r_max) const {
+
+	// same as project_range, the support point n*radius+h*0.5 dotted with the local normal
+	Simd4 local[3];
+	Simd4 distance;
+	_axes4_to_local(p_axes,p_transform,local,distance);
+
+	Simd4 local_len = (local[0]*local[0] + local[1]*local[1] + local[2]*local[2]).sqrt();
+	Simd4 length = local_len*Simd4(radius) + local[2].abs()*Simd4(height*0.5);
+
+	r_min = distance - length;
+	r_max = distance + length;
+}
+
 Vector3 CapsuleShapeSW::get_support(const Vector3& p_normal) const {
 
 	Vector3 n=p_normal;
@@ -643,43 +669,96 @@ void ConvexPolygonShapeSW::project_range(const Vector3& p_normal, const Transfor
 	if (vertex_count==0)
 		return;
 
-	const Vector3 *vrts=&mesh.vertices[0];
+	// project in shape space, four vertices at a time
+	Vector3 n=p_transform.basis.xform_inv(p_normal);
+	real_t distance=p_normal.dot(p_transform.origin);
+	Simd4 nx(n.x),ny(n.y),nz(n.z);
 
-	for (int i=0;i<vertex_count;i++) {
+	const real_t *soa=soa_vertices.ptr();
+	Simd4 d=Simd4::load(soa)*nx+Simd4::load(soa+4)*ny+Simd4::load(soa+8)*nz;
+	Simd4 dmin=d;
+	Simd4 dmax=d;
 
-		float d=p_normal.dot( p_transform.xform( vrts[i] ) );
+	int blocks=(vertex_count+3)>>2;
+	for (int i=1;i<blocks;i++) {
 
-		if (i==0 || d > r_max)
-			r_max=d;
-		if (i==0 || d < r_min)
-			r_min=d;
+		const real_t *b=&soa[i*12];
+		d=Simd4::load(b)*nx+Simd4::load(b+4)*ny+Simd4::load(b+8)*nz;
+		dmin=dmin.min(d);
+		dmax=dmax.max(d);
 	}
+
+	r_min=dmin.horizontal_min()+distance;
+	r_max=dmax.horizontal_max()+distance;
 }
 
-Vector3 ConvexPolygonShapeSW::get_support(const Vector3& p_normal) const {
+void ConvexPolygonShapeSW::project_range4(const Simd4 *p_axes, const Transform& p_transform, Simd4 &r_min, Simd4 &r_max) const {
 
-	Vector3 n=p_normal;
+	int vertex_count=mesh.vertices.size();
+	if (vertex_count==0)
+		return;
 
-	int vert_support_idx=-1;
-	float support_max;
+	// one vertex against four axes per step
+	Simd4 local[3];
+	Simd4 distance;
+	_axes4_to_local(p_axes,p_transform,local,distance);
+
+	const Vector3 *vrts=mesh.vertices.ptr();
+	Simd4 d=local[0]*Simd4(vrts[0].x)+local[1]*Simd4(vrts[0].y)+local[2]*Simd4(vrts[0].z);
+	Simd4 dmin=d;
+	Simd4 dmax=d;
+
+	for (int i=1;i<vertex_count;i++) {
+
+		d=local[0]*Simd4(vrts[i].x)+local[1]*Simd4(vrts[i].y)+local[2]*Simd4(vrts[i].z);
+		dmin=dmin.min(d);
+		dmax=dmax.max(d);
+	}
+
+	r_min=dmin+distance;
+	r_max=dmax+distance;
+}
+
+Vector3 ConvexPolygonShapeSW::get_support(const Vector3& p_normal) const {
 
 	int vertex_count=mesh.vertices.size();
 	if (vertex_count==0)
 		return Vector3();
 
-	const Vector3 *vrts=&mesh.vertices[0];
+	// keep the first best vertex per lane, then the first best lane, like a linear scan would
+	Simd4 nx(p_normal.x),ny(p_normal.y),nz(p_normal.z);
+	const real_t *soa=soa_vertices.ptr();
 
-	for (int i=0;i<vertex_count;i++) {
+	Simd4 best=Simd4::load(soa)*nx+Simd4::load(soa+4)*ny+Simd4::load(soa+8)*nz;
+	Simd4 best_idx(0,1,2,3);
+	Simd4 idx=best_idx;
+	Simd4 four(4);
 
-		float d=n.dot(vrts[i]);
+	int blocks=(vertex_count+3)>>2;
+	for (int i=1;i<blocks;i++) {
 
-		if (i==0 || d > support_max) {
-			support_max=d;
-			vert_support_idx=i;
-		}
+		const real_t *b=&soa[i*12];
+		Simd4 d=Simd4::load(b)*nx+Simd4::load(b+4)*ny+Simd4::load(b+8)*nz;
+		idx=idx+four;
+		Simd4 better=d.greater(best);
+		best=Simd4::select(better,d,best);
+		best_idx=Simd4::select(better,idx,best_idx);
+	}
+
+	real_t support_max=best.horizontal_max();
+	int vert_support_idx=vertex_count;
+	for(int i=0;i<4;i++) {
+
+		int lane_idx=int(best_idx.get(i));
+		if (best.get(i)==support_max && lane_idx<vert_support_idx)
+			vert_support_idx=lane_idx;
 	}
 
-	return  vrts[vert_support_idx];
+	// padding repeats the last vertex
+	if (vert_support_idx>=vertex_count)
+		vert_support_idx=vertex_count-1;
+
+	return mesh.vertices[vert_support_idx];
 
 }
 
@@ -819,6 +898,19 @@ Vector3 ConvexPolygonShapeSW::get_moment_of_inertia(float p_mass) const {
 void ConvexPolygonShapeSW::_setup(const Vector<Vector3>& p_vertices)  {
 
 	Error err = QuickHull::build(p_vertices,mesh);
+
+	int vertex_count=mesh.vertices.size();
+	int blocks=(vertex_count+3)>>2;
+	soa_vertices.resize(blocks*12);
+	for(int i=0;i<blocks*4;i++) {
+
+		const Vector3 &v=mesh.vertices[MIN(i,vertex_count-1)];
+		real_t *b=&soa_vertices[(i>>2)*12+(i&3)];
+		b[0]=v.x;
+		b[4]=v.y;
+		b[8]=v.z;
+	}
+
 	AABB _aabb;
 
 	for(int i=0;i<mesh.vertices.size();i++) {
@@ -32,6 +32,7 @@
 #include "servers/physics_server.h"
 #include "bsp_tree.h"
 #include "geometry.h"
+#include "simd4.h"
 /*
 
 SHAPE_LINE, ///< plane:"plane"
@@ -67,6 +68,16 @@ class ShapeSW {
 protected:
 
 	void configure(const AABB& p_aabb);
+
+	// four world axes (x,y,z lanes) to shape space, plus their projection of the origin
+	static _FORCE_INLINE_ void _axes4_to_local(const Simd4 *p_axes,const Transform& p_transform,Simd4 *r_local,Simd4 &r_origin) {
+
+		const Matrix3 &b=p_transform.basis;
+		for(int i=0;i<3;i++)
+			r_local[i]=p_axes[0]*Simd4(b.elements[0][i])+p_axes[1]*Simd4(b.elements[1][i])+p_axes[2]*Simd4(b.elements[2][i]);
+		const Vector3 &o=p_transform.origin;
+		r_origin=p_axes[0]*Simd4(o.x)+p_axes[1]*Simd4(o.y)+p_axes[2]*Simd4(o.z);
+	}
 public:
 
 	enum {
@@ -202,6 +213,7 @@ public:
 	virtual PhysicsServer::ShapeType get_type() const { return PhysicsServer::SHAPE_BOX; }
 
 	virtual void project_range(const Vector3& p_normal, const Transform& p_transform, real_t &r_min, real_t &r_max) const;
+	void project_range4(const Simd4 *p_axes, const Transform& p_transform, Simd4 &r_min, Simd4 &r_max) const;
 	virtual Vector3 get_support(const Vector3& p_normal) const;
 	virtual void get_supports(const Vector3& p_normal,int p_max,Vector3 *r_supports,int & r_amount) const;
 	virtual bool intersect_segment(const Vector3& p_begin,const Vector3& p_end,Vector3 &r_result, Vector3 &r_normal) const;
@@ -229,6 +241,7 @@ public:
 	virtual PhysicsServer::ShapeType get_type() const { return PhysicsServer::SHAPE_CAPSULE; }
 
 	virtual void project_range(const Vector3& p_normal, const Transform& p_transform, real_t &r_min, real_t &r_max) const;
+	void project_range4(const Simd4 *p_axes, const Transform& p_transform, Simd4 &r_min, Simd4 &r_max) const;
 	virtual Vector3 get_support(const Vector3& p_normal) const;
 	virtual void get_supports(const Vector3& p_normal,int p_max,Vector3 *r_supports,int & r_amount) const;
 	virtual bool intersect_segment(const Vector3& p_begin,const Vector3& p_end,Vector3 &r_result, Vector3 &r_normal) const;
@@ -244,6 +257,8 @@ public:
 struct ConvexPolygonShapeSW : public ShapeSW {
 
 	Geometry::MeshData mesh;
+	// vertices in blocks of four: x0..x3,y0..y3,z0..z3, last block padded with the last vertex
+	Vector<real_t> soa_vertices;
 
 	void _setup(const Vector<Vector3>& p_vertices);
 public:
@@ -253,6 +268,7 @@ public:
 	virtual PhysicsServer::ShapeType get_type() const { return PhysicsServer::SHAPE_CONVEX_POLYGON; }
 
 	virtual void project_range(const Vector3& p_normal, const Transform& p_transform, real_t &r_min, real_t &r_max) const;
+	void project_range4(const Simd4 *p_axes, const Transform& p_transform, Simd4 &r_min, Simd4 &r_max) const;
 	virtual Vector3 get_support(const Vector3& p_normal) const;
 	virtual void get_supports(const Vector3& p_normal,int p_max,Vector3 *r_supports,int & r_amount) const;
 	virtual bool intersect_segment(const Vector3& p_begin,const Vector3& p_end,Vector3 &r_result, Vector3 &r_normal) const;
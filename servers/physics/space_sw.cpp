@@ -30,6 +30,9 @@
 #include "space_sw.h"
 #include "collision_solver_sw.h"
 #include "physics_server_sw.h"
+#include "sort.h"
+
+#include <string.h>
 
 
 bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3& p_from, const Vector3& p_to,RayResult &r_result,const Set<RID>& p_exclude,uint32_t p_user_mask) {
@@ -207,6 +210,11 @@ void* SpaceSW::_broadphase_pair(CollisionObjectSW *A,int p_subindex_A,CollisionO
 		return area_pair;
 	} else {
 
+		//keep pairs oriented by id, so a pair recreated after a restore solves the same way
+		if (B->get_self() < A->get_self()) {
+			SWAP(A,B);
+			SWAP(p_subindex_A,p_subindex_B);
+		}
 
 		BodyPairSW *b = memnew( BodyPairSW((BodySW*)A,p_subindex_A,(BodySW*)B,p_subindex_B) );
 		return b;
@@ -327,6 +335,497 @@ void SpaceSW::call_queries() {
 
 }
 
+static bool _sweep_aabb_range(const AABB& p_moving,const Vector3& p_dir,const AABB& p_static,real_t &r_from,real_t &r_to) {
+
+	//narrow [r_from,r_to] to the offsets along p_dir where the moving box overlaps the static one
+	for(int i=0;i<3;i++) {
+
+		real_t lo = p_static.pos[i]-(p_moving.pos[i]+p_moving.size[i]);
+		real_t hi = (p_static.pos[i]+p_static.size[i])-p_moving.pos[i];
+
+		if (Math::abs(p_dir[i])<CMP_EPSILON) {
+			if (lo>0 || hi<0)
+				return false; //never overlap on this axis
+			continue;
+		}
+
+		real_t t0 = lo/p_dir[i];
+		real_t t1 = hi/p_dir[i];
+		if (t0>t1)
+			SWAP(t0,t1);
+		r_from=MAX(r_from,t0);
+		r_to=MIN(r_to,t1);
+		if (r_from>r_to)
+			return false;
+	}
+
+	return true;
+}
+
+real_t SpaceSW::body_cast_motion(const BodySW *p_body,const Vector3& p_motion) {
+
+	// conservative advancement of every body shape along the motion (rotation is ignored).
+	// returns the fraction of the motion that can be safely applied, the body ends up
+	// slightly touching the first obstacle so regular contacts resolve it next step.
+
+	real_t motion_len = p_motion.length();
+	if (motion_len<CMP_EPSILON)
+		return 1.0;
+
+	Vector3 motion_dir = p_motion/motion_len;
+	real_t safe_len=motion_len;
+
+	for(int i=0;i<p_body->get_shape_count();i++) {
+
+		const ShapeSW *shape = p_body->get_shape(i);
+		if (shape->is_concave() || shape->get_type()==PhysicsServer::SHAPE_PLANE || shape->get_type()==PhysicsServer::SHAPE_RAY)
+			continue; //can't be swept
+
+		Transform xform = p_body->get_transform() * p_body->get_shape_transform(i);
+
+		real_t smin,smax;
+		shape->project_range(motion_dir,xform,smin,smax);
+
+		//advancing less than half the thinnest extent of the shape keeps consecutive samples
+		//overlapping, also when moving diagonally
+		real_t step = smax-smin;
+		for(int k=0;k<3;k++) {
+
+			real_t amin,amax;
+			shape->project_range(xform.basis.get_axis(k).normalized(),xform,amin,amax);
+			step=MIN(step,amax-amin);
+		}
+		step*=0.5;
+		if (step<CMP_EPSILON || safe_len<=step)
+			continue; //too thin to sweep, or discrete collision already catches it
+
+		AABB shape_aabb = xform.xform(shape->get_aabb());
+		AABB aabb=shape_aabb.merge(AABB(shape_aabb.pos+motion_dir*safe_len,shape_aabb.size));
+
+		int amount = broadphase->cull_aabb(aabb,intersection_query_results,INTERSECTION_QUERY_MAX,intersection_query_subindex_results);
+
+		for(int j=0;j<amount;j++) {
+
+			const CollisionObjectSW *col_obj=intersection_query_results[j];
+
+			if (col_obj==p_body || col_obj->get_type()==CollisionObjectSW::TYPE_AREA)
+				continue;
+
+			const BodySW *col_body=static_cast<const BodySW*>(col_obj);
+			if (p_body->has_exception(col_body->get_self()) || col_body->has_exception(p_body->get_self()))
+				continue;
+
+			int shape_idx=intersection_query_subindex_results[j];
+			const ShapeSW *col_shape=col_obj->get_shape(shape_idx);
+			Transform col_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
+
+			real_t cmin,cmax;
+			col_shape->project_range(motion_dir,col_xform,cmin,cmax);
+
+			//along the motion, the shapes can't touch before this offset and are past each other after that one
+			real_t from = MAX(0,cmin-smax);
+			real_t to = MIN(safe_len,cmax-smin);
+			if (from>=to)
+				continue;
+
+			//only sample where the bounding boxes overlap, this keeps big obstacles cheap
+			real_t box_from=from;
+			if (!_sweep_aabb_range(shape_aabb,motion_dir,col_xform.xform(col_shape->get_aabb()),box_from,to))
+				continue;
+
+			if (CollisionSolverSW::solve_static(shape,xform,col_shape,col_xform,NULL,NULL))
+				continue; //already in contact, regular contacts take care of it
+
+			//never sample further apart than step, or thin obstacles slip between samples.
+			//start a step before the boxes touch, so bisection begins from a free position
+			real_t sample_step = step;
+			real_t free_ofs=0;
+			real_t hit_ofs=-1;
+			real_t ofs=MAX(from,box_from-sample_step);
+
+			while(true) {
+
+				if (ofs>0) {
+
+					Transform sample_xform=xform;
+					sample_xform.origin+=motion_dir*ofs;
+					if (CollisionSolverSW::solve_static(shape,sample_xform,col_shape,col_xform,NULL,NULL)) {
+						hit_ofs=ofs;
+						break;
+					}
+					free_ofs=ofs;
+				}
+
+				if (ofs>=to)
+					break;
+				ofs=MIN(ofs+sample_step,to);
+			}
+
+			if (hit_ofs<0)
+				continue;
+
+			//refine time of impact
+			for(int k=0;k<CCD_BISECTION_STEPS;k++) {
+
+				real_t mid=(free_ofs+hit_ofs)*0.5;
+				Transform sample_xform=xform;
+				sample_xform.origin+=motion_dir*mid;
+				if (CollisionSolverSW::solve_static(shape,sample_xform,col_shape,col_xform,NULL,NULL))
+					hit_ofs=mid;
+				else
+					free_ofs=mid;
+			}
+
+			//the first hit may only be touching, end a little inside so the contact is found next step
+			hit_ofs=MIN(hit_ofs+contact_max_allowed_penetration,to);
+			if (hit_ofs<safe_len)
+				safe_len=hit_ofs;
+		}
+	}
+
+	return safe_len/motion_len;
+}
+
+int SpaceSW::get_snapshot_size() const {
+
+	int size=sizeof(SnapshotHeader);
+
+	for(const Set<CollisionObjectSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()==CollisionObjectSW::TYPE_BODY) {
+
+			const BodySW *body=static_cast<const BodySW*>(E->get());
+			size+=sizeof(SnapshotBody)+sizeof(AABB)*body->get_shape_count();
+
+			for(const Map<ConstraintSW*,int,ConstraintCMP>::Element *F=body->get_constraint_map().front();F;F=F->next()) {
+
+				if (F->get()==0 && F->key()->get_type()==ConstraintSW::TYPE_BODY_PAIR)
+					size+=sizeof(SnapshotPair)+static_cast<const BodyPairSW*>(F->key())->get_state_size();
+			}
+		} else {
+
+			const AreaSW *area=static_cast<const AreaSW*>(E->get());
+			for(const Set<ConstraintSW*,ConstraintCMP>::Element *F=area->get_constraints().front();F;F=F->next()) {
+
+				if (static_cast<const AreaPairSW*>(F->get())->is_colliding())
+					size+=sizeof(SnapshotPair);
+			}
+		}
+	}
+
+	for(const SelfList<BodySW> *b=active_list.first();b;b=b->next())
+		size+=sizeof(uint32_t);
+
+	return size;
+}
+
+int SpaceSW::snapshot(uint8_t *r_buffer,int p_size) const {
+
+	ERR_FAIL_COND_V(locked,0);
+	int size=get_snapshot_size();
+	ERR_FAIL_COND_V(p_size<size,0);
+
+	SnapshotHeader header;
+	header.magic=SNAPSHOT_MAGIC;
+	header.body_count=0;
+	header.active_count=0;
+	header.body_pair_count=0;
+	header.area_pair_count=0;
+
+	uint8_t *w=r_buffer+sizeof(SnapshotHeader);
+
+	for(const Set<CollisionObjectSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObjectSW::TYPE_BODY)
+			continue;
+
+		const BodySW *body=static_cast<const BodySW*>(E->get());
+		SnapshotBody sb;
+		sb.id=body->get_self().get_id();
+		sb.shape_count=body->get_shape_count();
+		body->save_state(sb.state);
+		memcpy(w,&sb,sizeof(SnapshotBody));
+		w+=sizeof(SnapshotBody);
+
+		for(int i=0;i<body->get_shape_count();i++) {
+
+			memcpy(w,&body->get_shape_aabb(i),sizeof(AABB));
+			w+=sizeof(AABB);
+		}
+		header.body_count++;
+	}
+
+	//islands are built following the active list, so its order is part of the state
+	for(const SelfList<BodySW> *b=active_list.first();b;b=b->next()) {
+
+		uint32_t id=b->self()->get_self().get_id();
+		memcpy(w,&id,sizeof(uint32_t));
+		w+=sizeof(uint32_t);
+		header.active_count++;
+	}
+
+	//contact caches, grouped by their first body in object order
+	for(const Set<CollisionObjectSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObjectSW::TYPE_BODY)
+			continue;
+
+		const BodySW *body=static_cast<const BodySW*>(E->get());
+		for(const Map<ConstraintSW*,int,ConstraintCMP>::Element *F=body->get_constraint_map().front();F;F=F->next()) {
+
+			if (F->get()!=0 || F->key()->get_type()!=ConstraintSW::TYPE_BODY_PAIR)
+				continue;
+
+			SnapshotPair sp;
+			sp.key=F->key()->get_sort_key();
+			sp.subkey=F->key()->get_sort_subkey();
+			sp.size=static_cast<const BodyPairSW*>(F->key())->save_state(w+sizeof(SnapshotPair));
+			memcpy(w,&sp,sizeof(SnapshotPair));
+			w+=sizeof(SnapshotPair)+sp.size;
+			header.body_pair_count++;
+		}
+	}
+
+	for(const Set<CollisionObjectSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObjectSW::TYPE_AREA)
+			continue;
+
+		const AreaSW *area=static_cast<const AreaSW*>(E->get());
+		for(const Set<ConstraintSW*,ConstraintCMP>::Element *F=area->get_constraints().front();F;F=F->next()) {
+
+			if (!static_cast<const AreaPairSW*>(F->get())->is_colliding())
+				continue;
+
+			SnapshotPair sp;
+			sp.key=F->get()->get_sort_key();
+			sp.subkey=F->get()->get_sort_subkey();
+			sp.size=0;
+			memcpy(w,&sp,sizeof(SnapshotPair));
+			w+=sizeof(SnapshotPair);
+			header.area_pair_count++;
+		}
+	}
+
+	memcpy(r_buffer,&header,sizeof(SnapshotHeader));
+
+	return w-r_buffer;
+}
+
+static _FORCE_INLINE_ bool _snapshot_pair_less(uint64_t p_key,uint64_t p_subkey,const ConstraintSW *p_constraint) {
+
+	if (p_key!=p_constraint->get_sort_key())
+		return p_key < p_constraint->get_sort_key();
+	return p_subkey < p_constraint->get_sort_subkey();
+}
+
+Error SpaceSW::restore_snapshot(const uint8_t *p_buffer,int p_size) {
+
+	ERR_FAIL_COND_V(locked,ERR_LOCKED);
+	ERR_FAIL_COND_V(p_size<(int)sizeof(SnapshotHeader),ERR_INVALID_DATA);
+
+	SnapshotHeader header;
+	memcpy(&header,p_buffer,sizeof(SnapshotHeader));
+	ERR_FAIL_COND_V(header.magic!=SNAPSHOT_MAGIC,ERR_INVALID_DATA);
+
+	//validate everything before touching the space, a snapshot only applies to the bodies it was taken from
+	const uint8_t *r=p_buffer+sizeof(SnapshotHeader);
+	int left=p_size-sizeof(SnapshotHeader);
+	uint32_t body_count=0;
+
+	for(Set<CollisionObjectSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObjectSW::TYPE_BODY)
+			continue;
+
+		BodySW *body=static_cast<BodySW*>(E->get());
+		ERR_FAIL_COND_V(left<(int)sizeof(SnapshotBody),ERR_INVALID_DATA);
+		SnapshotBody sb;
+		memcpy(&sb,r,sizeof(SnapshotBody));
+		ERR_FAIL_COND_V(sb.id!=body->get_self().get_id() || (int)sb.shape_count!=body->get_shape_count(),ERR_INVALID_DATA);
+		int len=sizeof(SnapshotBody)+sizeof(AABB)*sb.shape_count;
+		ERR_FAIL_COND_V(left<len,ERR_INVALID_DATA);
+		r+=len;
+		left-=len;
+		body_count++;
+	}
+
+	ERR_FAIL_COND_V(body_count!=header.body_count || header.active_count>body_count,ERR_INVALID_DATA);
+	const uint8_t *active_ids=r;
+	ERR_FAIL_COND_V(left<int(header.active_count*sizeof(uint32_t)),ERR_INVALID_DATA);
+	r+=header.active_count*sizeof(uint32_t);
+	left-=header.active_count*sizeof(uint32_t);
+
+	const uint8_t *body_pairs=r;
+	for(uint32_t i=0;i<header.body_pair_count;i++) {
+
+		ERR_FAIL_COND_V(left<(int)sizeof(SnapshotPair),ERR_INVALID_DATA);
+		SnapshotPair sp;
+		memcpy(&sp,r,sizeof(SnapshotPair));
+		ERR_FAIL_COND_V(left<int(sizeof(SnapshotPair)+sp.size),ERR_INVALID_DATA);
+		r+=sizeof(SnapshotPair)+sp.size;
+		left-=sizeof(SnapshotPair)+sp.size;
+	}
+
+	ERR_FAIL_COND_V(header.area_pair_count>uint32_t(left/sizeof(SnapshotPair)),ERR_INVALID_DATA);
+	const uint8_t *area_pairs=r;
+
+	/* BODIES */
+
+	while(active_list.first())
+		active_list.first()->self()->set_active(false);
+
+	if (snapshot_body_cache.size()<(int)body_count)
+		snapshot_body_cache.resize(body_count);
+	BodySW **cache=snapshot_body_cache.ptr();
+
+	r=p_buffer+sizeof(SnapshotHeader);
+	int idx=0;
+
+	for(Set<CollisionObjectSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObjectSW::TYPE_BODY)
+			continue;
+
+		BodySW *body=static_cast<BodySW*>(E->get());
+		SnapshotBody sb;
+		memcpy(&sb,r,sizeof(SnapshotBody));
+		r+=sizeof(SnapshotBody);
+		body->load_state(sb.state);
+
+		//shape aabbs may have been extended by motion, restoring them as they were gives the broadphase the same pairs
+		for(int i=0;i<body->get_shape_count();i++) {
+
+			AABB aabb;
+			memcpy(&aabb,r,sizeof(AABB));
+			r+=sizeof(AABB);
+			body->_set_shape_aabb(i,aabb);
+		}
+
+		cache[idx++]=body;
+	}
+
+	broadphase->update();
+
+	SortArray<BodySW*,SnapshotBodyCMP> sorter;
+	sorter.sort(cache,body_count);
+
+	//the list adds to the front, so go backwards
+	for(int i=int(header.active_count)-1;i>=0;i--) {
+
+		uint32_t id;
+		memcpy(&id,active_ids+i*sizeof(uint32_t),sizeof(uint32_t));
+
+		int low=0;
+		int high=body_count;
+		while(low<high) {
+			int mid=(low+high)>>1;
+			if (cache[mid]->get_self().get_id()<id)
+				low=mid+1;
+			else
+				high=mid;
+		}
+
+		ERR_CONTINUE(low==int(body_count) || cache[low]->get_self().get_id()!=id);
+		cache[low]->set_active(true);
+	}
+
+	/* PAIRS */
+
+	r=body_pairs;
+	uint32_t pairs_left=header.body_pair_count;
+
+	for(Set<CollisionObjectSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObjectSW::TYPE_BODY)
+			continue;
+
+		BodySW *body=static_cast<BodySW*>(E->get());
+		uint32_t id=body->get_self().get_id();
+
+		for(Map<ConstraintSW*,int,ConstraintCMP>::Element *F=body->get_constraint_map().front();F;F=F->next()) {
+
+			if (F->get()!=0 || F->key()->get_type()!=ConstraintSW::TYPE_BODY_PAIR)
+				continue;
+
+			BodyPairSW *pair=static_cast<BodyPairSW*>(F->key());
+			SnapshotPair sp;
+
+			//both sides are sorted the same way, skip records of pairs that no longer exist
+			while(pairs_left) {
+				memcpy(&sp,r,sizeof(SnapshotPair));
+				if ((sp.key>>32)!=id || !_snapshot_pair_less(sp.key,sp.subkey,pair))
+					break;
+				r+=sizeof(SnapshotPair)+sp.size;
+				pairs_left--;
+			}
+
+			if (pairs_left && sp.key==pair->get_sort_key() && sp.subkey==pair->get_sort_subkey()) {
+
+				pair->load_state(r+sizeof(SnapshotPair),sp.size);
+				r+=sizeof(SnapshotPair)+sp.size;
+				pairs_left--;
+			} else {
+
+				pair->clear_state();
+			}
+		}
+
+		while(pairs_left) {
+			SnapshotPair sp;
+			memcpy(&sp,r,sizeof(SnapshotPair));
+			if ((sp.key>>32)!=id)
+				break;
+			r+=sizeof(SnapshotPair)+sp.size;
+			pairs_left--;
+		}
+	}
+
+	r=area_pairs;
+	pairs_left=header.area_pair_count;
+
+	for(Set<CollisionObjectSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObjectSW::TYPE_AREA)
+			continue;
+
+		AreaSW *area=static_cast<AreaSW*>(E->get());
+		uint32_t id=area->get_self().get_id();
+
+		for(const Set<ConstraintSW*,ConstraintCMP>::Element *F=area->get_constraints().front();F;F=F->next()) {
+
+			AreaPairSW *pair=static_cast<AreaPairSW*>(F->get());
+			SnapshotPair sp;
+
+			while(pairs_left) {
+				memcpy(&sp,r,sizeof(SnapshotPair));
+				if ((sp.key>>32)!=id || !_snapshot_pair_less(sp.key,sp.subkey,pair))
+					break;
+				r+=sizeof(SnapshotPair);
+				pairs_left--;
+			}
+
+			bool colliding = pairs_left && sp.key==pair->get_sort_key() && sp.subkey==pair->get_sort_subkey();
+			pair->set_colliding(colliding);
+			if (colliding) {
+				r+=sizeof(SnapshotPair);
+				pairs_left--;
+			}
+		}
+
+		while(pairs_left) {
+			SnapshotPair sp;
+			memcpy(&sp,r,sizeof(SnapshotPair));
+			if ((sp.key>>32)!=id)
+				break;
+			r+=sizeof(SnapshotPair);
+			pairs_left--;
+		}
+	}
+
+	return OK;
+}
+
 void SpaceSW::setup() {
 
 
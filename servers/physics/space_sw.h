@@ -81,7 +81,8 @@ class SpaceSW {
 
 	enum {
 
-		INTERSECTION_QUERY_MAX=2048
+		INTERSECTION_QUERY_MAX=2048,
+		CCD_BISECTION_STEPS=8
 	};
 
 	CollisionObjectSW *intersection_query_results[INTERSECTION_QUERY_MAX];
@@ -94,6 +95,40 @@ class SpaceSW {
 
 	bool locked;
 
+	enum {
+		SNAPSHOT_MAGIC=0x50534e50 // PSNP
+	};
+
+	struct SnapshotHeader {
+
+		uint32_t magic;
+		uint32_t body_count;
+		uint32_t active_count;
+		uint32_t body_pair_count;
+		uint32_t area_pair_count;
+	};
+
+	struct SnapshotBody {
+
+		uint32_t id;
+		uint32_t shape_count;
+		BodySW::State state;
+	};
+
+	struct SnapshotPair {
+
+		uint64_t key;
+		uint64_t subkey;
+		uint32_t size;
+	};
+
+	struct SnapshotBodyCMP {
+
+		_FORCE_INLINE_ bool operator()(const BodySW* p_a,const BodySW* p_b) const { return p_a->get_self() < p_b->get_self(); }
+	};
+
+	Vector<BodySW*> snapshot_body_cache;
+
 friend class PhysicsDirectSpaceStateSW;
 
 public:
@@ -139,6 +174,12 @@ public:
 	void setup();
 	void call_queries();
 
+	real_t body_cast_motion(const BodySW *p_body,const Vector3& p_motion);
+
+	int get_snapshot_size() const;
+	int snapshot(uint8_t *r_buffer,int p_size) const;
+	Error restore_snapshot(const uint8_t *p_buffer,int p_size);
+
 
 	bool is_locked() const;
 	void lock();
@@ -35,7 +35,7 @@ void StepSW::_populate_island(BodySW* p_body,BodySW** p_island,ConstraintSW **p_
 	p_body->set_island_next(*p_island);
 	*p_island=p_body;
 
-	for(Map<ConstraintSW*,int>::Element *E=p_body->get_constraint_map().front();E;E=E->next()) {
+	for(Map<ConstraintSW*,int,ConstraintCMP>::Element *E=p_body->get_constraint_map().front();E;E=E->next()) {
 
 		ConstraintSW *c=(ConstraintSW*)E->key();
 		if (c->get_island_step()==_step)
@@ -167,7 +167,7 @@ void StepSW::step(SpaceSW* p_space,float p_delta,int p_iterations) {
 	const SelfList<AreaSW>::List &aml = p_space->get_moved_area_list();
 
 	while(aml.first()) {
-		for(const Set<ConstraintSW*>::Element *E=aml.first()->self()->get_constraints().front();E;E=E->next()) {
+		for(const Set<ConstraintSW*,ConstraintCMP>::Element *E=aml.first()->self()->get_constraints().front();E;E=E->next()) {
 
 			ConstraintSW*c=E->get();
 			if (c->get_island_step()==_step)
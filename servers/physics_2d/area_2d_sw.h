@@ -93,7 +93,7 @@ class Area2DSW : public CollisionObject2DSW{
 
 	//virtual void shape_changed_notify(Shape2DSW *p_shape);
 	//virtual void shape_deleted_notify(Shape2DSW *p_shape);
-	Set<Constraint2DSW*> constraints;
+	Set<Constraint2DSW*,Constraint2DCMP> constraints;
 
 
 	virtual void _shapes_changed();
@@ -136,7 +136,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint( Constraint2DSW* p_constraint) { constraints.insert(p_constraint); }
 	_FORCE_INLINE_ void remove_constraint( Constraint2DSW* p_constraint) { constraints.erase(p_constraint); }
-	_FORCE_INLINE_ const Set<Constraint2DSW*>& get_constraints() const { return constraints; }
+	_FORCE_INLINE_ const Set<Constraint2DSW*,Constraint2DCMP>& get_constraints() const { return constraints; }
 
 	void set_transform(const Matrix32& p_transform);
 
@@ -472,11 +472,44 @@ void Body2DSW::integrate_velocities(real_t p_step) {
 
 
 
+void Body2DSW::save_state(State& r_state) const {
+
+	r_state.transform=get_transform();
+	r_state.inv_transform=get_inv_transform();
+	r_state.new_transform=new_transform;
+	r_state.linear_velocity=linear_velocity;
+	r_state.angular_velocity=angular_velocity;
+	r_state.biased_linear_velocity=biased_linear_velocity;
+	r_state.biased_angular_velocity=biased_angular_velocity;
+	r_state.applied_force=applied_force;
+	r_state.applied_torque=applied_torque;
+	r_state.still_time=still_time;
+}
+
+void Body2DSW::load_state(const State& p_state) {
+
+	//shapes are not updated here, the space restores their exact broadphase aabbs
+	_set_transform(p_state.transform,false);
+	_set_inv_transform(p_state.inv_transform);
+
+	new_transform=p_state.new_transform;
+	linear_velocity=p_state.linear_velocity;
+	angular_velocity=p_state.angular_velocity;
+	biased_linear_velocity=p_state.biased_linear_velocity;
+	biased_angular_velocity=p_state.biased_angular_velocity;
+	applied_force=p_state.applied_force;
+	applied_torque=p_state.applied_torque;
+	still_time=p_state.still_time;
+
+	if (fi_callback && get_space() && !direct_state_query_list.in_list())
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+}
+
 void Body2DSW::wakeup_neighbours() {
 
 
 
-	for(Map<Constraint2DSW*,int>::Element *E=constraint_map.front();E;E=E->next()) {
+	for(Map<Constraint2DSW*,int,Constraint2DCMP>::Element *E=constraint_map.front();E;E=E->next()) {
 
 		const Constraint2DSW *c=E->key();
 		Body2DSW **n = c->get_body_ptr();
@@ -77,7 +77,7 @@ class Body2DSW : public CollisionObject2DSW {
 	Matrix32 new_transform;
 
 
-	Map<Constraint2DSW*,int> constraint_map;
+	Map<Constraint2DSW*,int,Constraint2DCMP> constraint_map;
 
 	struct AreaCMP {
 
@@ -127,6 +127,22 @@ friend class Physics2DDirectBodyStateSW; // i give up, too many functions to exp
 
 public:
 
+	struct State {
+
+		Matrix32 transform;
+		Matrix32 inv_transform;
+		Matrix32 new_transform;
+		Vector2 linear_velocity;
+		real_t angular_velocity;
+		Vector2 biased_linear_velocity;
+		real_t biased_angular_velocity;
+		Vector2 applied_force;
+		real_t applied_torque;
+		real_t still_time;
+	};
+
+	void save_state(State& r_state) const;
+	void load_state(const State& p_state);
 
 	void set_force_integration_callback(ObjectID p_id, const StringName& p_method, const Variant &p_udata=Variant());
 
@@ -157,7 +173,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(Constraint2DSW* p_constraint, int p_pos) { constraint_map[p_constraint]=p_pos; }
 	_FORCE_INLINE_ void remove_constraint(Constraint2DSW* p_constraint) { constraint_map.erase(p_constraint); }
-	const Map<Constraint2DSW*,int>& get_constraint_map() const { return constraint_map; }
+	const Map<Constraint2DSW*,int,Constraint2DCMP>& get_constraint_map() const { return constraint_map; }
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration=p_omit_force_integration; }
 	_FORCE_INLINE_ bool get_omit_force_integration() const { return omit_force_integration; }
@@ -30,6 +30,8 @@
 #include "collision_solver_2d_sw.h"
 #include "space_2d_sw.h"
 
+#include <string.h>
+
 
 #define POSITION_CORRECTION
 #define ACCUMULATE_IMPULSES
@@ -443,6 +445,48 @@ void BodyPair2DSW::solve(float p_step) {
 }
 
 
+int BodyPair2DSW::get_state_size() const {
+
+	return sizeof(State)+sizeof(Contact)*contact_count;
+}
+
+int BodyPair2DSW::save_state(uint8_t *r_buffer) const {
+
+	State state;
+	state.offset_B=offset_B;
+	state.sep_axis=sep_axis;
+	state.contact_count=contact_count;
+	state.collided=collided;
+	memcpy(r_buffer,&state,sizeof(State));
+	memcpy(r_buffer+sizeof(State),contacts,sizeof(Contact)*contact_count);
+
+	return get_state_size();
+}
+
+int BodyPair2DSW::load_state(const uint8_t *p_buffer,int p_size) {
+
+	ERR_FAIL_COND_V(p_size<(int)sizeof(State),0);
+	State state;
+	memcpy(&state,p_buffer,sizeof(State));
+	ERR_FAIL_COND_V(state.contact_count<0 || state.contact_count>MAX_CONTACTS,0);
+	ERR_FAIL_COND_V(p_size<int(sizeof(State)+sizeof(Contact)*state.contact_count),0);
+
+	offset_B=state.offset_B;
+	sep_axis=state.sep_axis;
+	contact_count=state.contact_count;
+	collided=state.collided;
+	memcpy(contacts,p_buffer+sizeof(State),sizeof(Contact)*contact_count);
+
+	return get_state_size();
+}
+
+void BodyPair2DSW::clear_state() {
+
+	sep_axis=Vector2();
+	contact_count=0;
+	collided=false;
+}
+
 BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A,Body2DSW *p_B, int p_shape_B) : Constraint2DSW(_arr,2) {
 
 	A=p_A;
@@ -450,6 +494,8 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A,Body2DSW *p_B, int p_sha
 	shape_A=p_shape_A;
 	shape_B=p_shape_B;
 	space=A->get_space();
+	_set_type(TYPE_BODY_PAIR);
+	_set_sort_key((uint64_t(A->get_self().get_id())<<32)|B->get_self().get_id(),(uint64_t(uint32_t(shape_A))<<32)|uint32_t(shape_B));
 	A->add_constraint(this,0);
 	B->add_constraint(this,1);
 	contact_count=0;
@@ -82,8 +82,22 @@ class BodyPair2DSW : public Constraint2DSW {
 	static void _add_contact(const Vector2& p_point_A,const Vector2& p_point_B,void *p_self);
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2& p_point_A,const Vector2& p_point_B);
 
+	struct State {
+
+		Vector2 offset_B;
+		Vector2 sep_axis;
+		int contact_count;
+		bool collided;
+	};
+
 public:
 
+	//contact cache as raw bytes, only the contacts in use are stored
+	int get_state_size() const;
+	int save_state(uint8_t *r_buffer) const;
+	int load_state(const uint8_t *p_buffer,int p_size);
+	void clear_state();
+
 	bool setup(float p_step);
 	void solve(float p_step);
 
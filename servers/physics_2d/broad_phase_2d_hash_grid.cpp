@@ -29,423 +29,440 @@
 #include "broad_phase_2d_hash_grid.h"
 #include "globals.h"
 
-void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element* p_with) {
+#define _ELEMENT_EXISTS(m_id) (elements.is_valid(m_id) && elements[m_id].owner)
 
-	Map<Element*,PairData*>::Element *E=p_elem->paired.find(p_with);
+void BroadPhase2DHashGrid::IndexTable::resize(uint32_t p_size) {
 
-	ERR_FAIL_COND(p_elem->_static && p_with->_static);
+	Slot *old_slots=slots;
+	uint32_t old_size=slots?mask+1:0;
 
-	if (!E) {
+	slots = memnew_arr(Slot,p_size);
+	mask = p_size-1;
+	count = 0;
 
-		PairData *pd = memnew( PairData );
-		p_elem->paired[p_with]=pd;
-		p_with->paired[p_elem]=pd;
-	} else {
-		E->get()->rc++;
+	for(uint32_t i=0;i<p_size;i++)
+		slots[i].index=0;
+
+	for(uint32_t i=0;i<old_size;i++) {
+
+		if (old_slots[i].index)
+			insert(old_slots[i].key,old_slots[i].index);
 	}
 
+	if (old_slots)
+		memdelete_arr(old_slots);
 }
 
-void BroadPhase2DHashGrid::_unpair_attempt(Element *p_elem, Element* p_with) {
+void BroadPhase2DHashGrid::IndexTable::insert(uint64_t p_key,uint32_t p_index) {
 
-	Map<Element*,PairData*>::Element *E=p_elem->paired.find(p_with);
+	if ((count+1)*2 > mask+1)
+		resize((mask+1)*2); //keep load under 50%
 
-	ERR_FAIL_COND(!E); //this should really be paired..
+	uint32_t pos = hash(p_key)&mask;
+	while(slots[pos].index)
+		pos=(pos+1)&mask;
 
-	E->get()->rc--;
+	slots[pos].key=p_key;
+	slots[pos].index=p_index;
+	count++;
+}
 
-	if (E->get()->rc==0) {
+void BroadPhase2DHashGrid::IndexTable::erase(uint64_t p_key) {
 
-		if (E->get()->colliding) {
-			//uncollide
-			if (unpair_callback) {
-				unpair_callback(p_elem->owner,p_elem->subindex,p_with->owner,p_with->subindex,E->get()->ud,unpair_userdata);
-			}
+	uint32_t pos = hash(p_key)&mask;
+	while(true) {
+		if (!slots[pos].index)
+			return; //not here
+		if (slots[pos].key==p_key)
+			break;
+		pos=(pos+1)&mask;
+	}
 
+	slots[pos].index=0;
+	count--;
 
-		}
+	//shift back the following entries of the run, so lookups never need tombstones
+	uint32_t next=(pos+1)&mask;
+	while(slots[next].index) {
 
-		memdelete(E->get());
-		p_elem->paired.erase(E);
-		p_with->paired.erase(p_elem);
+		uint32_t ideal = hash(slots[next].key)&mask;
+		if (((next-ideal)&mask) >= ((next-pos)&mask)) {
+			slots[pos]=slots[next];
+			slots[next].index=0;
+			pos=next;
+		}
+		next=(next+1)&mask;
 	}
-
-
 }
 
-void BroadPhase2DHashGrid::_check_motion(Element *p_elem) {
 
-	for (Map<Element*,PairData*>::Element *E=p_elem->paired.front();E;E=E->next()) {
+void BroadPhase2DHashGrid::_pair_attempt(ID p_elem, ID p_with) {
 
-		bool pairing = p_elem->aabb.intersects( E->key()->aabb );
+	ERR_FAIL_COND(elements[p_elem]._static && elements[p_with]._static);
 
-		if (pairing!=E->get()->colliding) {
+	PairKey pk(p_elem,p_with);
+	uint32_t idx = pair_table.find(pk.key);
 
-			if (pairing) {
-
-				if (pair_callback) {
-					E->get()->ud=pair_callback(p_elem->owner,p_elem->subindex,E->key()->owner,E->key()->subindex,pair_userdata);
-				}
-			} else {
-
-				if (unpair_callback) {
-					unpair_callback(p_elem->owner,p_elem->subindex,E->key()->owner,E->key()->subindex,E->get()->ud,unpair_userdata);
-				}
-
-			}
+	if (idx) {
+		pairs[idx].rc++;
+		return;
+	}
 
-			E->get()->colliding=pairing;
+	idx = pairs.alloc();
+	Pair &p = pairs[idx];
+	p.elem[0]=pk.a;
+	p.elem[1]=pk.b;
+	p.rc=1;
+	p.colliding=false;
+	p.ud=NULL;
+
+	//link at the front of the pair list of both elements
+	for(int i=0;i<2;i++) {
+
+		Element &e = elements[p.elem[i]];
+		p.prev[i]=0;
+		p.next[i]=e.pair_list;
+		if (e.pair_list) {
+			Pair &n=pairs[e.pair_list];
+			n.prev[n.side(p.elem[i])]=idx;
 		}
+		e.pair_list=idx;
 	}
+
+	pair_table.insert(pk.key,idx);
 }
 
-void BroadPhase2DHashGrid::_enter_grid( Element* p_elem, const Rect2& p_rect,bool p_static) {
+void BroadPhase2DHashGrid::_unpair_attempt(ID p_elem, ID p_with) {
 
+	PairKey pk(p_elem,p_with);
+	uint32_t idx = pair_table.find(pk.key);
 
-	Point2i from = (p_rect.pos/cell_size).floor();
-	Point2i to = ((p_rect.pos+p_rect.size)/cell_size).floor();
+	ERR_FAIL_COND(!idx); //this should really be paired..
 
-	for(int i=from.x;i<=to.x;i++) {
+	Pair &p = pairs[idx];
+	p.rc--;
 
+	if (p.rc>0)
+		return;
 
-		for(int j=from.y;j<=to.y;j++) {
+	if (p.colliding) {
+		//uncollide
+		if (unpair_callback) {
+			const Element &e=elements[p_elem];
+			const Element &w=elements[p_with];
+			unpair_callback(e.owner,e.subindex,w.owner,w.subindex,p.ud,unpair_userdata);
+		}
+	}
+
+	for(int i=0;i<2;i++) {
 
-			PosKey pk;
-			pk.x=i;
-			pk.y=j;
+		if (p.prev[i]) {
+			Pair &pr=pairs[p.prev[i]];
+			pr.next[pr.side(p.elem[i])]=p.next[i];
+		} else {
+			elements[p.elem[i]].pair_list=p.next[i];
+		}
 
-			uint32_t idx = pk.hash() % hash_table_size;
-			PosBin *pb = hash_table[idx];
+		if (p.next[i]) {
+			Pair &nx=pairs[p.next[i]];
+			nx.prev[nx.side(p.elem[i])]=p.prev[i];
+		}
+	}
 
-			while (pb) {
+	pair_table.erase(pk.key);
+	pairs.free(idx);
+}
 
-				if (pb->key == pk) {
-					break;
-				}
+void BroadPhase2DHashGrid::_check_motion(ID p_elem) {
 
-				pb=pb->next;
-			}
+	Element &e = elements[p_elem];
 
+	uint32_t idx=e.pair_list;
+	while(idx) {
 
-			bool entered=false;
+		Pair &p=pairs[idx];
+		int side = p.side(p_elem);
+		const Element &other = elements[p.elem[side^1]];
 
-			if (!pb) {
-				//does not exist, create!
-				pb = memnew( PosBin );
-				pb->key=pk;
-				pb->next=hash_table[idx];
-				hash_table[idx]=pb;
-			}
+		bool pairing = e.aabb.intersects( other.aabb );
 
+		if (pairing!=p.colliding) {
 
+			if (pairing) {
 
-			if (p_static) {
-				if (pb->static_object_set[p_elem].inc()==1) {
-					entered=true;
+				if (pair_callback) {
+					p.ud=pair_callback(e.owner,e.subindex,other.owner,other.subindex,pair_userdata);
 				}
 			} else {
-				if (pb->object_set[p_elem].inc()==1) {
-
-					entered=true;
-				}
-			}
-
-			if (entered) {
 
-				for(Map<Element*,RC>::Element *E=pb->object_set.front();E;E=E->next()) {
-
-					if (E->key()->owner==p_elem->owner)
-						continue;
-					_pair_attempt(p_elem,E->key());
+				if (unpair_callback) {
+					unpair_callback(e.owner,e.subindex,other.owner,other.subindex,p.ud,unpair_userdata);
 				}
 
-				if (!p_static) {
-
-					for(Map<Element*,RC>::Element *E=pb->static_object_set.front();E;E=E->next()) {
-
-						if (E->key()->owner==p_elem->owner)
-							continue;
-						_pair_attempt(p_elem,E->key());
-					}
-				}
 			}
 
+			p.colliding=pairing;
 		}
 
+		idx=p.next[side];
 	}
-
-
 }
 
+void BroadPhase2DHashGrid::_enter_cell(ID p_elem,const PosKey& p_key) {
 
-void BroadPhase2DHashGrid::_exit_grid( Element* p_elem, const Rect2& p_rect,bool p_static) {
-
+	uint32_t idx = cell_table.find(p_key.key);
 
-	Point2i from = (p_rect.pos/cell_size).floor();
-	Point2i to = ((p_rect.pos+p_rect.size)/cell_size).floor();
-
-	for(int i=from.x;i<=to.x;i++) {
-
-		for(int j=from.y;j<=to.y;j++) {
+	if (!idx) {
+		//does not exist, create! (recycled cells keep the memory of their lists)
+		idx = cells.alloc();
+		Cell &c = cells[idx];
+		c.key=p_key;
+		c.object_set.count=0;
+		c.static_object_set.count=0;
+		cell_table.insert(p_key.key,idx);
+	}
 
-			PosKey pk;
-			pk.x=i;
-			pk.y=j;
+	Cell &c = cells[idx];
+	const Element &e = elements[p_elem];
 
-			uint32_t idx = pk.hash() % hash_table_size;
-			PosBin *pb = hash_table[idx];
+	for(uint32_t i=0;i<c.object_set.count;i++) {
 
-			while (pb) {
+		ID with = c.object_set.ids[i];
+		if (elements[with].owner==e.owner)
+			continue;
+		_pair_attempt(p_elem,with);
+	}
 
-				if (pb->key == pk) {
-					break;
-				}
+	if (!e._static) {
 
-				pb=pb->next;
-			}
+		for(uint32_t i=0;i<c.static_object_set.count;i++) {
 
-			ERR_CONTINUE(!pb); //should exist!!
+			ID with = c.static_object_set.ids[i];
+			if (elements[with].owner==e.owner)
+				continue;
+			_pair_attempt(p_elem,with);
+		}
 
-			bool exited=false;
+		c.object_set.push_back(p_elem);
+	} else {
 
+		c.static_object_set.push_back(p_elem);
+	}
+}
 
-			if (p_static) {
-				if (pb->static_object_set[p_elem].dec()==0) {
+void BroadPhase2DHashGrid::_exit_cell(ID p_elem,const PosKey& p_key) {
 
-					pb->static_object_set.erase(p_elem);
-					exited=true;
+	uint32_t idx = cell_table.find(p_key.key);
+	ERR_FAIL_COND(!idx); //should exist!!
 
-				}
-			} else {
-				if (pb->object_set[p_elem].dec()==0) {
+	Cell &c = cells[idx];
+	const Element &e = elements[p_elem];
 
-					pb->object_set.erase(p_elem);
-					exited=true;
+	if (e._static) {
+		ERR_FAIL_COND(!c.static_object_set.erase(p_elem));
+	} else {
+		ERR_FAIL_COND(!c.object_set.erase(p_elem));
+	}
 
-				}
-			}
+	for(uint32_t i=0;i<c.object_set.count;i++) {
 
-			if (exited) {
+		ID with = c.object_set.ids[i];
+		if (elements[with].owner==e.owner)
+			continue;
+		_unpair_attempt(p_elem,with);
+	}
 
-				for(Map<Element*,RC>::Element *E=pb->object_set.front();E;E=E->next()) {
+	if (!e._static) {
 
-					if (E->key()->owner==p_elem->owner)
-						continue;
-					_unpair_attempt(p_elem,E->key());
+		for(uint32_t i=0;i<c.static_object_set.count;i++) {
 
-				}
+			ID with = c.static_object_set.ids[i];
+			if (elements[with].owner==e.owner)
+				continue;
+			_unpair_attempt(p_elem,with);
+		}
+	}
 
-				if (!p_static) {
+	if (c.object_set.count==0 && c.static_object_set.count==0) {
 
-					for(Map<Element*,RC>::Element *E=pb->static_object_set.front();E;E=E->next()) {
+		cell_table.erase(p_key.key);
+		cells.free(idx);
+	}
+}
 
-						if (E->key()->owner==p_elem->owner)
-							continue;
-						_unpair_attempt(p_elem,E->key());
-					}
-				}
-			}
+void BroadPhase2DHashGrid::_enter_grid(ID p_elem,const Point2i& p_from,const Point2i& p_to,const Point2i& p_skip_from,const Point2i& p_skip_to,bool p_skip) {
 
-			if (pb->object_set.empty() && pb->static_object_set.empty()) {
+	for(int i=p_from.x;i<=p_to.x;i++) {
 
-				if (hash_table[idx]==pb) {
-					hash_table[idx]=pb->next;
-				} else {
+		for(int j=p_from.y;j<=p_to.y;j++) {
 
-					PosBin *px = hash_table[idx];
+			if (p_skip && i>=p_skip_from.x && i<=p_skip_to.x && j>=p_skip_from.y && j<=p_skip_to.y)
+				continue; //already there
 
-					while (px) {
+			_enter_cell(p_elem,PosKey(i,j));
+		}
+	}
+}
 
-						if (px->next==pb) {
-							px->next=pb->next;
-							break;
-						}
+void BroadPhase2DHashGrid::_exit_grid(ID p_elem,const Point2i& p_from,const Point2i& p_to,const Point2i& p_skip_from,const Point2i& p_skip_to,bool p_skip) {
 
-						px=px->next;
-					}
+	for(int i=p_from.x;i<=p_to.x;i++) {
 
-					ERR_CONTINUE(!px);
-				}
+		for(int j=p_from.y;j<=p_to.y;j++) {
 
-				memdelete(pb);
+			if (p_skip && i>=p_skip_from.x && i<=p_skip_to.x && j>=p_skip_from.y && j<=p_skip_to.y)
+				continue; //still there
 
-			}
+			_exit_cell(p_elem,PosKey(i,j));
 		}
-
 	}
-
 }
 
 
 BroadPhase2DHashGrid::ID BroadPhase2DHashGrid::create(CollisionObject2DSW *p_object, int p_subindex) {
 
-	current++;
+	ERR_FAIL_COND_V(!p_object,0);
 
-	Element e;
+	ID id = elements.alloc();
+
+	Element &e=elements[id];
 	e.owner=p_object;
 	e._static=false;
+	e.aabb=Rect2();
 	e.subindex=p_subindex;
-	e.self=current;
 	e.pass=0;
+	e.pair_list=0;
 
-	element_map[current]=e;
-	return current;
+	return id;
 
 }
 
 void BroadPhase2DHashGrid::move(ID p_id, const Rect2& p_aabb) {
 
+	ERR_FAIL_COND(!_ELEMENT_EXISTS(p_id));
 
-	Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND(!E);
-
-	Element &e=E->get();
+	Element &e=elements[p_id];
 
 	if (p_aabb==e.aabb)
 		return;
 
+	bool had_cells = e.aabb!=Rect2();
+	bool has_cells = p_aabb!=Rect2();
 
-	if (p_aabb!=Rect2()) {
+	Point2i from,to;
+	if (has_cells)
+		_get_cells(p_aabb,from,to);
 
-		_enter_grid(&e,p_aabb,e._static);
-	}
+	if (!had_cells || !has_cells || from!=e.cell_from || to!=e.cell_to) {
 
-	if (e.aabb!=Rect2()) {
+		//only touch the cells that actually changed, enter first so shared pairs are kept alive
+		if (has_cells)
+			_enter_grid(p_id,from,to,e.cell_from,e.cell_to,had_cells);
+
+		if (had_cells)
+			_exit_grid(p_id,e.cell_from,e.cell_to,from,to,has_cells);
 
-		_exit_grid(&e,e.aabb,e._static);
+		e.cell_from=from;
+		e.cell_to=to;
 	}
 
 	e.aabb=p_aabb;
 
-	_check_motion(&e);
-
-	e.aabb=p_aabb;
+	_check_motion(p_id);
 
 }
 void BroadPhase2DHashGrid::set_static(ID p_id, bool p_static) {
 
-	Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND(!E);
+	ERR_FAIL_COND(!_ELEMENT_EXISTS(p_id));
 
-	Element &e=E->get();
+	Element &e=elements[p_id];
 
 	if (e._static==p_static)
 		return;
 
 	if (e.aabb!=Rect2())
-		_exit_grid(&e,e.aabb,e._static);
+		_exit_grid(p_id,e.cell_from,e.cell_to,Point2i(),Point2i(),false);
 
 	e._static=p_static;
 
 	if (e.aabb!=Rect2()) {
-		_enter_grid(&e,e.aabb,e._static);
-		_check_motion(&e);
+		_enter_grid(p_id,e.cell_from,e.cell_to,Point2i(),Point2i(),false);
+		_check_motion(p_id);
 	}
 
 }
 void BroadPhase2DHashGrid::remove(ID p_id) {
 
-	Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND(!E);
+	ERR_FAIL_COND(!_ELEMENT_EXISTS(p_id));
 
-	Element &e=E->get();
+	Element &e=elements[p_id];
 
 	if (e.aabb!=Rect2())
-		_exit_grid(&e,e.aabb,e._static);
+		_exit_grid(p_id,e.cell_from,e.cell_to,Point2i(),Point2i(),false);
 
-	element_map.erase(p_id);
+	ERR_FAIL_COND(e.pair_list!=0); //all pairs should be gone
+
+	e.owner=NULL;
+	elements.free(p_id);
 
 }
 
 CollisionObject2DSW *BroadPhase2DHashGrid::get_object(ID p_id) const {
 
-	const Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND_V(!E,NULL);
-	return E->get().owner;
+	ERR_FAIL_COND_V(!_ELEMENT_EXISTS(p_id),NULL);
+	return elements[p_id].owner;
 
 }
 bool BroadPhase2DHashGrid::is_static(ID p_id) const {
 
-	const Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND_V(!E,false);
-	return E->get()._static;
+	ERR_FAIL_COND_V(!_ELEMENT_EXISTS(p_id),false);
+	return elements[p_id]._static;
 
 }
 int BroadPhase2DHashGrid::get_subindex(ID p_id) const {
 
-	const Map<ID,Element>::Element *E=element_map.find(p_id);
-	ERR_FAIL_COND_V(!E,-1);
-	return E->get().subindex;
+	ERR_FAIL_COND_V(!_ELEMENT_EXISTS(p_id),-1);
+	return elements[p_id].subindex;
 }
 
 template<bool use_aabb,bool use_segment>
 void BroadPhase2DHashGrid::_cull(const Point2i p_cell,const Rect2& p_aabb,const Point2& p_from, const Point2& p_to,CollisionObject2DSW** p_results,int p_max_results,int *p_result_indices,int &index) {
 
 
-	PosKey pk;
-	pk.x=p_cell.x;
-	pk.y=p_cell.y;
-
-	uint32_t idx = pk.hash() % hash_table_size;
-	PosBin *pb = hash_table[idx];
-
-	while (pb) {
-
-		if (pb->key == pk) {
-			break;
-		}
-
-		pb=pb->next;
-	}
+	uint32_t idx = cell_table.find(PosKey(p_cell.x,p_cell.y).key);
 
-	if (!pb)
+	if (!idx)
 		return;
 
+	const Cell &c = cells[idx];
+	const IDList *lists[2]={&c.object_set,&c.static_object_set};
 
+	for(int l=0;l<2;l++) {
 
-	for(Map<Element*,RC>::Element *E=pb->object_set.front();E;E=E->next()) {
+		const IDList &list=*lists[l];
 
+		for(uint32_t i=0;i<list.count;i++) {
 
-		if (index>=p_max_results)
-			break;
-		if (E->key()->pass==pass)
-			continue;
-
-		E->key()->pass=pass;
+			if (index>=p_max_results)
+				return;
 
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb))
-			continue;
+			Element &e = elements[list.ids[i]];
 
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from,p_to))
-			continue;
+			if (e.pass==pass)
+				continue;
 
-		p_results[index]=E->key()->owner;
-		p_result_indices[index]=E->key()->subindex;
-		index++;
+			e.pass=pass;
 
+			if (use_aabb && !p_aabb.intersects(e.aabb))
+				continue;
 
-	}
+			if (use_segment && !e.aabb.intersects_segment(p_from,p_to))
+				continue;
 
-	for(Map<Element*,RC>::Element *E=pb->static_object_set.front();E;E=E->next()) {
-
-
-		if (index>=p_max_results)
-			break;
-		if (E->key()->pass==pass)
-			continue;
-
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb)) {
-			continue;
+			p_results[index]=e.owner;
+			p_result_indices[index]=e.subindex;
+			index++;
 		}
-
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from,p_to))
-			continue;
-
-		E->key()->pass=pass;
-		p_results[index]=E->key()->owner;
-		p_result_indices[index]=E->key()->subindex;
-		index++;
-
 	}
 }
 
@@ -533,8 +550,8 @@ int BroadPhase2DHashGrid::cull_aabb(const Rect2& p_aabb,CollisionObject2DSW** p_
 
 	pass++;
 
-	Point2i from = (p_aabb.pos/cell_size).floor();
-	Point2i to = ((p_aabb.pos+p_aabb.size)/cell_size).floor();
+	Point2i from,to;
+	_get_cells(p_aabb,from,to);
 	int cullcount=0;
 
 	for(int i=from.x;i<=to.x;i++) {
@@ -575,31 +592,32 @@ BroadPhase2DSW *BroadPhase2DHashGrid::_create() {
 
 BroadPhase2DHashGrid::BroadPhase2DHashGrid() {
 
-	hash_table_size = GLOBAL_DEF("physics_2d/bp_hash_table_size",4096);
-	hash_table_size = Math::larger_prime(hash_table_size);
-	hash_table = memnew_arr( PosBin*, hash_table_size);
+	uint32_t hash_table_size = GLOBAL_DEF("physics_2d/bp_hash_table_size",4096);
+	hash_table_size = nearest_power_of_2(hash_table_size);
+
+	cell_table.resize(hash_table_size);
+	pair_table.resize(hash_table_size);
 
 	cell_size = GLOBAL_DEF("physics_2d/cell_size",128);
 
-	for(int i=0;i<hash_table_size;i++)
-		hash_table[i]=NULL;
 	pass=1;
 
-	current=0;
+	pair_callback=NULL;
+	pair_userdata=NULL;
+	unpair_callback=NULL;
+	unpair_userdata=NULL;
 }
 
 BroadPhase2DHashGrid::~BroadPhase2DHashGrid() {
 
-	for(int i=0;i<hash_table_size;i++) {
-		while(hash_table[i]) {
-			PosBin *pb=hash_table[i];
-			hash_table[i]=pb->next;
-			memdelete(pb);
-		}
-	}
-
-	memdelete_arr( hash_table );
+	// free the lists of every cell ever created, recycled ones included
+	for(uint32_t i=1;i<cells.used;i++) {
 
+		if (cells[i].object_set.ids)
+			memfree(cells[i].object_set.ids);
+		if (cells[i].static_object_set.ids)
+			memfree(cells[i].static_object_set.ids);
+	}
 
 }
 
@@ -30,38 +30,145 @@
 #define BROAD_PHASE_2D_HASH_GRID_H
 
 #include "broad_phase_2d_sw.h"
-#include "map.h"
+#include "os/memory.h"
+#include "os/copymem.h"
 
 class BroadPhase2DHashGrid : public BroadPhase2DSW {
 
 
-	struct PairData {
+	/* growable array with a free list, index 0 is never handed out so it can mean "none".
+	   memory is only requested when the pool grows (new slots are zeroed), freed slots are recycled */
 
-		bool colliding;
-		int rc;
-		void *ud;
-		PairData() { colliding=false; rc=1; ud=NULL; }
+	template<class T>
+	struct Pool {
+
+		T *data;
+		uint32_t *free_indices;
+		uint32_t free_count;
+		uint32_t used;
+		uint32_t capacity;
+
+		_FORCE_INLINE_ uint32_t alloc() {
+
+			if (free_count)
+				return free_indices[--free_count];
+
+			if (used>=capacity) {
+
+				uint32_t old_capacity=capacity;
+				capacity = capacity ? capacity*2 : 256;
+				data = (T*)(data ? memrealloc(data,sizeof(T)*capacity) : memalloc(sizeof(T)*capacity));
+				free_indices = (uint32_t*)(free_indices ? memrealloc(free_indices,sizeof(uint32_t)*capacity) : memalloc(sizeof(uint32_t)*capacity));
+				zeromem(&data[old_capacity],sizeof(T)*(capacity-old_capacity));
+			}
+
+			return used++;
+		}
+
+		_FORCE_INLINE_ void free(uint32_t p_index) { free_indices[free_count++]=p_index; }
+		_FORCE_INLINE_ bool is_valid(uint32_t p_index) const { return p_index>0 && p_index<used; }
+		_FORCE_INLINE_ T& operator[](uint32_t p_index) { return data[p_index]; }
+		_FORCE_INLINE_ const T& operator[](uint32_t p_index) const { return data[p_index]; }
+
+		Pool() { data=NULL; free_indices=NULL; free_count=0; used=1; capacity=0; }
+		~Pool() { if (data) memfree(data); if (free_indices) memfree(free_indices); }
+	};
+
+	/* open addressing (linear probing) table from 64 bits keys to pool indices */
+
+	struct IndexTable {
+
+		struct Slot {
+			uint64_t key;
+			uint32_t index; // 0 is empty
+		};
+
+		Slot *slots;
+		uint32_t mask;
+		uint32_t count;
+
+		_FORCE_INLINE_ static uint32_t hash(uint64_t p_key) {
+			uint64_t k=p_key;
+			k = (~k) + (k << 18); // k = (k << 18) - k - 1;
+			k = k ^ (k >> 31);
+			k = k * 21; // k = (k + (k << 2)) + (k << 4);
+			k = k ^ (k >> 11);
+			k = k + (k << 6);
+			k = k ^ (k >> 22);
+			return k;
+		}
+
+		_FORCE_INLINE_ uint32_t find(uint64_t p_key) const {
+
+			uint32_t pos = hash(p_key)&mask;
+			while(slots[pos].index) {
+				if (slots[pos].key==p_key)
+					return slots[pos].index;
+				pos=(pos+1)&mask;
+			}
+			return 0;
+		}
+
+		void insert(uint64_t p_key,uint32_t p_index);
+		void erase(uint64_t p_key);
+		void resize(uint32_t p_size);
+
+		IndexTable() { slots=NULL; mask=0; count=0; }
+		~IndexTable() { if (slots) memdelete_arr(slots); }
+	};
+
+	/* small array of element ids living inside a cell, keeps its memory when the cell is recycled */
+
+	struct IDList {
+
+		ID *ids;
+		uint32_t count;
+		uint32_t capacity;
+
+		_FORCE_INLINE_ void push_back(ID p_id) {
+
+			if (count==capacity) {
+				capacity = capacity ? capacity*2 : 4;
+				ids = (ID*)(ids ? memrealloc(ids,sizeof(ID)*capacity) : memalloc(sizeof(ID)*capacity));
+			}
+			ids[count++]=p_id;
+		}
+
+		_FORCE_INLINE_ bool erase(ID p_id) {
+
+			for(uint32_t i=0;i<count;i++) {
+				if (ids[i]==p_id) {
+					ids[i]=ids[--count];
+					return true;
+				}
+			}
+			return false;
+		}
 	};
 
 	struct Element {
 
-		ID self;
 		CollisionObject2DSW *owner;
 		bool _static;
 		Rect2 aabb;
 		int subindex;
 		uint64_t pass;
-		Map<Element*,PairData*> paired;
-
+		Point2i cell_from; // cells currently occupied, valid when aabb is not empty
+		Point2i cell_to;
+		uint32_t pair_list; // first pair this element belongs to
 	};
 
+	struct Pair {
 
-	Map<ID,Element> element_map;
-
-	ID current;
-
-	uint64_t pass;
+		ID elem[2]; // sorted, elem[0] < elem[1]
+		uint32_t next[2]; // next pair in the list of each element
+		uint32_t prev[2];
+		int rc; // amount of cells shared
+		bool colliding;
+		void *ud;
 
+		_FORCE_INLINE_ int side(ID p_elem) const { return elem[0]==p_elem ? 0 : 1; }
+	};
 
 	struct PairKey {
 
@@ -73,31 +180,11 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 			uint64_t key;
 		};
 
-		_FORCE_INLINE_ bool operator<(const PairKey& p_key) const {
-			return key < p_key.key;
-		}
-
 		PairKey() { key=0; }
 		PairKey(ID p_a, ID p_b) { if (p_a>p_b) { a=p_b; b=p_a; } else { a=p_a; b=p_b; }}
 
 	};
 
-
-	Map<PairKey,PairData> pair_map;
-
-	int cell_size;
-
-	PairCallback pair_callback;
-	void *pair_userdata;
-	UnpairCallback unpair_callback;
-	void *unpair_userdata;
-
-	void _enter_grid(Element* p_elem, const Rect2& p_rect,bool p_static);
-	void _exit_grid(Element* p_elem, const Rect2& p_rect,bool p_static);
-	template<bool use_aabb,bool use_segment>
-	_FORCE_INLINE_ void _cull(const Point2i p_cell,const Rect2& p_aabb,const Point2& p_from, const Point2& p_to,CollisionObject2DSW** p_results,int p_max_results,int *p_result_indices,int &index);
-
-
 	struct PosKey {
 
 		union {
@@ -108,58 +195,49 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 			uint64_t key;
 		};
 
+		PosKey() { key=0; }
+		PosKey(int32_t p_x,int32_t p_y) { x=p_x; y=p_y; }
+	};
 
-		_FORCE_INLINE_ uint32_t hash() const {
-			uint64_t k=key;
-			k = (~k) + (k << 18); // k = (k << 18) - k - 1;
-			k = k ^ (k >> 31);
-			k = k * 21; // k = (k + (k << 2)) + (k << 4);
-			k = k ^ (k >> 11);
-			k = k + (k << 6);
-			k = k ^ (k >> 22);
-			return k;
-		}
-
-		bool operator==(const PosKey& p_key) const { return key==p_key.key; }
-		_FORCE_INLINE_ bool operator<(const PosKey& p_key) const {
-			return key < p_key.key;
-		}
+	struct Cell {
 
+		PosKey key;
+		IDList object_set;
+		IDList static_object_set;
 	};
 
-	struct RC {
+	Pool<Element> elements;
+	Pool<Pair> pairs;
+	Pool<Cell> cells;
 
-		int ref;
+	IndexTable pair_table;
+	IndexTable cell_table;
 
-		_FORCE_INLINE_ int inc() {
-			ref++;
-			return ref;
-		}
-		_FORCE_INLINE_ int dec() {
-			ref--;
-			return ref;
-		}
+	uint64_t pass;
 
-		_FORCE_INLINE_ RC() {
-			ref=0;
-		}
-	};
+	int cell_size;
 
-	struct PosBin {
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
 
-		PosKey key;
-		Map<Element*,RC> object_set;
-		Map<Element*,RC> static_object_set;
-		PosBin *next;
-	};
+	_FORCE_INLINE_ void _get_cells(const Rect2& p_rect,Point2i &r_from,Point2i &r_to) const {
 
+		r_from = (p_rect.pos/cell_size).floor();
+		r_to = ((p_rect.pos+p_rect.size)/cell_size).floor();
+	}
 
-	uint32_t hash_table_size;
-	PosBin **hash_table;
+	void _enter_cell(ID p_elem,const PosKey& p_key);
+	void _exit_cell(ID p_elem,const PosKey& p_key);
+	void _enter_grid(ID p_elem,const Point2i& p_from,const Point2i& p_to,const Point2i& p_skip_from,const Point2i& p_skip_to,bool p_skip);
+	void _exit_grid(ID p_elem,const Point2i& p_from,const Point2i& p_to,const Point2i& p_skip_from,const Point2i& p_skip_to,bool p_skip);
+	template<bool use_aabb,bool use_segment>
+	_FORCE_INLINE_ void _cull(const Point2i p_cell,const Rect2& p_aabb,const Point2& p_from, const Point2& p_to,CollisionObject2DSW** p_results,int p_max_results,int *p_result_indices,int &index);
 
-	void _pair_attempt(Element *p_elem, Element* p_with);
-	void _unpair_attempt(Element *p_elem, Element* p_with);
-	void _check_motion(Element *p_elem);
+	void _pair_attempt(ID p_elem, ID p_with);
+	void _unpair_attempt(ID p_elem, ID p_with);
+	void _check_motion(ID p_elem);
 
 
 public:
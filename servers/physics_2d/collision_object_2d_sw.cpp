@@ -29,6 +29,15 @@
 #include "collision_object_2d_sw.h"
 #include "space_2d_sw.h"
 
+bool Constraint2DCMP::operator()(const Constraint2DSW* p_a,const Constraint2DSW* p_b) const {
+
+	if (p_a->get_sort_key()!=p_b->get_sort_key())
+		return p_a->get_sort_key() < p_b->get_sort_key();
+	if (p_a->get_sort_subkey()!=p_b->get_sort_subkey())
+		return p_a->get_sort_subkey() < p_b->get_sort_subkey();
+	return p_a < p_b;
+}
+
 void CollisionObject2DSW::add_shape(Shape2DSW *p_shape,const Matrix32& p_transform) {
 
 	Shape s;
@@ -152,6 +161,26 @@ void CollisionObject2DSW::_update_shapes() {
 
 }
 
+void CollisionObject2DSW::_set_shape_aabb(int p_index,const Rect2& p_aabb) {
+
+	ERR_FAIL_INDEX(p_index,shapes.size());
+	Shape &s=shapes[p_index];
+	if (s.bpid!=0 && s.aabb_cache==p_aabb)
+		return; //broadphase already has it
+
+	s.aabb_cache=p_aabb;
+
+	if (!space)
+		return;
+
+	if (s.bpid==0) {
+		s.bpid=space->get_broadphase()->create(this,p_index);
+		space->get_broadphase()->set_static(s.bpid,_static);
+	}
+
+	space->get_broadphase()->move(s.bpid,s.aabb_cache);
+}
+
 void CollisionObject2DSW::_update_shapes_with_motion(const Vector2& p_motion) {
 
 
@@ -35,6 +35,12 @@
 #include "broad_phase_2d_sw.h"
 
 class Space2DSW;
+class Constraint2DSW;
+
+struct Constraint2DCMP {
+
+	bool operator()(const Constraint2DSW* p_a,const Constraint2DSW* p_b) const;
+};
 
 class CollisionObject2DSW : public ShapeOwner2DSW {
 public:
@@ -93,6 +99,7 @@ public:
 	_FORCE_INLINE_ ObjectID get_instance_id() const { return instance_id; }
 
 	void _shape_changed();
+	void _set_shape_aabb(int p_index,const Rect2& p_aabb);
 
 	_FORCE_INLINE_ Type get_type() const { return type; }
 	void add_shape(Shape2DSW *p_shape,const Matrix32& p_transform=Matrix32());
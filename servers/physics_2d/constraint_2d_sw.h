@@ -32,6 +32,13 @@
 #include "body_2d_sw.h"
 
 class Constraint2DSW {
+public:
+	enum Type {
+		TYPE_JOINT,
+		TYPE_BODY_PAIR,
+		TYPE_AREA_PAIR
+	};
+private:
 
 	Body2DSW **_body_ptr;
 	int _body_count;
@@ -41,11 +48,22 @@ class Constraint2DSW {
 
 
 	RID self;
+	Type type;
+	uint64_t sort_key;
+	uint64_t sort_subkey;
 
 protected:
-	Constraint2DSW(Body2DSW **p_body_ptr=NULL,int p_body_count=0) { _body_ptr=p_body_ptr; _body_count=p_body_count; island_step=0; }
+	Constraint2DSW(Body2DSW **p_body_ptr=NULL,int p_body_count=0) { _body_ptr=p_body_ptr; _body_count=p_body_count; island_step=0; type=TYPE_JOINT; sort_key=0; sort_subkey=0; }
+
+	//pairs are recreated by the broadphase, so they are ordered by what they link instead of by address
+	_FORCE_INLINE_ void _set_type(Type p_type) { type=p_type; }
+	_FORCE_INLINE_ void _set_sort_key(uint64_t p_key,uint64_t p_subkey) { sort_key=p_key; sort_subkey=p_subkey; }
 public:
 
+	_FORCE_INLINE_ Type get_type() const { return type; }
+	_FORCE_INLINE_ uint64_t get_sort_key() const { return sort_key; }
+	_FORCE_INLINE_ uint64_t get_sort_subkey() const { return sort_subkey; }
+
 	_FORCE_INLINE_ void set_self(const RID& p_self) { self=p_self; }
 	_FORCE_INLINE_ RID get_self() const { return self; }
 
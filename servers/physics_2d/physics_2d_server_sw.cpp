@@ -255,6 +255,27 @@ Physics2DDirectSpaceState* Physics2DServerSW::space_get_direct_state(RID p_space
 	return space->get_direct_state();
 }
 
+int Physics2DServerSW::space_get_snapshot_size(RID p_space) const {
+
+	const Space2DSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space,0);
+	return space->get_snapshot_size();
+}
+
+int Physics2DServerSW::space_snapshot(RID p_space,uint8_t *r_buffer,int p_size) const {
+
+	const Space2DSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space,0);
+	return space->snapshot(r_buffer,p_size);
+}
+
+Error Physics2DServerSW::space_restore_snapshot(RID p_space,const uint8_t *p_buffer,int p_size) {
+
+	Space2DSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space,ERR_INVALID_PARAMETER);
+	return space->restore_snapshot(p_buffer,p_size);
+}
+
 RID Physics2DServerSW::area_create() {
 
 	Area2DSW *area = memnew( Area2DSW );
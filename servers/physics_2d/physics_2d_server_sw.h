@@ -96,6 +96,10 @@ public:
 	// this function only works on fixed process, errors and returns null otherwise
 	virtual Physics2DDirectSpaceState* space_get_direct_state(RID p_space);
 
+	virtual int space_get_snapshot_size(RID p_space) const;
+	virtual int space_snapshot(RID p_space,uint8_t *r_buffer,int p_size) const;
+	virtual Error space_restore_snapshot(RID p_space,const uint8_t *p_buffer,int p_size);
+
 
 	/* AREA API */
 
@@ -29,6 +29,9 @@
 #include "space_2d_sw.h"
 #include "collision_solver_2d_sw.h"
 #include "physics_2d_server_sw.h"
+#include "sort.h"
+
+#include <string.h>
 
 
 _FORCE_INLINE_ static bool _match_object_type_query(CollisionObject2DSW *p_object, uint32_t p_user_mask, uint32_t p_type_mask) {
@@ -456,6 +459,11 @@ void* Space2DSW::_broadphase_pair(CollisionObject2DSW *A,int p_subindex_A,Collis
 		return area_pair;
 	} else {
 
+		//keep pairs oriented by id, so a pair recreated after a restore solves the same way
+		if (B->get_self() < A->get_self()) {
+			SWAP(A,B);
+			SWAP(p_subindex_A,p_subindex_B);
+		}
 
 		BodyPair2DSW *b = memnew( BodyPair2DSW((Body2DSW*)A,p_subindex_A,(Body2DSW*)B,p_subindex_B) );
 		return b;
@@ -574,6 +582,352 @@ void Space2DSW::call_queries() {
 
 }
 
+int Space2DSW::get_snapshot_size() const {
+
+	int size=sizeof(SnapshotHeader);
+
+	for(const Set<CollisionObject2DSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()==CollisionObject2DSW::TYPE_BODY) {
+
+			const Body2DSW *body=static_cast<const Body2DSW*>(E->get());
+			size+=sizeof(SnapshotBody)+sizeof(SnapshotShape)*body->get_shape_count();
+
+			for(const Map<Constraint2DSW*,int,Constraint2DCMP>::Element *F=body->get_constraint_map().front();F;F=F->next()) {
+
+				if (F->get()==0 && F->key()->get_type()==Constraint2DSW::TYPE_BODY_PAIR)
+					size+=sizeof(SnapshotPair)+static_cast<const BodyPair2DSW*>(F->key())->get_state_size();
+			}
+		} else {
+
+			const Area2DSW *area=static_cast<const Area2DSW*>(E->get());
+			for(const Set<Constraint2DSW*,Constraint2DCMP>::Element *F=area->get_constraints().front();F;F=F->next()) {
+
+				if (static_cast<const AreaPair2DSW*>(F->get())->is_colliding())
+					size+=sizeof(SnapshotPair);
+			}
+		}
+	}
+
+	for(const SelfList<Body2DSW> *b=active_list.first();b;b=b->next())
+		size+=sizeof(uint32_t);
+
+	return size;
+}
+
+int Space2DSW::snapshot(uint8_t *r_buffer,int p_size) const {
+
+	ERR_FAIL_COND_V(locked,0);
+	int size=get_snapshot_size();
+	ERR_FAIL_COND_V(p_size<size,0);
+
+	SnapshotHeader header;
+	header.magic=SNAPSHOT_MAGIC;
+	header.body_count=0;
+	header.active_count=0;
+	header.body_pair_count=0;
+	header.area_pair_count=0;
+
+	uint8_t *w=r_buffer+sizeof(SnapshotHeader);
+
+	for(const Set<CollisionObject2DSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObject2DSW::TYPE_BODY)
+			continue;
+
+		const Body2DSW *body=static_cast<const Body2DSW*>(E->get());
+		SnapshotBody sb;
+		sb.id=body->get_self().get_id();
+		sb.shape_count=body->get_shape_count();
+		body->save_state(sb.state);
+		memcpy(w,&sb,sizeof(SnapshotBody));
+		w+=sizeof(SnapshotBody);
+
+		for(int i=0;i<body->get_shape_count();i++) {
+
+			SnapshotShape ss;
+			ss.aabb=body->get_shape_aabb(i);
+			ss.kinematic_advance=body->get_shape_kinematic_advance(i);
+			ss.kinematic_retreat=body->get_shape_kinematic_retreat(i);
+			memcpy(w,&ss,sizeof(SnapshotShape));
+			w+=sizeof(SnapshotShape);
+		}
+		header.body_count++;
+	}
+
+	//islands are built following the active list, so its order is part of the state
+	for(const SelfList<Body2DSW> *b=active_list.first();b;b=b->next()) {
+
+		uint32_t id=b->self()->get_self().get_id();
+		memcpy(w,&id,sizeof(uint32_t));
+		w+=sizeof(uint32_t);
+		header.active_count++;
+	}
+
+	//contact caches, grouped by their first body in object order
+	for(const Set<CollisionObject2DSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObject2DSW::TYPE_BODY)
+			continue;
+
+		const Body2DSW *body=static_cast<const Body2DSW*>(E->get());
+		for(const Map<Constraint2DSW*,int,Constraint2DCMP>::Element *F=body->get_constraint_map().front();F;F=F->next()) {
+
+			if (F->get()!=0 || F->key()->get_type()!=Constraint2DSW::TYPE_BODY_PAIR)
+				continue;
+
+			SnapshotPair sp;
+			sp.key=F->key()->get_sort_key();
+			sp.subkey=F->key()->get_sort_subkey();
+			sp.size=static_cast<const BodyPair2DSW*>(F->key())->save_state(w+sizeof(SnapshotPair));
+			memcpy(w,&sp,sizeof(SnapshotPair));
+			w+=sizeof(SnapshotPair)+sp.size;
+			header.body_pair_count++;
+		}
+	}
+
+	for(const Set<CollisionObject2DSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObject2DSW::TYPE_AREA)
+			continue;
+
+		const Area2DSW *area=static_cast<const Area2DSW*>(E->get());
+		for(const Set<Constraint2DSW*,Constraint2DCMP>::Element *F=area->get_constraints().front();F;F=F->next()) {
+
+			if (!static_cast<const AreaPair2DSW*>(F->get())->is_colliding())
+				continue;
+
+			SnapshotPair sp;
+			sp.key=F->get()->get_sort_key();
+			sp.subkey=F->get()->get_sort_subkey();
+			sp.size=0;
+			memcpy(w,&sp,sizeof(SnapshotPair));
+			w+=sizeof(SnapshotPair);
+			header.area_pair_count++;
+		}
+	}
+
+	memcpy(r_buffer,&header,sizeof(SnapshotHeader));
+
+	return w-r_buffer;
+}
+
+static _FORCE_INLINE_ bool _snapshot_pair_less(uint64_t p_key,uint64_t p_subkey,const Constraint2DSW *p_constraint) {
+
+	if (p_key!=p_constraint->get_sort_key())
+		return p_key < p_constraint->get_sort_key();
+	return p_subkey < p_constraint->get_sort_subkey();
+}
+
+Error Space2DSW::restore_snapshot(const uint8_t *p_buffer,int p_size) {
+
+	ERR_FAIL_COND_V(locked,ERR_LOCKED);
+	ERR_FAIL_COND_V(p_size<(int)sizeof(SnapshotHeader),ERR_INVALID_DATA);
+
+	SnapshotHeader header;
+	memcpy(&header,p_buffer,sizeof(SnapshotHeader));
+	ERR_FAIL_COND_V(header.magic!=SNAPSHOT_MAGIC,ERR_INVALID_DATA);
+
+	//validate everything before touching the space, a snapshot only applies to the bodies it was taken from
+	const uint8_t *r=p_buffer+sizeof(SnapshotHeader);
+	int left=p_size-sizeof(SnapshotHeader);
+	uint32_t body_count=0;
+
+	for(Set<CollisionObject2DSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObject2DSW::TYPE_BODY)
+			continue;
+
+		Body2DSW *body=static_cast<Body2DSW*>(E->get());
+		ERR_FAIL_COND_V(left<(int)sizeof(SnapshotBody),ERR_INVALID_DATA);
+		SnapshotBody sb;
+		memcpy(&sb,r,sizeof(SnapshotBody));
+		ERR_FAIL_COND_V(sb.id!=body->get_self().get_id() || (int)sb.shape_count!=body->get_shape_count(),ERR_INVALID_DATA);
+		int len=sizeof(SnapshotBody)+sizeof(SnapshotShape)*sb.shape_count;
+		ERR_FAIL_COND_V(left<len,ERR_INVALID_DATA);
+		r+=len;
+		left-=len;
+		body_count++;
+	}
+
+	ERR_FAIL_COND_V(body_count!=header.body_count || header.active_count>body_count,ERR_INVALID_DATA);
+	const uint8_t *active_ids=r;
+	ERR_FAIL_COND_V(left<int(header.active_count*sizeof(uint32_t)),ERR_INVALID_DATA);
+	r+=header.active_count*sizeof(uint32_t);
+	left-=header.active_count*sizeof(uint32_t);
+
+	const uint8_t *body_pairs=r;
+	for(uint32_t i=0;i<header.body_pair_count;i++) {
+
+		ERR_FAIL_COND_V(left<(int)sizeof(SnapshotPair),ERR_INVALID_DATA);
+		SnapshotPair sp;
+		memcpy(&sp,r,sizeof(SnapshotPair));
+		ERR_FAIL_COND_V(left<int(sizeof(SnapshotPair)+sp.size),ERR_INVALID_DATA);
+		r+=sizeof(SnapshotPair)+sp.size;
+		left-=sizeof(SnapshotPair)+sp.size;
+	}
+
+	ERR_FAIL_COND_V(header.area_pair_count>uint32_t(left/sizeof(SnapshotPair)),ERR_INVALID_DATA);
+	const uint8_t *area_pairs=r;
+
+	/* BODIES */
+
+	while(active_list.first())
+		active_list.first()->self()->set_active(false);
+
+	if (snapshot_body_cache.size()<(int)body_count)
+		snapshot_body_cache.resize(body_count);
+	Body2DSW **cache=snapshot_body_cache.ptr();
+
+	r=p_buffer+sizeof(SnapshotHeader);
+	int idx=0;
+
+	for(Set<CollisionObject2DSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObject2DSW::TYPE_BODY)
+			continue;
+
+		Body2DSW *body=static_cast<Body2DSW*>(E->get());
+		SnapshotBody sb;
+		memcpy(&sb,r,sizeof(SnapshotBody));
+		r+=sizeof(SnapshotBody);
+		body->load_state(sb.state);
+
+		//shape aabbs may have been extended by motion, restoring them as they were gives the broadphase the same pairs
+		for(int i=0;i<body->get_shape_count();i++) {
+
+			SnapshotShape ss;
+			memcpy(&ss,r,sizeof(SnapshotShape));
+			r+=sizeof(SnapshotShape);
+			body->_set_shape_aabb(i,ss.aabb);
+			body->set_shape_kinematic_advance(i,ss.kinematic_advance);
+			body->set_shape_kinematic_retreat(i,ss.kinematic_retreat);
+		}
+
+		cache[idx++]=body;
+	}
+
+	broadphase->update();
+
+	SortArray<Body2DSW*,SnapshotBodyCMP> sorter;
+	sorter.sort(cache,body_count);
+
+	//the list adds to the front, so go backwards
+	for(int i=int(header.active_count)-1;i>=0;i--) {
+
+		uint32_t id;
+		memcpy(&id,active_ids+i*sizeof(uint32_t),sizeof(uint32_t));
+
+		int low=0;
+		int high=body_count;
+		while(low<high) {
+			int mid=(low+high)>>1;
+			if (cache[mid]->get_self().get_id()<id)
+				low=mid+1;
+			else
+				high=mid;
+		}
+
+		ERR_CONTINUE(low==int(body_count) || cache[low]->get_self().get_id()!=id);
+		cache[low]->set_active(true);
+	}
+
+	/* PAIRS */
+
+	r=body_pairs;
+	uint32_t pairs_left=header.body_pair_count;
+
+	for(Set<CollisionObject2DSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObject2DSW::TYPE_BODY)
+			continue;
+
+		Body2DSW *body=static_cast<Body2DSW*>(E->get());
+		uint32_t id=body->get_self().get_id();
+
+		for(Map<Constraint2DSW*,int,Constraint2DCMP>::Element *F=body->get_constraint_map().front();F;F=F->next()) {
+
+			if (F->get()!=0 || F->key()->get_type()!=Constraint2DSW::TYPE_BODY_PAIR)
+				continue;
+
+			BodyPair2DSW *pair=static_cast<BodyPair2DSW*>(F->key());
+			SnapshotPair sp;
+
+			//both sides are sorted the same way, skip records of pairs that no longer exist
+			while(pairs_left) {
+				memcpy(&sp,r,sizeof(SnapshotPair));
+				if ((sp.key>>32)!=id || !_snapshot_pair_less(sp.key,sp.subkey,pair))
+					break;
+				r+=sizeof(SnapshotPair)+sp.size;
+				pairs_left--;
+			}
+
+			if (pairs_left && sp.key==pair->get_sort_key() && sp.subkey==pair->get_sort_subkey()) {
+
+				pair->load_state(r+sizeof(SnapshotPair),sp.size);
+				r+=sizeof(SnapshotPair)+sp.size;
+				pairs_left--;
+			} else {
+
+				pair->clear_state();
+			}
+		}
+
+		while(pairs_left) {
+			SnapshotPair sp;
+			memcpy(&sp,r,sizeof(SnapshotPair));
+			if ((sp.key>>32)!=id)
+				break;
+			r+=sizeof(SnapshotPair)+sp.size;
+			pairs_left--;
+		}
+	}
+
+	r=area_pairs;
+	pairs_left=header.area_pair_count;
+
+	for(Set<CollisionObject2DSW*>::Element *E=objects.front();E;E=E->next()) {
+
+		if (E->get()->get_type()!=CollisionObject2DSW::TYPE_AREA)
+			continue;
+
+		Area2DSW *area=static_cast<Area2DSW*>(E->get());
+		uint32_t id=area->get_self().get_id();
+
+		for(const Set<Constraint2DSW*,Constraint2DCMP>::Element *F=area->get_constraints().front();F;F=F->next()) {
+
+			AreaPair2DSW *pair=static_cast<AreaPair2DSW*>(F->get());
+			SnapshotPair sp;
+
+			while(pairs_left) {
+				memcpy(&sp,r,sizeof(SnapshotPair));
+				if ((sp.key>>32)!=id || !_snapshot_pair_less(sp.key,sp.subkey,pair))
+					break;
+				r+=sizeof(SnapshotPair);
+				pairs_left--;
+			}
+
+			bool colliding = pairs_left && sp.key==pair->get_sort_key() && sp.subkey==pair->get_sort_subkey();
+			pair->set_colliding(colliding);
+			if (colliding) {
+				r+=sizeof(SnapshotPair);
+				pairs_left--;
+			}
+		}
+
+		while(pairs_left) {
+			SnapshotPair sp;
+			memcpy(&sp,r,sizeof(SnapshotPair));
+			if ((sp.key>>32)!=id)
+				break;
+			r+=sizeof(SnapshotPair);
+			pairs_left--;
+		}
+	}
+
+	return OK;
+}
+
 void Space2DSW::setup() {
 
 
@@ -97,6 +97,47 @@ class Space2DSW {
 
 	bool locked;
 
+	enum {
+		SNAPSHOT_MAGIC=0x50534e50 // PSNP
+	};
+
+	struct SnapshotHeader {
+
+		uint32_t magic;
+		uint32_t body_count;
+		uint32_t active_count;
+		uint32_t body_pair_count;
+		uint32_t area_pair_count;
+	};
+
+	struct SnapshotBody {
+
+		uint32_t id;
+		uint32_t shape_count;
+		Body2DSW::State state;
+	};
+
+	struct SnapshotShape {
+
+		Rect2 aabb;
+		Vector2 kinematic_advance;
+		float kinematic_retreat;
+	};
+
+	struct SnapshotPair {
+
+		uint64_t key;
+		uint64_t subkey;
+		uint32_t size;
+	};
+
+	struct SnapshotBodyCMP {
+
+		_FORCE_INLINE_ bool operator()(const Body2DSW* p_a,const Body2DSW* p_b) const { return p_a->get_self() < p_b->get_self(); }
+	};
+
+	Vector<Body2DSW*> snapshot_body_cache;
+
 friend class Physics2DDirectSpaceStateSW;
 
 public:
@@ -145,6 +186,9 @@ public:
 	void setup();
 	void call_queries();
 
+	int get_snapshot_size() const;
+	int snapshot(uint8_t *r_buffer,int p_size) const;
+	Error restore_snapshot(const uint8_t *p_buffer,int p_size);
 
 	bool is_locked() const;
 	void lock();
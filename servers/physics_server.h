@@ -207,6 +207,11 @@ public:
 	// this function only works on fixed process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState* space_get_direct_state(RID p_space)=0;
 
+	// binary copy of the simulation state (bodies, contacts, sleeping) for rollback, buffers are owned by the caller
+	virtual int space_get_snapshot_size(RID p_space) const=0;
+	virtual int space_snapshot(RID p_space,uint8_t *r_buffer,int p_size) const=0;
+	virtual Error space_restore_snapshot(RID p_space,const uint8_t *p_buffer,int p_size)=0;
+
 
 	//missing space parameters
 
@@ -559,6 +559,18 @@ Rasterizer::Rasterizer() {
 
 }
 
+void Rasterizer::skeleton_set_bone_transforms(RID p_skeleton,const float *p_transforms,int p_count) {
+
+	for(int i=0;i<p_count;i++) {
+
+		const float *m=&p_transforms[i*12];
+		Transform t;
+		t.basis.set(m[0],m[1],m[2],m[4],m[5],m[6],m[8],m[9],m[10]);
+		t.origin=Vector3(m[3],m[7],m[11]);
+		skeleton_bone_set_transform(p_skeleton,i,t);
+	}
+}
+
 RID Rasterizer::create_overdraw_debug_material() {
 	RID mat = fixed_material_create();
 	fixed_material_set_parameter( mat,VisualServer::FIXED_MATERIAL_PARAM_SPECULAR,Color(0,0,0) );
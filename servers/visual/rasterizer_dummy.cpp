@@ -1058,6 +1058,23 @@ Transform RasterizerDummy::skeleton_bone_get_transform(RID p_skeleton,int p_bone
 	return skeleton->bones[p_bone];
 }
 
+void RasterizerDummy::skeleton_set_bone_transforms(RID p_skeleton,const float *p_transforms,int p_count) {
+
+	Skeleton *skeleton = skeleton_owner.get( p_skeleton );
+	ERR_FAIL_COND(!skeleton);
+	ERR_FAIL_COND( p_count<0 || p_count>skeleton->bones.size() );
+
+	Transform *bones = skeleton->bones.ptr();
+
+	for(int i=0;i<p_count;i++) {
+
+		const float *m=&p_transforms[i*12];
+		Transform &t=bones[i];
+		t.basis.set(m[0],m[1],m[2],m[4],m[5],m[6],m[8],m[9],m[10]);
+		t.origin=Vector3(m[3],m[7],m[11]);
+	}
+}
+
 
 /* LIGHT API */
 
@@ -821,6 +821,12 @@ Transform VisualServerRaster::skeleton_bone_get_transform(RID p_skeleton,int p_b
 	return rasterizer->skeleton_bone_get_transform(p_skeleton,p_bone);
 
 }
+
+void VisualServerRaster::skeleton_set_bone_transforms(RID p_skeleton,const float *p_transforms,int p_count) {
+	VS_CHANGED;
+	rasterizer->skeleton_set_bone_transforms(p_skeleton,p_transforms,p_count);
+
+}
 	
 
 /* VISIBILITY API */
@@ -60,6 +60,8 @@ class VisualServerWrapMT : public VisualServer {
 
 	void thread_exit();
 
+	void _skeleton_set_bone_transforms(RID p_skeleton,Vector<float> p_transforms) { visual_server->skeleton_set_bone_transforms(p_skeleton,p_transforms.ptr(),p_transforms.size()/12); }
+
 	Mutex*alloc_mutex;
 
 
@@ -838,6 +840,19 @@ public:
 	FUNC3(skeleton_bone_set_transform,RID,int, const Transform&);
 	FUNC2R(Transform,skeleton_bone_get_transform,RID,int );
 
+	virtual void skeleton_set_bone_transforms(RID p_skeleton,const float *p_transforms,int p_count) {
+		if (Thread::get_caller_ID()!=server_thread) {
+			//the caller may reuse its buffer right away, so the command carries a copy
+			Vector<float> transforms;
+			transforms.resize(p_count*12);
+			if (p_count>0)
+				copymem(transforms.ptr(),p_transforms,p_count*12*sizeof(float));
+			command_queue.push( this, &VisualServerWrapMT::_skeleton_set_bone_transforms,p_skeleton,transforms);
+		} else {
+			visual_server->skeleton_set_bone_transforms(p_skeleton,p_transforms,p_count);
+		}
+	}
+
 	/* ROOM API */
 
 	FUNC0R(RID,room_create);
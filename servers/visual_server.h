@@ -527,6 +527,7 @@ public:
 	virtual int skeleton_get_bone_count(RID p_skeleton) const=0;
 	virtual void skeleton_bone_set_transform(RID p_skeleton,int p_bone, const Transform& p_transform)=0;
 	virtual Transform skeleton_bone_get_transform(RID p_skeleton,int p_bone)=0;
+	virtual void skeleton_set_bone_transforms(RID p_skeleton,const float *p_transforms,int p_count)=0; ///< bones 0..p_count-1 in one go, 12 floats each: the 3x4 row major matrix (basis row, then origin component)
 	
 	/* ROOM API */
 
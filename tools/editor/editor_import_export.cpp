@@ -39,6 +39,8 @@
 #include "io/config_file.h"
 #include "io/resource_saver.h"
 #include "io/md5.h"
+#include "io/marshalls.h"
+#include "io/file_access_pack.h"
 #include "io_plugins/editor_texture_import_plugin.h"
 
 String EditorImportPlugin::validate_source_path(const String& p_path) {
@@ -909,7 +911,8 @@ Error EditorExportPlatform::save_pack_file(void *p_userdata,const String& p_path
 	td.pos=pd->f->get_pos();;
 	td.ofs=pd->ftmp->get_pos();
 	td.size=p_data.size();
-	pd->file_ofs.push_back(td);
+	td.hash=PackedData::hash_path(p_path);
+	td.path=cs;
 	pd->f->store_64(0); //ofs
 	pd->f->store_64(0); //size
 	{
@@ -918,10 +921,15 @@ Error EditorExportPlatform::save_pack_file(void *p_userdata,const String& p_path
 		MD5Update(&ctx,(unsigned char*)p_data.ptr(),p_data.size());
 		MD5Final(&ctx);
 		pd->f->store_buffer(ctx.digest,16);
+		for(int i=0;i<16;i++)
+			td.md5[i]=ctx.digest[i];
 	}
+	pd->file_ofs.push_back(td);
 	pd->ep->step("Storing File: "+p_path,2+p_file*100/p_total);
 	pd->count++;
 	pd->ftmp->store_buffer(p_data.ptr(),p_data.size());
+	while(pd->ftmp->get_pos()%4)
+		pd->ftmp->store_8(0); //keep files aligned, so they can be mapped
 	return OK;
 
 }
@@ -958,6 +966,9 @@ Error EditorExportPlatform::save_pack(FileAccess *dst,bool p_make_bundles) {
 	if (err)
 		return err;
 
+	while(dst->get_pos()%4)
+		dst->store_8(0);
+
 	size_t ofsplus = dst->get_pos();
 	//append file
 
@@ -977,9 +988,56 @@ Error EditorExportPlatform::save_pack(FileAccess *dst,bool p_make_bundles) {
 
 	memdelete(tmp);
 
+	//hash index sorted by path hash, lets the engine skip parsing the directory
+
+	Vector<TempData> sorted = pd.file_ofs;
+	sorted.sort();
+
+	uint32_t paths_size=0;
+	for(int i=0;i<sorted.size();i++)
+		paths_size+=sorted[i].path.length();
+
+	Vector<uint8_t> entries;
+	entries.resize(sorted.size()*PackedData::INDEX_ENTRY_SIZE+paths_size);
+	uint8_t *w=entries.ptr();
+	uint8_t *wp=&w[sorted.size()*PackedData::INDEX_ENTRY_SIZE];
+	uint32_t path_ofs=0;
+	for(int i=0;i<sorted.size();i++) {
+
+		//paths are stored too, the hash alone could match a path that is not in the pack
+		uint32_t path_len=sorted[i].path.length();
+		encode_uint64(sorted[i].hash,&w[0]);
+		encode_uint64(sorted[i].ofs+ofsplus,&w[8]);
+		encode_uint64(sorted[i].size,&w[16]);
+		for(int j=0;j<16;j++)
+			w[24+j]=sorted[i].md5[j];
+		encode_uint32(path_ofs,&w[40]);
+		encode_uint32(path_len,&w[44]);
+		copymem(&wp[path_ofs],sorted[i].path.get_data(),path_len);
+		path_ofs+=path_len;
+		w+=PackedData::INDEX_ENTRY_SIZE;
+	}
+
+	MD5_CTX ctx;
+	MD5Init(&ctx);
+	MD5Update(&ctx,entries.ptr(),entries.size());
+	MD5Final(&ctx);
+
+	uint64_t index_ofs=dst->get_pos();
+	dst->store_32(PackedData::INDEX_MAGIC);
+	dst->store_32(sorted.size());
+	dst->store_32(paths_size);
+	dst->store_buffer(ctx.digest,16);
+	dst->store_buffer(entries.ptr(),entries.size());
+
 	dst->store_64(dst->get_pos()-ofs_begin);
 	dst->store_32(0x43504447); //GDPK
 
+	//index location goes in the first two reserved fields
+	dst->seek(ofs_begin+20);
+	dst->store_32(index_ofs&0xFFFFFFFF);
+	dst->store_32(index_ofs>>32);
+
 	//fix offsets
 
 	dst->seek(fcountpos);
@@ -91,6 +91,11 @@ protected:
 		uint64_t pos;
 		uint64_t ofs;
 		uint64_t size;
+		uint64_t hash;
+		uint8_t md5[16];
+		CharString path;
+
+		bool operator<(const TempData& p_data) const { return hash<p_data.hash; }
 	};
 
 	struct PackData {
@@ -4,9 +4,9 @@
 #include "../editor_settings.h"
 
 //#define DEBUG_PRINT(m_p) print_line(m_p)
-#define DEBUG_TIME(m_what) printf("MS: %s - %lli\n",m_what,OS::get_singleton()->get_ticks_usec());
+//#define DEBUG_TIME(m_what) printf("MS: %s - %lli\n",m_what,OS::get_singleton()->get_ticks_usec());
 
-//#define DEBUG_TIME(m_what)
+#define DEBUG_TIME(m_what)
 
 void EditorFileServer::_close_client(ClientData *cd) {
 
@@ -138,8 +138,6 @@ void EditorFileServer::_subthread_start(void*s) {
 					_close_client(cd);
 					ERR_FAIL_COND(!s.begins_with("res://"));
 				}
-				ERR_CONTINUE(cd->files.has(id));
-
 				if (cmd==FileAccessNetwork::COMMAND_FILE_EXISTS) {
 
 					encode_uint32(id,buf4);
@@ -164,6 +162,12 @@ void EditorFileServer::_subthread_start(void*s) {
 					break;
 				}
 
+				if (cd->files.has(id)) {
+					//reopened without closing
+					memdelete(cd->files[id]);
+					cd->files.erase(id);
+				}
+
 				FileAccess *fa = FileAccess::open(s,FileAccess::READ);
 				if (!fa) {
 					//not found, continue
@@ -199,8 +203,6 @@ void EditorFileServer::_subthread_start(void*s) {
 					ERR_FAIL_COND(err!=OK);
 				}
 
-				ERR_CONTINUE(!cd->files.has(id));
-
 				uint64_t offset = decode_uint64(buf4);
 
 				err = cd->connection->get_data(buf4,4);
@@ -209,28 +211,70 @@ void EditorFileServer::_subthread_start(void*s) {
 					ERR_FAIL_COND(err!=OK);
 				}
 
+				ERR_CONTINUE(!cd->files.has(id));
+
 				int blocklen=decode_uint32(buf4);
-				ERR_CONTINUE(blocklen > (16*1024*1024));
+				ERR_CONTINUE(blocklen<0 || blocklen > FileAccessNetwork::MAX_BLOCK_SIZE);
 
+				//header and data go out in one write, blocks may span many pages
 				cd->files[id]->seek(offset);
-				Vector<uint8_t> buf;
-				buf.resize(blocklen);
-				int read = cd->files[id]->get_buffer(buf.ptr(),blocklen);
+				cd->block.resize(20+blocklen);
+				uint8_t *w = cd->block.ptr();
+				int read = cd->files[id]->get_buffer(&w[20],blocklen);
 				ERR_CONTINUE(read<0);
 
-				print_line("GET BLOCK - offset: "+itos(offset)+", blocklen: "+itos(blocklen));
+				encode_uint32(id,&w[0]);
+				encode_uint32(FileAccessNetwork::RESPONSE_DATA,&w[4]);
+				encode_uint64(offset,&w[8]);
+				encode_uint32(read,&w[16]);
+				cd->connection->put_data(w,20+read);
 
-				//not found, continue
-				encode_uint32(id,buf4);
-				cd->connection->put_data(buf4,4);
-				encode_uint32(FileAccessNetwork::RESPONSE_DATA,buf4);
-				cd->connection->put_data(buf4,4);
-				encode_uint64(offset,buf4);
-				cd->connection->put_data(buf4,8);
-				encode_uint32(read,buf4);
-				cd->connection->put_data(buf4,4);
-				cd->connection->put_data(buf.ptr(),read);
 
+			} break;
+			case FileAccessNetwork::COMMAND_GET_MODTIMES: {
+
+				err = cd->connection->get_data(buf4,4);
+				if (err!=OK) {
+					_close_client(cd);
+					ERR_FAIL_COND(err!=OK);
+				}
+
+				int count=decode_uint32(buf4);
+				if (count<0 || count>FileAccessNetwork::MAX_MODTIMES) {
+					_close_client(cd);
+					ERR_FAIL();
+				}
+
+				cd->block.resize(12+count*8);
+				uint8_t *w = cd->block.ptr();
+				encode_uint32(id,&w[0]);
+				encode_uint32(FileAccessNetwork::RESPONSE_GET_MODTIMES,&w[4]);
+				encode_uint32(count,&w[8]);
+
+				Vector<char> fileutf8;
+				for(int i=0;i<count;i++) {
+
+					err = cd->connection->get_data(buf4,4);
+					int namelen=decode_uint32(buf4);
+					if (err!=OK || namelen<0 || namelen>4096) {
+						_close_client(cd);
+						ERR_FAIL();
+					}
+					fileutf8.resize(namelen+1);
+					err = cd->connection->get_data((uint8_t*)fileutf8.ptr(),namelen);
+					if (err!=OK) {
+						_close_client(cd);
+						ERR_FAIL_COND(err!=OK);
+					}
+					fileutf8[namelen]=0;
+					String s;
+					s.parse_utf8(fileutf8.ptr());
+
+					uint64_t mt = s.begins_with("res://") ? FileAccess::get_modified_time(s) : 0;
+					encode_uint64(mt,&w[12+i*8]);
+				}
+
+				cd->connection->put_data(w,12+count*8);
 
 			} break;
 			case FileAccessNetwork::COMMAND_CLOSE: {
@@ -290,10 +334,14 @@ void EditorFileServer::_thread_start(void*s) {
 
 void EditorFileServer::start() {
 
+	start(EDITOR_DEF("file_server/port",6010),EDITOR_DEF("file_server/password",""));
+}
+
+void EditorFileServer::start(int p_port,const String& p_password) {
 
 	stop();
-	port=EDITOR_DEF("file_server/port",6010);
-	password=EDITOR_DEF("file_server/password","");
+	port=p_port;
+	password=p_password;
 	cmd=CMD_ACTIVATE;
 
 }
@@ -317,8 +365,10 @@ EditorFileServer::EditorFileServer() {
 	active=false;
 	cmd=CMD_NONE;
 
-	EDITOR_DEF("file_server/port",6010);
-	EDITOR_DEF("file_server/password","");
+	if (EditorSettings::get_singleton()) {
+		EDITOR_DEF("file_server/port",6010);
+		EDITOR_DEF("file_server/password","");
+	}
 }
 
 EditorFileServer::~EditorFileServer() {
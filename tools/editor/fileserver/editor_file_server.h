@@ -23,6 +23,7 @@ class EditorFileServer : public Object {
 		Thread *thread;
 		Ref<StreamPeerTCP> connection;
 		Map<int,FileAccess*> files;
+		Vector<uint8_t> block;
 		EditorFileServer *efs;
 		bool quit;
 
@@ -48,6 +49,7 @@ class EditorFileServer : public Object {
 public:
 
 	void start();
+	void start(int p_port,const String& p_password="");
 	void stop();
 
 	bool is_active() const;